@@ -22,6 +22,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include <cmath>
 #include <string>
+#include <numeric>
 
 #include <kj/exception.h>
 
@@ -43,6 +44,18 @@ using namespace std;
 using namespace monica;
 using namespace Tools;
 
+namespace {
+
+//! replace the value at index in the ring buffer and keep the buffer's running sum up to date
+void pushToRingBuffer(std::pmr::vector<double>& buffer, double& sum, int index, double value) {
+  sum += value - buffer[index];
+  buffer[index] = value;
+  // resum once per cycle, so rounding errors can't pile up over a long run
+  if (index == 0) sum = accumulate(buffer.begin(), buffer.end(), 0.0);
+}
+
+} // namespace
+
 /**
  * @brief Constructor
  * @param sc Soil column
@@ -59,13 +72,14 @@ CropModule::CropModule(SoilColumn &sc,
                        const SiteParameters &stps,
                        const CropModuleParameters &cropPs,
                        const SimulationParameters &simPs,
-                       std::function<void(std::string)> fireEvent,
-                       std::function<void(std::map<size_t, double>, double)> addOrganicMatter,
+                       std::function<void(const std::string&)> fireEvent,
+                       std::function<void(kj::ArrayPtr<const double>, double)> addOrganicMatter,
                        std::function<std::pair<double, double>(double)> getSnowDepthAndCalcTempUnderSnow,
                        Intercropping &ic)
-    : _intercropping(ic), _frostKillOn(simPs.pc_FrostKillOn), soilColumn(sc), cropPs(cropPs),
+    : _intercropping(&ic), _frostKillOn(simPs.pc_FrostKillOn), soilColumn(&sc), cropPs(&cropPs),
       speciesPs(cps.speciesParams), cultivarPs(cps.cultivarParams), residuePs(kj::mv(rps)), _isWinterCrop(isWinterCrop),
       _bareSoilKcFactor(stps.bareSoilKcFactor), vs_Latitude(stps.vs_Latitude),
+      _solarGeometry(SolarGeometryTable::forLatitude(stps.vs_Latitude)),
       pc_AbovegroundOrgan(cps.speciesParams.pc_AbovegroundOrgan),
       pc_AssimilatePartitioningCoeff(cps.cultivarParams.pc_AssimilatePartitioningCoeff),
       pc_AssimilateReallocation(cps.speciesParams.pc_AssimilateReallocation),
@@ -77,8 +91,8 @@ CropModule::CropModule(SoilColumn &sc,
       pc_CriticalTemperatureHeatStress(cps.cultivarParams.pc_CriticalTemperatureHeatStress),
       pc_CropHeightP1(cps.cultivarParams.pc_CropHeightP1), pc_CropHeightP2(cps.cultivarParams.pc_CropHeightP2),
       pc_CropName(cps.pc_CropName()), pc_CropSpecificMaxRootingDepth(cps.cultivarParams.pc_CropSpecificMaxRootingDepth),
-      vc_CurrentTemperatureSum(
-          cps.speciesParams.pc_NumberOfDevelopmentalStages(), 0.0),
+      vc_CropWaterUptake(soilColumn->get_allocator()),
+      vc_CurrentTemperatureSum(cps.speciesParams.pc_NumberOfDevelopmentalStages(), 0.0, soilColumn->get_allocator()),
       pc_CuttingDelayDays(cps.speciesParams.pc_CuttingDelayDays),
       pc_DaylengthRequirement(cps.cultivarParams.pc_DaylengthRequirement),
       pc_DefaultRadiationUseEfficiency(cps.speciesParams.pc_DefaultRadiationUseEfficiency),
@@ -94,8 +108,8 @@ CropModule::CropModule(SoilColumn &sc,
       pc_HeatSumIrrigationEnd(cps.cultivarParams.pc_HeatSumIrrigationEnd), vs_HeightNN(stps.vs_HeightNN),
       pc_InitialKcFactor(cps.speciesParams.pc_InitialKcFactor),
       pc_InitialOrganBiomass(cps.speciesParams.pc_InitialOrganBiomass),
-      pc_InitialRootingDepth(cps.speciesParams.pc_InitialRootingDepth), vc_sunlitLeafAreaIndex(24),
-      vc_shadedLeafAreaIndex(24), pc_LowTemperatureExposure(cps.cultivarParams.pc_LowTemperatureExposure),
+      pc_InitialRootingDepth(cps.speciesParams.pc_InitialRootingDepth), vc_sunlitLeafAreaIndex(24, soilColumn->get_allocator()),
+      vc_shadedLeafAreaIndex(24, soilColumn->get_allocator()), pc_LowTemperatureExposure(cps.cultivarParams.pc_LowTemperatureExposure),
       pc_LimitingTemperatureHeatStress(cps.speciesParams.pc_LimitingTemperatureHeatStress),
       pc_LT50cultivar(cps.cultivarParams.pc_LT50cultivar), pc_LuxuryNCoeff(cps.speciesParams.pc_LuxuryNCoeff),
       pc_MaxAssimilationRate(cps.cultivarParams.pc_MaxAssimilationRate),
@@ -112,23 +126,25 @@ CropModule::CropModule(SoilColumn &sc,
         simPs.pc_NitrogenResponseOn),
       pc_NumberOfDevelopmentalStages(cps.speciesParams.pc_NumberOfDevelopmentalStages()),
       pc_NumberOfOrgans(cps.speciesParams.pc_NumberOfOrgans()),
-      vc_NUptakeFromLayer(soilColumn.vs_NumberOfLayers(), 0.0), pc_OptimumTemperature(
-        cps.cultivarParams.pc_OptimumTemperature), vc_OrganBiomass(pc_NumberOfOrgans, 0.0), vc_OrganDeadBiomass(
-        cps.speciesParams.pc_NumberOfOrgans(), 0.0), vc_OrganGreenBiomass(cps.speciesParams.pc_NumberOfOrgans(), 0.0),
-      vc_OrganGrowthIncrement(pc_NumberOfOrgans, 0.0), pc_OrganGrowthRespiration(
+      vc_NUptakeFromLayer(soilColumn->vs_NumberOfLayers(), 0.0, soilColumn->get_allocator()), pc_OptimumTemperature(
+        cps.cultivarParams.pc_OptimumTemperature), vc_OrganBiomass(pc_NumberOfOrgans, 0.0, soilColumn->get_allocator()), vc_OrganDeadBiomass(
+        cps.speciesParams.pc_NumberOfOrgans(), 0.0, soilColumn->get_allocator()),
+      vc_OrganGreenBiomass(cps.speciesParams.pc_NumberOfOrgans(), 0.0, soilColumn->get_allocator()),
+      vc_OrganGrowthIncrement(pc_NumberOfOrgans, 0.0, soilColumn->get_allocator()), pc_OrganGrowthRespiration(
         cps.speciesParams.pc_OrganGrowthRespiration), pc_OrganIdsForPrimaryYield(
         cps.cultivarParams.pc_OrganIdsForPrimaryYield), pc_OrganIdsForSecondaryYield(
         cps.cultivarParams.pc_OrganIdsForSecondaryYield), pc_OrganIdsForCutting(
         cps.cultivarParams.pc_OrganIdsForCutting), pc_OrganMaintenanceRespiration(
-        cps.speciesParams.pc_OrganMaintenanceRespiration), vc_OrganSenescenceIncrement(pc_NumberOfOrgans, 0.0),
+        cps.speciesParams.pc_OrganMaintenanceRespiration), vc_OrganSenescenceIncrement(pc_NumberOfOrgans, 0.0, soilColumn->get_allocator()),
       pc_OrganSenescenceRate(cps.cultivarParams.pc_OrganSenescenceRate), pc_PartBiologicalNFixation(
         cps.speciesParams.pc_PartBiologicalNFixation), pc_Perennial(cps.cultivarParams.pc_Perennial), pc_PlantDensity(
         cps.speciesParams.pc_PlantDensity), pc_ResidueNRatio(cps.cultivarParams.pc_ResidueNRatio), pc_RespiratoryStress(
-        cps.cultivarParams.pc_RespiratoryStress), vc_RootDensity(soilColumn.vs_NumberOfLayers(), 0.0), vc_RootDiameter(
-        soilColumn.vs_NumberOfLayers(), 0.0), pc_RootDistributionParam(cps.speciesParams.pc_RootDistributionParam),
-      vc_RootEffectivity(soilColumn.vs_NumberOfLayers(), 0.0), pc_RootFormFactor(cps.speciesParams.pc_RootFormFactor),
+        cps.cultivarParams.pc_RespiratoryStress), vc_RootDensity(soilColumn->vs_NumberOfLayers(), 0.0, soilColumn->get_allocator()),
+      vc_RootDensityFactor(soilColumn->get_allocator()), _deadRootBiomassPerLayer(soilColumn->get_allocator()),
+      vc_RootDiameter(soilColumn->vs_NumberOfLayers(), 0.0, soilColumn->get_allocator()), pc_RootDistributionParam(cps.speciesParams.pc_RootDistributionParam),
+      vc_RootEffectivity(soilColumn->vs_NumberOfLayers(), 0.0, soilColumn->get_allocator()), pc_RootFormFactor(cps.speciesParams.pc_RootFormFactor),
       pc_RootGrowthLag(cps.speciesParams.pc_RootGrowthLag), pc_RootPenetrationRate(
-        cps.speciesParams.pc_RootPenetrationRate), vs_SoilMineralNContent(soilColumn.vs_NumberOfLayers(), 0.0),
+        cps.speciesParams.pc_RootPenetrationRate), vs_SoilMineralNContent(soilColumn->vs_NumberOfLayers(), 0.0, soilColumn->get_allocator()),
       pc_SpecificLeafArea(cps.cultivarParams.pc_SpecificLeafArea), pc_SpecificRootLength(
         cps.speciesParams.pc_SpecificRootLength), pc_StageAfterCut(cps.speciesParams.pc_StageAfterCut - 1),
       pc_StageAtMaxDiameter(cps.speciesParams.pc_StageAtMaxDiameter), pc_StageAtMaxHeight(
@@ -136,12 +152,13 @@ CropModule::CropModule(SoilColumn &sc,
         cps.speciesParams.pc_StageMaxRootNConcentration), pc_StageKcFactor(cps.cultivarParams.pc_StageKcFactor),
       pc_StageTemperatureSum(cps.cultivarParams.pc_StageTemperatureSum), pc_StorageOrgan(
         cps.speciesParams.pc_StorageOrgan), vc_TimeUnderAnoxiaThreshold(cropPs.pc_TimeUnderAnoxiaThreshold),
-      vs_Tortuosity(cropPs.pc_Tortuosity), vc_Transpiration(
-        soilColumn.vs_NumberOfLayers(), 0.0), vc_TranspirationRedux(soilColumn.vs_NumberOfLayers(), 1.0),
+      vs_Tortuosity(cropPs.pc_Tortuosity), vc_Transpiration(soilColumn->vs_NumberOfLayers(), 0.0, soilColumn->get_allocator()),
+      vc_TranspirationRedux(soilColumn->vs_NumberOfLayers(), 1.0, soilColumn->get_allocator()),
       pc_VernalisationRequirement(cps.cultivarParams.pc_VernalisationRequirement), pc_WaterDeficitResponseOn(
         simPs.pc_WaterDeficitResponseOn), vs_MaxEffectiveRootingDepth(stps.vs_MaxEffectiveRootingDepth),
-      vs_ImpenetrableLayerDepth(stps.vs_ImpenetrableLayerDepth), _rad24(_stepSize24), _rad240(_stepSize240), _tfol24(
-        _stepSize24), _tfol240(_stepSize240), _fireEvent(kj::mv(fireEvent)),
+      vs_ImpenetrableLayerDepth(stps.vs_ImpenetrableLayerDepth), _rad24(_stepSize24, soilColumn->get_allocator()),
+      _rad240(_stepSize240, soilColumn->get_allocator()), _tfol24(_stepSize24, soilColumn->get_allocator()),
+      _tfol240(_stepSize240, soilColumn->get_allocator()), _fireEvent(kj::mv(fireEvent)),
       _addOrganicMatter(kj::mv(addOrganicMatter)),
       _getSnowDepthAndCalcTempUnderSnow(kj::mv(getSnowDepthAndCalcTempUnderSnow)), __enable_vernalisation_factor_fix__(
         cps.__enable_vernalisation_factor_fix__.orDefault(cropPs.__enable_vernalisation_factor_fix__)) {
@@ -201,10 +218,10 @@ CropModule::CropModule(SoilColumn &sc,
 //
     // std::cout << "old mrd: " << vc_MaxRootingDepth << " -> ";
     auto R_P_max = pc_CropSpecificMaxRootingDepth;
-    double f_S = soilColumn[0].vs_SoilSandContent(); // [kg kg-1]
+    double f_S = (*soilColumn)[0].vs_SoilSandContent(); // [kg kg-1]
     auto R_S = (f_S - 0.5) * -0.6;
 
-    double rho_B = soilColumn[0].vs_SoilBulkDensity(); // [kg m-3]
+    double rho_B = (*soilColumn)[0].vs_SoilBulkDensity(); // [kg m-3]
     auto R_D = (rho_B / 1000.0 - 1) * -0.3;
 
     vc_MaxRootingDepth =
@@ -221,16 +238,57 @@ CropModule::CropModule(SoilColumn &sc,
 
 CropModule::CropModule(SoilColumn &sc,
                        const CropModuleParameters &cropPs,
-                       std::function<void(std::string)> fireEvent,
-                       std::function<void(std::map<size_t, double>, double)> addOrganicMatter,
+                       std::function<void(const std::string&)> fireEvent,
+                       std::function<void(kj::ArrayPtr<const double>, double)> addOrganicMatter,
                        std::function<std::pair<double, double>(double)> getSnowDepthAndCalcTempUnderSnow,
                        mas::schema::model::monica::CropModuleState::Reader reader,
                        Intercropping &ic)
-    : _intercropping(ic), soilColumn(sc), cropPs(cropPs), _fireEvent(kj::mv(fireEvent)), _addOrganicMatter(
+    : _intercropping(&ic), soilColumn(&sc), cropPs(&cropPs),
+      vc_CropWaterUptake(soilColumn->get_allocator()), vc_CurrentTemperatureSum(soilColumn->get_allocator()),
+      vc_sunlitLeafAreaIndex(soilColumn->get_allocator()), vc_shadedLeafAreaIndex(soilColumn->get_allocator()),
+      vc_NUptakeFromLayer(soilColumn->get_allocator()), vc_OrganBiomass(soilColumn->get_allocator()),
+      vc_OrganDeadBiomass(soilColumn->get_allocator()), vc_OrganGreenBiomass(soilColumn->get_allocator()),
+      vc_OrganGrowthIncrement(soilColumn->get_allocator()), vc_OrganSenescenceIncrement(soilColumn->get_allocator()),
+      vc_RootDensity(soilColumn->get_allocator()), vc_RootDensityFactor(soilColumn->get_allocator()),
+      _deadRootBiomassPerLayer(soilColumn->get_allocator()), vc_RootDiameter(soilColumn->get_allocator()),
+      vc_RootEffectivity(soilColumn->get_allocator()), vs_SoilMineralNContent(soilColumn->get_allocator()),
+      vc_Transpiration(soilColumn->get_allocator()), vc_TranspirationRedux(soilColumn->get_allocator()),
+      _rad24(soilColumn->get_allocator()), _rad240(soilColumn->get_allocator()), _tfol24(soilColumn->get_allocator()),
+      _tfol240(soilColumn->get_allocator()),
+      _fireEvent(kj::mv(fireEvent)), _addOrganicMatter(
     kj::mv(addOrganicMatter)), _getSnowDepthAndCalcTempUnderSnow(kj::mv(getSnowDepthAndCalcTempUnderSnow)) {
   deserialize(reader);
 }
 
+CropModule::CropModule(const CropModule &other,
+                       SoilColumn &sc,
+                       const CropModuleParameters &cropPs,
+                       std::function<void(const std::string&)> fireEvent,
+                       std::function<void(kj::ArrayPtr<const double>, double)> addOrganicMatter,
+                       std::function<std::pair<double, double>(double)> getSnowDepthAndCalcTempUnderSnow,
+                       Intercropping &ic)
+    : soilColumn(&sc),
+      vc_CropWaterUptake(sc.get_allocator()), vc_CurrentTemperatureSum(sc.get_allocator()),
+      vc_sunlitLeafAreaIndex(sc.get_allocator()), vc_shadedLeafAreaIndex(sc.get_allocator()),
+      vc_NUptakeFromLayer(sc.get_allocator()), vc_OrganBiomass(sc.get_allocator()),
+      vc_OrganDeadBiomass(sc.get_allocator()), vc_OrganGreenBiomass(sc.get_allocator()),
+      vc_OrganGrowthIncrement(sc.get_allocator()), vc_OrganSenescenceIncrement(sc.get_allocator()),
+      vc_RootDensity(sc.get_allocator()), vc_RootDensityFactor(sc.get_allocator()),
+      _deadRootBiomassPerLayer(sc.get_allocator()), vc_RootDiameter(sc.get_allocator()),
+      vc_RootEffectivity(sc.get_allocator()), vs_SoilMineralNContent(sc.get_allocator()),
+      vc_Transpiration(sc.get_allocator()), vc_TranspirationRedux(sc.get_allocator()),
+      _rad24(sc.get_allocator()), _rad240(sc.get_allocator()), _tfol24(sc.get_allocator()),
+      _tfol240(sc.get_allocator()) {
+  // the assignment keeps the memory resource of the state vectors (like SoilLayer), afterwards rebind
+  *this = other;
+  _intercropping = &ic;
+  soilColumn = &sc;
+  this->cropPs = &cropPs;
+  _fireEvent = kj::mv(fireEvent);
+  _addOrganicMatter = kj::mv(addOrganicMatter);
+  _getSnowDepthAndCalcTempUnderSnow = kj::mv(getSnowDepthAndCalcTempUnderSnow);
+}
+
 double CropModule::sumStageTemperatureSums(int startAtStage, int endAtInclStage) const {
   double ts = 0;
   double endAtInclStage2 = endAtInclStage < 0 ? pc_NumberOfDevelopmentalStages + endAtInclStage + 1 : endAtInclStage;
@@ -245,18 +303,13 @@ void CropModule::deserialize(mas::schema::model::monica::CropModuleState::Reader
   residuePs.deserialize(reader.getResidueParams());
   _isWinterCrop = reader.getIsWinterCrop();
   vs_Latitude = reader.getVsLatitude();
+  _solarGeometry = SolarGeometryTable::forLatitude(vs_Latitude);
   vc_AbovegroundBiomass = reader.getAbovegroundBiomass();
   vc_AbovegroundBiomassOld = reader.getAbovegroundBiomassOld();
   setFromCapnpList(pc_AbovegroundOrgan, reader.getPcAbovegroundOrgan());
   vc_ActualTranspiration = reader.getActualTranspiration();
 
-  {
-    auto listReader = reader.getPcAssimilatePartitioningCoeff();
-    pc_AssimilatePartitioningCoeff.resize(listReader.size());
-    capnp::uint i = 0;
-    for (auto &v: pc_AssimilatePartitioningCoeff)
-      setFromCapnpList(v, listReader[i++]);
-  }
+  pc_AssimilatePartitioningCoeff.deserialize(reader.getPcAssimilatePartitioningCoeff());
 
   pc_AssimilateReallocation = reader.getPcAssimilateReallocation();
   vc_Assimilates = reader.getAssimilates();
@@ -381,13 +434,7 @@ void CropModule::deserialize(mas::schema::model::monica::CropModuleState::Reader
   setFromCapnpList(pc_OrganMaintenanceRespiration, reader.getPcOrganMaintenanceRespiration());
   setFromCapnpList(vc_OrganSenescenceIncrement, reader.getOrganSenescenceIncrement());
 
-  {
-    auto listReader = reader.getPcOrganSenescenceRate();
-    pc_OrganSenescenceRate.resize(listReader.size());
-    capnp::uint i = 0;
-    for (auto &v: pc_OrganSenescenceRate)
-      setFromCapnpList(v, listReader[i++]);
-  }
+  pc_OrganSenescenceRate.deserialize(reader.getPcOrganSenescenceRate());
 
   vc_OvercastDayRadiation = reader.getOvercastDayRadiation();
   vc_OxygenDeficit = reader.getOxygenDeficit();
@@ -478,6 +525,10 @@ void CropModule::deserialize(mas::schema::model::monica::CropModuleState::Reader
   _index240 = reader.getIndex240();
   _full24 = reader.getFull24();
   _full240 = reader.getFull240();
+  _rad24Sum = accumulate(_rad24.begin(), _rad24.end(), 0.0);
+  _rad240Sum = accumulate(_rad240.begin(), _rad240.end(), 0.0);
+  _tfol24Sum = accumulate(_tfol24.begin(), _tfol24.end(), 0.0);
+  _tfol240Sum = accumulate(_tfol240.begin(), _tfol240.end(), 0.0);
   _guentherEmissions.deserialize(reader.getGuentherEmissions());
   _jjvEmissions.deserialize(reader.getJjvEmissions());
   _vocSpecies.deserialize(reader.getVocSpecies());
@@ -505,12 +556,8 @@ void CropModule::serialize(mas::schema::model::monica::CropModuleState::Builder
   setCapnpList(pc_AbovegroundOrgan, builder.initPcAbovegroundOrgan((capnp::uint) pc_AbovegroundOrgan.size()));
   builder.setActualTranspiration(vc_ActualTranspiration);
 
-  {
-    auto coeffs = builder.initPcAssimilatePartitioningCoeff((capnp::uint) pc_AssimilatePartitioningCoeff.size());
-    capnp::uint i = 0;
-    for (const auto &v: pc_AssimilatePartitioningCoeff)
-      setCapnpList(v, coeffs.init(i++, (capnp::uint) v.size()));
-  }
+  pc_AssimilatePartitioningCoeff.serialize(
+      builder.initPcAssimilatePartitioningCoeff((capnp::uint) pc_AssimilatePartitioningCoeff.numberOfStages()));
 
   builder.setPcAssimilateReallocation(pc_AssimilateReallocation);
   builder.setAssimilates(vc_Assimilates);
@@ -645,12 +692,8 @@ void CropModule::serialize(mas::schema::model::monica::CropModuleState::Builder
   setCapnpList(vc_OrganSenescenceIncrement,
                builder.initOrganSenescenceIncrement((capnp::uint) vc_OrganSenescenceIncrement.size()));
 
-  {
-    auto listBuilder = builder.initPcOrganSenescenceRate((capnp::uint) pc_OrganSenescenceRate.size());
-    capnp::uint i = 0;
-    for (const auto &v: pc_OrganSenescenceRate)
-      setCapnpList(v, listBuilder.init(i++, (capnp::uint) v.size()));
-  }
+  pc_OrganSenescenceRate.serialize(
+      builder.initPcOrganSenescenceRate((capnp::uint) pc_OrganSenescenceRate.numberOfStages()));
 
   builder.setOvercastDayRadiation(vc_OvercastDayRadiation);
   builder.setOxygenDeficit(vc_OxygenDeficit);
@@ -799,9 +842,9 @@ void CropModule::step(double vw_MeanAirTemperature,
   size_t old_DevelopmentalStage = vc_DevelopmentalStage;
 
   fc_CropDevelopmentalStage(vw_MeanAirTemperature,
-                            soilColumn[0].get_Vs_SoilMoisture_m3(),
-                            soilColumn[0].vs_FieldCapacity(),
-                            soilColumn[0].vs_PermanentWiltingPoint());
+                            (*soilColumn)[0].get_Vs_SoilMoisture_m3(),
+                            (*soilColumn)[0].vs_FieldCapacity(),
+                            (*soilColumn)[0].vs_PermanentWiltingPoint());
 
   if (old_DevelopmentalStage == 0 && vc_DevelopmentalStage == 1) {
     if (_fireEvent) _fireEvent("emergence");
@@ -852,14 +895,14 @@ void CropModule::step(double vw_MeanAirTemperature,
   }
 
   auto icSendRcv = [&](const string &outmsg) {
-    if (cropPs.isIntercropping && _intercropping.isAsync()) {
+    if (cropPs->isIntercropping && _intercropping->isAsync()) {
       debug() << outmsg;
       // tell the other side our current crop height
-      auto wreq = _intercropping.writer.writeRequest();
+      auto wreq = _intercropping->writer.writeRequest();
       auto wval = wreq.initValue();
       wval.setHeight(vc_CropHeight);
-      auto prom = wreq.send();//.wait(_intercropping.ioContext->waitScope); //.eagerlyEvaluate(nullptr); //[](kj::Exception&& ex){ cout << "crop-module: CropModule::fc_CropPhotosynthesis: write height failed: " << ex.getDescription().cStr() << endl;});
-      auto val = _intercropping.reader.readRequest().send().wait(_intercropping.ioContext->waitScope).getValue();
+      auto prom = wreq.send();//.wait(_intercropping->ioContext->waitScope); //.eagerlyEvaluate(nullptr); //[](kj::Exception&& ex){ cout << "crop-module: CropModule::fc_CropPhotosynthesis: write height failed: " << ex.getDescription().cStr() << endl;});
+      auto val = _intercropping->reader.readRequest().send().wait(_intercropping->ioContext->waitScope).getValue();
       debug() << "sent height: " << vc_CropHeight << " and received ";
       if (val.isHeight()) {
         _intercroppingOtherCropHeight = val.getHeight();
@@ -875,9 +918,9 @@ void CropModule::step(double vw_MeanAirTemperature,
   };
 
   if (vc_DevelopmentalStage > 0) {
-    auto maxCropHeight = cropPs.isIntercropping
+    auto maxCropHeight = cropPs->isIntercropping
                          && _intercroppingOtherCropHeight > vc_CropHeight
-                         ? pc_MaxCropHeight * cropPs.pc_intercropping_phRedux
+                         ? pc_MaxCropHeight * cropPs->pc_intercropping_phRedux
                          : pc_MaxCropHeight;
     debug() << "original maxCropHeight: " << pc_MaxCropHeight << " -> new maxCropHeight: " << maxCropHeight << endl;
 
@@ -930,12 +973,12 @@ void CropModule::step(double vw_MeanAirTemperature,
       // use reference evapotranspiration from climate file
       vc_ReferenceEvapotranspiration = vw_ReferenceEvapotranspiration;
     }
-    fc_CropWaterUptake(soilColumn.vm_GroundwaterTableLayer,
+    fc_CropWaterUptake(soilColumn->vm_GroundwaterTableLayer,
                        vw_GrossPrecipitation,
                        vc_CurrentTotalTemperatureSum,
                        vc_TotalTemperatureSum);
 
-    fc_CropNUptake(soilColumn.vm_GroundwaterTableLayer,
+    fc_CropNUptake(soilColumn->vm_GroundwaterTableLayer,
                    vc_CurrentTotalTemperatureSum,
                    vc_TotalTemperatureSum);
 
@@ -963,64 +1006,16 @@ void CropModule::step(double vw_MeanAirTemperature,
 void CropModule::fc_Radiation(double vs_JulianDay,
                               double vw_GlobalRadiation,
                               double vw_SunshineHours) {
-
-  double vc_DeclinationSinus = 0.0;  // old SINLD
-  double vc_DeclinationCosinus = 0.0; // old COSLD
-
-  // Calculation of declination - old DEC
-  vc_Declination = -23.4 * cos(2.0 * PI * ((vs_JulianDay + 10.0) / 365.0));
-
-  vc_DeclinationSinus = sin(vc_Declination * PI / 180.0) * sin(vs_Latitude * PI / 180.0);
-  vc_DeclinationCosinus = cos(vc_Declination * PI / 180.0) * cos(vs_Latitude * PI / 180.0);
-
-  // Calculation of the atmospheric day lenght - old DL
-  double arg_AstroDayLength = vc_DeclinationSinus / vc_DeclinationCosinus;
-  arg_AstroDayLength = bound(-1.0, arg_AstroDayLength, 1.0); // The argument of asin must be in the range of -1 to 1
-  vc_AstronomicDayLenght = 12.0 * (PI + 2.0 * asin(arg_AstroDayLength)) / PI;
-
-  // Calculation of the effective day length - old DLE
-
-  double EDLHelper = (-sin(8.0 * PI / 180.0) + vc_DeclinationSinus) / vc_DeclinationCosinus;
-
-  if ((EDLHelper < -1.0) || (EDLHelper > 1.0)) {
-    vc_EffectiveDayLength = 0.01;
-  } else {
-    vc_EffectiveDayLength = 12.0 * (PI + 2.0 * asin(EDLHelper)) / PI;
-  }
-  /*EDLHelper = bound(-1.0, EDLHelper, 1.0);
-  vc_EffectiveDayLength = 12.0 * (PI + 2.0 * asin(EDLHelper)) / PI;*/
-
-  // old DLP
-  double arg_PhotoDayLength = (-sin(-6.0 * PI / 180.0) + vc_DeclinationSinus) / vc_DeclinationCosinus;
-  arg_PhotoDayLength = bound(-1.0, arg_PhotoDayLength, 1.0); // The argument of asin must be in the range of -1 to 1
-  vc_PhotoperiodicDaylength = 12.0 * (PI + 2.0 * asin(arg_PhotoDayLength)) / PI;
-
-  // Calculation of the mean photosynthetically active radiation [J m-2] - old RDN
-  double arg_PhotAct = min(1.0, ((vc_DeclinationSinus / vc_DeclinationCosinus) *
-                                 (vc_DeclinationSinus / vc_DeclinationCosinus))); // The argument of sqrt must be >= 0
-  vc_PhotActRadiationMean = 3600.0 * (vc_DeclinationSinus * vc_AstronomicDayLenght +
-                                      24.0 / PI * vc_DeclinationCosinus * sqrt(1.0 - arg_PhotAct));
-
-  // Calculation of radiation on a clear day [J m-2] - old DRC
-  if (vc_PhotActRadiationMean > 0 && vc_AstronomicDayLenght > 0) {
-    vc_ClearDayRadiation = 0.5 * 1300.0 * vc_PhotActRadiationMean *
-                           exp(-0.14 / (vc_PhotActRadiationMean / (vc_AstronomicDayLenght * 3600.0)));
-  } else {
-    vc_ClearDayRadiation = 0;
-  }
-
-  // Calculation of radiation on an overcast day [J m-2] - old DRO
-  vc_OvercastDayRadiation = 0.2 * vc_ClearDayRadiation;
-
-  // Calculation of extraterrestrial radiation - old EXT
-  double pc_SolarConstant = 0.082; //[MJ m-2 d-1] Note: Here is the difference to HERMES, which calculates in [J cm-2 d-1]!
-  double SC = 24.0 * 60.0 / PI * pc_SolarConstant * (1.0 + 0.033 * cos(2.0 * PI * vs_JulianDay / 365.0));
-
-  double arg_SolarAngle = -tan(vs_Latitude * PI / 180.0) * tan(vc_Declination * PI / 180.0);
-  arg_SolarAngle = bound(-1.0, arg_SolarAngle, 1.0);
-  double vc_SunsetSolarAngle = acos(arg_SolarAngle);
-  vc_ExtraterrestrialRadiation =
-      SC * (vc_SunsetSolarAngle * vc_DeclinationSinus + vc_DeclinationCosinus * sin(vc_SunsetSolarAngle)); // [MJ m-2]
+  // the terms depending only on latitude and day of year are taken from the (shared) precomputed table
+  const auto& sg = _solarGeometry->at(int(vs_JulianDay));
+  vc_Declination = sg.declination; // old DEC
+  vc_AstronomicDayLenght = sg.astronomicDayLength; // old DL
+  vc_EffectiveDayLength = sg.effectiveDayLength; // old DLE
+  vc_PhotoperiodicDaylength = sg.photoperiodicDayLength; // old DLP
+  vc_PhotActRadiationMean = sg.photActRadiationMean; // old RDN [J m-2]
+  vc_ClearDayRadiation = sg.clearDayRadiation; // old DRC [J m-2]
+  vc_OvercastDayRadiation = sg.overcastDayRadiation; // old DRO [J m-2]
+  vc_ExtraterrestrialRadiation = sg.extraterrestrialRadiation; // old EXT [MJ m-2]
 
   if (vw_GlobalRadiation > 0.0) {
     vc_GlobalRadiation = vw_GlobalRadiation;
@@ -1145,10 +1140,10 @@ double CropModule::fc_OxygenDeficiency(double d_CriticalOxygenContent) {
   // Reduktion bei Luftmangel Stauwasser berücksichtigen!!!!
   double sumSaturation = 0, sumSoilMoisture = 0;
   int sumLayers = 0;
-  auto nols = std::min(std::max(size_t(3), vc_RootingDepth), soilColumn.vs_NumberOfLayers());
+  auto nols = std::min(std::max(size_t(3), vc_RootingDepth), soilColumn->vs_NumberOfLayers());
   for (size_t i = 0; i < nols; i++) {
-    sumSaturation += soilColumn[i].vs_Saturation();
-    sumSoilMoisture += soilColumn[i].get_Vs_SoilMoisture_m3();
+    sumSaturation += (*soilColumn)[i].vs_Saturation();
+    sumSoilMoisture += (*soilColumn)[i].get_Vs_SoilMoisture_m3();
     sumLayers++;
   }
   double avgAirFilledPoreVolume = (sumSaturation - sumSoilMoisture) / sumLayers;
@@ -1217,7 +1212,7 @@ void CropModule::fc_CropDevelopmentalStage(double meanAirTemperature,
         if (vc_DevelopmentalStage < (pc_NumberOfDevelopmentalStages - 1)) vc_DevelopmentalStage++;
       }
     } else { // pc_Perennial == false
-      double vc_SoilTemperature = soilColumn[0].get_Vs_SoilTemperature();
+      double vc_SoilTemperature = (*soilColumn)[0].get_Vs_SoilTemperature();
       if (vc_SoilTemperature > pc_BaseTemperature[vc_DevelopmentalStage]) {
 
         // @todo Claas: Schränkt trockener Boden das Aufsummieren der Wärmeeinheiten ein, oder
@@ -1234,7 +1229,7 @@ void CropModule::fc_CropDevelopmentalStage(double meanAirTemperature,
         }
         // Germination only if no water is stored on the soil surface.
         if (pc_EmergenceFloodingControlOn) {
-          emergenceCondition = emergenceCondition && soilColumn.vs_SurfaceWaterStorage < 0.001;
+          emergenceCondition = emergenceCondition && soilColumn->vs_SurfaceWaterStorage < 0.001;
         }
 
         if (emergenceCondition) {
@@ -1274,7 +1269,7 @@ void CropModule::fc_CropDevelopmentalStage(double meanAirTemperature,
     double vc_DevelopmentAccelerationByStress =
         max(vc_DevelopmentAccelerationByNitrogenStress, vc_DevelopmentAccelerationByWaterStress);
 
-    if (cropPs.__enable_Phenology_WangEngelTemperatureResponse__) {
+    if (cropPs->__enable_Phenology_WangEngelTemperatureResponse__) {
       double devTresponse = max(0.0, WangEngelTemperatureResponse(meanAirTemperature,
                                                                   cultivarPs.pc_MinTempDev_WE,
                                                                   cultivarPs.pc_OptTempDev_WE,
@@ -1427,7 +1422,7 @@ void CropModule::fc_CropGreenArea(double vw_MeanAirTemperature,
                                   double d_StageTemperatureSum,
                                   double d_CurrentTemperatureSum) {
   double TempResponseExpansion = 1.0;
-  if (cropPs.__enable_T_response_leaf_expansion__) {
+  if (cropPs->__enable_T_response_leaf_expansion__) {
     // Stage switch T response leaf exp (wheat = 2, maize = -1 (deactivated))
     if (vc_DevelopmentalStage + 1 <= speciesPs.pc_TransitionStageLeafExp) {
       // Early stages leaf expansion T response
@@ -1563,24 +1558,30 @@ ostream &monica::tout(bool closeFile)
 
 void CropModule::fc_MoveDeadRootBiomassToSoil(double deadRootBiomass,
                                               double vc_RootDensityFactorSum,
-                                              const vector<double> &vc_RootDensityFactor) {
-  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+                                              const std::pmr::vector<double> &vc_RootDensityFactor) {
+  auto nools = soilColumn->vs_NumberOfOrganicLayers();
 
-  map<size_t, double> layer2deadRootBiomassAtLayer;
+  _deadRootBiomassPerLayer.assign(nools, 0.0);
+  bool anyDeadRootBiomass = false;
   for (size_t i = 0; i < vc_RootingZone; i++) {
     double deadRootBiomassAtLayer = vc_RootDensityFactor.at(i) / vc_RootDensityFactorSum * deadRootBiomass;
     // just add organica matter if > 0.0001
     if (int(deadRootBiomassAtLayer * 10000) > 0) {
-      layer2deadRootBiomassAtLayer[i < nools ? i : nools - 1] += deadRootBiomassAtLayer;
+      _deadRootBiomassPerLayer[i < nools ? i : nools - 1] += deadRootBiomassAtLayer;
+      anyDeadRootBiomass = true;
     }
   }
 
-  if (!layer2deadRootBiomassAtLayer.empty()) _addOrganicMatter(layer2deadRootBiomassAtLayer, vc_NConcentrationRoot);
+  if (anyDeadRootBiomass) {
+    _addOrganicMatter(kj::arrayPtr(_deadRootBiomassPerLayer.data(), _deadRootBiomassPerLayer.size()),
+                      vc_NConcentrationRoot);
+  }
 }
 
 void CropModule::addAndDistributeRootBiomassInSoil(double rootBiomass) {
-  auto p = calcRootDensityFactorAndSum();
-  fc_MoveDeadRootBiomassToSoil(rootBiomass, p.second, p.first);
+  // refresh the factors, the rooting zone might not have been calculated yet today (or not at all after deserialization)
+  updateRootDensityFactors();
+  fc_MoveDeadRootBiomassToSoil(rootBiomass, vc_RootDensityFactorSum, vc_RootDensityFactor);
 }
 
 /**
@@ -1619,14 +1620,14 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 
   double vc_AssimilationRateReference = 0.0;
 
-  double pc_ReferenceLeafAreaIndex = cropPs.pc_ReferenceLeafAreaIndex;
-  double pc_ReferenceMaxAssimilationRate = cropPs.pc_ReferenceMaxAssimilationRate;
-  double pc_MaintenanceRespirationParameter_1 = cropPs.pc_MaintenanceRespirationParameter1;
-  double pc_MaintenanceRespirationParameter_2 = cropPs.pc_MaintenanceRespirationParameter2;
+  double pc_ReferenceLeafAreaIndex = cropPs->pc_ReferenceLeafAreaIndex;
+  double pc_ReferenceMaxAssimilationRate = cropPs->pc_ReferenceMaxAssimilationRate;
+  double pc_MaintenanceRespirationParameter_1 = cropPs->pc_MaintenanceRespirationParameter1;
+  double pc_MaintenanceRespirationParameter_2 = cropPs->pc_MaintenanceRespirationParameter2;
 
-  double pc_GrowthRespirationParameter_1 = cropPs.pc_GrowthRespirationParameter1;
-  double pc_GrowthRespirationParameter_2 = cropPs.pc_GrowthRespirationParameter2;
-  double pc_CanopyReflectionCoeff = cropPs.pc_CanopyReflectionCoefficient; // old REFLC;
+  double pc_GrowthRespirationParameter_1 = cropPs->pc_GrowthRespirationParameter1;
+  double pc_GrowthRespirationParameter_2 = cropPs->pc_GrowthRespirationParameter2;
+  double pc_CanopyReflectionCoeff = cropPs->pc_CanopyReflectionCoefficient; // old REFLC;
 
   double vc_RadiationUseEfficiency = pc_DefaultRadiationUseEfficiency;
   double vc_RadiationUseEfficiencyReference = pc_DefaultRadiationUseEfficiency;
@@ -1658,7 +1659,7 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
       _cropPhotosynthesisResults.ko = Mko * 1000.0; // mmol -> umol
 
       // OLD exponential response
-      double KTvmax = cropPs.__enable_Photosynthesis_WangEngelTemperatureResponse__
+      double KTvmax = cropPs->__enable_Photosynthesis_WangEngelTemperatureResponse__
                       ? max(0.00001, WangEngelTemperatureResponse(vw_MeanAirTemperature,
                                                                   pc_MinimumTemperatureForAssimilation,
                                                                   pc_OptimumTemperatureForAssimilation,
@@ -2059,22 +2060,49 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 #pragma region hourly FvCB code
     int vs_JulianDay = currentDate.julianDay();
     double dailyGP = 0;
-    if (cropPs.__enable_hourly_FvCB_photosynthesis__ && pc_CarboxylationPathway == 1) {
-      vector<double> hourlyGlobrads;
-      vector<double> hourlyExtrarad;
-      int sunriseH = 0;
+    if (cropPs->__enable_hourly_FvCB_photosynthesis__ && pc_CarboxylationPathway == 1) {
+      using namespace FvCB;
 
+      // collect the course of the day, so the light and temperature dependent parts
+      // of the FvCB model can be calculated for all hours at once
+      FvCB_canopy_daily_in FvCB_in;
+      const auto& sg = _solarGeometry->at(vs_JulianDay);
+      int sunriseH = 0;
       for (int h = 0; h < 24; h++) {
-        double hgr = hourlyRad(vc_GlobalRadiation, vs_Latitude, vs_JulianDay, h);
-        if (hgr > 0 && hourlyGlobrads.back() == 0.0) {
+        double hgr = _solarGeometry->hourlyRadiationIsProportional()
+                     ? vc_GlobalRadiation * sg.hourlyRadiationFraction[h]
+                     : hourlyRad(vc_GlobalRadiation, vs_Latitude, vs_JulianDay, h);
+        if (h > 0 && hgr > 0 && FvCB_in.global_rad[h - 1] == 0.0) {
           sunriseH = h;
         }
-        hourlyGlobrads.push_back(hgr);
-
-        hourlyExtrarad.push_back(hourlyRad(vc_ExtraterrestrialRadiation, vs_Latitude, vs_JulianDay, h));
+        FvCB_in.global_rad[h] = hgr;
+        FvCB_in.extra_terr_rad[h] = sg.hourlyExtraterrestrialRadiation[h];
+        FvCB_in.solar_el[h] = sg.solarElevation[h];
       }
-
-      using namespace FvCB;
+      for (int h = 0; h < 24; h++) {
+        double hourlyTemp = hourlyT(vw_MinAirTemperature, vw_MaxAirTemperature, h, sunriseH);
+        FvCB_in.leaf_temp[h] = hourlyTemp;
+        FvCB_in.VPD[h] = hourlyVaporPressureDeficit(hourlyTemp, vw_MinAirTemperature, vw_MeanAirTemperature,
+                                                    vw_MaxAirTemperature);
+      }
+      FvCB_in.LAI = LAI;
+      FvCB_in.Ca = vw_AtmosphericCO2Concentration;
+      const auto FvCB_env = FvCB_canopy_daily_env_f(FvCB_in);
+
+      // the soil water of the rooted zone doesn't change during the day
+      auto root_depth = get_RootingDepth();
+      double rootZoneFC = 0, rootZoneWP = 0, rootZoneSWC = 0;
+      if (root_depth >= 1) {
+        for (int i = 0; i < root_depth; i++) {
+          rootZoneFC += (*soilColumn)[i].vs_FieldCapacity();
+          rootZoneWP += (*soilColumn)[i].vs_PermanentWiltingPoint();
+          rootZoneSWC += (*soilColumn)[i].get_Vs_SoilMoisture_m3();
+        }
+        rootZoneFC /= (root_depth + 1);
+        rootZoneWP /= (root_depth + 1);
+        rootZoneSWC /= (root_depth + 1);
+      }
+      double referenceET = get_ReferenceEvapotranspiration();
 
       _guentherEmissions = Voc::Emissions();
       _jjvEmissions = Voc::Emissions();
@@ -2088,22 +2116,10 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
           << "," << vw_AtmosphericCO2Concentration;
 #endif
         // hourly photosynthesis
-        FvCB_canopy_hourly_in FvCB_in;
-
-        double hourlyTemp = hourlyT(vw_MinAirTemperature, vw_MaxAirTemperature, h, sunriseH);
-        FvCB_in.leaf_temp = hourlyTemp;
-        FvCB_in.global_rad = hourlyGlobrads.at(h);
-        FvCB_in.extra_terr_rad = hourlyExtrarad.at(h);
-        FvCB_in.LAI = LAI;
-        FvCB_in.solar_el = solarElevation(h, vs_Latitude, vs_JulianDay);
-        FvCB_in.VPD = hourlyVaporPressureDeficit(hourlyTemp, vw_MinAirTemperature, vw_MeanAirTemperature,
-                                                 vw_MaxAirTemperature);
-        FvCB_in.Ca = vw_AtmosphericCO2Concentration;
-
         FvCB_canopy_hourly_params hps;
         hps.Vcmax_25 = speciesPs.VCMAX25 * vc_O3_shortTermDamage * vc_O3_senescence;
 
-        auto FvCB_res = FvCB_canopy_hourly_C3(FvCB_in, hps);
+        auto FvCB_res = FvCB_canopy_hourly_C3(FvCB_in, FvCB_env, h, hps);
 
         vc_sunlitLeafAreaIndex[h] = FvCB_res.sunlit.LAI;
         vc_shadedLeafAreaIndex[h] = FvCB_res.shaded.LAI;
@@ -2117,7 +2133,6 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
         O3_par.gamma3 = 0.05;  // TODO: calibrate and add to crop params
         O3_par.gamma1 = 0.025; // TODO: calibrate and add to crop params
 
-        auto root_depth = get_RootingDepth();
         if (root_depth >= 1) // the crop has emerged
         {
 #ifdef TEST_O3_HOURLY_OUTPUT
@@ -2128,13 +2143,6 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
             << "," << vw_AtmosphericCO2Concentration
             << "," << vw_AtmosphericO3Concentration;
 #endif
-          double FC = 0, WP = 0, SWC = 0;
-          for (int i = 0; i < root_depth; i++) {
-            FC += soilColumn[i].vs_FieldCapacity();
-            WP += soilColumn[i].vs_PermanentWiltingPoint();
-            SWC += soilColumn[i].get_Vs_SoilMoisture_m3();
-          }
-
           // weighted average gs and conversion from unit ground area to unit leaf area
           double lai_sun_weight = FvCB_res.sunlit.LAI / (FvCB_res.sunlit.LAI + FvCB_res.shaded.LAI);
           double lai_sh_weight = 1 - lai_sun_weight;
@@ -2143,10 +2151,10 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
             avg_leaf_gs += lai_sun_weight * FvCB_res.sunlit.gs / FvCB_res.sunlit.LAI;
           }
 
-          O3_in.FC = FC / (root_depth + 1);  // field capacity, m3 m-3, avg in the rooted zone
-          O3_in.WP = WP / (root_depth + 1);  // wilting point, m3 m-3
-          O3_in.SWC = SWC / (root_depth + 1); // soil water content, m3 m-3
-          O3_in.ET0 = get_ReferenceEvapotranspiration();
+          O3_in.FC = rootZoneFC;  // field capacity, m3 m-3, avg in the rooted zone
+          O3_in.WP = rootZoneWP;  // wilting point, m3 m-3
+          O3_in.SWC = rootZoneSWC; // soil water content, m3 m-3
+          O3_in.ET0 = referenceET;
           O3_in.O3a = vw_AtmosphericO3Concentration; // ambient O3 partial pressure, nbar or nmol mol-1
           O3_in.gs = avg_leaf_gs;             // stomatal conductance mol m-2 s-1 bar-1
           O3_in.h = h;                 // hour of the day (0-23)
@@ -2166,15 +2174,15 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
         }
 
         // calculate VOC emissions
-        double globradWm2 = FvCB_in.global_rad * 1000000.0 / 3600; // MJ m-2 h-1 -> W m-2
+        double globradWm2 = FvCB_in.global_rad[h] * 1000000.0 / 3600; // MJ m-2 h-1 -> W m-2
         if (_index240 < _stepSize240 - 1) {
           _index240++;
         } else {
           _index240 = 0;
           _full240 = true;
         }
-        _rad240[_index240] = globradWm2;
-        _tfol240[_index240] = FvCB_in.leaf_temp;
+        pushToRingBuffer(_rad240, _rad240Sum, _index240, globradWm2);
+        pushToRingBuffer(_tfol240, _tfol240Sum, _index240, FvCB_in.leaf_temp[h]);
 
         if (_index24 < _stepSize24 - 1) {
           _index24++;
@@ -2182,127 +2190,139 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
           _index24 = 0;
           _full24 = true;
         }
-        _rad24[_index24] = globradWm2;
-        _tfol24[_index24] = FvCB_in.leaf_temp;
+        pushToRingBuffer(_rad24, _rad24Sum, _index24, globradWm2);
+        pushToRingBuffer(_tfol24, _tfol24Sum, _index24, FvCB_in.leaf_temp[h]);
 
         Voc::MicroClimateData mcd;
         // hourly or time step average global radiation (in case of monica usually 24h)
         mcd.rad = globradWm2;
-        mcd.rad24 = accumulate(_rad24.begin(), _rad24.end(), 0.0) / (_full24 ? _rad24.size() : _index24 + 1);
-        mcd.rad240 = accumulate(_rad240.begin(), _rad240.end(), 0.0) / (_full240 ? _rad240.size() : _index240 + 1);
-        mcd.tFol = FvCB_in.leaf_temp;
-        mcd.tFol24 = accumulate(_tfol24.begin(), _tfol24.end(), 0.0) / (_full24 ? _tfol24.size() : _index24 + 1);
-        mcd.tFol240 = accumulate(_tfol240.begin(), _tfol240.end(), 0.0) / (_full240 ? _tfol240.size() : _index240 + 1);
+        mcd.rad24 = _rad24Sum / (_full24 ? _rad24.size() : _index24 + 1);
+        mcd.rad240 = _rad240Sum / (_full240 ? _rad240.size() : _index240 + 1);
+        mcd.tFol = FvCB_in.leaf_temp[h];
+        mcd.tFol24 = _tfol24Sum / (_full24 ? _tfol24.size() : _index24 + 1);
+        mcd.tFol240 = _tfol240Sum / (_full240 ? _tfol240.size() : _index240 + 1);
         mcd.co2concentration = vw_AtmosphericCO2Concentration;
 
         // auto sunShadeLaiAtZenith = laiSunShade(_sitePs.vs_Latitude, julday, 12, vc_LeafAreaIndex);
         // mcd.sunlitfoliagefraction = sunShadeLaiAtZenith.first / lai;
         // mcd.sunlitfoliagefraction24 = mcd.sunlitfoliagefraction;
 
-        Voc::SpeciesData species;
-        // species.id = 0; // right now we just have one crop at a time, so no need to distinguish multiple crops
-        species.lai = LAI;
-        species.mFol =
-            get_OrganGreenBiomass(OId::LEAF) / (100. * 100.);                                // kg/ha -> kg/m2
-        species.sla =
-            species.mFol > 0 ? species.lai / species.mFol : pc_SpecificLeafArea[vc_DevelopmentalStage] * 100. *
-                                                            100.; // ha/kg -> m2/kg
-
-        species.EF_MONO = speciesPs.EF_MONO;
-        species.EF_MONOS = speciesPs.EF_MONOS;
-        species.EF_ISO = speciesPs.EF_ISO;
-        species.VCMAX25 = speciesPs.VCMAX25;
-        species.AEKC = speciesPs.AEKC;
-        species.AEKO = speciesPs.AEKO;
-        species.AEVC = speciesPs.AEVC;
-        species.KC25 = speciesPs.KC25;
-
-        auto ges = Voc::calculateGuentherVOCEmissions(species, mcd, 1. / 24.);
-        // cout << "G: C: " << ges.monoterpene_emission << " em: " << ges.isoprene_emission << endl;
-        _guentherEmissions += ges;
-        // debug() << "guenther: isoprene: " << gems.isoprene_emission << " monoterpene: " << gems.monoterpene_emission << endl;
-
-#ifdef TEST_HOURLY_OUTPUT
-        tout()
-          << currentDate.toIsoDateString()
-          << "," << h
-          << "," << speciesPs.pc_SpeciesId << "/" << cultivarPs.pc_CultivarId
-          << "," << FvCB_in.global_rad
-          << "," << FvCB_in.extra_terr_rad
-          << "," << FvCB_in.solar_el
-          << "," << mcd.rad
-          << "," << FvCB_in.LAI
-          << "," << species.mFol
-          << "," << species.sla
-          << "," << FvCB_in.leaf_temp
-          << "," << FvCB_in.VPD
-          << "," << FvCB_in.Ca
-          << "," << FvCB_in.fO3
-          << "," << FvCB_in.fls
-          << "," << FvCB_res.canopy_net_photos
-          << "," << FvCB_res.canopy_resp
-          << "," << FvCB_res.canopy_gross_photos
-          << "," << FvCB_res.jmax_c;
-        //<< "," << ges.isoprene_emission
-        //<< "," << ges.monoterpene_emission;
-#endif
-        double sun_LAI = FvCB_res.sunlit.LAI;
-        double sh_LAI = FvCB_res.shaded.LAI;
-        // JJV
-        for (const auto &lf: {FvCB_res.sunlit, FvCB_res.shaded}) {
-          species.lai = lf.LAI;
-          species.mFol = get_OrganGreenBiomass(OId::LEAF) / (100. * 100.) * lf.LAI /
-                         (sun_LAI + sh_LAI);                // kg/ha -> kg/m2
-          species.sla =
-              species.mFol > 0 ? species.lai / species.mFol : pc_SpecificLeafArea[vc_DevelopmentalStage] * 100. *
-                                                              100.; // ha/kg -> m2/kg
-
-          mcd.rad = lf.rad; // lf.rad; //W m-2 global incident
-
-          // auto ges = Voc::calculateGuentherVOCEmissions(species, mcd, 1. / 24.);
-          // cout << "G: C: " << ges.monoterpene_emission << " em: " << ges.isoprene_emission << endl;
-          //_guentherEmissions += ges;
-          // debug() << "guenther: isoprene: " << gems.isoprene_emission << " monoterpene: " << gems.monoterpene_emission << endl;
-
+        // the photosynthesis results of the leaves are part of the crop state, so they are kept up to date
+        // even if the VOC emissions are skipped
+        auto setCropPhotosynthesisResults = [&](const auto &lf) {
           _cropPhotosynthesisResults.kc = lf.kc;
           _cropPhotosynthesisResults.ko = lf.ko * 1000;
           _cropPhotosynthesisResults.oi = lf.oi * 1000;
           _cropPhotosynthesisResults.ci = lf.ci;
-          _cropPhotosynthesisResults.vcMax = FvCB::Vcmax_bernacchi_f(mcd.tFol, speciesPs.VCMAX25) * vc_CropNRedux *
+          _cropPhotosynthesisResults.vcMax = speciesPs.VCMAX25 * FvCB_env.Vcmax_T[h] * vc_CropNRedux *
                                              vc_TranspirationDeficit; // lf.vcMax;
           _cropPhotosynthesisResults.jMax =
-              FvCB::Jmax_bernacchi_f(mcd.tFol, 120) * vc_CropNRedux * vc_TranspirationDeficit;           // lf.jMax;
+              120 * FvCB_env.Jmax_T[h] * vc_CropNRedux * vc_TranspirationDeficit;           // lf.jMax;
           _cropPhotosynthesisResults.jj = lf.jj;
           _cropPhotosynthesisResults.jj1000 = lf.jj1000;
           _cropPhotosynthesisResults.jv = lf.jv;
+        };
+
+        // the VOC emissions feed no state variable, so skip them if none of their outputs is requested
+        if (!_calculateVOCEmissions) {
+          // the JJV loop below leaves the results of the shaded leaves
+          setCropPhotosynthesisResults(FvCB_res.shaded);
+        } else {
+          Voc::SpeciesData species;
+          // species.id = 0; // right now we just have one crop at a time, so no need to distinguish multiple crops
+          species.lai = LAI;
+          species.mFol =
+              get_OrganGreenBiomass(OId::LEAF) / (100. * 100.);                                // kg/ha -> kg/m2
+          species.sla =
+              species.mFol > 0 ? species.lai / species.mFol : pc_SpecificLeafArea[vc_DevelopmentalStage] * 100. *
+                                                              100.; // ha/kg -> m2/kg
+
+          species.EF_MONO = speciesPs.EF_MONO;
+          species.EF_MONOS = speciesPs.EF_MONOS;
+          species.EF_ISO = speciesPs.EF_ISO;
+          species.VCMAX25 = speciesPs.VCMAX25;
+          species.AEKC = speciesPs.AEKC;
+          species.AEKO = speciesPs.AEKO;
+          species.AEVC = speciesPs.AEVC;
+          species.KC25 = speciesPs.KC25;
 
-          auto jjves = Voc::calculateJJVVOCEmissions(species, mcd, _cropPhotosynthesisResults, 1. / 24., false);
-          // cout << "J: C: " << jjves.monoterpene_emission << " em: " << jjves.isoprene_emission << endl;
-          _jjvEmissions += jjves;
-          // debug() << "jjv: isoprene: " << jjvems.isoprene_emission << " monoterpene: " << jjvems.monoterpene_emission << endl;
+          auto ges = Voc::calculateGuentherVOCEmissions(species, mcd, 1. / 24.);
+          // cout << "G: C: " << ges.monoterpene_emission << " em: " << ges.isoprene_emission << endl;
+          _guentherEmissions += ges;
+          // debug() << "guenther: isoprene: " << gems.isoprene_emission << " monoterpene: " << gems.monoterpene_emission << endl;
 
 #ifdef TEST_HOURLY_OUTPUT
           tout()
-            << "," << species.lai
+            << currentDate.toIsoDateString()
+            << "," << h
+            << "," << speciesPs.pc_SpeciesId << "/" << cultivarPs.pc_CultivarId
+            << "," << FvCB_in.global_rad[h]
+            << "," << FvCB_in.extra_terr_rad[h]
+            << "," << FvCB_in.solar_el[h]
+            << "," << mcd.rad
+            << "," << FvCB_in.LAI
             << "," << species.mFol
             << "," << species.sla
-            << "," << lf.gs
-            << "," << lf.kc
-            << "," << lf.ko
-            << "," << lf.oi
-            << "," << lf.ci
-            << "," << lf.comp
-            << "," << lf.vcMax
-            << "," << lf.jMax
-            << "," << lf.rad
-            << "," << lf.jj
-            << "," << lf.jj1000
-            << "," << lf.jv
-            << "," << ges.isoprene_emission
-            << "," << ges.monoterpene_emission
-            << "," << jjves.isoprene_emission
-            << "," << jjves.monoterpene_emission;
+            << "," << FvCB_in.leaf_temp[h]
+            << "," << FvCB_in.VPD[h]
+            << "," << FvCB_in.Ca
+            << "," << FvCB_in.fO3
+            << "," << FvCB_in.fls
+            << "," << FvCB_res.canopy_net_photos
+            << "," << FvCB_res.canopy_resp
+            << "," << FvCB_res.canopy_gross_photos
+            << "," << FvCB_res.jmax_c;
+          //<< "," << ges.isoprene_emission
+          //<< "," << ges.monoterpene_emission;
 #endif
+          double sun_LAI = FvCB_res.sunlit.LAI;
+          double sh_LAI = FvCB_res.shaded.LAI;
+          // JJV
+          for (const auto &lf: {FvCB_res.sunlit, FvCB_res.shaded}) {
+            species.lai = lf.LAI;
+            species.mFol = get_OrganGreenBiomass(OId::LEAF) / (100. * 100.) * lf.LAI /
+                           (sun_LAI + sh_LAI);                // kg/ha -> kg/m2
+            species.sla =
+                species.mFol > 0 ? species.lai / species.mFol : pc_SpecificLeafArea[vc_DevelopmentalStage] * 100. *
+                                                                100.; // ha/kg -> m2/kg
+
+            mcd.rad = lf.rad; // lf.rad; //W m-2 global incident
+
+            // auto ges = Voc::calculateGuentherVOCEmissions(species, mcd, 1. / 24.);
+            // cout << "G: C: " << ges.monoterpene_emission << " em: " << ges.isoprene_emission << endl;
+            //_guentherEmissions += ges;
+            // debug() << "guenther: isoprene: " << gems.isoprene_emission << " monoterpene: " << gems.monoterpene_emission << endl;
+
+            setCropPhotosynthesisResults(lf);
+
+            auto jjves = Voc::calculateJJVVOCEmissions(species, mcd, _cropPhotosynthesisResults, 1. / 24., false);
+            // cout << "J: C: " << jjves.monoterpene_emission << " em: " << jjves.isoprene_emission << endl;
+            _jjvEmissions += jjves;
+            // debug() << "jjv: isoprene: " << jjvems.isoprene_emission << " monoterpene: " << jjvems.monoterpene_emission << endl;
+
+#ifdef TEST_HOURLY_OUTPUT
+            tout()
+              << "," << species.lai
+              << "," << species.mFol
+              << "," << species.sla
+              << "," << lf.gs
+              << "," << lf.kc
+              << "," << lf.ko
+              << "," << lf.oi
+              << "," << lf.ci
+              << "," << lf.comp
+              << "," << lf.vcMax
+              << "," << lf.jMax
+              << "," << lf.rad
+              << "," << lf.jj
+              << "," << lf.jj1000
+              << "," << lf.jv
+              << "," << ges.isoprene_emission
+              << "," << ges.monoterpene_emission
+              << "," << jjves.isoprene_emission
+              << "," << jjves.monoterpene_emission;
+#endif
+          }
         }
 #ifdef TEST_HOURLY_OUTPUT
         tout() << endl;
@@ -2311,7 +2331,7 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
     }
 #pragma endregion hourly FvCB code
 
-    vc_GrossCO2Assimilation = cropPs.__enable_hourly_FvCB_photosynthesis__ && pc_CarboxylationPathway == 1
+    vc_GrossCO2Assimilation = cropPs->__enable_hourly_FvCB_photosynthesis__ && pc_CarboxylationPathway == 1
                               ? dailyGP
                               : vc_GrossCO2Assimilation;
 
@@ -2333,9 +2353,9 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
     debug() << "assimilation calculations for only one crop: grossCO2Assim: " << vc_GrossCO2Assimilation
             << " ref: " << vc_GrossCO2AssimilationReference << endl;
   } else {
-    double k_t = cropPs.pc_intercropping_k_t;
-    double k_s = cropPs.pc_intercropping_k_s;
-    double phRedux = cropPs.pc_intercropping_phRedux;
+    double k_t = cropPs->pc_intercropping_k_t;
+    double k_s = cropPs->pc_intercropping_k_s;
+    double phRedux = cropPs->pc_intercropping_phRedux;
     double ph_s = min(_intercroppingOtherCropHeight, vc_CropHeight);
     double ph_t = max(_intercroppingOtherCropHeight, vc_CropHeight);
     double phr = vc_CropHeight <= zeroHeightEps ? 0.0 : ph_s * phRedux / ph_t;
@@ -2356,12 +2376,12 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 
       // send out LAI_s and wait for LAI_t2 from the larger plant
       double LAI_t2 = phr * _intercroppingOtherLAIt;
-      if (_intercropping.isAsync()) {
-        auto wreq = _intercropping.writer.writeRequest();
+      if (_intercropping->isAsync()) {
+        auto wreq = _intercropping->writer.writeRequest();
         auto wval = wreq.initValue();
         wval.setLait(vc_LeafAreaIndex);
-        auto prom = wreq.send();//.wait(_intercropping.ioContext->waitScope); //.eagerlyEvaluate(nullptr);//[](kj::Exception&& ex){ cout << "crop-module: CropModule::fc_CropPhotosynthesis: write LAI failed: " << ex.getDescription().cStr() << endl;});
-        auto val = _intercropping.reader.readRequest().send().wait(_intercropping.ioContext->waitScope).getValue();
+        auto prom = wreq.send();//.wait(_intercropping->ioContext->waitScope); //.eagerlyEvaluate(nullptr);//[](kj::Exception&& ex){ cout << "crop-module: CropModule::fc_CropPhotosynthesis: write LAI failed: " << ex.getDescription().cStr() << endl;});
+        auto val = _intercropping->reader.readRequest().send().wait(_intercropping->ioContext->waitScope).getValue();
         LAI_t2 = val.isLait() ? val.getLait()
                               : -9999; // throw kj::Exception(kj::Exception::Type::FAILED, "crop-module.cpp", 2718);
         debug() << "sent LAI_s: " << vc_LeafAreaIndex << " received LAI_t2: " << LAI_t2 << endl;
@@ -2386,12 +2406,12 @@ void CropModule::fc_CropPhotosynthesis(double vw_MeanAirTemperature,
 
       // send out LAI_t2 and wait for LAI_s from the smaller plant
       double LAI_s = _intercroppingOtherLAIt;
-      if (_intercropping.isAsync()) {
-        auto wreq = _intercropping.writer.writeRequest();
+      if (_intercropping->isAsync()) {
+        auto wreq = _intercropping->writer.writeRequest();
         auto wval = wreq.initValue();
         wval.setLait(LAI_t2);
-        auto prom = wreq.send();//.wait(_intercropping.ioContext->waitScope); //.eagerlyEvaluate(nullptr);//[](kj::Exception&& ex){ cout << "crop-module: CropModule::fc_CropPhotosynthesis: write LAI failed: " << ex.getDescription().cStr() << endl;});
-        auto val = _intercropping.reader.readRequest().send().wait(_intercropping.ioContext->waitScope).getValue();
+        auto prom = wreq.send();//.wait(_intercropping->ioContext->waitScope); //.eagerlyEvaluate(nullptr);//[](kj::Exception&& ex){ cout << "crop-module: CropModule::fc_CropPhotosynthesis: write LAI failed: " << ex.getDescription().cStr() << endl;});
+        auto val = _intercropping->reader.readRequest().send().wait(_intercropping->ioContext->waitScope).getValue();
         LAI_s = val.isLait() ? val.getLait()
                              : -9999; // throw kj::Exception(kj::Exception::Type::FAILED, "crop-module.cpp", 2724);
         debug() << "sent LAI_t2: " << LAI_t2 << " received LAI_s: " << LAI_s << endl;
@@ -2621,7 +2641,7 @@ void CropModule::fc_FrostKill(double vw_MaxAirTemperature, double vw_MinAirTempe
   auto snowDepthAndTempUnderSnow = _getSnowDepthAndCalcTempUnderSnow(vc_CrownTemperature);
   if (vc_DevelopmentalStage <= 1) {
     vc_CrownTemperature =
-        (3.0 * soilColumn.vt_SoilSurfaceTemperature + 2.0 * soilColumn[0].get_Vs_SoilTemperature()) / 5.0;
+        (3.0 * soilColumn->vt_SoilSurfaceTemperature + 2.0 * (*soilColumn)[0].get_Vs_SoilTemperature()) / 5.0;
   } else if (snowDepthAndTempUnderSnow.first > 0.0) {
     vc_CrownTemperature = snowDepthAndTempUnderSnow.second;
   }
@@ -2652,7 +2672,7 @@ void CropModule::fc_FrostKill(double vw_MaxAirTemperature, double vw_MinAirTempe
   // }
 
   double vc_SnowDepthFactor = 1.0;
-  if (soilColumn.vm_SnowDepth <= 125.0) vc_SnowDepthFactor = soilColumn.vm_SnowDepth / 125.0;
+  if (soilColumn->vm_SnowDepth <= 125.0) vc_SnowDepthFactor = soilColumn->vm_SnowDepth / 125.0;
 
   double vc_RespirationFactor = (exp(0.84 + 0.051 * vc_CrownTemperature) - 2.0) / 1.85;
   double vc_RespiratoryStress = pc_RespiratoryStress * vc_RespirationFactor * vc_SnowDepthFactor;
@@ -2758,9 +2778,9 @@ void CropModule::fc_CropNitrogen() {
  * @author Claas Nendel
  */
 void CropModule::fc_CropDryMatter(double vw_MeanAirTemperature) {
-  assert(soilColumn.vs_NumberOfLayers() >= 0);
-  auto nols = soilColumn.vs_NumberOfLayers();
-  double layerThickness = soilColumn.vs_LayerThickness();
+  assert(soilColumn->vs_NumberOfLayers() >= 0);
+  auto nols = soilColumn->vs_NumberOfLayers();
+  double layerThickness = soilColumn->vs_LayerThickness();
 
   double vc_MaxRootNConcentration = 0.0; // old WGM
   double vc_NConcentrationOptimum = 0.0; // old DTOPTN
@@ -2774,7 +2794,7 @@ void CropModule::fc_CropDryMatter(double vw_MeanAirTemperature) {
   //   std::vector<double> vc_CapillaryWater(nols, 0.0);
   // std::vector<double> vc_RootSurface(nols, 0.0); // old FL
 
-  const CropModuleParameters &user_crops = cropPs;
+  const CropModuleParameters &user_crops = *cropPs;
   double pc_MaxCropNDemand = user_crops.pc_MaxCropNDemand;
 
   // double pc_GrowthRespirationRedux = user_crops->getPc_GrowthRespirationRedux();
@@ -3048,11 +3068,11 @@ void CropModule::fc_CropDryMatter(double vw_MeanAirTemperature) {
   // Determining root penetration rate according to soil clay content [m °C-1 d-1]
   double vc_RootPenetrationRate = 0.0; // [m °C-1 d-1]
   auto layerIndexBelowRootingDepth = std::min(vc_RootingDepth, nols - 1);
-  if (soilColumn[layerIndexBelowRootingDepth].vs_SoilClayContent() <= 0.02) {
+  if ((*soilColumn)[layerIndexBelowRootingDepth].vs_SoilClayContent() <= 0.02) {
     vc_RootPenetrationRate = 0.5 * pc_RootPenetrationRate;
-  } else if (soilColumn[layerIndexBelowRootingDepth].vs_SoilClayContent() <= 0.08) {
+  } else if ((*soilColumn)[layerIndexBelowRootingDepth].vs_SoilClayContent() <= 0.08) {
     vc_RootPenetrationRate =
-        ((1.0 / 3.0) + (0.5 / 0.06 * soilColumn[layerIndexBelowRootingDepth].vs_SoilClayContent())) *
+        ((1.0 / 3.0) + (0.5 / 0.06 * (*soilColumn)[layerIndexBelowRootingDepth].vs_SoilClayContent())) *
         pc_RootPenetrationRate; // [m °C-1 d-1]
   } else {
     vc_RootPenetrationRate = pc_RootPenetrationRate; // [m °C-1 d-1]
@@ -3080,12 +3100,10 @@ void CropModule::fc_CropDryMatter(double vw_MeanAirTemperature) {
   vc_TotalRootLength = vc_RootBiomass * pc_SpecificRootLength; //[m m-2]
 
   // Calculating a root density distribution factor []
-  std::vector<double> vc_RootDensityFactor;
-  double vc_RootDensityFactorSum = 0.0;
-  tie(vc_RootDensityFactor, vc_RootDensityFactorSum) = calcRootDensityFactorAndSum();
+  updateRootDensityFactors();
 
   // calculate the distribution of dead root biomass (for later addition into AOM pools (in soil-organic))
-  if (!cropPs.__disable_daily_root_biomass_to_soil__) {
+  if (!cropPs->__disable_daily_root_biomass_to_soil__) {
     fc_MoveDeadRootBiomassToSoil(dailyDeadBiomassIncrement[0], vc_RootDensityFactorSum, vc_RootDensityFactor);
   }
 
@@ -3196,12 +3214,12 @@ void CropModule::fc_CropDryMatter(double vw_MeanAirTemperature) {
   }
 }
 
-pair<vector<double>, double> CropModule::calcRootDensityFactorAndSum() {
-  auto nols = soilColumn.vs_NumberOfLayers();
-  double layerThickness = soilColumn.vs_LayerThickness();
+void CropModule::updateRootDensityFactors() {
+  auto nols = soilColumn->vs_NumberOfLayers();
+  double layerThickness = soilColumn->vs_LayerThickness();
 
   // Calculating a root density distribution factor []
-  std::vector<double> vc_RootDensityFactor(nols, 0.0);
+  vc_RootDensityFactor.resize(nols);
   for (size_t i_Layer = 0; i_Layer < nols; i_Layer++) {
     if (i_Layer < vc_RootingDepth) {
       vc_RootDensityFactor[i_Layer] = exp(-pc_RootFormFactor * (i_Layer * layerThickness)); // []
@@ -3214,11 +3232,9 @@ pair<vector<double>, double> CropModule::calcRootDensityFactorAndSum() {
   }
 
   // Summing up all factors to scale to a relative factor between [0;1]
-  double vc_RootDensityFactorSum = 0.0;
+  vc_RootDensityFactorSum = 0.0;
   for (size_t i_Layer = 0; i_Layer < vc_RootingZone; i_Layer++)
     vc_RootDensityFactorSum += vc_RootDensityFactor[i_Layer]; // []
-
-  return make_pair(vc_RootDensityFactor, vc_RootDensityFactorSum);
 }
 
 /**
@@ -3262,7 +3278,7 @@ double CropModule::fc_ReferenceEvapotranspiration(double vw_MaxAirTemperature,
   double vc_ReferenceEvapotranspiration;  //[mm]
   double vw_NetRadiation;          //[MJ m-2]
 
-  const CropModuleParameters &user_crops = cropPs;
+  const CropModuleParameters &user_crops = *cropPs;
   double pc_SaturationBeta = user_crops.pc_SaturationBeta;           // Original: Yu et al. 2001; beta = 3.5
   double pc_StomataConductanceAlpha = user_crops.pc_StomataConductanceAlpha; // Original: Yu et al. 2001; alpha = 0.06
   double pc_ReferenceAlbedo = user_crops.pc_ReferenceAlbedo;           // FAO Green gras reference albedo from Allen et al. (1998)
@@ -3375,8 +3391,8 @@ void CropModule::fc_CropWaterUptake(size_t vc_GroundwaterTable,
                                     double vw_GrossPrecipitation,
                                     double /*vc_CurrentTotalTemperatureSum*/,
                                     double /*vc_TotalTemperatureSum*/) {
-  size_t nols = soilColumn.vs_NumberOfLayers();
-  double layerThickness = soilColumn.vs_LayerThickness();
+  size_t nols = soilColumn->vs_NumberOfLayers();
+  double layerThickness = soilColumn->vs_LayerThickness();
   double vc_PotentialTranspirationDeficit = 0.0;  // [mm]
   vc_PotentialTranspiration = 0.0;        // old TRAMAX [mm]
   double vc_PotentialEvapotranspiration = 0.0;  // [mm]
@@ -3460,9 +3476,9 @@ void CropModule::fc_CropWaterUptake(size_t vc_GroundwaterTable,
 
     for (size_t i_Layer = 0; i_Layer < vc_RootingZone; i_Layer++) {
       double vc_AvailableWater =
-          soilColumn[i_Layer].vs_FieldCapacity() - soilColumn[i_Layer].vs_PermanentWiltingPoint();
+          (*soilColumn)[i_Layer].vs_FieldCapacity() - (*soilColumn)[i_Layer].vs_PermanentWiltingPoint();
       double vc_AvailableWaterPercentage =
-          (soilColumn[i_Layer].get_Vs_SoilMoisture_m3() - soilColumn[i_Layer].vs_PermanentWiltingPoint()) /
+          ((*soilColumn)[i_Layer].get_Vs_SoilMoisture_m3() - (*soilColumn)[i_Layer].vs_PermanentWiltingPoint()) /
           vc_AvailableWater;
       if (vc_AvailableWaterPercentage < 0.0) {
         vc_AvailableWaterPercentage = 0.0;
@@ -3533,10 +3549,10 @@ void CropModule::fc_CropWaterUptake(size_t vc_GroundwaterTable,
         vc_RemainingTotalRootEffectivity = 0.00001;
       }
       if (((vc_Transpiration[i_Layer] / 1000.0) / layerThickness) >
-          ((soilColumn[i_Layer].get_Vs_SoilMoisture_m3() - soilColumn[i_Layer].vs_PermanentWiltingPoint()))) {
+          (((*soilColumn)[i_Layer].get_Vs_SoilMoisture_m3() - (*soilColumn)[i_Layer].vs_PermanentWiltingPoint()))) {
         vc_PotentialTranspirationDeficit = (((vc_Transpiration[i_Layer] / 1000.0) / layerThickness) -
-                                            (soilColumn[i_Layer].get_Vs_SoilMoisture_m3() -
-                                             soilColumn[i_Layer].vs_PermanentWiltingPoint())) * layerThickness *
+                                            ((*soilColumn)[i_Layer].get_Vs_SoilMoisture_m3() -
+                                             (*soilColumn)[i_Layer].vs_PermanentWiltingPoint())) * layerThickness *
                                            1000.0; // [mm]
         if (vc_PotentialTranspirationDeficit < 0.0) {
           vc_PotentialTranspirationDeficit = 0.0;
@@ -3590,8 +3606,8 @@ void CropModule::fc_CropWaterUptake(size_t vc_GroundwaterTable,
 void CropModule::fc_CropNUptake(size_t vc_GroundwaterTable,
                                 double /*vc_CurrentTotalTemperatureSum*/,
                                 double /*vc_TotalTemperatureSum*/) {
-  auto nols = soilColumn.vs_NumberOfLayers();
-  double layerThickness = soilColumn.vs_LayerThickness();
+  auto nols = soilColumn->vs_NumberOfLayers();
+  double layerThickness = soilColumn->vs_LayerThickness();
 
   double vc_ConvectiveNUptake = 0.0;                // old TRNSUM
   double vc_DiffusiveNUptake = 0.0;                // old SUMDIFF
@@ -3601,9 +3617,9 @@ void CropModule::fc_CropNUptake(size_t vc_GroundwaterTable,
   std::vector<double> vc_DiffusiveNUptakeFromLayer(nols, 0.0);         // old DIFF
   double vc_ConvectiveNUptake_1 = 0.0;                     // old MASSUM
   double vc_DiffusiveNUptake_1 = 0.0;                       // old DIFFSUM
-  double pc_MinimumAvailableN = cropPs.pc_MinimumAvailableN;           // kg m-3
-  double pc_MinimumNConcentrationRoot = cropPs.pc_MinimumNConcentrationRoot; // kg kg-1
-  double pc_MaxCropNDemand = cropPs.pc_MaxCropNDemand;
+  double pc_MinimumAvailableN = cropPs->pc_MinimumAvailableN;           // kg m-3
+  double pc_MinimumNConcentrationRoot = cropPs->pc_MinimumNConcentrationRoot; // kg kg-1
+  double pc_MaxCropNDemand = cropPs->pc_MaxCropNDemand;
 
   vc_TotalNUptake = 0.0;
   vc_TotalNInput = 0.0;
@@ -3616,26 +3632,26 @@ void CropModule::fc_CropNUptake(size_t vc_GroundwaterTable,
 
     for (int i_Layer = 0; i_Layer < (min(vc_RootingZone, vc_GroundwaterTable)); i_Layer++) {
 
-      vs_SoilMineralNContent[i_Layer] = soilColumn[i_Layer].vs_SoilNO3; // [kg m-3]
+      vs_SoilMineralNContent[i_Layer] = (*soilColumn)[i_Layer].vs_SoilNO3; // [kg m-3]
 
       // Convective N uptake per layer
       vc_ConvectiveNUptakeFromLayer[i_Layer] = (vc_Transpiration[i_Layer] / 1000.0) *        //[mm --> m]
                                                (vs_SoilMineralNContent[i_Layer] /          // [kg m-3]
-                                                (soilColumn[i_Layer].get_Vs_SoilMoisture_m3())) * // old WG [m3 m-3]
+                                                ((*soilColumn)[i_Layer].get_Vs_SoilMoisture_m3())) * // old WG [m3 m-3]
                                                vc_TimeStep;                    // -->[kg m-2]
 
       vc_ConvectiveNUptake += vc_ConvectiveNUptakeFromLayer[i_Layer]; // [kg m-2]
 
       /** @todo Claas: Woher kommt der Wert für vs_Tortuosity? */
       /** @todo Claas: Prüfen ob Umstellung auf [m] die folgenden Gleichungen beeinflusst */
-      vc_DiffusionCoeff[i_Layer] = 0.000214 * (vs_Tortuosity * exp(soilColumn[i_Layer].get_Vs_SoilMoisture_m3() * 10)) /
-                                   soilColumn[i_Layer].get_Vs_SoilMoisture_m3(); //[m2 d-1]
+      vc_DiffusionCoeff[i_Layer] = 0.000214 * (vs_Tortuosity * exp((*soilColumn)[i_Layer].get_Vs_SoilMoisture_m3() * 10)) /
+                                   (*soilColumn)[i_Layer].get_Vs_SoilMoisture_m3(); //[m2 d-1]
 
       vc_DiffusiveNUptakeFromLayer[i_Layer] = (vc_DiffusionCoeff[i_Layer] *          // [m2 d-1]
-                                               soilColumn[i_Layer].get_Vs_SoilMoisture_m3() * // [m3 m-3]
+                                               (*soilColumn)[i_Layer].get_Vs_SoilMoisture_m3() * // [m3 m-3]
                                                2.0 * PI * vc_RootDiameter[i_Layer] *      // [m]
                                                (vs_SoilMineralNContent[i_Layer] / 1000.0 /  // [kg m-3]
-                                                soilColumn[i_Layer].get_Vs_SoilMoisture_m3() -
+                                                (*soilColumn)[i_Layer].get_Vs_SoilMoisture_m3() -
                                                 0.000014) *               // [m3 m-3]
                                                sqrt(PI * vc_RootDensity[i_Layer])) * // [m m-3]
                                               vc_RootDensity[i_Layer] *
@@ -4220,7 +4236,7 @@ typedef vector<monica::YieldComponent> VYC;
  * @param v Vector yield component
  * @param bmv
  */
-double calculateCropYield(const VYC &ycs, const vector<double> &bmv) {
+double calculateCropYield(const VYC &ycs, const std::pmr::vector<double> &bmv) {
   double yield = 0;
   for (const auto &yc: ycs)
     yield += bmv.at(yc.organId - 1) * (yc.yieldPercentage);
@@ -4233,7 +4249,7 @@ double calculateCropYield(const VYC &ycs, const vector<double> &bmv) {
  * @param v Vector yield component
  * @param bmv
  */
-double calculateCropFreshMatterYield(const VYC &ycs, const vector<double> &bmv) {
+double calculateCropFreshMatterYield(const VYC &ycs, const std::pmr::vector<double> &bmv) {
   double freshMatterYield = 0;
   for (auto yc: ycs)
     freshMatterYield += bmv.at(yc.organId - 1) * yc.yieldPercentage / yc.yieldDryMatter;
@@ -4545,7 +4561,7 @@ void CropModule::applyCutting(std::map<int, Cutting::Value> &organs,
     debug() << "adding organic matter from cut residues to soilOrganic" << endl;
     debug() << "Residue biomass: " << sumResidueBiomass
             << " Residue N concentration: " << residueNConcentration << endl;
-    _addOrganicMatter({{0, sumResidueBiomass}}, residueNConcentration);
+    _addOrganicMatter(kj::arrayPtr(&sumResidueBiomass, 1), residueNConcentration); // into top layer
   }
 
   // update LAI
@@ -4577,7 +4593,7 @@ void CropModule::applyCutting(std::map<int, Cutting::Value> &organs,
  * [m]
  */
 double CropModule::getEffectiveRootingDepth() const {
-  size_t nols = soilColumn.vs_NumberOfLayers();
+  size_t nols = soilColumn->vs_NumberOfLayers();
 
   for (size_t i_Layer = 0; i_Layer < nols; i_Layer++)
     if (vc_RootEffectivity[i_Layer] == 0.0) {
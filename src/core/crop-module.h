@@ -21,6 +21,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <stdlib.h>
 #include <math.h>
 #include <map>
+#include <memory>
+#include <memory_resource>
 #include <string>
 #include <ostream>
 #include <iostream>
@@ -36,6 +38,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "monica-parameters.h"
 #include "soilcolumn.h"
 #include "voc-common.h"
+#include "solar-geometry.h"
 #include "run/cultivation-method.h"
 
 namespace monica {
@@ -62,19 +65,29 @@ public:
              const SiteParameters &siteParams,
              const CropModuleParameters &cropPs,
              const SimulationParameters &simPs,
-             std::function<void(std::string)> fireEvent,
-             std::function<void(std::map<size_t, double>, double)> addOrganicMatter,
+             std::function<void(const std::string&)> fireEvent,
+             std::function<void(kj::ArrayPtr<const double>, double)> addOrganicMatter,
              std::function<std::pair<double, double>(double)> getSnowDepthAndCalcTempUnderSnow,
              Intercropping &ic);
 
   CropModule(SoilColumn &sc,
              const CropModuleParameters &cropPs,
-             std::function<void(std::string)> fireEvent,
-             std::function<void(std::map<size_t, double>, double)> addOrganicMatter,
+             std::function<void(const std::string&)> fireEvent,
+             std::function<void(kj::ArrayPtr<const double>, double)> addOrganicMatter,
              std::function<std::pair<double, double>(double)> getSnowDepthAndCalcTempUnderSnow,
              mas::schema::model::monica::CropModuleState::Reader reader,
              Intercropping &ic);
 
+  //! member-wise copy of other, bound to the soil column (whose memory resource the state vectors draw from),
+  //! parameters, callbacks and intercropping of a copied model
+  CropModule(const CropModule &other,
+             SoilColumn &sc,
+             const CropModuleParameters &cropPs,
+             std::function<void(const std::string&)> fireEvent,
+             std::function<void(kj::ArrayPtr<const double>, double)> addOrganicMatter,
+             std::function<std::pair<double, double>(double)> getSnowDepthAndCalcTempUnderSnow,
+             Intercropping &ic);
+
   void deserialize(mas::schema::model::monica::CropModuleState::Reader reader);
 
   void serialize(mas::schema::model::monica::CropModuleState::Builder builder) const;
@@ -140,7 +153,7 @@ public:
 
   void fc_MoveDeadRootBiomassToSoil(double deadRootBiomass,
                                     double vc_RootDensityFactorSum,
-                                    const std::vector<double> &vc_RootDensityFactor);
+                                    const std::pmr::vector<double> &vc_RootDensityFactor);
 
   void addAndDistributeRootBiomassInSoil(double rootBiomass);
 
@@ -190,6 +203,9 @@ public:
 
   Voc::Emissions jjvEmissions() const { return _jjvEmissions; }
 
+  //! VOC emissions are purely diagnostic, so they can be switched off if nobody requested them
+  void setCalculateVOCEmissions(bool calc) { _calculateVOCEmissions = calc; }
+
   double get_ReferenceEvapotranspiration() const;
 
   double get_RemainingEvapotranspiration() const;
@@ -385,11 +401,11 @@ public:
    */
   inline bool isDying() const { return this->dyingOut; }
 
-  void setPerennialCropParameters(const CropParameters &cps) { perennialCropParams = kj::heap<CropParameters>(cps); }
+  void setPerennialCropParameters(const CropParameters &cps) { perennialCropParams = std::make_shared<const CropParameters>(cps); }
 
   void fc_UpdateCropParametersForPerennial();
 
-  std::pair<const std::vector<double> &, const std::vector<double> &> sunlitAndShadedLAI() const {
+  std::pair<const std::pmr::vector<double> &, const std::pmr::vector<double> &> sunlitAndShadedLAI() const {
     return make_pair(vc_sunlitLeafAreaIndex, vc_shadedLeafAreaIndex);
   }
 
@@ -409,7 +425,15 @@ public:
 
   double rootNConcentration() const { return vc_NConcentrationRoot; }
 
-  std::pair<std::vector<double>, double> calcRootDensityFactorAndSum();
+  //! recalculate the per layer root density distribution factors and their sum into the persistent buffers
+  void updateRootDensityFactors();
+
+  //! the root density distribution factors of the last root growth step []
+  const std::pmr::vector<double>& rootDensityFactors() const { return vc_RootDensityFactor; }
+
+  const std::pmr::vector<double>& transpirations() const { return vc_Transpiration; }
+
+  double rootDensityFactorSum() const { return vc_RootDensityFactorSum; }
 
   void setStage(size_t newStage);
 
@@ -452,7 +476,7 @@ public:
   double rootNRedux{0.0}; //! old REDWU
   int vc_TimeUnderAnoxia{0};
 private:
-  Intercropping &_intercropping;
+  Intercropping *_intercropping;
 
   bool _frostKillOn{true};
 
@@ -463,9 +487,10 @@ private:
   bool isMaturityDay(size_t old_dev_stage, size_t new_dev_stage);
 
   // members
-  SoilColumn &soilColumn;
-  kj::Own<CropParameters> perennialCropParams;
-  const CropModuleParameters &cropPs;
+  //! the per layer and per organ state vectors and the VOC ring buffers below use the memory resource of the soil column
+  SoilColumn *soilColumn;
+  std::shared_ptr<const CropParameters> perennialCropParams;
+  const CropModuleParameters *cropPs;
   SpeciesParameters speciesPs;
   CultivarParameters cultivarPs;
   CropResidueParameters residuePs;
@@ -475,11 +500,13 @@ private:
   //! old N
   //  static const double vw_AtmosphericCO2Concentration;
   double vs_Latitude{};
+  //! day length and radiation terms for vs_Latitude, shared by all crops at the same latitude
+  std::shared_ptr<const SolarGeometryTable> _solarGeometry;
   double vc_AbovegroundBiomass{0.0};//! old OBMAS
   double vc_AbovegroundBiomassOld{0.0}; //! old OBALT
   std::vector<bool> pc_AbovegroundOrgan;  //! old KOMP
   double vc_ActualTranspiration{0.0};
-  std::vector<std::vector<double>> pc_AssimilatePartitioningCoeff; //! old PRO
+  StageOrganMatrix pc_AssimilatePartitioningCoeff; //! old PRO
   double pc_AssimilateReallocation{};
   double vc_Assimilates{0.0};
   double vc_AssimilationRate{0.0}; //! old AMAX
@@ -505,8 +532,8 @@ private:
   double vc_CropNDemand{0.0}; //! old DTGESN
   double vc_CropNRedux{1.0};              //! old REDUK
   double pc_CropSpecificMaxRootingDepth{};      //! old WUMAXPF [m]
-  std::vector<double> vc_CropWaterUptake; //! old TP
-  std::vector<double> vc_CurrentTemperatureSum;  //! old SUM
+  std::pmr::vector<double> vc_CropWaterUptake; //! old TP
+  std::pmr::vector<double> vc_CurrentTemperatureSum;  //! old SUM
   double vc_CurrentTotalTemperatureSum{0.0};      //! old FP
   double vc_CurrentTotalTemperatureSumRoot{0.0};
   int pc_CuttingDelayDays{0};
@@ -554,8 +581,8 @@ private:
   double vc_InterceptionStorage{0.0};
   double vc_KcFactor{0.6};      //! old FKc
   double vc_LeafAreaIndex{0.0};  //! old LAI
-  std::vector<double> vc_sunlitLeafAreaIndex;
-  std::vector<double> vc_shadedLeafAreaIndex;
+  std::pmr::vector<double> vc_sunlitLeafAreaIndex;
+  std::pmr::vector<double> vc_shadedLeafAreaIndex;
   double pc_LowTemperatureExposure{};
   double pc_LimitingTemperatureHeatStress{};
   double vc_LT50{-3.0};
@@ -590,19 +617,19 @@ private:
   bool pc_NitrogenResponseOn{};
   size_t pc_NumberOfDevelopmentalStages{0};
   size_t pc_NumberOfOrgans{0};              //! old NRKOM
-  std::vector<double> vc_NUptakeFromLayer; //! old PE
+  std::pmr::vector<double> vc_NUptakeFromLayer; //! old PE
   std::vector<double> pc_OptimumTemperature;
-  std::vector<double> vc_OrganBiomass;  //! old WORG
-  std::vector<double> vc_OrganDeadBiomass;  //! old WDORG
-  std::vector<double> vc_OrganGreenBiomass;
-  std::vector<double> vc_OrganGrowthIncrement;      //! old GORG
+  std::pmr::vector<double> vc_OrganBiomass;  //! old WORG
+  std::pmr::vector<double> vc_OrganDeadBiomass;  //! old WDORG
+  std::pmr::vector<double> vc_OrganGreenBiomass;
+  std::pmr::vector<double> vc_OrganGrowthIncrement;      //! old GORG
   std::vector<double> pc_OrganGrowthRespiration;  //! old MAIRT
   std::vector<YieldComponent> pc_OrganIdsForPrimaryYield;
   std::vector<YieldComponent> pc_OrganIdsForSecondaryYield;
   std::vector<YieldComponent> pc_OrganIdsForCutting;
   std::vector<double> pc_OrganMaintenanceRespiration;  //! old MAIRT
-  std::vector<double> vc_OrganSenescenceIncrement; //! old DGORG
-  std::vector<std::vector<double>> pc_OrganSenescenceRate;  //! old DEAD
+  std::pmr::vector<double> vc_OrganSenescenceIncrement; //! old DGORG
+  StageOrganMatrix pc_OrganSenescenceRate;  //! old DEAD
   double vc_OvercastDayRadiation{0.0};          //! old DRO
   double vc_OxygenDeficit{0.0};          //! old LURED
   double pc_PartBiologicalNFixation{};
@@ -619,10 +646,13 @@ private:
   double pc_RespiratoryStress{};
   double vc_RootBiomass{0.0};              //! old WUMAS
   double vc_RootBiomassOld{0.0};            //! old WUMALT
-  std::vector<double> vc_RootDensity;        //! old WUDICH
-  std::vector<double> vc_RootDiameter;        //! old WRAD
+  std::pmr::vector<double> vc_RootDensity;        //! old WUDICH
+  std::pmr::vector<double> vc_RootDensityFactor; //! per layer root density distribution factor []
+  double vc_RootDensityFactorSum{0.0};
+  std::pmr::vector<double> _deadRootBiomassPerLayer; //! buffer for the daily dead root biomass handed to soil organic
+  std::pmr::vector<double> vc_RootDiameter;        //! old WRAD
   double pc_RootDistributionParam{};
-  std::vector<double> vc_RootEffectivity; //! old WUEFF
+  std::pmr::vector<double> vc_RootEffectivity; //! old WUEFF
   double pc_RootFormFactor{};
   double pc_RootGrowthLag{};
   size_t vc_RootingDepth{0};                      //! old WURZ
@@ -631,7 +661,7 @@ private:
   double pc_RootPenetrationRate{};
   double vm_SaturationDeficit{0.0};
   double vc_SoilCoverage{0.0};
-  std::vector<double> vs_SoilMineralNContent;    //! old C1
+  std::pmr::vector<double> vs_SoilMineralNContent;    //! old C1
   double vc_SoilSpecificMaxRootingDepth{0.0};        //! old WURZMAX [m]
   double vs_SoilSpecificMaxRootingDepth{0.0};
   std::vector<double> pc_SpecificLeafArea;    //! old LAIFKT [ha kg-1]
@@ -661,8 +691,8 @@ private:
   double vc_TotalRootLength{0.0};            //! old WULAEN
   double vc_TotalTemperatureSum{0.0};
   double vc_TemperatureSumToFlowering{0.0};
-  std::vector<double> vc_Transpiration;      //! old TP
-  std::vector<double> vc_TranspirationRedux;   //! old TRRED
+  std::pmr::vector<double> vc_Transpiration;      //! old TP
+  std::pmr::vector<double> vc_TranspirationRedux;   //! old TRRED
   double vc_TranspirationDeficit{1.0};          //! old TRREL
   double vc_VernalisationDays{0.0}; //
   double vc_VernalisationFactor{0.0};          //! old FV
@@ -688,7 +718,9 @@ private:
 
   //VOC members
   int _stepSize24{24}, _stepSize240{240};
-  std::vector<double> _rad24, _rad240, _tfol24, _tfol240;
+  std::pmr::vector<double> _rad24, _rad240, _tfol24, _tfol240;
+  //! running sums of the ring buffers above, so their means are updated in O(1)
+  double _rad24Sum{0.0}, _rad240Sum{0.0}, _tfol24Sum{0.0}, _tfol240Sum{0.0};
   int _index24{0}, _index240{0};
   bool _full24{false}, _full240{false};
 
@@ -696,9 +728,10 @@ private:
   Voc::Emissions _jjvEmissions;
   Voc::SpeciesData _vocSpecies;
   Voc::CPData _cropPhotosynthesisResults;
+  bool _calculateVOCEmissions{true};
 
-  std::function<void(std::string)> _fireEvent;
-  std::function<void(std::map<size_t, double>, double)> _addOrganicMatter;
+  std::function<void(const std::string&)> _fireEvent;
+  std::function<void(kj::ArrayPtr<const double>, double)> _addOrganicMatter;
   std::function<std::pair<double, double>(double)> _getSnowDepthAndCalcTempUnderSnow;
 
   double vc_O3_shortTermDamage{1.0};
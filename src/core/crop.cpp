@@ -36,23 +36,14 @@ using namespace Tools;
 
 //----------------------------------------------------------------------------
 
-Crop::Crop(const Crop& other)
-  : _isValid(other._isValid)
-  , _speciesName(other._speciesName)
-  , _cultivarName(other._cultivarName)
-  , _seedDate(other._seedDate)
-  , _harvestDate(other._harvestDate)
-  , _isWinterCrop(other._isWinterCrop)
-  , _isPerennialCrop(other._isPerennialCrop)
-  , _cuttingDates(other._cuttingDates)
-  , _cropParams(other._cropParams)
-  , _separatePerennialCropParams(other._separatePerennialCropParams ? kj::heap<CropParameters>(other._perennialCropParams) : kj::Own<CropParameters>())
-  , _perennialCropParams(other._separatePerennialCropParams ? *_separatePerennialCropParams.get() : _cropParams)
-  , _residueParams(other._residueParams)
-  , _crossCropAdaptionFactor(other._crossCropAdaptionFactor)
-  , _automaticHarvest(other._automaticHarvest)
-  , _automaticHarvestParams(other._automaticHarvestParams)
-{}
+CropParameters& Crop::cropParameters() {
+  if (_cropParamsInterned || _cropParams.use_count() > 1) {
+    _cropParams = make_shared<CropParameters>(*_cropParams);
+    _cropParamsInterned = false;
+  }
+  // all parameter sets are created non-const, they are just shared as const
+  return const_cast<CropParameters&>(*_cropParams);
+}
 
 //Crop::Crop(const std::string& species,
 //           const string& cultivarName,
@@ -85,7 +76,6 @@ Crop::Crop(const Crop& other)
 //{}
 
 Crop::Crop(json11::Json j)
-	: _perennialCropParams(_cropParams)
 {
 	merge(j);
 }
@@ -99,12 +89,10 @@ void Crop::deserialize(mas::schema::model::monica::CropState::Reader reader) {
 	if (reader.hasIsPerennialCrop()) _isPerennialCrop.setValue(reader.getIsPerennialCrop().getValue());
 	setFromComplexCapnpList(_cuttingDates, reader.getCuttingDates());
 	if (!reader.hasCropParams()) _isValid = false;
-	else _cropParams.deserialize(reader.getCropParams());
-	if (reader.hasPerennialCropParams()) {
-		_separatePerennialCropParams = kj::heap<CropParameters>(reader.getPerennialCropParams());
-		_perennialCropParams = *_separatePerennialCropParams.get();
-	}
-	_residueParams.deserialize(reader.getResidueParams());
+	else setCropParameters(CropParameters(reader.getCropParams()));
+	if (reader.hasPerennialCropParams()) setPerennialCropParameters(CropParameters(reader.getPerennialCropParams()));
+	else _perennialCropParams = nullptr;
+	setResidueParameters(CropResidueParameters(reader.getResidueParams()));
 	_crossCropAdaptionFactor = reader.getCrossCropAdaptionFactor();
 	_automaticHarvest = reader.getAutomaticHarvest();
 	_automaticHarvestParams.deserialize(reader.getAutomaticHarvestParams());
@@ -118,9 +106,9 @@ void Crop::serialize(mas::schema::model::monica::CropState::Builder builder) con
   if (_isWinterCrop.isValue()) builder.initIsWinterCrop().setValue(_isWinterCrop.value());
   if (_isPerennialCrop.isValue()) builder.initIsPerennialCrop().setValue(_isPerennialCrop.value());
   setComplexCapnpList(_cuttingDates, builder.initCuttingDates((capnp::uint)_cuttingDates.size()));
-  if (isValid()) _cropParams.serialize(builder.initCropParams());
-	if (_separatePerennialCropParams) _separatePerennialCropParams->serialize(builder.initPerennialCropParams());
-  _residueParams.serialize(builder.initResidueParams());
+  if (isValid()) _cropParams->serialize(builder.initCropParams());
+	if (_perennialCropParams) _perennialCropParams->serialize(builder.initPerennialCropParams());
+  _residueParams->serialize(builder.initResidueParams());
 	builder.setCrossCropAdaptionFactor(_crossCropAdaptionFactor);
 	builder.setAutomaticHarvest(_automaticHarvest);
 	_automaticHarvestParams.serialize(builder.initAutomaticHarvestParams());
@@ -146,20 +134,25 @@ Errors Crop::merge(json11::Json j)
 	{
 		auto jcps = j["cropParams"];
 		if(jcps.has_shape({{"species", json11::Json::OBJECT}}, err)
-			 && jcps.has_shape({{"cultivar", json11::Json::OBJECT}}, err))
-			_cropParams.merge(j["cropParams"]);
-		else
+			 && jcps.has_shape({{"cultivar", json11::Json::OBJECT}}, err)) {
+			// like the residue parameters, the crop parameters are merged into the existing ones,
+			// the first merge into the defaults yields a shared set, identical sets are parsed once per process
+			_cropParamsInterned = _cropParams == ParameterStore<CropParameters>::defaults();
+			_cropParams = ParameterStore<CropParameters>::instance().merge(_cropParams, jcps);
+		} else
 			res.errors.push_back(string("Couldn't find 'species' or 'cultivar' key in JSON object 'cropParams':\n") + j.dump());
 
 		if(_speciesName.empty())
-			_speciesName = _cropParams.speciesParams.pc_SpeciesId;
+			_speciesName = _cropParams->speciesParams.pc_SpeciesId;
 		if(_cultivarName.empty())
-			_cultivarName = _cropParams.cultivarParams.pc_CultivarId;
+			_cultivarName = _cropParams->cultivarParams.pc_CultivarId;
 
-		if(_isPerennialCrop.isValue())
-			_cropParams.cultivarParams.pc_Perennial = _isPerennialCrop.value();
+		if(_isPerennialCrop.isValue()) {
+			if(_cropParams->cultivarParams.pc_Perennial != _isPerennialCrop.value())
+				cropParameters().cultivarParams.pc_Perennial = _isPerennialCrop.value();
+		}
 		else
-			_isPerennialCrop.setValue(_cropParams.cultivarParams.pc_Perennial);
+			_isPerennialCrop.setValue(_cropParams->cultivarParams.pc_Perennial);
 
 		_isValid = true;
 	}
@@ -176,16 +169,15 @@ Errors Crop::merge(json11::Json j)
 			auto jcps = j["perennialCropParams"];
 			if (jcps.has_shape({ {"species", json11::Json::OBJECT} }, err)
 				&& jcps.has_shape({ {"cultivar", json11::Json::OBJECT} }, err)) {
-				_separatePerennialCropParams = kj::heap<CropParameters>();
-				_separatePerennialCropParams->merge(j["cropParams"]);
-				_perennialCropParams = *_separatePerennialCropParams.get();
+				// like before, the perennial parameters are (still) read from 'cropParams'
+				_perennialCropParams = ParameterStore<CropParameters>::instance().intern(j["cropParams"]);
 			}
 		}
 	}
 
 	err = "";
 	if (j.has_shape({ {"residueParams", json11::Json::OBJECT} }, err)) {
-		_residueParams.merge(j["residueParams"]);
+		_residueParams = ParameterStore<CropResidueParameters>::instance().merge(_residueParams, j["residueParams"]);
 	} else {
 		res.errors.push_back(string("Couldn't find 'residueParams' key in JSON object:\n") + j.dump());
 		_isValid = false;
@@ -226,7 +218,7 @@ json11::Json Crop::to_json(bool includeFullCropParameters) const
   {
     if(_isValid)
       o["cropParams"] = cropParameters().to_json();
-    if(_separatePerennialCropParams)
+    if(_perennialCropParams)
       o["perennialCropParams"] = perennialCropParameters().to_json();
     if(_isValid)
       o["residueParams"] = residueParameters().to_json();
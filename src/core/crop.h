@@ -29,16 +29,18 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "tools/date.h"
 #include "json11/json11-helper.h"
 #include "monica-parameters.h"
+#include "parameter-store.h"
 
 namespace monica {
 
 class Crop : public Tools::Json11Serializable {
 public:
-  Crop() : _perennialCropParams(_cropParams) {}
+  Crop() = default;
 
-  Crop(const Crop& other);
+  //! copies share the (immutable) parameters
+  Crop(const Crop& other) = default;
 
-  explicit Crop(mas::schema::model::monica::CropState::Reader reader) : _perennialCropParams(_cropParams) { deserialize(reader); }
+  explicit Crop(mas::schema::model::monica::CropState::Reader reader) { deserialize(reader); }
   void deserialize(mas::schema::model::monica::CropState::Reader reader);
   void serialize(mas::schema::model::monica::CropState::Builder builder) const;
 
@@ -58,21 +60,31 @@ public:
 
   bool isValid() const { return _isValid; }
 
-  const CropParameters& cropParameters() const { return _cropParams; }
+  const CropParameters& cropParameters() const { return *_cropParams; }
 
-  CropParameters& cropParameters() { return _cropParams; }
+  //! the crop parameters might be shared with other crops, so they are copied before they can be changed
+  CropParameters& cropParameters();
 
-  void setCropParameters(CropParameters&& cps) { _cropParams = cps; }
+  void setCropParameters(CropParameters&& cps) {
+    _cropParams = std::make_shared<CropParameters>(std::move(cps));
+    _cropParamsInterned = false;
+  }
 
-  bool separatePerennialCropParameters() const { return _separatePerennialCropParams; }
+  bool separatePerennialCropParameters() const { return bool(_perennialCropParams); }
 
-  const CropParameters& perennialCropParameters() const { return _perennialCropParams; }
+  const CropParameters& perennialCropParameters() const {
+    return _perennialCropParams ? *_perennialCropParams : *_cropParams;
+  }
 
-  void setPerennialCropParameters(CropParameters&& cps) { _perennialCropParams = cps; }
+  void setPerennialCropParameters(CropParameters&& cps) {
+    _perennialCropParams = std::make_shared<CropParameters>(std::move(cps));
+  }
 
-  const CropResidueParameters& residueParameters() const { return _residueParams; }
+  const CropResidueParameters& residueParameters() const { return *_residueParams; }
 
-  void setResidueParameters(CropResidueParameters&& rps) { _residueParams = rps; }
+  void setResidueParameters(CropResidueParameters&& rps) {
+    _residueParams = std::make_shared<CropResidueParameters>(std::move(rps));
+  }
 
   Tools::Date seedDate() const { return _seedDate; }
 
@@ -119,10 +131,10 @@ private:
   Tools::Maybe<bool> _isWinterCrop;
   Tools::Maybe<bool> _isPerennialCrop;
   std::vector<Tools::Date> _cuttingDates;
-  CropParameters _cropParams;
-  kj::Own<CropParameters> _separatePerennialCropParams;
-  CropParameters& _perennialCropParams;
-  CropResidueParameters _residueParams;
+  std::shared_ptr<const CropParameters> _cropParams{ParameterStore<CropParameters>::defaults()};
+  bool _cropParamsInterned{false}; //!< _cropParams are owned by the ParameterStore
+  std::shared_ptr<const CropParameters> _perennialCropParams; //!< only set if different from _cropParams
+  std::shared_ptr<const CropResidueParameters> _residueParams{ParameterStore<CropResidueParameters>::defaults()};
 
   double _crossCropAdaptionFactor{1.0};
 
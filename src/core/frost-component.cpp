@@ -33,7 +33,7 @@ using namespace Tools;
 FrostComponent::FrostComponent(SoilColumn& sc,
   double pm_HydraulicConductivityRedux,
   double p_timeStep)
-  : soilColumn(sc),
+  : soilColumn(&sc),
   vm_LambdaRedux(sc.vs_NumberOfLayers() + 1, 1.0),
   vm_HydraulicConductivityRedux(pm_HydraulicConductivityRedux),
   pt_TimeStep(p_timeStep),
@@ -104,10 +104,10 @@ void FrostComponent::calcSoilFrost(double mean_air_temperature, double snow_dept
  */
 double
 FrostComponent::getMeanBulkDensity() {
-  auto vs_number_of_layers = soilColumn.vs_NumberOfLayers();
+  auto vs_number_of_layers = soilColumn->vs_NumberOfLayers();
   double bulk_density_accu = 0.0;
   for (int i_Layer = 0; i_Layer < vs_number_of_layers; i_Layer++) {
-    bulk_density_accu += soilColumn[i_Layer].vs_SoilBulkDensity();
+    bulk_density_accu += (*soilColumn)[i_Layer].vs_SoilBulkDensity();
   }
   return (bulk_density_accu / double(vs_number_of_layers) / 1000.0); // [Mg m-3]
 }
@@ -118,10 +118,10 @@ FrostComponent::getMeanBulkDensity() {
  */
 double
 FrostComponent::getMeanFieldCapacity() {
-  auto vs_number_of_layers = soilColumn.vs_NumberOfLayers();
+  auto vs_number_of_layers = soilColumn->vs_NumberOfLayers();
   double mean_field_capacity_accu = 0.0;
   for (int i_Layer = 0; i_Layer < vs_number_of_layers; i_Layer++) {
-    mean_field_capacity_accu += soilColumn[i_Layer].vs_FieldCapacity();
+    mean_field_capacity_accu += (*soilColumn)[i_Layer].vs_FieldCapacity();
   }
   return (mean_field_capacity_accu / double(vs_number_of_layers));
 }
@@ -289,14 +289,14 @@ FrostComponent::calcTemperatureUnderSnow(double mean_air_temperature, double sno
  */
 void
 FrostComponent::updateLambdaRedux() {
-  auto vs_number_of_layers = soilColumn.vs_NumberOfLayers();
+  auto vs_number_of_layers = soilColumn->vs_NumberOfLayers();
 
   for (int i_Layer = 0; i_Layer < vs_number_of_layers; i_Layer++) {
 
-    if (i_Layer < (std::floor((vm_FrostDepth / soilColumn[i_Layer].vs_LayerThickness) + 0.5))) {
+    if (i_Layer < (std::floor((vm_FrostDepth / (*soilColumn)[i_Layer].vs_LayerThickness) + 0.5))) {
 
       // soil layer is frozen
-      soilColumn[i_Layer].vs_SoilFrozen = true;
+      (*soilColumn)[i_Layer].vs_SoilFrozen = true;
       vm_LambdaRedux[i_Layer] = 0.0;
 
       if (i_Layer == 0) {
@@ -304,12 +304,12 @@ FrostComponent::updateLambdaRedux() {
       }
     }
 
-    if (i_Layer < (std::floor((vm_ThawDepth / soilColumn[i_Layer].vs_LayerThickness) + 0.5))) {
+    if (i_Layer < (std::floor((vm_ThawDepth / (*soilColumn)[i_Layer].vs_LayerThickness) + 0.5))) {
       // soil layer is thawing
 
-      if (vm_ThawDepth < (double(i_Layer + 1) * soilColumn[i_Layer].vs_LayerThickness) && (vm_ThawDepth < vm_FrostDepth)) {
+      if (vm_ThawDepth < (double(i_Layer + 1) * (*soilColumn)[i_Layer].vs_LayerThickness) && (vm_ThawDepth < vm_FrostDepth)) {
         // soil layer is thawing but there is more frost than thaw
-        soilColumn[i_Layer].vs_SoilFrozen = true;
+        (*soilColumn)[i_Layer].vs_SoilFrozen = true;
         vm_LambdaRedux[i_Layer] = 0.0;
         if (i_Layer == 0) {
           vm_HydraulicConductivityRedux = 0.0;
@@ -317,7 +317,7 @@ FrostComponent::updateLambdaRedux() {
 
       } else {
         // soil is thawing
-        soilColumn[i_Layer].vs_SoilFrozen = false;
+        (*soilColumn)[i_Layer].vs_SoilFrozen = false;
         vm_LambdaRedux[i_Layer] = 1.0;
         if (i_Layer == 0) {
           vm_HydraulicConductivityRedux = 0.1;
@@ -334,7 +334,7 @@ FrostComponent::updateLambdaRedux() {
 
       vm_HydraulicConductivityRedux = pm_HydraulicConductivityRedux;
       for (int i_Layer = 0; i_Layer < vs_number_of_layers; i_Layer++) {
-        soilColumn[i_Layer].vs_SoilFrozen = false;
+        (*soilColumn)[i_Layer].vs_SoilFrozen = false;
         vm_LambdaRedux[i_Layer] = 1.0;
       }
     }
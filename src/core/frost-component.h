@@ -31,7 +31,10 @@ class FrostComponent {
                     double pm_HydraulicConductivityRedux,
                     double p_timeStep);
 
-    FrostComponent(SoilColumn& sc, mas::schema::model::monica::FrostModuleState::Reader reader) : soilColumn(sc) { deserialize(reader); }
+    FrostComponent(SoilColumn& sc, mas::schema::model::monica::FrostModuleState::Reader reader) : soilColumn(&sc) { deserialize(reader); }
+
+    //! copy of other bound to the soil column sc (of a copied model)
+    FrostComponent(const FrostComponent& other, SoilColumn& sc) : FrostComponent(other) { soilColumn = &sc; }
     void deserialize(mas::schema::model::monica::FrostModuleState::Reader reader);
     void serialize(mas::schema::model::monica::FrostModuleState::Builder builder) const;
 
@@ -53,7 +56,7 @@ class FrostComponent {
     double calcFrostDepth(double mean_field_capacity, double heat_conductivity_frozen, double temperature_under_snow);
     void updateLambdaRedux();
 
-    SoilColumn& soilColumn;
+    SoilColumn* soilColumn;
     double vm_FrostDepth{0.0};
     double vm_accumulatedFrostDepth{0.0};
     double vm_NegativeDegreeDays{0.0}; //!< Counts negative degree-days under snow
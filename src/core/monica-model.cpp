@@ -60,19 +60,20 @@ struct AddFertiliserAmountsCallback {
 }
 
 
-MonicaModel::MonicaModel(const CentralParameterProvider &cpp)
+MonicaModel::MonicaModel(const CentralParameterProvider &cpp, std::pmr::memory_resource* mr)
     : _sitePs(kj::mv(cpp.siteParameters)), _envPs(kj::mv(cpp.userEnvironmentParameters)),
       _cropPs(kj::mv(cpp.userCropParameters)), _simPs(kj::mv(cpp.simulationParameters)),
       _groundwaterInformation(kj::mv(cpp.groundwaterInformation)),
       _soilColumn(kj::heap<SoilColumn>(_simPs.p_LayerThickness,
                                        cpp.userSoilOrganicParameters.ps_MaxMineralisationDepth,
-                                       _sitePs.vs_SoilParameters)),
+                                       _sitePs.vs_SoilParameters, mr)),
                                        //cpp.userSoilMoistureParameters.pm_CriticalMoistureDepth)),
       _soilTemperature(kj::heap<SoilTemperature>(*this, cpp.userSoilTemperatureParameters)),
       _soilMoisture(kj::heap<SoilMoisture>(*this, cpp.userSoilMoistureParameters)),
       _soilOrganic(kj::heap<SoilOrganic>(*_soilColumn, cpp.userSoilOrganicParameters)),
       _soilTransport(kj::heap<SoilTransport>(*_soilColumn, _sitePs, cpp.userSoilTransportParameters,
-                                             _envPs.p_LeachingDepth, _envPs.p_timeStep, _cropPs.pc_MinimumAvailableN)) {
+                                             _envPs.p_LeachingDepth, _envPs.p_timeStep, _cropPs.pc_MinimumAvailableN)),
+      _climateData(mr), _currentEvents(mr), _previousDaysEvents(mr) {
 }
 
 void MonicaModel::deserialize(mas::schema::model::monica::MonicaModelState::Reader reader) {
@@ -83,16 +84,16 @@ void MonicaModel::deserialize(mas::schema::model::monica::MonicaModelState::Read
   _groundwaterInformation.deserialize(reader.getGroundwaterInformation());
 
   if (_soilColumn) _soilColumn->deserialize(reader.getSoilColumn());
-  else _soilColumn = kj::heap<SoilColumn>(reader.getSoilColumn());
+  else _soilColumn = kj::heap<SoilColumn>(reader.getSoilColumn(), nullptr, memoryResource());
 
   if (reader.hasCurrentCropModule()) {
-    auto addOMFunc = [this](const std::map<size_t, double>& layer2amount, double nconc) {
+    auto addOMFunc = [this](kj::ArrayPtr<const double> layer2amount, double nconc) {
       this->_soilOrganic->addOrganicMatter(this->_currentCropModule->residueParameters(),
                                            layer2amount,
                                            nconc);
     };
     _currentCropModule = kj::heap<CropModule>(*_soilColumn, _cropPs,
-                                              [this](string event) { this->addEvent(event); }, addOMFunc,
+                                              [this](const string& event) { this->addEvent(event); }, addOMFunc,
                                               [this](double avgAirTemp) {
                                                 return this->soilMoisture().getSnowDepthAndCalcTemperatureUnderSnow(
                                                     avgAirTemp);
@@ -176,6 +177,66 @@ void MonicaModel::deserialize(mas::schema::model::monica::MonicaModelState::Read
   vs_GroundwaterDepth = reader.getVsGroundwaterDepth();
 
   _cultivationMethodCount = reader.getCultivationMethodCount();
+
+  // the diagnostics aren't part of the state, so reapply them to the (possibly new) modules
+  setDiagnostics(_diagnostics);
+}
+
+void MonicaModel::setDiagnostics(Diagnostics ds) {
+  _diagnostics = ds;
+  if (_soilOrganic) _soilOrganic->setCalculateN2OProduction(ds.n2oProduction);
+  if (_currentCropModule) _currentCropModule->setCalculateVOCEmissions(ds.vocEmissions);
+}
+
+MonicaModel::MonicaModel(const MonicaModel& other, std::pmr::memory_resource* mr)
+    : _sitePs(other._sitePs), _envPs(other._envPs), _cropPs(other._cropPs), _simPs(other._simPs),
+      _groundwaterInformation(other._groundwaterInformation),
+      _soilColumn(kj::heap<SoilColumn>(*other._soilColumn, mr)),
+      _sumFertiliser(other._sumFertiliser), _sumOrgFertiliser(other._sumOrgFertiliser),
+      _dailySumFertiliser(other._dailySumFertiliser), _dailySumOrgFertiliser(other._dailySumOrgFertiliser),
+      _dailySumOrganicFertilizerDM(other._dailySumOrganicFertilizerDM),
+      _sumOrganicFertilizerDM(other._sumOrganicFertilizerDM),
+      _humusBalanceCarryOver(other._humusBalanceCarryOver),
+      _dailySumIrrigationWater(other._dailySumIrrigationWater),
+      _optCarbonExportedResidues(other._optCarbonExportedResidues),
+      _optCarbonReturnedResidues(other._optCarbonReturnedResidues),
+      _currentStepDate(other._currentStepDate),
+      _climateData(other._climateData, mr),
+      _currentEvents(other._currentEvents, mr), _previousDaysEvents(other._previousDaysEvents, mr),
+      _clearCropUponNextDay(other._clearCropUponNextDay),
+      p_daysWithCrop(other.p_daysWithCrop), p_accuNStress(other.p_accuNStress),
+      p_accuWaterStress(other.p_accuWaterStress), p_accuHeatStress(other.p_accuHeatStress),
+      p_accuOxygenStress(other.p_accuOxygenStress),
+      vw_AtmosphericCO2Concentration(other.vw_AtmosphericCO2Concentration),
+      vw_AtmosphericO3Concentration(other.vw_AtmosphericO3Concentration),
+      vs_GroundwaterDepth(other.vs_GroundwaterDepth),
+      _cultivationMethodCount(other._cultivationMethodCount),
+      _diagnostics(other._diagnostics) {
+  // the modules are copied member-wise and bound to the parameters, soil column and crop of this model
+  if (other._currentCropModule) {
+    auto addOMFunc = [this](kj::ArrayPtr<const double> layer2amount, double nconc) {
+      this->_soilOrganic->addOrganicMatter(this->_currentCropModule->residueParameters(),
+                                           layer2amount,
+                                           nconc);
+    };
+    _currentCropModule = kj::heap<CropModule>(*other._currentCropModule, *_soilColumn, _cropPs,
+                                              [this](const string& event) { this->addEvent(event); }, addOMFunc,
+                                              [this](double avgAirTemp) {
+                                                return this->soilMoisture().getSnowDepthAndCalcTemperatureUnderSnow(
+                                                    avgAirTemp);
+                                              },
+                                              _intercropping);
+  }
+  auto cm = _currentCropModule.get();
+  _soilColumn->putCrop(cm);
+  _soilTemperature = kj::heap<SoilTemperature>(*other._soilTemperature, *this);
+  _soilMoisture = kj::heap<SoilMoisture>(*other._soilMoisture, *this, cm);
+  _soilOrganic = kj::heap<SoilOrganic>(*other._soilOrganic, *_soilColumn, cm);
+  _soilTransport = kj::heap<SoilTransport>(*other._soilTransport, *_soilColumn, cm);
+}
+
+kj::Own<MonicaModel> MonicaModel::clone(std::pmr::memory_resource* mr) const {
+  return kj::heap<MonicaModel>(*this, mr ? mr : memoryResource());
 }
 
 void MonicaModel::serialize(mas::schema::model::monica::MonicaModelState::Builder builder) {
@@ -273,7 +334,7 @@ void MonicaModel::seedCrop(mas::schema::model::monica::CropSpec::Reader reader)
 
     _cultivationMethodCount++;
 
-    auto addOMFunc = [this](const std::map<size_t, double>& layer2amount, double nConcentration) {
+    auto addOMFunc = [this](kj::ArrayPtr<const double> layer2amount, double nConcentration) {
       this->_soilOrganic->addOrganicMatter(_currentCropModule->residueParameters(),
                                            layer2amount,
                                            nConcentration);
@@ -288,6 +349,7 @@ void MonicaModel::seedCrop(mas::schema::model::monica::CropSpec::Reader reader)
                                                     avgAirTemp);
                                               },
                                               _intercropping);
+    _currentCropModule->setCalculateVOCEmissions(_diagnostics.vocEmissions);
 
     //if (crop->separatePerennialCropParameters())
     //  _currentCropModule->setPerennialCropParameters(crop->perennialCropParameters());
@@ -327,20 +389,22 @@ void MonicaModel::seedCrop(Crop *crop) {
   if (crop->isValid()) {
     _cultivationMethodCount++;
 
-    auto addOMFunc = [this](const std::map<size_t, double>& layer2amount, double nconc) {
+    auto addOMFunc = [this](kj::ArrayPtr<const double> layer2amount, double nconc) {
       this->_soilOrganic->addOrganicMatter(_currentCropModule->residueParameters(),
                                            layer2amount,
                                            nconc);
     };
-    auto cps = crop->cropParameters();
+    // read through the const accessor, the non-const one would copy the shared parameters
+    const auto& cps = std::as_const(*crop).cropParameters();
     _currentCropModule = kj::heap<CropModule>(*_soilColumn, cps, crop->residueParameters(),
                                               crop->isWinterCrop(), _sitePs, _cropPs, _simPs,
-                                              [this](string event) { this->addEvent(event); }, addOMFunc,
+                                              [this](const string& event) { this->addEvent(event); }, addOMFunc,
                                               [this](double avgAirTemp) {
                                                 return this->soilMoisture().getSnowDepthAndCalcTemperatureUnderSnow(
                                                     avgAirTemp);
                                               },
                                               _intercropping);
+    _currentCropModule->setCalculateVOCEmissions(_diagnostics.vocEmissions);
 
     if (crop->separatePerennialCropParameters())
       _currentCropModule->setPerennialCropParameters(crop->perennialCropParameters());
@@ -654,7 +718,7 @@ void MonicaModel::generalStep() {
   unsigned int julday = date.julianDay();
   bool leapYear = date.isLeapYear();
 
-  auto climateData = currentStepClimateData();
+  StepClimateData climateData(currentStepClimateData(), memoryResource());
   double tmin = climateData[Climate::tmin];
   double tavg = climateData[Climate::tavg];
   double tmax = climateData[Climate::tmax];
@@ -752,7 +816,7 @@ pair<double, double> laiSunShade(double latitude, int doy, int hour, double lai)
 
 void MonicaModel::cropStep() {
   auto date = _currentStepDate;
-  auto climateData = currentStepClimateData();
+  StepClimateData climateData(currentStepClimateData(), memoryResource());
 
   // do nothing if there is no crop
   if (!_currentCropModule) return;
@@ -26,6 +26,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <iostream>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <queue>
 #include <set>
 
@@ -53,16 +54,41 @@ namespace monica {
   
 class Crop;
 
+//! purely diagnostic calculations, which feed no state variable and thus can be skipped if none of their outputs
+//! (or conditions depending on them) are requested, by default everything is calculated
+//! (runs saving their state calculate everything, as the state contains running sums like vo_SumN2O_Produced)
+struct Diagnostics {
+  bool vocEmissions{true};
+  bool n2oProduction{true};
+};
+
 class MonicaModel {
 public:
-  explicit MonicaModel(const CentralParameterProvider& cpp);
+  //! climate data of a single step
+  typedef std::pmr::map<Climate::ACD, double> StepClimateData;
 
-  explicit MonicaModel(mas::schema::model::monica::MonicaModelState::Reader reader) { deserialize(reader); }
+  //! @param mr memory resource the per run containers of the model draw from (e.g. a per run pool),
+  //! has to outlive the model
+  explicit MonicaModel(const CentralParameterProvider& cpp,
+                       std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+
+  explicit MonicaModel(mas::schema::model::monica::MonicaModelState::Reader reader,
+                       std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+    : _climateData(mr), _currentEvents(mr), _previousDaysEvents(mr) { deserialize(reader); }
 
   void deserialize(mas::schema::model::monica::MonicaModelState::Reader reader);
 
   void serialize(mas::schema::model::monica::MonicaModelState::Builder builder);
 
+  //! member-wise deep copy of other including the whole climate history, with the modules bound to the copy
+  //! (the copy is not connected to an intercropping partner)
+  //! @param mr memory resource of the copy, has to outlive it
+  MonicaModel(const MonicaModel& other, std::pmr::memory_resource* mr);
+
+  //! deep copy of the model, see the copy constructor above
+  //! @param mr memory resource of the copy, defaults to the one of this model
+  kj::Own<MonicaModel> clone(std::pmr::memory_resource* mr = nullptr) const;
+
   void step();
 
   void generalStep();
@@ -172,15 +198,17 @@ public:
   Tools::Date currentStepDate() const { return _currentStepDate; }
   void setCurrentStepDate(Tools::Date d) { _currentStepDate = d; }
 
-  const std::map<Climate::ACD, double>& currentStepClimateData() const { return _climateData.back(); }
-  void setCurrentStepClimateData(const std::map<Climate::ACD, double>& cd) { _climateData.push_back(cd); }
+  const StepClimateData& currentStepClimateData() const { return _climateData.back(); }
+  void setCurrentStepClimateData(const std::map<Climate::ACD, double>& cd) { _climateData.emplace_back(cd.begin(), cd.end()); }
+
+  const std::pmr::vector<StepClimateData>& climateData() const { return _climateData; }
 
-  const std::vector<std::map<Climate::ACD, double>>& climateData() const { return _climateData; }
+  std::pmr::memory_resource* memoryResource() const { return _climateData.get_allocator().resource(); }
 
   void addEvent(std::string e) { _currentEvents.insert(e); }
   void clearEvents();
-  const std::set<std::string>& currentEvents() const { return _currentEvents; }
-  const std::set<std::string>& previousDaysEvents() const { return _previousDaysEvents; }
+  const std::pmr::set<std::string>& currentEvents() const { return _currentEvents; }
+  const std::pmr::set<std::string>& previousDaysEvents() const { return _previousDaysEvents; }
 
   int cultivationMethodCount() const { return _cultivationMethodCount; }
 
@@ -193,6 +221,10 @@ public:
 
   void setOtherCropHeightAndLAIt(double cropHeight, double lait);
 
+  const Diagnostics& diagnostics() const { return _diagnostics; }
+  //! switch the diagnostic calculations of the modules (including crops planted later) on or off
+  void setDiagnostics(Diagnostics ds);
+
 private:
   SiteParameters _sitePs;
   EnvironmentParameters _envPs;
@@ -226,9 +258,10 @@ private:
   double _optCarbonReturnedResidues{ 0.0 };
 
   Tools::Date _currentStepDate;
-  std::vector<std::map<Climate::ACD, double>> _climateData;
-  std::set<std::string> _currentEvents;
-  std::set<std::string> _previousDaysEvents;
+  std::pmr::vector<StepClimateData> _climateData;
+  //! the event names are short enough to be kept inline, so just the nodes come from the memory resource
+  std::pmr::set<std::string> _currentEvents;
+  std::pmr::set<std::string> _previousDaysEvents;
 
   bool _clearCropUponNextDay{ false };
 
@@ -246,6 +279,8 @@ private:
 
   Intercropping _intercropping;
 
+  Diagnostics _diagnostics;
+
   //public:
   //  uint critPos{ 0 };
   //  uint cmitPos{ 0 };
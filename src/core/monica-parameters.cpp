@@ -45,6 +45,32 @@ using namespace Climate;
 using namespace json11;
 
 
+StageOrganMatrix::StageOrganMatrix(const vector<vector<double>>& rows) {
+  size_t noOfOrgans = 0;
+  for (const auto& row : rows) noOfOrgans = max(noOfOrgans, row.size());
+  resize(rows.size(), noOfOrgans);
+  for (size_t s = 0; s < rows.size(); s++) copy(rows[s].begin(), rows[s].end(), (*this)[s]);
+}
+
+vector<vector<double>> StageOrganMatrix::rows() const {
+  vector<vector<double>> rs;
+  for (size_t s = 0; s < _noOfStages; s++) rs.emplace_back((*this)[s], (*this)[s] + _noOfOrgans);
+  return rs;
+}
+
+StageOrganMatrix StageOrganMatrix::fromJson(const Json& j) {
+  vector<vector<double>> rows;
+  for (const auto& js : j.array_items()) rows.push_back(double_vector(js));
+  return StageOrganMatrix(rows);
+}
+
+Json StageOrganMatrix::to_json() const {
+  J11Array rs;
+  for (const auto& row : rows()) rs.push_back(toPrimJsonArray(row));
+  return rs;
+}
+
+
 /**
  * @brief Constructor
  * @param oid organ ID
@@ -373,23 +399,8 @@ void CultivarParameters::deserialize(mas::schema::model::monica::CultivarParamet
   pc_CropHeightP2 = reader.getCropHeightP2();
   pc_CropSpecificMaxRootingDepth = reader.getCropSpecificMaxRootingDepth();
 
-  {
-    const auto listReader = reader.getAssimilatePartitioningCoeff();
-    for (const auto lr : listReader) {
-      vector<double> v;
-      setFromCapnpList(v, lr);
-      pc_AssimilatePartitioningCoeff.emplace_back(v);
-    }
-  }
-
-  {
-    const auto listReader = reader.getOrganSenescenceRate();
-    for (const auto lr : listReader) {
-      vector<double> v;
-      setFromCapnpList(v, lr);
-      pc_OrganSenescenceRate.emplace_back(v);
-    }
-  }
+  pc_AssimilatePartitioningCoeff.deserialize(reader.getAssimilatePartitioningCoeff());
+  pc_OrganSenescenceRate.deserialize(reader.getOrganSenescenceRate());
 
   setFromCapnpList(pc_BaseDaylength, reader.getBaseDaylength());
   setFromCapnpList(pc_OptimumTemperature, reader.getOptimumTemperature());
@@ -432,17 +443,10 @@ void CultivarParameters::serialize(mas::schema::model::monica::CultivarParameter
   builder.setCropHeightP2(pc_CropHeightP2);
   builder.setCropSpecificMaxRootingDepth(pc_CropSpecificMaxRootingDepth);
 
-  {
-    auto listBuilder = builder.initAssimilatePartitioningCoeff((capnp::uint) pc_AssimilatePartitioningCoeff.size());
-    capnp::uint i = 0;
-    for (const auto &v: pc_AssimilatePartitioningCoeff) setCapnpList(v, listBuilder.init(i++, (capnp::uint) v.size()));
-  }
-
-  {
-    auto listBuilder = builder.initOrganSenescenceRate((capnp::uint) pc_OrganSenescenceRate.size());
-    capnp::uint i = 0;
-    for (const auto &v: pc_OrganSenescenceRate) setCapnpList(v, listBuilder.init(i++, (capnp::uint) v.size()));
-  }
+  pc_AssimilatePartitioningCoeff.serialize(
+      builder.initAssimilatePartitioningCoeff((capnp::uint) pc_AssimilatePartitioningCoeff.numberOfStages()));
+  pc_OrganSenescenceRate.serialize(
+      builder.initOrganSenescenceRate((capnp::uint) pc_OrganSenescenceRate.numberOfStages()));
 
   setCapnpList(pc_BaseDaylength, builder.initBaseDaylength((capnp::uint) pc_BaseDaylength.size()));
   setCapnpList(pc_OptimumTemperature, builder.initOptimumTemperature((capnp::uint) pc_OptimumTemperature.size()));
@@ -528,18 +532,10 @@ Errors CultivarParameters::merge(json11::Json j) {
   set_bool_value(winterCrop, j, "WinterCrop");
 
   if (j["AssimilatePartitioningCoeff"].is_array()) {
-    auto apcs = j["AssimilatePartitioningCoeff"].array_items();
-    int i = 0;
-    pc_AssimilatePartitioningCoeff.resize(apcs.size());
-    for (auto js: apcs)
-      pc_AssimilatePartitioningCoeff[i++] = double_vector(js);
+    pc_AssimilatePartitioningCoeff = StageOrganMatrix::fromJson(j["AssimilatePartitioningCoeff"]);
   }
   if (j["OrganSenescenceRate"].is_array()) {
-    auto osrs = j["OrganSenescenceRate"].array_items();
-    int i = 0;
-    pc_OrganSenescenceRate.resize(osrs.size());
-    for (auto js: osrs)
-      pc_OrganSenescenceRate[i++] = double_vector(js);
+    pc_OrganSenescenceRate = StageOrganMatrix::fromJson(j["OrganSenescenceRate"]);
   }
 
   set_double_value(pc_EarlyRefLeafExp, j, "EarlyRefLeafExp");
@@ -554,13 +550,8 @@ Errors CultivarParameters::merge(json11::Json j) {
 }
 
 json11::Json CultivarParameters::to_json() const {
-  J11Array apcs;
-  for (auto v: pc_AssimilatePartitioningCoeff)
-    apcs.push_back(toPrimJsonArray(v));
-
-  J11Array osrs;
-  for (auto v: pc_OrganSenescenceRate)
-    osrs.push_back(toPrimJsonArray(v));
+  auto apcs = pc_AssimilatePartitioningCoeff.to_json();
+  auto osrs = pc_OrganSenescenceRate.to_json();
 
   auto cultivar = J11Object
       {{"type",                          "CultivarParameters"},
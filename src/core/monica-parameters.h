@@ -23,6 +23,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <memory>
 #include <functional>
 #include <cassert>
+#include <algorithm>
 
 #include <kj/async-io.h>
 #include <kj/common.h>
@@ -44,6 +45,15 @@ namespace monica {
 
 class CentralParameterProvider;
 
+//! floating point type of the bulk per layer soil state (pools, moisture, temperature)
+//! build with MONICA_SINGLE_PRECISION_STATE for large ensemble/Monte-Carlo runs,
+//! balances and accumulators are always kept in double precision
+#ifdef MONICA_SINGLE_PRECISION_STATE
+typedef float StateReal;
+#else
+typedef double StateReal;
+#endif
+
 enum Eva2_Nutzung {
   NUTZUNG_UNDEFINED = 0,
   NUTZUNG_GANZPFLANZE = 1,
@@ -52,6 +62,68 @@ enum Eva2_Nutzung {
   NUTZUNG_CCM = 8
 };
 
+/**
+ * @brief Crop parameters given per developmental stage and organ, stored row major (one row per stage).
+ *
+ * The dimensions are fixed when the parameters are read, m[stage][organ] indexes like the nested vectors did.
+ * Rows of different length (in JSON) are padded with 0.
+ */
+class DLL_API StageOrganMatrix {
+public:
+  StageOrganMatrix() = default;
+
+  explicit StageOrganMatrix(const std::vector<std::vector<double>>& rows);
+
+  size_t numberOfStages() const { return _noOfStages; }
+  size_t numberOfOrgans() const { return _noOfOrgans; }
+  bool empty() const { return _values.empty(); }
+
+  //! the row of the stage
+  const double* operator[](size_t stage) const { return _values.data() + stage * _noOfOrgans; }
+  double* operator[](size_t stage) { return _values.data() + stage * _noOfOrgans; }
+
+  double at(size_t stage, size_t organ) const { return _values.at(stage * _noOfOrgans + organ); }
+
+  std::vector<std::vector<double>> rows() const;
+
+  static StageOrganMatrix fromJson(const json11::Json& j);
+  json11::Json to_json() const;
+
+  //! read from a capnp List(List(Float64))
+  template<typename ListOfListsReader>
+  void deserialize(ListOfListsReader reader) {
+    size_t noOfOrgans = 0;
+    for (auto row : reader) noOfOrgans = std::max(noOfOrgans, size_t(row.size()));
+    resize(reader.size(), noOfOrgans);
+    size_t s = 0;
+    for (auto row : reader) {
+      size_t o = 0;
+      for (auto v : row) (*this)[s][o++] = v;
+      s++;
+    }
+  }
+
+  //! write into a capnp List(List(Float64)) already initialized with numberOfStages() rows
+  template<typename ListOfListsBuilder>
+  void serialize(ListOfListsBuilder builder) const {
+    for (size_t s = 0; s < _noOfStages; s++) {
+      auto row = builder.init((capnp::uint)s, (capnp::uint)_noOfOrgans);
+      for (size_t o = 0; o < _noOfOrgans; o++) row.set((capnp::uint)o, (*this)[s][o]);
+    }
+  }
+
+private:
+  void resize(size_t noOfStages, size_t noOfOrgans) {
+    _noOfStages = noOfStages;
+    _noOfOrgans = noOfOrgans;
+    _values.assign(noOfStages * noOfOrgans, 0.0);
+  }
+
+  size_t _noOfStages{0};
+  size_t _noOfOrgans{0};
+  std::vector<double> _values;
+};
+
 /**
  * @brief
  */
@@ -194,8 +266,8 @@ struct DLL_API CultivarParameters : public Tools::Json11Serializable {
   double pc_CropHeightP2{ 0.0 };
   double pc_CropSpecificMaxRootingDepth{ 0.0 };
 
-  std::vector<std::vector<double>> pc_AssimilatePartitioningCoeff;
-  std::vector<std::vector<double>> pc_OrganSenescenceRate;
+  StageOrganMatrix pc_AssimilatePartitioningCoeff;
+  StageOrganMatrix pc_OrganSenescenceRate;
 
   std::vector<double> pc_BaseDaylength;
   std::vector<double> pc_OptimumTemperature;
@@ -0,0 +1,98 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "json11/json11.hpp"
+
+namespace monica {
+
+/**
+ * @brief Process wide store of immutable parameter sets (crop, residue, organic fertilizer parameters).
+ *
+ * The sets are keyed by the content of their JSON description, so identical sets
+ * (e.g. the same few cultivars in thousands of jobs of a batch) are parsed once and shared read-only.
+ * The store holds the sets weakly, a set is released when the last user is gone.
+ *
+ * @tparam Params a Tools::Json11Serializable, created via default construction and merge
+ */
+template<typename Params>
+class ParameterStore {
+public:
+  static ParameterStore& instance() {
+    static ParameterStore store;
+    return store;
+  }
+
+  //! get the shared parameters described by j, they are parsed only if not already in the store
+  std::shared_ptr<const Params> intern(const json11::Json& j) {
+    auto key = j.dump();
+
+    std::lock_guard<std::mutex> lock(_lockable);
+    auto& entry = _entries[key];
+    if (auto ps = entry.lock()) return ps;
+
+    auto ps = std::make_shared<Params>();
+    ps->merge(j);
+    entry = ps;
+
+    // drop the released sets from time to time
+    if (_entries.size() >= _purgeAtSize) {
+      for (auto it = _entries.begin(); it != _entries.end();) {
+        if (it->second.expired()) it = _entries.erase(it);
+        else ++it;
+      }
+      _purgeAtSize = std::max(size_t(64), 2 * _entries.size());
+    }
+
+    return ps;
+  }
+
+  //! the default parameters, shared by everybody who hasn't got parameters merged in yet
+  static const std::shared_ptr<const Params>& defaults() {
+    static const std::shared_ptr<const Params> ps = std::make_shared<Params>();
+    return ps;
+  }
+
+  //! merge j into the parameters ps (like Params::merge) without changing ps, as they might be shared:
+  //! as long as ps are the defaults this is the same as interning j, else j is merged into a copy of ps
+  std::shared_ptr<const Params> merge(const std::shared_ptr<const Params>& ps, const json11::Json& j) {
+    if (!ps || ps == defaults()) return intern(j);
+    auto merged = std::make_shared<Params>(*ps);
+    merged->merge(j);
+    return merged;
+  }
+
+  //! number of (possibly released) parameter sets in the store
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(_lockable);
+    return _entries.size();
+  }
+
+private:
+  ParameterStore() = default;
+
+  mutable std::mutex _lockable;
+  std::unordered_map<std::string, std::weak_ptr<const Params>> _entries;
+  size_t _purgeAtSize{64};
+};
+
+} // namespace monica
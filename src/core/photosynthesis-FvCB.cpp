@@ -25,14 +25,12 @@ using namespace FvCB;
 using namespace Tools;
 using namespace std;
 
-std::map<FvCB_Model_Consts, double> FvCB::c_bernacchi = {{Rd, 18.72},{Vcmax, 26.35},{Vomax, 22.98},{Gamma, 19.02},{Kc, 38.05},{Ko, 20.30},{Jmax, 17.57}}; //dimensionless
-std::map<FvCB_Model_Consts, double> FvCB::deltaH_bernacchi = {{Rd, 46.39},{Vcmax, 65.33},{Vomax, 60.11},{Gamma, 37.83},{Kc, 79.43},{Ko, 36.38},{Jmax, 43.54}}; //kJ mol - 1
-
 //estimate the fraction of diffuse radiation; it requires hourly input
 double diffuse_fraction_hourly_f(double globrad, double extra_terr_rad, double solar_elev)
 {
   double glob_extra_ratio = globrad / extra_terr_rad;
-  double R = (0.847 - 1.61 * sin(solar_elev) + 1.04 * pow(sin(solar_elev), 2));
+  double sin_solar_elev = sin(solar_elev);
+  double R = (0.847 - 1.61 * sin_solar_elev + 1.04 * sin_solar_elev * sin_solar_elev);
   double K = (1.47 - R) / 1.66;
 
   if (glob_extra_ratio <= 0.22)
@@ -41,7 +39,7 @@ double diffuse_fraction_hourly_f(double globrad, double extra_terr_rad, double s
   }
   else if (glob_extra_ratio <= 0.35)
   {
-    return 1 - 6.4 * pow((glob_extra_ratio - 0.22), 2);
+    return 1 - 6.4 * (glob_extra_ratio - 0.22) * (glob_extra_ratio - 0.22);
   }
   else if (glob_extra_ratio <= K)
   {
@@ -211,30 +209,46 @@ std::tuple<double, double> LAI_sunlit_shaded_f(double LAI, double solar_elev)
 //T response
 double Tresp_bernacchi_f(double c, double deltaH, double leafT)
 {
+  constexpr double R = 8.314472e-3; //kJ K - 1 mol - 1
   double Tk = leafT + 273;
-  double R = 8.314472 * pow(10, -3); //kJ K - 1 mol - 1
   return exp(c - deltaH / (R * Tk));
 }
 
+double Tresp_bernacchi_f(FvCB_Model_Consts param, double leafT)
+{
+  return Tresp_bernacchi_f(c_bernacchi[param], deltaH_bernacchi[param], leafT);
+}
+
+//the temperature response at 25oC, to derive the values at 25oC from the reference parameters
+const double Vcmax_T25 = Tresp_bernacchi_f(Vcmax, 25.0);
+
 double FvCB::Vcmax_bernacchi_f(double leafT, double Vcmax_25)
 {
-  return Vcmax_25 * Tresp_bernacchi_f(c_bernacchi[Vcmax], deltaH_bernacchi[Vcmax], leafT);
+  return Vcmax_25 * Tresp_bernacchi_f(Vcmax, leafT);
 }
 
 double FvCB::Jmax_bernacchi_f(double leafT, double Jmax_25)
 {
-  return Jmax_25 * Tresp_bernacchi_f(c_bernacchi[Jmax], deltaH_bernacchi[Jmax], leafT);
+  return Jmax_25 * Tresp_bernacchi_f(Jmax, leafT);
+}
+
+double theta_ps2_f(double leafT)
+{
+  return 0.76 + 0.018 * leafT - 3.7e-4 * leafT * leafT;
+}
+
+double phi_ps2max_f(double leafT)
+{
+  return 0.352 + 0.022 * leafT - 3.4e-4 * leafT * leafT;
 }
 
-double J_bernacchi_f(double Q, double leafT, double Jmax)
+double J_bernacchi_f(double Q, double Jmax, double theta_ps2, double phi_ps2max)
 {
   double alfa = 0.85; //total leaf absorbance 
   double beta = 0.5; //fraction of absorbed quanta reaching PSII
-  double theta_ps2 = 0.76 + 0.018 * leafT - 3.7 * pow(10, -4) * pow(leafT, 2);
-  double phi_ps2max = 0.352 + 0.022 *leafT - 3.4 * pow(10, -4) * pow(leafT, 2);
   double Q2 = Q * alfa * phi_ps2max * beta;
 
-  double numerator = Q2 + Jmax - sqrt(pow((Q2 + Jmax), 2) - 4 * theta_ps2 * Q2 * Jmax);
+  double numerator = Q2 + Jmax - sqrt((Q2 + Jmax) * (Q2 + Jmax) - 4 * theta_ps2 * Q2 * Jmax);
   double denominator = 2 * theta_ps2;
   return numerator / denominator;
 }
@@ -247,39 +261,19 @@ double J_grote_f(double Q, double Jmax)
   double  jj = tmp_var > 0.0 ? (Q + Jmax - sqrt(tmp_var)) / (2.0 * species_THETA) : 0.0;
   return jj;
 }
-  
-double Rd_bernacchi_f(double leafT)
-{
-  return Tresp_bernacchi_f(c_bernacchi[Rd], deltaH_bernacchi[Rd], leafT);
-}
-
-double Vomax_bernacchi_f(double leafT, double Vcmax_25)
-{
-  return Vcmax_25 * Tresp_bernacchi_f(c_bernacchi[Vomax], deltaH_bernacchi[Vomax], leafT);
-}
-
-double Kc_bernacchi_f(double leafT)
-{
-  return Tresp_bernacchi_f(c_bernacchi[Kc], deltaH_bernacchi[Kc], leafT);
-}
-
-double Ko_bernacchi_f(double leafT)
-{
-  return Tresp_bernacchi_f(c_bernacchi[Ko], deltaH_bernacchi[Ko], leafT);
-}
 
 double Oi_f(double leafT)
 {
-  double T1 = 1.3087 * pow(10, -3) * leafT;
-  double T2 = 2.5603 * pow(10, -5) * pow(leafT, 2);
-  double T3 = 2.1441 * pow(10, -7) * pow(leafT, 3);
-  return 210 * (4.7 * pow(10, -2) - T1 + T2 - T3) / (2.6934 * pow(10, -2));
+  double T1 = 1.3087e-3 * leafT;
+  double T2 = 2.5603e-5 * leafT * leafT;
+  double T3 = 2.1441e-7 * leafT * leafT * leafT;
+  return 210 * (4.7e-2 - T1 + T2 - T3) / 2.6934e-2;
 }
 
-double Gamma_bernacchi_f(double leafT, double Vcmax, double Vomax)
+double Gamma_bernacchi_f(double Vcmax, double Vomax, double Kc, double Ko, double Oi)
 {
-  double numerator = 0.5 * Vomax * Kc_bernacchi_f(leafT) * Oi_f(leafT);
-  double denominator = Vcmax * Ko_bernacchi_f(leafT);
+  double numerator = 0.5 * Vomax * Kc * Oi;
+  double denominator = Vcmax * Ko;
   return flt_equal_zero(denominator) ? 0.0 : numerator / denominator;
 }
 
@@ -355,10 +349,10 @@ double fVPD_f(double VPD)
 #pragma region 
 //Lumped coefficients cubic equation C3
 
-std::tuple<double, double> x_rubisco(double leafT, double Vcmax)
+std::tuple<double, double> x_rubisco(double Vcmax, double Kc, double Ko, double Oi)
 {
   double x1 = Vcmax;
-  double x2 = Kc_bernacchi_f(leafT) * (1 + Oi_f(leafT) / Ko_bernacchi_f(leafT));
+  double x2 = Kc * (1 + Oi / Ko);
 
   return std::make_tuple(x1, x2);
 }
@@ -414,13 +408,14 @@ Lumped_Coeffs calculate_lumped_coeffs(double x1, double x2, double fVPD, double
   lumped_coeffs.p = -(d + (x1 - Rd) / gm_C3 + a*(1 / gm_C3 + 1 / gb) + (g0 / gm_C3 + fVPD)*c) / m;
 
   //U
-  double U = (2 * pow(lumped_coeffs.p, 3) - 9 * lumped_coeffs.p*q + 27 * r) / 54;
+  double p = lumped_coeffs.p;
+  double U = (2 * p * p * p - 9 * p * q + 27 * r) / 54;
 
   //Q
-  lumped_coeffs.Q = (pow(lumped_coeffs.p, 2) - 3 * q) / 9;
+  lumped_coeffs.Q = (p * p - 3 * q) / 9;
 
   //psi
-  lumped_coeffs.psi = acos(U / sqrt(pow(lumped_coeffs.Q, 3)));
+  lumped_coeffs.psi = acos(U / sqrt(lumped_coeffs.Q * lumped_coeffs.Q * lumped_coeffs.Q));
 
   return lumped_coeffs;
 }
@@ -520,7 +515,43 @@ ostream& FvCB::tout(bool closeFile)
 
 #pragma region
 //Model composition (C3)
-FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvCB_canopy_hourly_params par)
+FvCB_canopy_daily_env FvCB::FvCB_canopy_daily_env_f(const FvCB_canopy_daily_in& in)
+{
+  FvCB_canopy_daily_env env;
+
+  //1. calculate diffuse and direct radiation
+  //2. calculate Radiation absorbed by sunlit / shaded canopy
+  for (std::size_t h = 0; h < HOURS_PER_DAY; h++)
+  {
+    double diffuse_fraction = diffuse_fraction_hourly_f(in.global_rad[h], in.extra_terr_rad[h], in.solar_el[h]);
+    double hourly_diffuse_rad = in.global_rad[h] * diffuse_fraction;
+    double hourly_direct_rad = in.global_rad[h] - hourly_diffuse_rad;
+    double inst_diff_rad = hourly_diffuse_rad * 1e6 / 3600.0 * 4.56 * 0.45; //umol m - 2 s - 1 (unit ground area)
+    double inst_dir_rad = hourly_direct_rad * 1e6 / 3600.0 * 4.56 * 0.45; //1 W m-2 = 4.56 umol m-2 s-1; PAR = 0.45 * global radiation
+
+    env.Ic_sun[h] = Ic_sun_f(inst_dir_rad, inst_diff_rad, in.solar_el[h], in.LAI); //umol m - 2 s - 1 (unit ground area)
+    env.Ic_sh[h] = Ic_shade_f(inst_dir_rad, inst_diff_rad, in.solar_el[h], in.LAI); //umol m - 2 s - 1 (unit ground area)
+
+    //2.1. calculate sunlit/shaded LAI
+    std::tie(env.LAI_sun[h], env.LAI_sh[h]) = LAI_sunlit_shaded_f(in.LAI, in.solar_el[h]);
+  }
+
+  //temperature responses of the model parameters
+  for (std::size_t h = 0; h < HOURS_PER_DAY; h++) env.Vcmax_T[h] = Tresp_bernacchi_f(Vcmax, in.leaf_temp[h]);
+  for (std::size_t h = 0; h < HOURS_PER_DAY; h++) env.Vomax_T[h] = Tresp_bernacchi_f(Vomax, in.leaf_temp[h]);
+  for (std::size_t h = 0; h < HOURS_PER_DAY; h++) env.Jmax_T[h] = Tresp_bernacchi_f(Jmax, in.leaf_temp[h]);
+  for (std::size_t h = 0; h < HOURS_PER_DAY; h++) env.Rd[h] = Tresp_bernacchi_f(Rd, in.leaf_temp[h]);
+  for (std::size_t h = 0; h < HOURS_PER_DAY; h++) env.Kc[h] = Tresp_bernacchi_f(Kc, in.leaf_temp[h]);
+  for (std::size_t h = 0; h < HOURS_PER_DAY; h++) env.Ko[h] = Tresp_bernacchi_f(Ko, in.leaf_temp[h]);
+  for (std::size_t h = 0; h < HOURS_PER_DAY; h++) env.Oi[h] = Oi_f(in.leaf_temp[h]);
+  for (std::size_t h = 0; h < HOURS_PER_DAY; h++) env.theta_ps2[h] = theta_ps2_f(in.leaf_temp[h]);
+  for (std::size_t h = 0; h < HOURS_PER_DAY; h++) env.phi_ps2max[h] = phi_ps2max_f(in.leaf_temp[h]);
+
+  return env;
+}
+
+FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(const FvCB_canopy_daily_in& in, const FvCB_canopy_daily_env& env,
+                                                   std::size_t h, FvCB_canopy_hourly_params par)
 {
   FvCB_canopy_hourly_out out;
   //0. initialize VOCE out
@@ -538,25 +569,20 @@ FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvC
   out.sunlit.jv = 0.0;
   out.shaded.jv = 0.0;
 
-  //1. calculate diffuse and direct radiation
-  double diffuse_fraction = diffuse_fraction_hourly_f(in.global_rad, in.extra_terr_rad, in.solar_el);	
-  double hourly_diffuse_rad = in.global_rad * diffuse_fraction;
-  double hourly_direct_rad = in.global_rad - hourly_diffuse_rad;
-  double inst_diff_rad = hourly_diffuse_rad * pow(10, 6) / 3600.0 * 4.56 * 0.45; //�mol m - 2 s - 1 (unit ground area)
-  double inst_dir_rad = hourly_direct_rad * pow(10, 6) / 3600.0 * 4.56 * 0.45; //1 W m-2 = 4.56 �mol m-2 s-1; PAR = 0.45 * global radiation 
-  
-  //2. calculate Radiation absorbed by sunlit / shaded canopy
-  double Ic_sun = Ic_sun_f(inst_dir_rad, inst_diff_rad, in.solar_el, in.LAI); //�mol m - 2 s - 1 (unit ground area)
-  double Ic_sh = Ic_shade_f(inst_dir_rad, inst_diff_rad, in.solar_el, in.LAI); //�mol m - 2 s - 1 (unit ground area)
+  const double global_rad = in.global_rad[h];
+  const double solar_el = in.solar_el[h];
+
+  //1. - 2. radiation absorbed by sunlit / shaded canopy (precalculated for the whole day)
+  double Ic_sun = env.Ic_sun[h]; //umol m - 2 s - 1 (unit ground area)
+  double Ic_sh = env.Ic_sh[h]; //umol m - 2 s - 1 (unit ground area)
 
-  //2.1. calculate sunlit/shaded LAI
-  std::tuple<double, double> sun_shade_LAI = LAI_sunlit_shaded_f(in.LAI, in.solar_el);
-  out.sunlit.LAI = std::get<0>(sun_shade_LAI);
-  out.shaded.LAI = std::get<1>(sun_shade_LAI);
+  //2.1. sunlit/shaded LAI
+  out.sunlit.LAI = env.LAI_sun[h];
+  out.shaded.LAI = env.LAI_sh[h];
 
 #ifdef TEST_FVCB_HOURLY_OUTPUT
   tout()
-    << "," << in.leaf_temp
+    << "," << in.leaf_temp[h]
     << "," << out.sunlit.LAI
     << "," << out.shaded.LAI
     << "," << Ic_sun
@@ -566,56 +592,56 @@ FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvC
   //For each fraction :
   //-------------------
   //3. canopy photosynthetic capacity
-  double Vcmax = Vcmax_bernacchi_f(in.leaf_temp, par.Vcmax_25);
-  double Vcmax_25 = Vcmax_bernacchi_f(25.0, par.Vcmax_25); //the value at 25�C calculated with bernacchi slightly deviates from par.Vcmax_25
+  double Vcmax = par.Vcmax_25 * env.Vcmax_T[h];
+  double Vcmax_25 = par.Vcmax_25 * Vcmax_T25; //the value at 25oC calculated with bernacchi slightly deviates from par.Vcmax_25
 
   //test
   //Vcmax = 100.0;
     
-  double Vc_25 = canopy_ps_capacity_f(in.LAI, Vcmax_25, par.kn); //�mol m - 2 s - 1 (unit ground area)
-  double Vc_sun_25 = canopy_ps_capacity_sunlit_f(in.LAI, in.solar_el, Vcmax_25, par.kn);
+  double Vc_25 = canopy_ps_capacity_f(in.LAI, Vcmax_25, par.kn); //umol m - 2 s - 1 (unit ground area)
+  double Vc_sun_25 = canopy_ps_capacity_sunlit_f(in.LAI, solar_el, Vcmax_25, par.kn);
   double Vc_sh_25 = Vc_25 - Vc_sun_25;
   double Vc = canopy_ps_capacity_f(in.LAI, Vcmax, par.kn); 
-  double Vc_sun = canopy_ps_capacity_sunlit_f(in.LAI, in.solar_el, Vcmax, par.kn);
+  double Vc_sun = canopy_ps_capacity_sunlit_f(in.LAI, solar_el, Vcmax, par.kn);
   double Vc_sh = Vc - Vc_sun;
   //cout << Vc << endl;
 
   //4. canopy electron transport capacity
-  double Jmax_c_sun_25 = 1.6 * Vc_sun_25; // �mol m - 2 s - 1 (unit ground area)
+  double Jmax_c_sun_25 = 1.6 * Vc_sun_25; // umol m - 2 s - 1 (unit ground area)
   double Jmax_c_sh_25 = 1.6 * Vc_sh_25; 
   
-  double Jmax_c_sun = Jmax_bernacchi_f(in.leaf_temp, Jmax_c_sun_25);
-  double Jmax_c_sh = Jmax_bernacchi_f(in.leaf_temp, Jmax_c_sh_25);
+  double Jmax_c_sun = Jmax_c_sun_25 * env.Jmax_T[h];
+  double Jmax_c_sh = Jmax_c_sh_25 * env.Jmax_T[h];
   out.jmax_c = Jmax_c_sun + Jmax_c_sh;
 
-  double J_c_sun = J_bernacchi_f(Ic_sun, in.leaf_temp, Jmax_c_sun); //�mol m - 2 s - 1 (unit ground area)
-  double J_c_sh = J_bernacchi_f(Ic_sh, in.leaf_temp, Jmax_c_sh);
-  //double J_c_sun = J_grote_f(Ic_sun, Jmax_c_sun); //�mol m - 2 s - 1 (unit ground area)
+  double J_c_sun = J_bernacchi_f(Ic_sun, Jmax_c_sun, env.theta_ps2[h], env.phi_ps2max[h]); //umol m - 2 s - 1 (unit ground area)
+  double J_c_sh = J_bernacchi_f(Ic_sh, Jmax_c_sh, env.theta_ps2[h], env.phi_ps2max[h]);
+  //double J_c_sun = J_grote_f(Ic_sun, Jmax_c_sun); //umol m - 2 s - 1 (unit ground area)
   //double J_c_sh = J_grote_f(Ic_sh, Jmax_c_sh);
   
   //5. canopy respiration
-  double Rd_sun = Rd_bernacchi_f(in.leaf_temp)* out.sunlit.LAI; //�mol m - 2 s - 1 (unit ground area)
-  double Rd_sh = Rd_bernacchi_f(in.leaf_temp)* out.shaded.LAI;
+  double Rd_sun = env.Rd[h] * out.sunlit.LAI; //umol m - 2 s - 1 (unit ground area)
+  double Rd_sh = env.Rd[h] * out.shaded.LAI;
 
   out.canopy_resp = (Rd_sun + Rd_sh) * 3600.0;
   
   //6. Coupled photosynthesis - stomatal conductance
   //6.1. estimate inputs (for solving cubic equation)
   //6.1.1 Gamma
-  double Vomax_sun = Vomax_bernacchi_f(in.leaf_temp, Vc_sun_25);
-  double Vomax_sh = Vomax_bernacchi_f(in.leaf_temp, Vc_sh_25);
-  double gamma_sun = Gamma_bernacchi_f(in.leaf_temp, Vc_sun, Vomax_sun);
-  double gamma_sh = Gamma_bernacchi_f(in.leaf_temp, Vc_sh, Vomax_sh);
+  double Vomax_sun = Vc_sun_25 * env.Vomax_T[h];
+  double Vomax_sh = Vc_sh_25 * env.Vomax_T[h];
+  double gamma_sun = Gamma_bernacchi_f(Vc_sun, Vomax_sun, env.Kc[h], env.Ko[h], env.Oi[h]);
+  double gamma_sh = Gamma_bernacchi_f(Vc_sh, Vomax_sh, env.Kc[h], env.Ko[h], env.Oi[h]);
 
   //calculate some outputs to be used in VOCE modules
-  out.sunlit.kc = out.shaded.kc = Kc_bernacchi_f(in.leaf_temp);
-  out.sunlit.ko = out.shaded.ko = Ko_bernacchi_f(in.leaf_temp);
-  out.sunlit.oi = out.shaded.oi = Oi_f(in.leaf_temp);
+  out.sunlit.kc = out.shaded.kc = env.Kc[h];
+  out.sunlit.ko = out.shaded.ko = env.Ko[h];
+  out.sunlit.oi = out.shaded.oi = env.Oi[h];
   out.sunlit.comp = gamma_sun; 
   out.shaded.comp = gamma_sh;
-  //out.sunlit.rad = Ic_sun / 4.56 / 0.45 / 0.860; //W m - 2 (glob rad, 1 W m-2 = 4.56 �mol m-2 s-1; PAR = 0.45 * global radiation, 0.860 = adsorberd fraction in JJV model)
+  //out.sunlit.rad = Ic_sun / 4.56 / 0.45 / 0.860; //W m - 2 (glob rad, 1 W m-2 = 4.56 umol m-2 s-1; PAR = 0.45 * global radiation, 0.860 = adsorberd fraction in JJV model)
   //out.shaded.rad = Ic_sh / 4.56 / 0.45 / 0.860; //W m-2
-  double hourly_globrad = in.global_rad * pow(10, 6) / 3600.0; //W m - 2
+  double hourly_globrad = global_rad * 1e6 / 3600.0; //W m - 2
   out.sunlit.rad = hourly_globrad > 0 ? hourly_globrad * Ic_sun / (Ic_sun + Ic_sh): 0.0;
   out.shaded.rad = hourly_globrad > 0 ? hourly_globrad * Ic_sh / (Ic_sun + Ic_sh) : 0.0;
 
@@ -624,19 +650,19 @@ FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvC
     out.sunlit.vcMax = Vc_sun / out.sunlit.LAI; //Vcmax;
     out.sunlit.jMax = Jmax_c_sun / out.sunlit.LAI; //Jmax_bernacchi_f(in.leaf_temp, Vcmax_25*2.1);
     out.sunlit.jj = J_c_sun / out.sunlit.LAI;
-    out.sunlit.jj1000 = J_bernacchi_f(1000, in.leaf_temp, out.sunlit.jMax);
+    out.sunlit.jj1000 = J_bernacchi_f(1000, out.sunlit.jMax, env.theta_ps2[h], env.phi_ps2max[h]);
   }	
   if (out.shaded.LAI > 0)
   {
     out.shaded.vcMax = Vc_sh / out.shaded.LAI;//Vcmax;
     out.shaded.jMax = Jmax_c_sh / out.shaded.LAI; //Jmax_bernacchi_f(in.leaf_temp, Vcmax_25*2.1);
     out.shaded.jj = J_c_sh / out.shaded.LAI;
-    out.shaded.jj1000 = J_bernacchi_f(1000, in.leaf_temp, out.shaded.jMax);
+    out.shaded.jj1000 = J_bernacchi_f(1000, out.shaded.jMax, env.theta_ps2[h], env.phi_ps2max[h]);
   }
   
   //6.1.2 x1, x2 rubisco
-  std::tuple<double, double> x1_x2_rub_sun = x_rubisco(in.leaf_temp, Vc_sun);
-  std::tuple<double, double> x1_x2_rub_sh = x_rubisco(in.leaf_temp, Vc_sh);
+  std::tuple<double, double> x1_x2_rub_sun = x_rubisco(Vc_sun, env.Kc[h], env.Ko[h], env.Oi[h]);
+  std::tuple<double, double> x1_x2_rub_sh = x_rubisco(Vc_sh, env.Kc[h], env.Ko[h], env.Oi[h]);
 
   //6.1.2 x1, x2 electron
   std::tuple<double, double> x1_x2_el_sun = x_electron(J_c_sun, gamma_sun);
@@ -651,7 +677,7 @@ FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvC
   double gm_sun = gm_t * out.sunlit.LAI;
   double gm_sh = gm_t * out.shaded.LAI;
 
-  if (in.global_rad <= 0.0)
+  if (global_rad <= 0.0)
   {
     //handle cases where no photosynthesis can occur
     out.canopy_gross_photos = 0.0;
@@ -662,7 +688,7 @@ FvCB_canopy_hourly_out FvCB::FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvC
   else
   {
     //6.1.4 fVPD
-    double fVPD = fVPD_f(in.VPD);
+    double fVPD = fVPD_f(in.VPD[h]);
 
     //6.2 calculate lumped coeffs (sun/shade)
     Lumped_Coeffs lumped_rub_sun = calculate_lumped_coeffs(std::get<0>(x1_x2_rub_sun), std::get<1>(x1_x2_rub_sun), fVPD, in.Ca, gamma_sun, Rd_sun, g0_sun, gm_sun, gb_sun);
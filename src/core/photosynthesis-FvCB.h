@@ -16,15 +16,18 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #pragma once
 
-#include <map>
-#include <vector>
+#include <array>
+#include <cstddef>
 #include <cmath>
 
 namespace FvCB {
   
 enum FvCB_Model_Consts { Rd = 0, Vcmax, Vomax, Gamma, Kc, Ko, Jmax };
-extern std::map<FvCB_Model_Consts, double> c_bernacchi;// = {{ Rd, 18.72},{ Vcmax, 26.35 },{ Vomax, 22.98 },{ Gamma, 19.02 },{ Kc, 38.05 },{ Ko, 20.30 }, { Jmax, 17.57 }}; //dimensionless
-extern std::map<FvCB_Model_Consts, double> deltaH_bernacchi;// = {{ Rd, 46.39 },{ Vcmax, 65.33 },{ Vomax, 60.11 },{ Gamma, 37.83 },{ Kc, 79.43 },{ Ko, 36.38 },{ Jmax, 43.54 }}; //kJ mol - 1
+//indexed by FvCB_Model_Consts
+inline constexpr double c_bernacchi[] = { 18.72, 26.35, 22.98, 19.02, 38.05, 20.30, 17.57 }; //dimensionless
+inline constexpr double deltaH_bernacchi[] = { 46.39, 65.33, 60.11, 37.83, 79.43, 36.38, 43.54 }; //kJ mol - 1
+
+constexpr std::size_t HOURS_PER_DAY = 24;
   
 struct FvCB_canopy_hourly_params {
   double Vcmax_25;
@@ -34,13 +37,14 @@ struct FvCB_canopy_hourly_params {
   double gm_25 = { 0.10125 }; //mesophyll conductance (C3) at 25�C, mol m-2 s-1 bar-1
 };
 
-struct FvCB_canopy_hourly_in {
-  double global_rad; //MJ m-2 h-1
-  double extra_terr_rad; //MJ m - 2 h - 1
-  double solar_el; //radians
+//inputs for all hours of a day, the LAI and CO2 are assumed to be constant over the day
+struct FvCB_canopy_daily_in {
+  std::array<double, HOURS_PER_DAY> global_rad; //MJ m-2 h-1
+  std::array<double, HOURS_PER_DAY> extra_terr_rad; //MJ m - 2 h - 1
+  std::array<double, HOURS_PER_DAY> solar_el; //radians
+  std::array<double, HOURS_PER_DAY> leaf_temp; //�C
+  std::array<double, HOURS_PER_DAY> VPD; //KPa
   double LAI; //m2 m-2
-  double leaf_temp; //�C
-  double VPD; //KPa
   double Ca; //ambient CO2 partial pressure, �bar or �mol mol-1
   //double fO3 = { 1.0 }; //effect of high ozone fluxes on rubisco-limited photosynthesis
   //double fls = { 1.0 }; //effect of senescence on rubisco-limited photosynthesis, modified by cumulative ozone uptake 
@@ -72,7 +76,30 @@ struct FvCB_canopy_hourly_out {
   FvCB_leaf_fraction shaded;
 };
 
-FvCB_canopy_hourly_out FvCB_canopy_hourly_C3(FvCB_canopy_hourly_in in, FvCB_canopy_hourly_params par);
+//the parts of the model which depend only on the (daily known) light and temperature course,
+//evaluated for all hours (and sun/shade leaves) of a day at once
+struct FvCB_canopy_daily_env {
+  std::array<double, HOURS_PER_DAY> Ic_sun; //umol m - 2 s - 1 (unit ground area)
+  std::array<double, HOURS_PER_DAY> Ic_sh; //umol m - 2 s - 1 (unit ground area)
+  std::array<double, HOURS_PER_DAY> LAI_sun; //m2 m-2
+  std::array<double, HOURS_PER_DAY> LAI_sh; //m2 m-2
+  //temperature responses (Bernacchi), the ones for Vcmax, Vomax and Jmax have still to be multiplied by the value at 25oC
+  std::array<double, HOURS_PER_DAY> Vcmax_T;
+  std::array<double, HOURS_PER_DAY> Vomax_T;
+  std::array<double, HOURS_PER_DAY> Jmax_T;
+  std::array<double, HOURS_PER_DAY> Rd; //umol m - 2 s - 1 (unit leaf area)
+  std::array<double, HOURS_PER_DAY> Kc;
+  std::array<double, HOURS_PER_DAY> Ko;
+  std::array<double, HOURS_PER_DAY> Oi;
+  std::array<double, HOURS_PER_DAY> theta_ps2;
+  std::array<double, HOURS_PER_DAY> phi_ps2max;
+};
+
+FvCB_canopy_daily_env FvCB_canopy_daily_env_f(const FvCB_canopy_daily_in& in);
+
+//the hourly photosynthesis/stomatal conductance for hour h, par may change from hour to hour (e.g. due to O3 damage)
+FvCB_canopy_hourly_out FvCB_canopy_hourly_C3(const FvCB_canopy_daily_in& in, const FvCB_canopy_daily_env& env,
+                                             std::size_t h, FvCB_canopy_hourly_params par);
 double Jmax_bernacchi_f(double leafT, double Jmax_25);
 double Vcmax_bernacchi_f(double leafT, double Vcmax_25);
 
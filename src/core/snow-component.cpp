@@ -37,7 +37,7 @@ using namespace monica;
    * user data base are initialized.
    */
 SnowComponent::SnowComponent(SoilColumn& sc, const SoilMoistureModuleParameters& smps)
-  : soilColumn(sc)
+  : soilColumn(&sc)
   , vm_SnowmeltTemperature(smps.pm_SnowMeltTemperature) // Base temperature for snowmelt [°C]
   , vm_SnowAccumulationThresholdTemperature(smps.pm_SnowAccumulationTresholdTemperature)
   , vm_TemperatureLimitForLiquidWater(smps.pm_TemperatureLimitForLiquidWater) // Lower temperature limit of liquid water in snow
@@ -373,6 +373,6 @@ SnowComponent::calcSnowDepth(double snow_water_equivalent) {
     vm_LiquidWaterInSnow = 0.0;
   }
 
-  soilColumn.vm_SnowDepth = vm_SnowDepth;
+  soilColumn->vm_SnowDepth = vm_SnowDepth;
   vm_AccumulatedSnowDepth += vm_SnowDepth;
 }
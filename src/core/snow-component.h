@@ -31,7 +31,10 @@ public:
   SnowComponent(SoilColumn& sc, const SoilMoistureModuleParameters& smps);
   ~SnowComponent() {}
 
-  SnowComponent(SoilColumn& sc, mas::schema::model::monica::SnowModuleState::Reader reader) : soilColumn(sc) { deserialize(reader); }
+  SnowComponent(SoilColumn& sc, mas::schema::model::monica::SnowModuleState::Reader reader) : soilColumn(&sc) { deserialize(reader); }
+
+  //! copy of other bound to the soil column sc (of a copied model)
+  SnowComponent(const SnowComponent& other, SoilColumn& sc) : SnowComponent(other) { soilColumn = &sc; }
   void deserialize(mas::schema::model::monica::SnowModuleState::Reader reader);
   void serialize(mas::schema::model::monica::SnowModuleState::Builder builder) const;
 
@@ -52,7 +55,7 @@ private:
   double calcPotentialInfiltration(double net_precipitation, double snow_layer_water_release, double snow_depth);
   void calcSnowDepth(double snow_water_equivalent);
 
-  SoilColumn& soilColumn;
+  SoilColumn* soilColumn;
 
   double vm_SnowDensity{ 0.0 }; //!< Snow density [kg dm-3]
   double vm_SnowDepth{ 0.0 }; //!< Snow depth [mm]
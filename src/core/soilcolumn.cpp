@@ -95,8 +95,9 @@ void AOM_Properties::serialize(mas::schema::model::monica::AOMProperties::Builde
  * @param sps Soil parameters
  */
 SoilLayer::SoilLayer(double vs_LayerThickness,
-                     const SoilParameters &sps)
-    : vs_LayerThickness(vs_LayerThickness), vs_SoilNH4(sps.vs_SoilAmmonium), vs_SoilNO3(sps.vs_SoilNitrate), _sps(sps),
+                     const SoilParameters &sps,
+                     const allocator_type &alloc)
+    : vs_LayerThickness(vs_LayerThickness), vo_AOM_Pool(alloc), vs_SoilNH4(sps.vs_SoilAmmonium), vs_SoilNO3(sps.vs_SoilNitrate), _sps(sps),
       vs_SoilMoisture_m3(sps.vs_FieldCapacity * sps.vs_SoilMoisturePercentFC / 100.0)
 //, vs_SoilMoistureOld_m3(sps.vs_FieldCapacity * sps.vs_SoilMoisturePercentFC / 100.0)
 {
@@ -204,12 +205,14 @@ double SoilLayer::vs_SoilMoisture_pF() {
  */
 SoilColumn::SoilColumn(double ps_LayerThickness,
                        double ps_MaxMineralisationDepth,
-                       const SoilPMs &soilParams)//,
+                       const SoilPMs &soilParams,
+                       std::pmr::memory_resource *mr)//,
                        //double pm_CriticalMoistureDepth)
-    : ps_MaxMineralisationDepth(ps_MaxMineralisationDepth) {
+    : std::pmr::vector<SoilLayer>(mr), ps_MaxMineralisationDepth(ps_MaxMineralisationDepth) {
     //, pm_CriticalMoistureDepth(pm_CriticalMoistureDepth) {
   debug() << "Constructor: SoilColumn " << soilParams.size() << endl;
-  for (const auto& sp: soilParams) push_back(SoilLayer(ps_LayerThickness, sp));
+  reserve(soilParams.size());
+  for (const auto& sp: soilParams) emplace_back(ps_LayerThickness, sp);
 
   _vs_NumberOfOrganicLayers = calculateNumberOfOrganicLayers();
 }
@@ -32,6 +32,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <vector>
 #include <list>
 #include <iostream>
+#include <functional>
+#include <memory_resource>
 #include <assert.h>
 
 #include "model/monica/monica_state.capnp.h"
@@ -61,8 +63,8 @@ struct AOM_Properties {
 
   void serialize(mas::schema::model::monica::AOMProperties::Builder builder) const;
 
-  double vo_AOM_Slow{0.0}; //!< C content in slowly decomposing added organic matter pool [kgC m-3]
-  double vo_AOM_Fast{0.0}; //!< C content in rapidly decomposing added organic matter pool [kgC m-3]
+  StateReal vo_AOM_Slow{0.0}; //!< C content in slowly decomposing added organic matter pool [kgC m-3]
+  StateReal vo_AOM_Fast{0.0}; //!< C content in rapidly decomposing added organic matter pool [kgC m-3]
 
   double vo_AOM_SlowDecRate_to_SMB_Slow{0.0}; //!< Rate for slow AOM consumed by SMB Slow is calculated.
   double vo_AOM_SlowDecRate_to_SMB_Fast{0.0}; //!< Rate for slow AOM consumed by SMB Fast is calculated.
@@ -107,14 +109,31 @@ struct AOM_Properties {
  */
 class SoilLayer {
 public:
-  SoilLayer() {}
+  //! the layers pass the memory resource of their soil column on to their AOM pools
+  using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+  SoilLayer() = default;
+
+  explicit SoilLayer(const allocator_type &alloc) : vo_AOM_Pool(alloc) {}
 
 //    SoilLayer(const UserInitialValues* initParams);
 
   SoilLayer(double vs_LayerThickness,
-            const Soil::SoilParameters &soilParams);
+            const Soil::SoilParameters &soilParams,
+            const allocator_type &alloc = {});
+
+  SoilLayer(mas::schema::model::monica::SoilLayerState::Reader reader, const allocator_type &alloc = {})
+      : vo_AOM_Pool(alloc) { deserialize(reader); }
+
+  SoilLayer(const SoilLayer &other) = default;
+  SoilLayer(SoilLayer &&other) = default;
 
-  SoilLayer(mas::schema::model::monica::SoilLayerState::Reader reader) { deserialize(reader); }
+  SoilLayer(const SoilLayer &other, const allocator_type &alloc) : vo_AOM_Pool(alloc) { *this = other; }
+  SoilLayer(SoilLayer &&other, const allocator_type &alloc) : vo_AOM_Pool(alloc) { *this = std::move(other); }
+
+  //! assignment keeps the memory resource of the AOM pool
+  SoilLayer &operator=(const SoilLayer &other) = default;
+  SoilLayer &operator=(SoilLayer &&other) = default;
 
   void deserialize(mas::schema::model::monica::SoilLayerState::Reader reader);
 
@@ -189,25 +208,25 @@ public:
   //double vs_SoilMoistureOld_m3{0.25}; //!< Soil layer's moisture content of previous day [m3 m-3]
   double vs_SoilWaterFlux{0.0}; //!< Water flux at the upper boundary of the soil layer [l m-2]
 
-  std::vector<AOM_Properties> vo_AOM_Pool; //!< List of different added organic matter pools in soil layer
+  std::pmr::vector<AOM_Properties> vo_AOM_Pool; //!< List of different added organic matter pools in soil layer
 
-  double vs_SOM_Slow{0.0}; //!< C content of soil organic matter slow pool [kg C m-3]
-  double vs_SOM_Fast{0.0}; //!< C content of soil organic matter fast pool size [kg C m-3]
-  double vs_SMB_Slow{0.0}; //!< C content of soil microbial biomass slow pool size [kg C m-3]
-  double vs_SMB_Fast{0.0}; //!< C content of soil microbial biomass fast pool size [kg C m-3]
+  StateReal vs_SOM_Slow{0.0}; //!< C content of soil organic matter slow pool [kg C m-3]
+  StateReal vs_SOM_Fast{0.0}; //!< C content of soil organic matter fast pool size [kg C m-3]
+  StateReal vs_SMB_Slow{0.0}; //!< C content of soil microbial biomass slow pool size [kg C m-3]
+  StateReal vs_SMB_Fast{0.0}; //!< C content of soil microbial biomass fast pool size [kg C m-3]
 
   // anorganische Stickstoff-Formen
-  double vs_SoilCarbamid{0.0}; //!< Soil layer's carbamide-N content [kg Carbamide-N m-3]
-  double vs_SoilNH4{0.0001}; //!< Soil layer's NH4-N content [kg NH4-N m-3]
-  double vs_SoilNO2{0.001}; //!< Soil layer's NO2-N content [kg NO2-N m-3]
-  double vs_SoilNO3{0.0001}; //!< Soil layer's NO3-N content [kg NO3-N m-3]
+  StateReal vs_SoilCarbamid{0.0}; //!< Soil layer's carbamide-N content [kg Carbamide-N m-3]
+  StateReal vs_SoilNH4{0.0001}; //!< Soil layer's NH4-N content [kg NH4-N m-3]
+  StateReal vs_SoilNO2{0.001}; //!< Soil layer's NO2-N content [kg NO2-N m-3]
+  StateReal vs_SoilNO3{0.0001}; //!< Soil layer's NO3-N content [kg NO3-N m-3]
   bool vs_SoilFrozen{false};
 
 private:
   Soil::SoilParameters _sps;
 
-  double vs_SoilMoisture_m3{0.25}; //!< Soil layer's moisture content [m3 m-3]
-  double vs_SoilTemperature{0.0}; //!< Soil layer's temperature [°C]
+  StateReal vs_SoilMoisture_m3{0.25}; //!< Soil layer's moisture content [m3 m-3]
+  StateReal vs_SoilTemperature{0.0}; //!< Soil layer's temperature [°C]
 };
 
 //----------------------------------------------------------------------------
@@ -224,15 +243,25 @@ private:
   * @see Monica::SoilLayer
   *
   */
-class SoilColumn : public std::vector<SoilLayer> {
+class SoilColumn : public std::pmr::vector<SoilLayer> {
 public:
+  //! @param mr memory resource of the layers and their AOM pools (e.g. the pool of a run), has to outlive the column
   SoilColumn(double ps_LayerThickness,
              double ps_MaxMineralisationDepth,
-             const Soil::SoilPMs &soilParams);//,
+             const Soil::SoilPMs &soilParams,
+             std::pmr::memory_resource *mr = std::pmr::get_default_resource());//,
              //double pm_CriticalMoistureDepth);
 
-  SoilColumn(mas::schema::model::monica::SoilColumnState::Reader reader, CropModule *cropModule = nullptr)
-      : cropModule(cropModule) { deserialize(reader); }
+  SoilColumn(mas::schema::model::monica::SoilColumnState::Reader reader, CropModule *cropModule = nullptr,
+             std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+      : std::pmr::vector<SoilLayer>(mr), cropModule(cropModule) { deserialize(reader); }
+
+  //! copy of other with the layers drawing from mr, without a crop (see putCrop)
+  SoilColumn(const SoilColumn &other, std::pmr::memory_resource *mr)
+      : std::pmr::vector<SoilLayer>(mr) {
+    *this = other;
+    cropModule = nullptr;
+  }
 
   void deserialize(mas::schema::model::monica::SoilColumnState::Reader reader);
 
@@ -267,6 +296,13 @@ public:
 
   inline size_t vs_NumberOfLayers() const { return size(); }
 
+  //! writes a per layer variable of the layers [from, to] contiguously as doubles to into (room for to - from + 1),
+  //! e.g. layerValues(&SoilLayer::get_SoilNO3, 0, 19, into), to read a whole slice of the column in one pass
+  template<typename Get>
+  void layerValues(Get get, size_t from, size_t to, double *into) const {
+    for (auto i = from; i <= to; i++) *into++ = double(std::invoke(get, (*this)[i]));
+  }
+
   void applyTillage(double depth);
 
   /**
@@ -41,14 +41,14 @@ using namespace Tools;
  * @param mm Monica model
  */
 SoilMoisture::SoilMoisture(MonicaModel& mm, const SoilMoistureModuleParameters& smPs)
-  : soilColumn(mm.soilColumnNC())
-  , siteParameters(mm.siteParameters())
-  , monica(mm)
+  : soilColumn(&mm.soilColumnNC())
+  , siteParameters(&mm.siteParameters())
+  , monica(&mm)
   , _params(smPs)
-  , envPs(mm.environmentParameters())
-  , cropPs(mm.cropParameters())
-  , numberOfMoistureLayers(soilColumn.vs_NumberOfLayers() + 1)
-  , numberOfSoilLayers(soilColumn.vs_NumberOfLayers()) //extern
+  , envPs(&mm.environmentParameters())
+  , cropPs(&mm.cropParameters())
+  , numberOfMoistureLayers(soilColumn->vs_NumberOfLayers() + 1)
+  , numberOfSoilLayers(soilColumn->vs_NumberOfLayers()) //extern
   , vm_AvailableWater(numberOfMoistureLayers, 0.0) // Soil available water in [mm]
   , pm_CapillaryRiseRate(numberOfMoistureLayers, 0.0)
   , vm_CapillaryWater(numberOfMoistureLayers, 0.0) // soil capillary water in [mm]
@@ -60,7 +60,7 @@ SoilMoisture::SoilMoisture(MonicaModel& mm, const SoilMoistureModuleParameters&
 //, vm_GroundwaterDistance(vm_NumberOfLayers, 0), // map (joachim)
 , vm_HeatConductivity(numberOfMoistureLayers, 0)
 , vm_Lambda(numberOfMoistureLayers, 0.0)
-, vs_Latitude(siteParameters.vs_Latitude)
+, vs_Latitude(siteParameters->vs_Latitude)
 , vm_LayerThickness(numberOfMoistureLayers, 0.01)
 , vm_PermanentWiltingPoint(numberOfMoistureLayers, 0.0)
 , vm_PercolationRate(numberOfMoistureLayers, 0.0) // Percolation rate in [mm d-1] //intern
@@ -69,16 +69,16 @@ SoilMoisture::SoilMoisture(MonicaModel& mm, const SoilMoistureModuleParameters&
 , vm_SoilPoreVolume(numberOfMoistureLayers, 0.0)
 , vm_Transpiration(numberOfMoistureLayers, 0.0) //intern
 , vm_WaterFlux(numberOfMoistureLayers, 0.0)
-, snowComponent(kj::heap<SnowComponent>(soilColumn, smPs))
-, frostComponent(kj::heap<FrostComponent>(soilColumn, smPs.pm_HydraulicConductivityRedux, envPs.p_timeStep)) {
+, snowComponent(*soilColumn, smPs)
+, frostComponent(*soilColumn, smPs.pm_HydraulicConductivityRedux, envPs->p_timeStep) {
   debug() << "Constructor: SoilMoisture" << endl;
 
   vm_HydraulicConductivityRedux = smPs.pm_HydraulicConductivityRedux;
-  pt_TimeStep = envPs.p_timeStep;
+  pt_TimeStep = envPs->p_timeStep;
   vm_SurfaceRoughness = smPs.pm_SurfaceRoughness;
   vm_GroundwaterDischarge = smPs.pm_GroundwaterDischarge;
   pm_MaxPercolationRate = smPs.pm_MaxPercolationRate;
-  pm_LeachingDepth = envPs.p_LeachingDepth;
+  pm_LeachingDepth = envPs->p_LeachingDepth;
 
   //  cout << "pm_LeachingDepth:\t" << pm_LeachingDepth << endl;
   pm_LayerThickness = mm.simulationParameters().p_LayerThickness;
@@ -107,15 +107,29 @@ SoilMoisture::SoilMoisture(MonicaModel& mm, const SoilMoistureModuleParameters&
 }
 
 SoilMoisture::SoilMoisture(MonicaModel& mm, mas::schema::model::monica::SoilMoistureModuleState::Reader reader, CropModule* cropModule)
-  : soilColumn(mm.soilColumnNC())
-  , siteParameters(mm.siteParameters())
-  , monica(mm)
-  , envPs(mm.environmentParameters())
-  , cropPs(mm.cropParameters())
+  : soilColumn(&mm.soilColumnNC())
+  , siteParameters(&mm.siteParameters())
+  , monica(&mm)
+  , envPs(&mm.environmentParameters())
+  , cropPs(&mm.cropParameters())
+  , snowComponent(*soilColumn, reader.getSnowComponent())
+  , frostComponent(*soilColumn, reader.getFrostComponent())
   , cropModule(cropModule) {
   deserialize(reader);
 }
 
+SoilMoisture::SoilMoisture(const SoilMoisture& other, MonicaModel& mm, CropModule* cropModule)
+  : SoilMoisture(other) {
+  soilColumn = &mm.soilColumnNC();
+  siteParameters = &mm.siteParameters();
+  monica = &mm;
+  envPs = &mm.environmentParameters();
+  cropPs = &mm.cropParameters();
+  snowComponent = SnowComponent(other.snowComponent, *soilColumn);
+  frostComponent = FrostComponent(other.frostComponent, *soilColumn);
+  this->cropModule = cropModule;
+}
+
 void SoilMoisture::deserialize(mas::schema::model::monica::SoilMoistureModuleState::Reader reader) {
   _params.deserialize(reader.getModuleParams());
   numberOfMoistureLayers = reader.getNumberOfLayers();
@@ -171,8 +185,8 @@ void SoilMoisture::deserialize(mas::schema::model::monica::SoilMoistureModuleSta
   setFromCapnpList(vm_Transpiration, reader.getTranspiration());
   setFromCapnpList(vm_WaterFlux, reader.getWaterFlux());
   vm_XSACriticalSoilMoisture = reader.getXSACriticalSoilMoisture();
-  if(reader.hasSnowComponent()) snowComponent = kj::heap<SnowComponent>(soilColumn, reader.getSnowComponent());
-  if (reader.hasFrostComponent()) frostComponent = kj::heap<FrostComponent>(soilColumn, reader.getFrostComponent());
+  if (reader.hasSnowComponent()) snowComponent.deserialize(reader.getSnowComponent());
+  if (reader.hasFrostComponent()) frostComponent.deserialize(reader.getFrostComponent());
 }
 
 void SoilMoisture::serialize(mas::schema::model::monica::SoilMoistureModuleState::Builder builder) const {
@@ -230,8 +244,8 @@ void SoilMoisture::serialize(mas::schema::model::monica::SoilMoistureModuleState
   setCapnpList(vm_Transpiration, builder.initTranspiration((capnp::uint)vm_Transpiration.size()));
   setCapnpList(vm_WaterFlux, builder.initWaterFlux((capnp::uint)vm_WaterFlux.size()));
   builder.setXSACriticalSoilMoisture(vm_XSACriticalSoilMoisture);
-  if (snowComponent) snowComponent->serialize(builder.initSnowComponent());
-  if (frostComponent) frostComponent->serialize(builder.initFrostComponent());
+  snowComponent.serialize(builder.initSnowComponent());
+  frostComponent.serialize(builder.initFrostComponent());
 }
 
 /*!
@@ -258,36 +272,36 @@ void SoilMoisture::step(double vs_GroundwaterDepth,
   double vw_ReferenceEvapotranspiration) {
   for (int i = 0; i < numberOfSoilLayers; i++) {
     // initialization with moisture values stored in the layer
-    vm_SoilMoisture[i] = soilColumn[i].get_Vs_SoilMoisture_m3();
+    vm_SoilMoisture[i] = (*soilColumn)[i].get_Vs_SoilMoisture_m3();
     vm_WaterFlux[i] = 0.0;
-    vm_FieldCapacity[i] = soilColumn[i].vs_FieldCapacity();
-    vm_SoilPoreVolume[i] = soilColumn[i].vs_Saturation();
-    vm_PermanentWiltingPoint[i] = soilColumn[i].vs_PermanentWiltingPoint();
-    vm_LayerThickness[i] = soilColumn[i].vs_LayerThickness;
-    vm_Lambda[i] = soilColumn[i].vs_Lambda();
+    vm_FieldCapacity[i] = (*soilColumn)[i].vs_FieldCapacity();
+    vm_SoilPoreVolume[i] = (*soilColumn)[i].vs_Saturation();
+    vm_PermanentWiltingPoint[i] = (*soilColumn)[i].vs_PermanentWiltingPoint();
+    vm_LayerThickness[i] = (*soilColumn)[i].vs_LayerThickness;
+    vm_Lambda[i] = (*soilColumn)[i].vs_Lambda();
   }
 
-  vm_SoilMoisture[numberOfMoistureLayers - 1] = soilColumn[numberOfMoistureLayers - 2].get_Vs_SoilMoisture_m3();
+  vm_SoilMoisture[numberOfMoistureLayers - 1] = (*soilColumn)[numberOfMoistureLayers - 2].get_Vs_SoilMoisture_m3();
   vm_WaterFlux[numberOfMoistureLayers - 1] = 0.0;
-  vm_FieldCapacity[numberOfMoistureLayers - 1] = soilColumn[numberOfMoistureLayers - 2].vs_FieldCapacity();
-  vm_SoilPoreVolume[numberOfMoistureLayers - 1] = soilColumn[numberOfMoistureLayers - 2].vs_Saturation();
-  vm_LayerThickness[numberOfMoistureLayers - 1] = soilColumn[numberOfMoistureLayers - 2].vs_LayerThickness;
-  vm_Lambda[numberOfMoistureLayers - 1] = soilColumn[numberOfMoistureLayers - 2].vs_Lambda();
+  vm_FieldCapacity[numberOfMoistureLayers - 1] = (*soilColumn)[numberOfMoistureLayers - 2].vs_FieldCapacity();
+  vm_SoilPoreVolume[numberOfMoistureLayers - 1] = (*soilColumn)[numberOfMoistureLayers - 2].vs_Saturation();
+  vm_LayerThickness[numberOfMoistureLayers - 1] = (*soilColumn)[numberOfMoistureLayers - 2].vs_LayerThickness;
+  vm_Lambda[numberOfMoistureLayers - 1] = (*soilColumn)[numberOfMoistureLayers - 2].vs_Lambda();
 
-  vm_SurfaceWaterStorage = soilColumn.vs_SurfaceWaterStorage;
+  vm_SurfaceWaterStorage = soilColumn->vs_SurfaceWaterStorage;
 
   bool vc_CropPlanted = false;
   double vc_CropHeight = 0.0;
   int vc_DevelopmentalStage = 0;
 
-  if (monica.cropGrowth()) {
+  if (monica->cropGrowth()) {
     vc_CropPlanted = true;
-    vc_PercentageSoilCoverage = monica.cropGrowth()->get_SoilCoverage();
-    vc_KcFactor = monica.cropGrowth()->get_KcFactor();
-    vc_CropHeight = monica.cropGrowth()->get_CropHeight();
-    vc_DevelopmentalStage = (int)monica.cropGrowth()->get_DevelopmentalStage();
+    vc_PercentageSoilCoverage = monica->cropGrowth()->get_SoilCoverage();
+    vc_KcFactor = monica->cropGrowth()->get_KcFactor();
+    vc_CropHeight = monica->cropGrowth()->get_CropHeight();
+    vc_DevelopmentalStage = (int)monica->cropGrowth()->get_DevelopmentalStage();
     if (vc_DevelopmentalStage > 0) {
-      vc_NetPrecipitation = monica.cropGrowth()->get_NetPrecipitation();
+      vc_NetPrecipitation = monica->cropGrowth()->get_NetPrecipitation();
     } else {
       vc_NetPrecipitation = vw_Precipitation;
     }
@@ -303,20 +317,20 @@ void SoilMoisture::step(double vs_GroundwaterDepth,
   int i = int(numberOfSoilLayers - 1);
   while (i >= 0 && int(vm_SoilMoisture[i]*10000) == int(vm_SoilPoreVolume[i]*10000)) vm_GroundwaterTableLayer = i--;
 
-  auto oscillGroundWaterLayer = size_t(vs_GroundwaterDepth / soilColumn[0].vs_LayerThickness);
+  auto oscillGroundWaterLayer = size_t(vs_GroundwaterDepth / (*soilColumn)[0].vs_LayerThickness);
   if ((vm_GroundwaterTableLayer > oscillGroundWaterLayer && vm_GroundwaterTableLayer < numberOfSoilLayers + 2)
       || vm_GroundwaterTableLayer >= numberOfSoilLayers + 2) {
     vm_GroundwaterTableLayer = oscillGroundWaterLayer;
   }
 
-  soilColumn.vm_GroundwaterTableLayer = vm_GroundwaterTableLayer;
+  soilColumn->vm_GroundwaterTableLayer = vm_GroundwaterTableLayer;
 
   // calculates snow layer water storage and release
-  snowComponent->calcSnowLayer(vw_MeanAirTemperature, vc_NetPrecipitation);
-  double vm_WaterToInfiltrate = snowComponent->getWaterToInfiltrate();
+  snowComponent.calcSnowLayer(vw_MeanAirTemperature, vc_NetPrecipitation);
+  double vm_WaterToInfiltrate = snowComponent.getWaterToInfiltrate();
 
   // Calculates frost and thaw depth and switches lambda
-  frostComponent->calcSoilFrost(vw_MeanAirTemperature, snowComponent->getVm_SnowDepth());
+  frostComponent.calcSoilFrost(vw_MeanAirTemperature, snowComponent.getVm_SnowDepth());
 
   // calculates infiltration of water from surface
   fm_Infiltration(vm_WaterToInfiltrate);
@@ -329,20 +343,20 @@ void SoilMoisture::step(double vs_GroundwaterDepth,
     fm_BackwaterReplenishment();
   }
 
-  fm_Evapotranspiration(vc_PercentageSoilCoverage, vc_KcFactor, siteParameters.vs_HeightNN, vw_MaxAirTemperature,
+  fm_Evapotranspiration(vc_PercentageSoilCoverage, vc_KcFactor, siteParameters->vs_HeightNN, vw_MaxAirTemperature,
     vw_MinAirTemperature, vw_RelativeHumidity, vw_MeanAirTemperature, vw_WindSpeed, vw_WindSpeedHeight,
     vw_GlobalRadiation, vc_DevelopmentalStage, vs_JulianDay, vs_Latitude, vw_ReferenceEvapotranspiration);
 
   fm_CapillaryRise();
 
   for (int i_Layer = 0; i_Layer < numberOfSoilLayers; i_Layer++) {
-    soilColumn[i_Layer].set_Vs_SoilMoisture_m3(vm_SoilMoisture[i_Layer]);
-    soilColumn[i_Layer].vs_SoilWaterFlux = vm_WaterFlux[i_Layer];
+    (*soilColumn)[i_Layer].set_Vs_SoilMoisture_m3(vm_SoilMoisture[i_Layer]);
+    (*soilColumn)[i_Layer].vs_SoilWaterFlux = vm_WaterFlux[i_Layer];
     //commented out because old calc_vs_SoilMoisture_pF algorithm is calcualted every time vs_SoilMoisture_pF is accessed
 //    soilColumn[i_Layer].calc_vs_SoilMoisture_pF();
   }
-  soilColumn.vs_SurfaceWaterStorage = vm_SurfaceWaterStorage;
-  soilColumn.vs_FluxAtLowerBoundary = vm_FluxAtLowerBoundary;
+  soilColumn->vs_SurfaceWaterStorage = vm_SurfaceWaterStorage;
+  soilColumn->vs_FluxAtLowerBoundary = vm_FluxAtLowerBoundary;
 }
 
 /*!
@@ -384,7 +398,7 @@ void SoilMoisture::fm_Infiltration(double vm_WaterToInfiltrate) {
 
     /** @todo <b>Claas:</b> Mathematischer Sinn ist zu überprüfen */
     vm_Infiltration = min(vm_Infiltration, ((vm_SoilPoreVolume[0] - vm_SoilMoisture[0]) * 1000.0
-      * soilColumn[0].vs_LayerThickness));
+      * (*soilColumn)[0].vs_LayerThickness));
 
     // Limitation of airfilled pore space added to prevent water contents
     // above pore space in layers below (Claas Nendel)
@@ -400,24 +414,24 @@ void SoilMoisture::fm_Infiltration(double vm_WaterToInfiltrate) {
   }
 
   // Calculating overflow due to water level exceeding surface roughness [mm]
-  if (vm_SurfaceWaterStorage > (10.0 * vm_SurfaceRoughness / (siteParameters.vs_Slope + 0.001))) {
+  if (vm_SurfaceWaterStorage > (10.0 * vm_SurfaceRoughness / (siteParameters->vs_Slope + 0.001))) {
     // Calculating surface run-off driven by slope and altered by surface roughness and soil coverage
     // minimal slope at which water will be run off the surface
     auto vm_RunOffFactor = 0.02 + (vm_SurfaceRoughness / 4.0) + (vc_PercentageSoilCoverage / 15.0);
-    if (siteParameters.vs_Slope < 0.0 || siteParameters.vs_Slope > 1.0) {
+    if (siteParameters->vs_Slope < 0.0 || siteParameters->vs_Slope > 1.0) {
       // no valid slope
       cerr << "Slope value out ouf boundary" << endl;
-    } else if (siteParameters.vs_Slope == 0.0) {
+    } else if (siteParameters->vs_Slope == 0.0) {
 
       // no slope so there will be no loss of water
       vm_SurfaceRunOff = 0.0;
-    } else if (siteParameters.vs_Slope > vm_RunOffFactor) {
+    } else if (siteParameters->vs_Slope > vm_RunOffFactor) {
       // add all water from the surface to the run-off storage
       vm_SurfaceRunOff += vm_SurfaceWaterStorage;
     } else {
       // some water is running off because of a sloped surface
       /** @todo Claas: Ist die Formel korrekt? vm_RunOffFactor wird einmal reduziert? */
-      vm_SurfaceRunOff += ((siteParameters.vs_Slope * vm_RunOffFactor) / (vm_RunOffFactor * vm_RunOffFactor)) * vm_SurfaceWaterStorage;
+      vm_SurfaceRunOff += ((siteParameters->vs_Slope * vm_RunOffFactor) / (vm_RunOffFactor * vm_RunOffFactor)) * vm_SurfaceWaterStorage;
     }
 
     // Update surface water storage
@@ -433,7 +447,7 @@ void SoilMoisture::fm_Infiltration(double vm_WaterToInfiltrate) {
   // Calculating excess soil moisture (water content exceeding field capacity) for percolation
   if (vm_SoilMoisture[0] > vm_FieldCapacity[0]) {
     vm_GravitationalWater[0] = (vm_SoilMoisture[0] - vm_FieldCapacity[0]) * 1000.0 * vm_LayerThickness[0];
-    auto vm_LambdaReduced = vm_Lambda[0] * frostComponent->getLambdaRedux(0);
+    auto vm_LambdaReduced = vm_Lambda[0] * frostComponent.getLambdaRedux(0);
     auto vm_PercolationFactor = 1 + vm_LambdaReduced * vm_GravitationalWater[0];
     vm_PercolationRate[0] = (vm_GravitationalWater[0] * vm_GravitationalWater[0] * vm_LambdaReduced)
         / vm_PercolationFactor;
@@ -483,7 +497,7 @@ void SoilMoisture::fm_Infiltration(double vm_WaterToInfiltrate) {
  * @param layer Index of layer
  */
 double SoilMoisture::get_SoilMoisture(int layer) const {
-  return soilColumn[layer].get_Vs_SoilMoisture_m3();
+  return (*soilColumn)[layer].get_Vs_SoilMoisture_m3();
 }
 
 /**
@@ -543,7 +557,7 @@ void SoilMoisture::fm_CapillaryRise() {
     // Find first layer above groundwater with 70% available water
     auto vm_StartLayer = min(vm_GroundwaterTableLayer, (numberOfSoilLayers - 1));
     for (int i = int(vm_StartLayer); i >= 0; i--) {
-      std::string vs_SoilTexture = soilColumn[i].vs_SoilTexture();
+      std::string vs_SoilTexture = (*soilColumn)[i].vs_SoilTexture();
       assert(!vs_SoilTexture.empty());
       double vm_CapillaryRiseRate = min(0.01, _params.getCapillaryRiseRate(vs_SoilTexture, vm_GroundwaterDistance)); // [m d-1]
       if (vm_AvailableWater[i] < vm_CapillaryWater70[i]) {
@@ -577,7 +591,7 @@ void SoilMoisture::fm_PercolationWithGroundwater(size_t oscillGroundwaterLayer)
             (vm_SoilMoisture[indexOfLayerBelow] - vm_FieldCapacity[indexOfLayerBelow]) * 1000.0 *
             vm_LayerThickness[i + 1];
 
-        double vm_LambdaReduced = vm_Lambda[indexOfLayerBelow] * frostComponent->getLambdaRedux(indexOfLayerBelow);
+        double vm_LambdaReduced = vm_Lambda[indexOfLayerBelow] * frostComponent.getLambdaRedux(indexOfLayerBelow);
         double vm_PercolationFactor = 1 + vm_LambdaReduced * vm_GravitationalWater[indexOfLayerBelow];
         vm_PercolationRate[indexOfLayerBelow] = (
             (vm_GravitationalWater[indexOfLayerBelow] * vm_GravitationalWater[indexOfLayerBelow]
@@ -720,7 +734,7 @@ void SoilMoisture::fm_PercolationWithoutGroundwater() {
       // too much water for this layer so some water is released to layers below
       vm_GravitationalWater[indexOfLayerBelow] =
         (vm_SoilMoisture[indexOfLayerBelow] - vm_FieldCapacity[indexOfLayerBelow]) * 1000.0 * vm_LayerThickness[0];
-      auto vm_LambdaReduced = vm_Lambda[indexOfLayerBelow] * frostComponent->getLambdaRedux(indexOfLayerBelow);
+      auto vm_LambdaReduced = vm_Lambda[indexOfLayerBelow] * frostComponent.getLambdaRedux(indexOfLayerBelow);
       auto vm_PercolationFactor = 1.0 + (vm_LambdaReduced * vm_GravitationalWater[indexOfLayerBelow]);
       vm_PercolationRate[indexOfLayerBelow] =
       (vm_GravitationalWater[indexOfLayerBelow] * vm_GravitationalWater[indexOfLayerBelow]
@@ -831,7 +845,7 @@ void SoilMoisture::fm_Evapotranspiration(double vc_PercentageSoilCoverage, doubl
   vm_EvaporatedFromSurface = 0.0;
   bool vm_EvaporationFromSurface = false;
 
-  double vm_SnowDepth = snowComponent->getVm_SnowDepth();
+  double vm_SnowDepth = snowComponent.getVm_SnowDepth();
 
   // Berechnung der Bodenevaporation bis max. 4dm Tiefe
   pm_EvaporationZeta = _params.pm_EvaporationZeta; // Parameterdatei
@@ -849,15 +863,15 @@ void SoilMoisture::fm_Evapotranspiration(double vc_PercentageSoilCoverage, doubl
     // Reference evapotranspiration is only grabbed here for consistent
     // output in monica.cpp
     if (vw_ReferenceEvapotranspiration < 0.0) {
-      vm_ReferenceEvapotranspiration = monica.cropGrowth()->get_ReferenceEvapotranspiration();
+      vm_ReferenceEvapotranspiration = monica->cropGrowth()->get_ReferenceEvapotranspiration();
     } else {
       vm_ReferenceEvapotranspiration = vw_ReferenceEvapotranspiration;
     }
 
     // Remaining ET from crop module already includes Kc factor and evaporation
     // from interception storage
-    vm_PotentialEvapotranspiration = monica.cropGrowth()->get_RemainingEvapotranspiration();
-    vc_EvaporatedFromIntercept = monica.cropGrowth()->get_EvaporatedFromIntercept();
+    vm_PotentialEvapotranspiration = monica->cropGrowth()->get_RemainingEvapotranspiration();
+    vc_EvaporatedFromIntercept = monica->cropGrowth()->get_EvaporatedFromIntercept();
 
   } else { // if no crop grows ETp is calculated from ET0 * kc
 
@@ -951,7 +965,7 @@ void SoilMoisture::fm_Evapotranspiration(double vc_PercentageSoilCoverage, doubl
 
           // Transpiration is derived from ET0; Soil coverage and Kc factors
           // already considered in crop part!
-          vm_Transpiration[i_Layer] = monica.cropGrowth()->get_Transpiration(i_Layer);
+          vm_Transpiration[i_Layer] = monica->cropGrowth()->get_Transpiration(i_Layer);
 
           //std::cout << setprecision(11) << "vm_Transpiration[i_Layer]: " << i_Layer << ", " << vm_Transpiration[i_Layer] << std::endl;
 
@@ -1034,7 +1048,7 @@ double SoilMoisture::ReferenceEvapotranspiration(double vs_HeightNN, double vw_M
   double vm_SurfaceResistance; //[s m-1]
   double vc_ExtraterrestrialRadiation;
   double vm_ReferenceEvapotranspiration; //[mm]
-  double pc_ReferenceAlbedo = cropPs.pc_ReferenceAlbedo; // FAO Green gras reference albedo from Allen et al. (1998)
+  double pc_ReferenceAlbedo = cropPs->pc_ReferenceAlbedo; // FAO Green gras reference albedo from Allen et al. (1998)
   double PI = 3.14159265358979323;
 
   vc_Declination = -23.4 * cos(2.0 * PI * ((vs_JulianDay + 10.0) / 365.0));
@@ -1139,10 +1153,10 @@ double SoilMoisture::ReferenceEvapotranspiration(double vs_HeightNN, double vw_M
   return vm_ReferenceEvapotranspiration;
 }
 
-double SoilMoisture::get_FrostDepth() const { return frostComponent->getFrostDepth(); }
+double SoilMoisture::get_FrostDepth() const { return frostComponent.getFrostDepth(); }
 
 //! Returns thaw depth [m]
-double SoilMoisture::get_ThawDepth() const { return frostComponent->getThawDepth(); }
+double SoilMoisture::get_ThawDepth() const { return frostComponent.getThawDepth(); }
 
 /*!
  * Get capillary rise from KA4
@@ -1169,9 +1183,9 @@ double SoilMoisture::get_EReducer_1(int i_Layer,
   double vm_ReferenceEvapotranspiration) {
   double vm_EReductionFactor;
   int vm_EvaporationReductionMethod = 1;
-  double vm_SoilMoisture_m3 = soilColumn[i_Layer].get_Vs_SoilMoisture_m3();
-  double vm_PWP = soilColumn[i_Layer].vs_PermanentWiltingPoint();
-  double vm_FK = soilColumn[i_Layer].vs_FieldCapacity();
+  double vm_SoilMoisture_m3 = (*soilColumn)[i_Layer].get_Vs_SoilMoisture_m3();
+  double vm_PWP = (*soilColumn)[i_Layer].vs_PermanentWiltingPoint();
+  double vm_FK = (*soilColumn)[i_Layer].vs_FieldCapacity();
   double vm_RelativeEvaporableWater;
   double vm_CriticalSoilMoisture;
   double vm_XSA;
@@ -1195,7 +1209,7 @@ double SoilMoisture::get_EReducer_1(int i_Layer,
       } else {
         vm_Reducer = vm_XSACriticalSoilMoisture / 2.5 * vm_ReferenceEvapotranspiration;
       }
-      vm_CriticalSoilMoisture = soilColumn[i_Layer].vs_FieldCapacity() * vm_Reducer;
+      vm_CriticalSoilMoisture = (*soilColumn)[i_Layer].vs_FieldCapacity() * vm_Reducer;
     }
 
     // Calculation of an evaporation-reducing factor in relation to soil water content
@@ -1284,11 +1298,11 @@ double SoilMoisture::meanWaterContent(double depth_m) const {
 
   for (int i = 0; i < numberOfSoilLayers; i++) {
     count++;
-    double smm3 = soilColumn[i].get_Vs_SoilMoisture_m3();
-    double fc = soilColumn[i].vs_FieldCapacity();
-    double pwp = soilColumn[i].vs_PermanentWiltingPoint();
+    double smm3 = (*soilColumn)[i].get_Vs_SoilMoisture_m3();
+    double fc = (*soilColumn)[i].vs_FieldCapacity();
+    double pwp = (*soilColumn)[i].vs_PermanentWiltingPoint();
     sum += smm3 / (fc - pwp); //[%nFK]
-    lsum += soilColumn[i].vs_LayerThickness;
+    lsum += (*soilColumn)[i].vs_LayerThickness;
     if (lsum >= depth_m)
       break;
   }
@@ -1307,9 +1321,9 @@ double SoilMoisture::meanWaterContent(int layer, int number_of_layers) const {
 
   for (int i = layer; i < layer + number_of_layers; i++) {
     count++;
-    double smm3 = soilColumn[i].get_Vs_SoilMoisture_m3();
-    double fc = soilColumn[i].vs_FieldCapacity();
-    double pwp = soilColumn[i].vs_PermanentWiltingPoint();
+    double smm3 = (*soilColumn)[i].get_Vs_SoilMoisture_m3();
+    double fc = (*soilColumn)[i].vs_FieldCapacity();
+    double pwp = (*soilColumn)[i].vs_PermanentWiltingPoint();
     sum += smm3 / (fc - pwp); //[%nFK]
   }
 
@@ -1330,19 +1344,19 @@ double SoilMoisture::get_KcFactor() const {
  * @return Value for snow depth
  */
 double SoilMoisture::get_SnowDepth() const {
-  return snowComponent->getVm_SnowDepth();
+  return snowComponent.getVm_SnowDepth();
 }
 
 double SoilMoisture::getMaxSnowDepth() const {
-  return snowComponent->getMaxSnowDepth();
+  return snowComponent.getMaxSnowDepth();
 }
 
 double SoilMoisture::getAccumulatedSnowDepth() const {
-  return snowComponent->getAccumulatedSnowDepth();
+  return snowComponent.getAccumulatedSnowDepth();
 }
 
 double SoilMoisture::getAccumulatedFrostDepth() const {
-  return frostComponent->getAccumulatedFrostDepth();
+  return frostComponent.getAccumulatedFrostDepth();
 }
 
 /**
@@ -1350,10 +1364,10 @@ double SoilMoisture::getAccumulatedFrostDepth() const {
 * @return Value for snow depth
 */
 double SoilMoisture::getTemperatureUnderSnow() const {
-  return frostComponent->getTemperatureUnderSnow();
+  return frostComponent.getTemperatureUnderSnow();
 }
 
 std::pair<double, double> SoilMoisture::getSnowDepthAndCalcTemperatureUnderSnow(double avgAirTemp) const {
-  double snowDepth = snowComponent->getVm_SnowDepth();
-  return make_pair(snowDepth, frostComponent->calcTemperatureUnderSnow(avgAirTemp, snowDepth));
+  double snowDepth = snowComponent.getVm_SnowDepth();
+  return make_pair(snowDepth, frostComponent.calcTemperatureUnderSnow(avgAirTemp, snowDepth));
 }
\ No newline at end of file
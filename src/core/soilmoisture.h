@@ -48,6 +48,9 @@ public:
   SoilMoisture(MonicaModel& monica, const SoilMoistureModuleParameters& smPs);
 
   SoilMoisture(MonicaModel& monica, mas::schema::model::monica::SoilMoistureModuleState::Reader reader, CropModule* cropModule = nullptr);
+
+  //! copy of other bound to the soil column, parameters and crop module of the (copied) model monica
+  SoilMoisture(const SoilMoisture& other, MonicaModel& monica, CropModule* cropModule = nullptr);
   void deserialize(mas::schema::model::monica::SoilMoistureModuleState::Reader reader);
   void serialize(mas::schema::model::monica::SoilMoistureModuleState::Builder builder) const;
 
@@ -73,6 +76,11 @@ void step(double vs_DepthGroundwaterTable,
   double get_PercolationRate(int layer) const;
 
   double waterFlux(int layer) const { return vm_WaterFlux.at(layer); }
+
+  //! per layer values, e.g. for output
+  const std::vector<double>& capillaryRises() const { return vm_CapillaryWater; }
+  const std::vector<double>& percolationRates() const { return vm_PercolationRate; }
+  const std::vector<double>& waterFluxes() const { return vm_WaterFlux; }
   double percolationRate(int layer) const { return vm_PercolationRate.at(layer); }
 
   double get_Infiltration() const { return vm_Infiltration; } // [mm]
@@ -170,12 +178,12 @@ void step(double vs_DepthGroundwaterTable,
   double vm_EvaporatedFromSurface{0.0}; //!< Amount of water evaporated from surface [mm]
 
 private:
-  SoilColumn& soilColumn;
-  const SiteParameters& siteParameters;
-  MonicaModel& monica;
+  SoilColumn* soilColumn;
+  const SiteParameters* siteParameters;
+  MonicaModel* monica;
   SoilMoistureModuleParameters _params;
-  const EnvironmentParameters& envPs;
-  const CropModuleParameters& cropPs;
+  const EnvironmentParameters* envPs;
+  const CropModuleParameters* cropPs;
   size_t numberOfMoistureLayers{0};
   size_t numberOfSoilLayers{0};
 
@@ -235,8 +243,8 @@ private:
   std::vector<double> vm_WaterFlux; //!< Soil water flux at the layer's upper boundary[mm d-1]
   double vm_XSACriticalSoilMoisture{0.0};
 
-  kj::Own<SnowComponent> snowComponent;
-  kj::Own<FrostComponent> frostComponent;
+  SnowComponent snowComponent;
+  FrostComponent frostComponent;
   CropModule* cropModule{nullptr};
 }; 
 
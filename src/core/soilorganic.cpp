@@ -49,7 +49,7 @@ using namespace Soil;
  * @param org_fert Parameter for organic fertiliser
  */
 SoilOrganic::SoilOrganic(SoilColumn &sc, SoilOrganicModuleParameters userParams)
-    : soilColumn(sc),
+    : soilColumn(&sc),
       _params(std::move(userParams)),
       vs_NumberOfLayers(sc.vs_NumberOfLayers()),
       vs_NumberOfOrganicLayers(sc.vs_NumberOfOrganicLayers()),
@@ -87,8 +87,8 @@ SoilOrganic::SoilOrganic(SoilColumn &sc, SoilOrganicModuleParameters userParams)
 
   //Conversion of soil organic carbon weight fraction to volume unit
   for (size_t i = 0; i < vs_NumberOfOrganicLayers; i++) {
-    SoilLayer &layer = soilColumn[i];
-    auto &layi = soilColumn.at(i);
+    SoilLayer &layer = (*soilColumn)[i];
+    auto &layi = soilColumn->at(i);
 
     vo_SoilOrganicC[i] =
         layer.vs_SoilOrganicCarbon() * layer.vs_SoilBulkDensity(); //[kg C kg-1] * [kg m-3] --> [kg C m-3]
@@ -279,12 +279,14 @@ void SoilOrganic::step(double vw_MeanAirTemperature, double vw_Precipitation,
   if (_params.sticsParams.use_denit) fo_stics_Denitrification();
   else fo_Denitrification();
 
-  auto N2OProducedNitDenit = _params.sticsParams.use_n2o
-                             ? fo_stics_N2OProduction()
-                             : make_pair(fo_N2OProduction(), 0.0);
-  vo_N2O_Produced_Nit = N2OProducedNitDenit.first;
-  vo_N2O_Produced_Denit = N2OProducedNitDenit.second;
-  vo_N2O_Produced = vo_N2O_Produced_Nit + vo_N2O_Produced_Denit;
+  if (_calculateN2OProduction) {
+    auto N2OProducedNitDenit = _params.sticsParams.use_n2o
+                               ? fo_stics_N2OProduction()
+                               : make_pair(fo_N2OProduction(), 0.0);
+    vo_N2O_Produced_Nit = N2OProducedNitDenit.first;
+    vo_N2O_Produced_Denit = N2OProducedNitDenit.second;
+    vo_N2O_Produced = vo_N2O_Produced_Nit + vo_N2O_Produced_Denit;
+  }
 
   fo_PoolUpdate();
 
@@ -302,7 +304,7 @@ void SoilOrganic::step(double vw_MeanAirTemperature, double vw_Precipitation,
   //done before the stepping method
   irrigationAmount = 0.0;
 
-  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+  auto nools = soilColumn->vs_NumberOfOrganicLayers();
   for (size_t i = 0; i < nools; i++) {
     vo_AOM_SlowInput[i] = 0.0;
     vo_AOM_FastInput[i] = 0.0;
@@ -312,12 +314,12 @@ void SoilOrganic::step(double vw_MeanAirTemperature, double vw_Precipitation,
 }
 
 void SoilOrganic::addOrganicMatter(const OrganicMatterParameters &params,
-                                   const map<size_t, double> &layer2addedOrganicMatterAmount,
+                                   kj::ArrayPtr<const double> layer2addedOrganicMatterAmount,
                                    double addedOrganicMatterNConcentration) {
   debug() << "SoilOrganic: addOrganicMatter: " << params.toString() << endl;
 
-  auto nools = soilColumn.vs_NumberOfOrganicLayers();
-  double layerThickness = soilColumn.at(0).vs_LayerThickness;
+  auto nools = soilColumn->vs_NumberOfOrganicLayers();
+  double layerThickness = soilColumn->at(0).vs_LayerThickness;
 
   // check if the added organic matter is from crop residues
   bool areCropResidueParams = int(params.vo_CN_Ratio_AOM_Fast * 10000.0) == 0;
@@ -390,11 +392,11 @@ void SoilOrganic::addOrganicMatter(const OrganicMatterParameters &params,
 
   //urea
   if (nools > 0) {
-    for (const auto &p: layer2addedOrganicMatterAmount) {
-      if (p.first < nools) {
+    for (size_t i = 0; i < layer2addedOrganicMatterAmount.size() && i < nools; i++) {
+      if (layer2addedOrganicMatterAmount[i] != 0.0) {
         // kg N m-3 soil
-        soilColumn.at(p.first).vs_SoilCarbamid +=
-            p.second
+        soilColumn->at(i).vs_SoilCarbamid +=
+            layer2addedOrganicMatterAmount[i]
             * params.vo_AOM_DryMatterContent
             * params.vo_AOM_CarbamidContent
             / 10000.0
@@ -407,7 +409,7 @@ void SoilOrganic::addOrganicMatter(const OrganicMatterParameters &params,
   if (areCropResidueParams) {
     int i = 0;
     // find the index of an existing matching set of pools
-    for (const auto &props: soilColumn.at(0).vo_AOM_Pool) {
+    for (const auto &props: soilColumn->at(0).vo_AOM_Pool) {
       if (areSameAOMPropsAsOMParams(props)) {
         poolSetIndex = i;
         break;
@@ -416,10 +418,10 @@ void SoilOrganic::addOrganicMatter(const OrganicMatterParameters &params,
     }
   }
 
-  for (const auto &p: layer2addedOrganicMatterAmount) {
-    auto intoLayerIndex = p.first;
-    double addedOrganicMatterAmount = p.second;
-    auto &intoLayer = soilColumn.at(intoLayerIndex);
+  for (size_t intoLayerIndex = 0; intoLayerIndex < layer2addedOrganicMatterAmount.size(); intoLayerIndex++) {
+    double addedOrganicMatterAmount = layer2addedOrganicMatterAmount[intoLayerIndex];
+    if (addedOrganicMatterAmount == 0.0) continue;
+    auto &intoLayer = soilColumn->at(intoLayerIndex);
 
     // calculate the CN ratio for AOM fast, if we're talking about crop residues and the
     // equivalent added organic carbon amount for the given added organic matter amount
@@ -445,7 +447,7 @@ void SoilOrganic::addOrganicMatter(const OrganicMatterParameters &params,
 
       // append this pool (template) to each layer's pool list
       for (size_t i = 0; i < nools; i++) {
-        soilColumn.at(i).vo_AOM_Pool.push_back(pool);
+        soilColumn->at(i).vo_AOM_Pool.push_back(pool);
 
         // update the pool where the organic matter will go into
         if (i == intoLayerIndex) {
@@ -459,7 +461,7 @@ void SoilOrganic::addOrganicMatter(const OrganicMatterParameters &params,
       }
 
       // pools are now created, so can be used in the other layers
-      poolSetIndex = int(soilColumn.at(0).vo_AOM_Pool.size() - 1);
+      poolSetIndex = int(soilColumn->at(0).vo_AOM_Pool.size() - 1);
     } else {
       auto &cpool = intoLayer.vo_AOM_Pool[poolSetIndex];
       cpool.vo_AOM_Slow += AOM_slow_input = params.vo_PartAOM_to_AOM_Slow * added_Corg_amount;
@@ -507,9 +509,12 @@ void SoilOrganic::addOrganicMatter(const OrganicMatterParameters &organicMatterP
                                    double amount,
                                    double nConcentration,
                                    size_t intoLayerIndex) {
-  addOrganicMatter(organicMatterParams,
-                   {{intoLayerIndex, amount}},
-                   nConcentration);
+  if (amount == 0.0) return;
+
+  // the layers above intoLayerIndex get nothing
+  std::vector<double> layerAmounts(intoLayerIndex + 1, 0.0);
+  layerAmounts[intoLayerIndex] = amount;
+  addOrganicMatter(organicMatterParams, kj::arrayPtr(layerAmounts.data(), layerAmounts.size()), nConcentration);
 }
 
 void SoilOrganic::addIrrigationWater(double amount) {
@@ -570,7 +575,7 @@ void SoilOrganic::fo_OM_Input(bool vo_AOM_Addition) {
  * @param vo_RainIrrigation
  */
 void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
-  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+  auto nools = soilColumn->vs_NumberOfOrganicLayers();
   std::vector<double> vo_SoilCarbamid_solid(nools,
                                             0.0); // Solid carbamide concentration in soil solution [kmol urea m-3]
   std::vector<double> vo_SoilCarbamid_aq(nools,
@@ -595,8 +600,8 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
 
   vo_NH3_Volatilised = 0.0;
 
-  for (int i = 0; i < soilColumn.vs_NumberOfOrganicLayers(); i++) {
-    auto &layer = soilColumn.at(i);
+  for (int i = 0; i < soilColumn->vs_NumberOfOrganicLayers(); i++) {
+    auto &layer = soilColumn->at(i);
 
     // kmol urea m-3 soil
     vo_SoilCarbamid_solid[i] = layer.vs_SoilCarbamid /
@@ -670,7 +675,7 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
 
     // Calculate general volatilisation from NH4-Pool in top layer
     if (i == 0) {
-      auto layer0 = soilColumn.at(0);
+      auto layer0 = soilColumn->at(0);
 
       vo_H3OIonConcentration = pow(10.0, (-layer0.vs_SoilpH())); // kmol m-3
       vo_NH3aq_EquilibriumConst = pow(10.0, ((-2728.3 /
@@ -724,7 +729,7 @@ void SoilOrganic::fo_Urea(double vo_RainIrrigation) {
  */
 void SoilOrganic::fo_MIT() {
 
-  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+  auto nools = soilColumn->vs_NumberOfOrganicLayers();
   double po_SOM_SlowDecCoeffStandard = _params.po_SOM_SlowDecCoeffStandard;
   double po_SOM_FastDecCoeffStandard = _params.po_SOM_FastDecCoeffStandard;
   double po_SMB_SlowDeathRateStandard = _params.po_SMB_SlowDeathRateStandard;
@@ -842,7 +847,7 @@ void SoilOrganic::fo_MIT() {
 
   // Calculation of decay rate coefficients
   for (int i = 0; i < nools; i++) {
-    auto &layi = soilColumn.at(i);
+    auto &layi = soilColumn->at(i);
     double tod = _params.__enable_kaiteew_TempOnDecompostion__
                  ? fo_TempOnDecompostion_kaiteew(layi.get_Vs_SoilTemperature(),
                                                  _params.po_QTenFactor,
@@ -888,7 +893,7 @@ void SoilOrganic::fo_MIT() {
 
   // Calculation of pool changes by decomposition
   for (int i = 0; i < nools; i++) {
-    auto &layi = soilColumn.at(i);
+    auto &layi = soilColumn->at(i);
 
     for (auto &props: layi.vo_AOM_Pool) {
       // Eq.6-5 and 6-6 in the DAISY manual
@@ -980,7 +985,7 @@ void SoilOrganic::fo_MIT() {
 
   // Calculation of N balance
   for (int i = 0; i < nools; i++) {
-    auto &layi = soilColumn.at(i);
+    auto &layi = soilColumn->at(i);
 
     double CN_Ratio_SOM_Slow = layi.vs_Soil_CN_Ratio();
     double CN_Ratio_SOM_Fast = CN_Ratio_SOM_Slow;
@@ -1005,7 +1010,7 @@ void SoilOrganic::fo_MIT() {
   vo_NetNMineralisation = 0.0;
 
   for (int i = 0; i < nools; i++) {
-    auto &layi = soilColumn.at(i);
+    auto &layi = soilColumn->at(i);
 
     double vo_CN_Ratio_SOM_Slow = layi.vs_Soil_CN_Ratio();
     double vo_CN_Ratio_SOM_Fast = vo_CN_Ratio_SOM_Slow;
@@ -1016,7 +1021,7 @@ void SoilOrganic::fo_MIT() {
         vo_AOM_SlowDeltaSum[i] = 0.0;
         vo_AOM_FastDeltaSum[i] = 0.0;
 
-        vector<AOM_Properties> &AOM_Pool = layi.vo_AOM_Pool;
+        auto &AOM_Pool = layi.vo_AOM_Pool;
 
         for (auto &props: AOM_Pool) {
           if (props.vo_CN_Ratio_AOM_Slow >= (po_CN_Ratio_SMB / po_AOM_SlowUtilizationEfficiency)) {
@@ -1101,7 +1106,7 @@ void SoilOrganic::fo_MIT() {
       layi.vs_SoilNH4 += fabs(vo_NBalance[i]);
     }
 
-    auto &lay0 = soilColumn.at(0);
+    auto &lay0 = soilColumn->at(0);
     vo_NetNMineralisationRate[i] = fabs(vo_NBalance[i]) * lay0.vs_LayerThickness; // [kg m-3] --> [kg m-2]
     vo_NetNMineralisation += fabs(vo_NBalance[i]) * lay0.vs_LayerThickness; // [kg m-3] --> [kg m-2]
     vo_SumNetNMineralisation += fabs(vo_NBalance[i]) * lay0.vs_LayerThickness; // [kg m-3] --> [kg m-2]
@@ -1130,7 +1135,7 @@ void SoilOrganic::fo_MIT() {
     vo_SMB_CO2EvolutionRate[i] = vo_SMB_SlowCO2EvolutionRate[i] + vo_SMB_FastCO2EvolutionRate[i];
 
     vo_DecomposerRespiration +=
-        vo_SMB_CO2EvolutionRate[i] * soilColumn.at(i).vs_LayerThickness; // [kg C m-3] -> [kg C m-2]
+        vo_SMB_CO2EvolutionRate[i] * soilColumn->at(i).vs_LayerThickness; // [kg C m-3] -> [kg C m-2]
   }
 }
 
@@ -1159,7 +1164,7 @@ void SoilOrganic::fo_Volatilisation(bool vo_AOM_Addition, double vw_MeanAirTempe
 
   int vo_DaysAfterApplicationSum = 0;
 
-  auto lay0 = soilColumn.at(0);
+  auto lay0 = soilColumn->at(0);
 
   if (lay0.vs_SoilMoisture_pF() > 2.5) {
     vo_SoilWet = 0.0;
@@ -1167,7 +1172,7 @@ void SoilOrganic::fo_Volatilisation(bool vo_AOM_Addition, double vw_MeanAirTempe
     vo_SoilWet = 1.0;
   }
 
-  vector<AOM_Properties> &AOM_Pool = lay0.vo_AOM_Pool;
+  auto &AOM_Pool = lay0.vo_AOM_Pool;
   for (auto &props: AOM_Pool) {
     vo_DaysAfterApplicationSum += props.vo_DaysAfterApplication;
   }
@@ -1250,7 +1255,7 @@ void SoilOrganic::fo_Volatilisation(bool vo_AOM_Addition, double vw_MeanAirTempe
  * @brief Internal Subroutine Nitrification
  */
 void SoilOrganic::fo_Nitrification() {
-  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+  auto nools = soilColumn->vs_NumberOfOrganicLayers();
   double po_AmmoniaOxidationRateCoeffStandard = _params.po_AmmoniaOxidationRateCoeffStandard;
   double po_NitriteOxidationRateCoeffStandard = _params.po_NitriteOxidationRateCoeffStandard;
 
@@ -1263,7 +1268,7 @@ void SoilOrganic::fo_Nitrification() {
   //std::vector<double> vo_NitriteOxidationRate(nools, 0.0);
 
   for (int i = 0; i < nools; i++) {
-    auto &layi = soilColumn.at(i);
+    auto &layi = soilColumn->at(i);
     auto NH4i = layi.vs_SoilNH4;
 
     // Calculate nitrification rate coefficients
@@ -1304,11 +1309,11 @@ void SoilOrganic::fo_Nitrification() {
 }
 
 void SoilOrganic::fo_stics_Nitrification() {
-  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+  auto nools = soilColumn->vs_NumberOfOrganicLayers();
   auto sticsParams = _params.sticsParams;
 
   for (int i = 0; i < nools; i++) {
-    auto &layi = soilColumn.at(i);
+    auto &layi = soilColumn->at(i);
     auto smi = layi.get_Vs_SoilMoisture_m3(); // m3-water/m3-soil
     auto sbdi = layi.vs_SoilBulkDensity(); // kg-soil/m3-soil
     auto NH4i = layi.get_SoilNH4();
@@ -1341,14 +1346,14 @@ void SoilOrganic::fo_stics_Nitrification() {
  * @brief Denitrification
  */
 void SoilOrganic::fo_Denitrification() {
-  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+  auto nools = soilColumn->vs_NumberOfOrganicLayers();
   std::vector<double> vo_PotDenitrificationRate(nools, 0.0);
   double po_SpecAnaerobDenitrification = _params.po_SpecAnaerobDenitrification;
   double po_TransportRateCoeff = _params.po_TransportRateCoeff;
   vo_TotalDenitrification = 0.0;
 
   for (int i = 0; i < nools; i++) {
-    auto &layi = soilColumn.at(i);
+    auto &layi = soilColumn->at(i);
     auto NO3i = layi.vs_SoilNO3;
 
     //Temperature function is the same as in Nitrification subroutine
@@ -1376,12 +1381,12 @@ void SoilOrganic::fo_Denitrification() {
 }
 
 void SoilOrganic::fo_stics_Denitrification() {
-  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+  auto nools = soilColumn->vs_NumberOfOrganicLayers();
   auto sticsParams = _params.sticsParams;
   vo_TotalDenitrification = 0.0;
 
   for (int i = 0; i < nools; i++) {
-    auto &layi = soilColumn.at(i);
+    auto &layi = soilColumn->at(i);
     auto smi = layi.get_Vs_SoilMoisture_m3(); // m3-water/m3-soil
     auto sbdi = layi.vs_SoilBulkDensity(); // kg-soil/m3-soil
     auto lti = layi.vs_LayerThickness;
@@ -1417,13 +1422,13 @@ void SoilOrganic::fo_stics_Denitrification() {
  * @brief N2O production
  */
 double SoilOrganic::fo_N2OProduction() {
-  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+  auto nools = soilColumn->vs_NumberOfOrganicLayers();
   double N2OProductionRate = _params.po_N2OProductionRate;
   double pKaHNO2 = OrganicConstants::po_pKaHNO2;
   double sumN2OProduced = 0.0;
 
   for (int i = 0; i < nools; i++) {
-    auto &layi = soilColumn.at(i);
+    auto &layi = soilColumn->at(i);
     auto pHi = layi.vs_SoilpH();
     auto NO2i = layi.vs_SoilNO2;
     auto lti = layi.vs_LayerThickness;
@@ -1446,12 +1451,12 @@ double SoilOrganic::fo_N2OProduction() {
 }
 
 SoilOrganic::NitDenitN2O SoilOrganic::fo_stics_N2OProduction() {
-  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+  auto nools = soilColumn->vs_NumberOfOrganicLayers();
   double sumN2OProducedNit = 0.0, sumN2OProducedDenit = 0.0;
   auto sticsParams = _params.sticsParams;
 
   for (int i = 0; i < nools; i++) {
-    auto &layi = soilColumn.at(i);
+    auto &layi = soilColumn->at(i);
     auto smi = layi.get_Vs_SoilMoisture_m3(); // m3-water/m3-soil
     auto sbdi = layi.vs_SoilBulkDensity(); // kg-soil/m3-soil
     auto lti = layi.vs_LayerThickness;
@@ -1485,9 +1490,9 @@ SoilOrganic::NitDenitN2O SoilOrganic::fo_stics_N2OProduction() {
  * @brief Internal Subroutine Pool update
  */
 void SoilOrganic::fo_PoolUpdate() {
-  auto nools = soilColumn.vs_NumberOfOrganicLayers();
+  auto nools = soilColumn->vs_NumberOfOrganicLayers();
   for (int i = 0; i < nools; i++) {
-    auto &layi = soilColumn.at(i);
+    auto &layi = soilColumn->at(i);
 
     vo_AOM_SlowDeltaSum[i] = 0.0;
     vo_AOM_FastDeltaSum[i] = 0.0;
@@ -1853,7 +1858,7 @@ double SoilOrganic::fo_NetEcosystemExchange(double d_NetPrimaryProduction, doubl
  * @return Soil organic C
  */
 double SoilOrganic::get_SoilOrganicC(int i_Layer) const {
-  return vo_SoilOrganicC[i_Layer] / soilColumn.at(i_Layer).vs_SoilBulkDensity();
+  return vo_SoilOrganicC[i_Layer] / soilColumn->at(i_Layer).vs_SoilBulkDensity();
 }
 
 /**
@@ -1877,7 +1882,7 @@ double SoilOrganic::get_AOM_SlowSum(int i_Layer) const {
  * @return SMB fast
  */
 double SoilOrganic::get_SMB_Fast(int i_Layer) const {
-  return soilColumn.at(i_Layer).vs_SMB_Fast;
+  return soilColumn->at(i_Layer).vs_SMB_Fast;
 }
 
 /**
@@ -1885,7 +1890,7 @@ double SoilOrganic::get_SMB_Fast(int i_Layer) const {
  * @return SMB slow
  */
 double SoilOrganic::get_SMB_Slow(int i_Layer) const {
-  return soilColumn.at(i_Layer).vs_SMB_Slow;
+  return soilColumn->at(i_Layer).vs_SMB_Slow;
 }
 
 /**
@@ -1893,7 +1898,7 @@ double SoilOrganic::get_SMB_Slow(int i_Layer) const {
  * @return AOM fast
  */
 double SoilOrganic::get_SOM_Fast(int i_Layer) const {
-  return soilColumn.at(i_Layer).vs_SOM_Fast;
+  return soilColumn->at(i_Layer).vs_SOM_Fast;
 }
 
 /**
@@ -1901,7 +1906,7 @@ double SoilOrganic::get_SOM_Fast(int i_Layer) const {
  * @return SOM slow
  */
 double SoilOrganic::get_SOM_Slow(int i_Layer) const {
-  return soilColumn.at(i_Layer).vs_SOM_Slow;
+  return soilColumn->at(i_Layer).vs_SOM_Slow;
 }
 
 /**
@@ -2039,11 +2044,11 @@ double SoilOrganic::get_Organic_N(int i) const {
   orgN += get_SMB_Fast(i) / _params.po_CN_Ratio_SMB;
   orgN += get_SMB_Slow(i) / _params.po_CN_Ratio_SMB;
 
-  double cn = soilColumn.at(i).vs_Soil_CN_Ratio();
+  double cn = soilColumn->at(i).vs_Soil_CN_Ratio();
   orgN += get_SOM_Fast(i) / cn;
   orgN += get_SOM_Slow(i) / cn;
 
-  for (const auto &aomp: soilColumn.at(i).vo_AOM_Pool) {
+  for (const auto &aomp: soilColumn->at(i).vo_AOM_Pool) {
     orgN += aomp.vo_AOM_Fast / aomp.vo_CN_Ratio_AOM_Fast;
     orgN += aomp.vo_AOM_Slow / aomp.vo_CN_Ratio_AOM_Slow;
   }
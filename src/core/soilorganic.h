@@ -28,6 +28,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <utility>
 #include <list>
 
+#include <kj/common.h>
+
 #include "model/monica/monica_state.capnp.h"
 #include "monica-parameters.h"
 
@@ -42,18 +44,26 @@ public:
   SoilOrganic(SoilColumn& soilColumn, SoilOrganicModuleParameters  params);
 
   SoilOrganic(SoilColumn& sc, mas::schema::model::monica::SoilOrganicModuleState::Reader reader, CropModule* cropModule = nullptr)
-    : soilColumn(sc)
+    : soilColumn(&sc)
     , cropModule(cropModule) {
     deserialize(reader);
   }
 
+  //! copy of other bound to the soil column sc and crop module (of a copied model)
+  SoilOrganic(const SoilOrganic& other, SoilColumn& sc, CropModule* cropModule = nullptr)
+    : SoilOrganic(other) {
+    soilColumn = &sc;
+    this->cropModule = cropModule;
+  }
+
   void deserialize(mas::schema::model::monica::SoilOrganicModuleState::Reader reader);
   void serialize(mas::schema::model::monica::SoilOrganicModuleState::Builder builder) const;
 
   void step(double vw_Precipitation, double vw_MeanAirTemperature, double vw_WindSpeed);
 
+  //! @param layerAmounts amount of organic matter per layer (index = layer), layers with 0 are skipped
   void addOrganicMatter(const OrganicMatterParameters& props,
-                        const std::map<size_t, double> &layer2amount,
+                        kj::ArrayPtr<const double> layerAmounts,
                         double nConcentration = 0);
 
   void addOrganicMatter(const OrganicMatterParameters &organicMatterParams,
@@ -92,6 +102,9 @@ public:
   double get_N2O_Produced_Nit() const { return vo_N2O_Produced_Nit; }
   double get_N2O_Produced_Denit() const { return vo_N2O_Produced_Denit; }
   double get_SumN2O_Produced() const;
+
+  //! the N2O production feeds no N pool, so it can be switched off if nobody requested it
+  void setCalculateN2OProduction(bool calc) { _calculateN2OProduction = calc; }
   double get_NetNMineralisation() const;
   double get_SumNetNMineralisation() const;
   double get_SumDenitrification() const;
@@ -113,6 +126,13 @@ public:
     return vo_ActDenitrificationRate.at(i);
   }
 
+  //! per layer values, e.g. for output
+  const std::vector<double>& actAmmoniaOxidationRates() const { return vo_ActAmmoniaOxidationRate; }
+  const std::vector<double>& actNitrificationRates() const { return vo_ActNitrificationRate; }
+  const std::vector<double>& actDenitrificationRates() const { return vo_ActDenitrificationRate; }
+  const std::vector<double>& cBalances() const { return vo_CBalance; }
+  const std::vector<double>& smbCO2EvolutionRates() const { return vo_SMB_CO2EvolutionRate; }
+
 private:
   //void fo_OM_Input(bool vo_AOM_Addition);
   void fo_Urea(double vo_RainIrrigation);
@@ -157,7 +177,7 @@ private:
   double fo_NH3onNitriteOxidation (double d_SoilNH4, double d_SoilpH);
   //void fo_distributeDeadRootBiomass();
 
-  SoilColumn& soilColumn;
+  SoilColumn* soilColumn;
   SoilOrganicModuleParameters _params;
 
   std::size_t vs_NumberOfLayers{0};
@@ -198,7 +218,7 @@ private:
   std::vector<double> vo_SOM_SlowDelta;
   double vo_SumDenitrification{0.0}; // kg-N/m2
   double vo_SumNetNMineralisation{0.0};
-  double vo_SumN2O_Produced{0.0};
+  double vo_SumN2O_Produced{0.0}; //!< stays 0 if the N2O production is skipped (never in runs saving their state)
   double vo_SumNH3_Volatilised{0.0};
   double vo_TotalDenitrification{0.0};
 
@@ -206,6 +226,7 @@ private:
   //! Parameter is automatically set to false, if carbamid amount is falling below 0.001.
   bool incorporation{false};
   CropModule* cropModule{nullptr};
+  bool _calculateN2OProduction{true};
 };
 
 } // namespace Monica
@@ -221,6 +221,35 @@ SoilTemperature::SoilTemperature(MonicaModel &mm, mas::schema::model::monica::So
   deserialize(reader);
 }
 
+SoilTemperature::SoilTemperature(const SoilTemperature &other, MonicaModel &mm)
+    : _soilColumn(mm.soilColumnNC())
+      , _monica(mm)
+      , _soilColumnGroundLayer(other._soilColumnGroundLayer)
+      , _soilColumnBottomLayer(other._soilColumnBottomLayer)
+      , _params(other._params)
+      , soilColumn(_soilColumn,
+                   _soilColumnGroundLayer,
+                   _soilColumnBottomLayer,
+                   other.soilColumn.vs_nols)
+      , _noOfTempLayers(other._noOfTempLayers)
+      , _noOfSoilLayers(other._noOfSoilLayers)
+      , _soilTemperature(other._soilTemperature)
+      , _V(other._V)
+      , _volumeMatrix(other._volumeMatrix)
+      , _volumeMatrixOld(other._volumeMatrixOld)
+      , _B(other._B)
+      , _matrixPrimaryDiagonal(other._matrixPrimaryDiagonal)
+      , _matrixSecondaryDiagonal(other._matrixSecondaryDiagonal)
+      , _heatConductivity(other._heatConductivity)
+      , _heatConductivityMean(other._heatConductivityMean)
+      , _heatCapacity(other._heatCapacity)
+      , _dampingFactor(other._dampingFactor)
+      , _soilSurfaceTemperature(other._soilSurfaceTemperature)
+      , _solution(other._solution)
+      , _matrixDiagonal(other._matrixDiagonal)
+      , _matrixLowerTriangle(other._matrixLowerTriangle)
+      , _heatFlow(other._heatFlow) {}
+
 void SoilTemperature::deserialize(mas::schema::model::monica::SoilTemperatureModuleState::Reader reader) {
   _soilSurfaceTemperature = reader.getSoilSurfaceTemperature();
   _soilColumnGroundLayer.deserialize(reader.getSoilColumnVtGroundLayer());
@@ -45,6 +45,10 @@ public:
   SoilTemperature(MonicaModel& monica, const SoilTemperatureModuleParameters& params);
 
   SoilTemperature(MonicaModel& monica, mas::schema::model::monica::SoilTemperatureModuleState::Reader reader);
+
+  //! copy of other bound to the soil column of the (copied) model monica
+  //! (spelled out, as the extra layers are referenced by the soil column view below)
+  SoilTemperature(const SoilTemperature& other, MonicaModel& monica);
   void deserialize(mas::schema::model::monica::SoilTemperatureModuleState::Reader reader);
   void serialize(mas::schema::model::monica::SoilTemperatureModuleState::Builder builder) const;
 
@@ -54,6 +58,10 @@ public:
 
   double getSoilSurfaceTemperature() const { return _soilSurfaceTemperature; }
   double getSoilTemperature(int layer) const { return soilColumn.at(layer).get_Vs_SoilTemperature();}
+  //! the temperatures of the layers [from, to] (including the ground and bottom layer below the soil column)
+  void soilTemperatures(size_t from, size_t to, double* into) const {
+    for (auto i = from; i <= to; i++) *into++ = soilColumn.at(i).get_Vs_SoilTemperature();
+  }
   //double getHeatConductivity(int layer) const { return _heatConductivity.at(layer);}
   //double getAvgTopSoilTemperature(double sumUpLayerThickness = 0.3) const;
   //double dampingFactor() const { return _dampingFactor; }
@@ -41,7 +41,7 @@ using namespace Tools;
  */
 SoilTransport::SoilTransport(SoilColumn& sc, const SiteParameters& sps, const SoilTransportModuleParameters& params,
   double p_LeachingDepth, double p_timeStep, double pc_MinimumAvailableN)
-  : soilColumn(sc)
+  : soilColumn(&sc)
   , _params(params)
   //, vs_NumberOfLayers(sc.vs_NumberOfLayers()) //extern
   , vq_Convection(sc.vs_NumberOfLayers(), 0.0)
@@ -110,18 +110,18 @@ void SoilTransport::serialize(mas::schema::model::monica::SoilTransportModuleSta
  */
 void SoilTransport::step() {
   double minTimeStepFactor = 1.0; // [t t-1]
-  const auto nols = soilColumn.vs_NumberOfLayers();
+  const auto nols = soilColumn->vs_NumberOfLayers();
 
   for (size_t i = 0; i < nols; i++) {
     //vq_FieldCapacity[i] = soilColumn[i].vs_FieldCapacity();
     //vq_SoilMoisture[i] = soilColumn[i].get_Vs_SoilMoisture_m3();
-    vq_SoilNO3[i] = soilColumn[i].vs_SoilNO3;
+    vq_SoilNO3[i] = (*soilColumn)[i].vs_SoilNO3;
 
     vc_NUptakeFromLayer[i] = cropModule ? cropModule->get_NUptakeFromLayer(i) : 0;
     if (i == nols - 1) 
-      vq_PercolationRate[i] = soilColumn.vs_FluxAtLowerBoundary; //[mm]
+      vq_PercolationRate[i] = soilColumn->vs_FluxAtLowerBoundary; //[mm]
     else
-      vq_PercolationRate[i] = soilColumn[i + 1].vs_SoilWaterFlux; //[mm]
+      vq_PercolationRate[i] = (*soilColumn)[i + 1].vs_SoilWaterFlux; //[mm]
 
     // Variable time step in case of high water fluxes to ensure stable numerics
     auto pri = vq_PercolationRate[i];
@@ -147,12 +147,12 @@ void SoilTransport::step() {
     fq_NTransport(vs_LeachingDepth, minTimeStepFactor);
 
   for (int i = 0; i < nols; i++) {
-    vq_SoilNO3[i] = vq_SoilNO3_aq[i] * soilColumn[i].get_Vs_SoilMoisture_m3();
+    vq_SoilNO3[i] = vq_SoilNO3_aq[i] * (*soilColumn)[i].get_Vs_SoilMoisture_m3();
 
     if (vq_SoilNO3[i] < 0.0) 
       vq_SoilNO3[i] = 0.0;
 
-    soilColumn[i].vs_SoilNO3 = vq_SoilNO3[i];
+    (*soilColumn)[i].vs_SoilNO3 = vq_SoilNO3[i];
   } 
 
 }
@@ -171,7 +171,7 @@ void SoilTransport::fq_NDeposition() {
   double dailyNDeposition = vs_NDeposition / 365.0;
 
   // Addition of N deposition to top layer [kg N m-3]
-  vq_SoilNO3[0] += dailyNDeposition / (10000.0 * soilColumn[0].vs_LayerThickness);
+  vq_SoilNO3[0] += dailyNDeposition / (10000.0 * (*soilColumn)[0].vs_LayerThickness);
 }
 
 /**
@@ -181,11 +181,11 @@ void SoilTransport::fq_NDeposition() {
  * Kersebaum 1989
  */
 void SoilTransport::fq_NUptake() {
-  const auto nols = soilColumn.vs_NumberOfLayers();
+  const auto nols = soilColumn->vs_NumberOfLayers();
   double cropNUptake = 0.0;
   for (size_t i = 0; i < nols; i++) {
-    const auto lti = soilColumn[i].vs_LayerThickness;
-    const auto smi = soilColumn[i].get_Vs_SoilMoisture_m3();
+    const auto lti = (*soilColumn)[i].vs_LayerThickness;
+    const auto smi = (*soilColumn)[i].get_Vs_SoilMoisture_m3();
 
     // Lower boundary for N exploitation per layer
     if (vc_NUptakeFromLayer[i] > ((vq_SoilNO3[i] * lti) - pc_MinimumAvailableN)) {
@@ -204,7 +204,7 @@ void SoilTransport::fq_NUptake() {
     vq_SoilNO3_aq[i] = vq_SoilNO3[i] / smi;
   }
 
-  soilColumn.vq_CropNUptake = cropNUptake; // [kg m-2]
+  soilColumn->vq_CropNUptake = cropNUptake; // [kg m-2]
 }
 
 /**
@@ -219,19 +219,19 @@ void SoilTransport::fq_NTransport(double leachingDepth, double timeStepFactor) {
   double dispersionLength = _params.pq_DispersionLength; // [m]
   double soilProfile = 0.0;
   size_t leachingDepthLayerIndex = 0;
-  const auto nols = soilColumn.vs_NumberOfLayers();
+  const auto nols = soilColumn->vs_NumberOfLayers();
   std::vector<double> soilMoistureGradient(nols, 0.0);
 
   for (size_t i = 0; i < nols; i++) {
-    soilProfile += soilColumn[i].vs_LayerThickness;
+    soilProfile += (*soilColumn)[i].vs_LayerThickness;
     if ((soilProfile - 0.001) < leachingDepth) 
       leachingDepthLayerIndex = i;
   }
 
   // Caluclation of convection for different cases of flux direction
   for (size_t i = 0; i < nols; i++) {
-    const auto wf0 = soilColumn[0].vs_SoilWaterFlux;
-    const auto lt = soilColumn[i].vs_LayerThickness;
+    const auto wf0 = (*soilColumn)[0].vs_SoilWaterFlux;
+    const auto lt = (*soilColumn)[i].vs_LayerThickness;
     const auto NO3 = vq_SoilNO3_aq[i];
 		
     if (i == 0) {
@@ -268,7 +268,7 @@ void SoilTransport::fq_NTransport(double leachingDepth, double timeStepFactor) {
     } else {
       // bottom layer
       const double pr_o = vq_PercolationRate[i - 1] / 1000.0 * timeStepFactor; // [m t-1] * [t t-1]
-      const double pr = soilColumn.vs_FluxAtLowerBoundary / 1000.0 * timeStepFactor; // [m t-1] * [t t-1]
+      const double pr = soilColumn->vs_FluxAtLowerBoundary / 1000.0 * timeStepFactor; // [m t-1] * [t t-1]
 
       if (pr >= 0.0 && pr_o >= 0.0) {
         const double NO3_o = vq_SoilNO3_aq[i - 1];
@@ -287,11 +287,11 @@ void SoilTransport::fq_NTransport(double leachingDepth, double timeStepFactor) {
   // Calculation of dispersion depending of pore water velocity
   for (size_t i = 0; i < nols; i++) {
     const auto pri = vq_PercolationRate[i] / 1000.0 * timeStepFactor; // [mm t-1 --> m t-1] * [t t-1]
-    const auto pr0 = soilColumn[0].vs_SoilWaterFlux / 1000.0 * timeStepFactor; // [mm t-1 --> m t-1] * [t t-1]
-    const auto lti = soilColumn[i].vs_LayerThickness;
+    const auto pr0 = (*soilColumn)[0].vs_SoilWaterFlux / 1000.0 * timeStepFactor; // [mm t-1 --> m t-1] * [t t-1]
+    const auto lti = (*soilColumn)[i].vs_LayerThickness;
     const auto NO3i = vq_SoilNO3_aq[i];
-    const auto fci = soilColumn[i].vs_FieldCapacity();
-    const auto smi = soilColumn[i].get_Vs_SoilMoisture_m3();
+    const auto fci = (*soilColumn)[i].vs_FieldCapacity();
+    const auto smi = (*soilColumn)[i].get_Vs_SoilMoisture_m3();
 
     // Original: W(I) --> um Steingehalt korrigierte Feldkapazität
     /** @todo Claas: generelle Korrektur der Feldkapazität durch den Steingehalt */
@@ -300,8 +300,8 @@ void SoilTransport::fq_NTransport(double leachingDepth, double timeStepFactor) {
       soilMoistureGradient[i] = smi; //[m3 m-3]
     }
     else {
-      const auto fcip1 = soilColumn[i + 1].vs_FieldCapacity();
-      const auto smip1 = soilColumn[i + 1].get_Vs_SoilMoisture_m3();
+      const auto fcip1 = (*soilColumn)[i + 1].vs_FieldCapacity();
+      const auto smip1 = (*soilColumn)[i + 1].get_Vs_SoilMoisture_m3();
       vq_PoreWaterVelocity[i] = fabs((pri) / ((fci + fcip1) * 0.5)); // [m t-1]
       soilMoistureGradient[i] = (smi + smip1) * 0.5; //[m3 m-3]
     }
@@ -348,7 +348,7 @@ void SoilTransport::fq_NTransport(double leachingDepth, double timeStepFactor) {
   
   if (vq_PercolationRate[leachingDepthLayerIndex] > 0.0) {
     //vq_LeachingDepthLayerIndex = gewählte Auswaschungstiefe
-    const auto lt = soilColumn[leachingDepthLayerIndex].vs_LayerThickness;
+    const auto lt = (*soilColumn)[leachingDepthLayerIndex].vs_LayerThickness;
     const auto NO3 = vq_SoilNO3_aq[leachingDepthLayerIndex];
 
     if (leachingDepthLayerIndex < nols - 1) {
@@ -358,12 +358,12 @@ void SoilTransport::fq_NTransport(double leachingDepth, double timeStepFactor) {
       vq_LeachingAtBoundary += ((pr_u * NO3) / lt * 10000.0 * lt) + ((vq_DispersionCoeff[leachingDepthLayerIndex]
         * (NO3 - NO3_u)) / (lt * lt) * 10000.0 * lt); //[kg ha-1]
     } else {
-      const double pr_u = soilColumn.vs_FluxAtLowerBoundary / 1000.0 * timeStepFactor; // [m t-1]
+      const double pr_u = soilColumn->vs_FluxAtLowerBoundary / 1000.0 * timeStepFactor; // [m t-1]
       vq_LeachingAtBoundary += pr_u * NO3 / lt * 10000.0 * lt; //[kg ha-1]
     }
   } else {
     const auto pr_u = vq_PercolationRate[leachingDepthLayerIndex] / 1000.0 * timeStepFactor;
-    const auto lt = soilColumn[leachingDepthLayerIndex].vs_LayerThickness;
+    const auto lt = (*soilColumn)[leachingDepthLayerIndex].vs_LayerThickness;
     const auto NO3 = vq_SoilNO3_aq[leachingDepthLayerIndex];
 
     if (leachingDepthLayerIndex < nols - 1) {
@@ -378,7 +378,7 @@ void SoilTransport::fq_NTransport(double leachingDepth, double timeStepFactor) {
   // Update of NO3 concentration
   // including transfomation back into [kg NO3-N m soil-3]
   for (size_t i = 0; i < nols; i++) {
-    const auto smi = soilColumn[i].get_Vs_SoilMoisture_m3();
+    const auto smi = (*soilColumn)[i].get_Vs_SoilMoisture_m3();
     vq_SoilNO3_aq[i] += (vq_Dispersion[i] - vq_Convection[i]) / smi;
   }
 }
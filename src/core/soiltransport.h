@@ -42,7 +42,15 @@ public:
                 double pc_MinimumAvailableN);
 
   SoilTransport(SoilColumn& soilColumn, mas::schema::model::monica::SoilTransportModuleState::Reader reader, CropModule* cropModule = nullptr)
-    : soilColumn(soilColumn), cropModule(cropModule) { deserialize(reader); }
+    : soilColumn(&soilColumn), cropModule(cropModule) { deserialize(reader); }
+
+  //! copy of other bound to the soil column sc and crop module (of a copied model)
+  SoilTransport(const SoilTransport& other, SoilColumn& sc, CropModule* cropModule = nullptr)
+    : SoilTransport(other) {
+    soilColumn = &sc;
+    this->cropModule = cropModule;
+  }
+
   void deserialize(mas::schema::model::monica::SoilTransportModuleState::Reader reader);
   void serialize(mas::schema::model::monica::SoilTransportModuleState::Builder builder) const;
 
@@ -68,9 +76,11 @@ public:
   //debug
   double get_vq_Dispersion(int i_Layer) const;
   double get_vq_Convection(int i_Layer) const;
+  const std::vector<double>& vq_Dispersions() const { return vq_Dispersion; }
+  const std::vector<double>& vq_Convections() const { return vq_Convection; }
 
 private:
-  SoilColumn& soilColumn;
+  SoilColumn* soilColumn;
   SoilTransportModuleParameters _params;
   //const size_t vs_NumberOfLayers;
   std::vector<double> vq_Convection;
@@ -0,0 +1,128 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Claas Nendel <claas.nendel@zalf.de>
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "solar-geometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <map>
+#include <mutex>
+
+#include "tools/helper.h"
+
+using namespace std;
+using namespace monica;
+using namespace Tools;
+
+namespace {
+
+const double PI = 3.14159265358979323;
+
+// same as CropModule::fc_Radiation, see there for the origin of the equations
+SolarGeometry calcSolarGeometry(double latitude, int julianDay) {
+  SolarGeometry sg;
+  double jd = julianDay;
+
+  sg.declination = -23.4 * cos(2.0 * PI * ((jd + 10.0) / 365.0));
+
+  sg.declinationSinus = sin(sg.declination * PI / 180.0) * sin(latitude * PI / 180.0);
+  sg.declinationCosinus = cos(sg.declination * PI / 180.0) * cos(latitude * PI / 180.0);
+  double sinus = sg.declinationSinus;
+  double cosinus = sg.declinationCosinus;
+
+  double arg_AstroDayLength = bound(-1.0, sinus / cosinus, 1.0);
+  sg.astronomicDayLength = 12.0 * (PI + 2.0 * asin(arg_AstroDayLength)) / PI;
+
+  double EDLHelper = (-sin(8.0 * PI / 180.0) + sinus) / cosinus;
+  if ((EDLHelper < -1.0) || (EDLHelper > 1.0)) {
+    sg.effectiveDayLength = 0.01;
+  } else {
+    sg.effectiveDayLength = 12.0 * (PI + 2.0 * asin(EDLHelper)) / PI;
+  }
+
+  double arg_PhotoDayLength = bound(-1.0, (-sin(-6.0 * PI / 180.0) + sinus) / cosinus, 1.0);
+  sg.photoperiodicDayLength = 12.0 * (PI + 2.0 * asin(arg_PhotoDayLength)) / PI;
+
+  double arg_PhotAct = min(1.0, ((sinus / cosinus) * (sinus / cosinus)));
+  sg.photActRadiationMean = 3600.0 * (sinus * sg.astronomicDayLength +
+                                      24.0 / PI * cosinus * sqrt(1.0 - arg_PhotAct));
+
+  if (sg.photActRadiationMean > 0 && sg.astronomicDayLength > 0) {
+    sg.clearDayRadiation = 0.5 * 1300.0 * sg.photActRadiationMean *
+                           exp(-0.14 / (sg.photActRadiationMean / (sg.astronomicDayLength * 3600.0)));
+  }
+  sg.overcastDayRadiation = 0.2 * sg.clearDayRadiation;
+
+  double pc_SolarConstant = 0.082; //[MJ m-2 d-1]
+  double SC = 24.0 * 60.0 / PI * pc_SolarConstant * (1.0 + 0.033 * cos(2.0 * PI * jd / 365.0));
+  double arg_SolarAngle = bound(-1.0, -tan(latitude * PI / 180.0) * tan(sg.declination * PI / 180.0), 1.0);
+  double sunsetSolarAngle = acos(arg_SolarAngle);
+  sg.extraterrestrialRadiation = SC * (sunsetSolarAngle * sinus + cosinus * sin(sunsetSolarAngle)); // [MJ m-2]
+
+  for (int h = 0; h < 24; h++) {
+    sg.solarElevation[h] = solarElevation(h, latitude, julianDay);
+    sg.hourlyRadiationFraction[h] = hourlyRad(1.0, latitude, julianDay, h);
+    sg.hourlyExtraterrestrialRadiation[h] = hourlyRad(sg.extraterrestrialRadiation, latitude, julianDay, h);
+  }
+
+  return sg;
+}
+
+} // namespace
+
+SolarGeometryTable::SolarGeometryTable(double latitude)
+  : _latitude(latitude) {
+  for (int jd = 1; jd <= 366; jd++) _days[jd - 1] = calcSolarGeometry(latitude, jd);
+
+  // the hourly global radiation is taken as the daily sum times the hourly fraction,
+  // which is just right if hourlyRad scales linearly with the daily sum, so check this for the usual range of sums
+  for (int jd = 1; jd <= 366 && _hourlyRadiationIsProportional; jd++) {
+    const auto& sg = _days[jd - 1];
+    for (int h = 0; h < 24 && _hourlyRadiationIsProportional; h++) {
+      for (double globrad : {5.0, 35.0}) { // [MJ m-2 d-1]
+        double proportional = globrad * sg.hourlyRadiationFraction[h];
+        if (fabs(hourlyRad(globrad, latitude, jd, h) - proportional) > 1e-9 * max(1.0, fabs(proportional))) {
+          _hourlyRadiationIsProportional = false;
+        }
+      }
+    }
+  }
+}
+
+shared_ptr<const SolarGeometryTable> SolarGeometryTable::forLatitude(double latitude) {
+  static mutex lockable;
+  static map<double, shared_ptr<const SolarGeometryTable>> tables;
+  // latitudes, most recently used first
+  static list<double> lru;
+
+  lock_guard<mutex> lock(lockable);
+  auto it = tables.find(latitude);
+  if (it != tables.end()) {
+    lru.remove(latitude);
+    lru.push_front(latitude);
+    return it->second;
+  }
+
+  auto sp = make_shared<const SolarGeometryTable>(latitude);
+  if (tables.size() >= maxCachedTables) {
+    tables.erase(lru.back());
+    lru.pop_back();
+  }
+  tables.emplace(latitude, sp);
+  lru.push_front(latitude);
+  return sp;
+}
@@ -0,0 +1,76 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Claas Nendel <claas.nendel@zalf.de>
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+
+namespace monica {
+
+//! the radiation and day length terms of a day, which depend only on latitude and day of year
+struct SolarGeometry {
+  double declination{0.0}; //!< old DEC [°]
+  double declinationSinus{0.0}; //!< old SINLD
+  double declinationCosinus{0.0}; //!< old COSLD
+  double astronomicDayLength{0.0}; //!< old DL [h]
+  double effectiveDayLength{0.0}; //!< old DLE [h]
+  double photoperiodicDayLength{0.0}; //!< old DLP [h]
+  double photActRadiationMean{0.0}; //!< old RDN [J m-2]
+  double clearDayRadiation{0.0}; //!< old DRC [J m-2]
+  double overcastDayRadiation{0.0}; //!< old DRO [J m-2]
+  double extraterrestrialRadiation{0.0}; //!< old EXT [MJ m-2]
+
+  std::array<double, 24> solarElevation{}; //!< [rad]
+  std::array<double, 24> hourlyRadiationFraction{}; //!< part of the daily global radiation falling into an hour
+  std::array<double, 24> hourlyExtraterrestrialRadiation{}; //!< [MJ m-2 h-1]
+};
+
+/**
+ * @brief Solar geometry of every day of the year at a latitude.
+ *
+ * The table is immutable after construction, so all runs at the same latitude
+ * (e.g. the cells of a latitude band in a grid run) share one instance via forLatitude().
+ * The shared tables of the most recently used latitudes are kept (see maxCachedTables),
+ * evicted ones stay alive as long as a crop still holds them.
+ */
+class SolarGeometryTable {
+public:
+  explicit SolarGeometryTable(double latitude);
+
+  //! get the shared table for the latitude, the table is built on first use
+  static std::shared_ptr<const SolarGeometryTable> forLatitude(double latitude);
+
+  //! number of tables (about 250 kB each) forLatitude() keeps for reuse
+  static const size_t maxCachedTables = 64;
+
+  double latitude() const { return _latitude; }
+
+  //! true if hourlyRad(globrad, ...) == globrad * hourlyRadiationFraction for all days and hours,
+  //! checked at construction, else the hourly global radiation has to be calculated with hourlyRad itself
+  bool hourlyRadiationIsProportional() const { return _hourlyRadiationIsProportional; }
+
+  //! @param julianDay day of year [1-366]
+  const SolarGeometry& at(int julianDay) const { return _days.at(size_t(julianDay - 1)); }
+
+private:
+  double _latitude{0.0};
+  bool _hourlyRadiationIsProportional{true};
+  std::array<SolarGeometry, 366> _days;
+};
+
+} // namespace monica
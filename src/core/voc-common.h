@@ -28,11 +28,15 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #pragma once
 
+#include <array>
+#include <bitset>
 #include <map>
 #include <vector>
 #include <cmath>
 #include <limits>
 
+#include <kj/debug.h>
+
 #include "model/monica/monica_params.capnp.h"
 
 namespace Voc
@@ -336,21 +340,27 @@ struct MicroClimateData
 
 struct Emissions
 {
+  //! max number of species (crops) whose emissions can be distinguished, right now there is just one crop at a time,
+  //! emissions of higher species ids are rejected with a kj::Exception instead of being dropped
+  static constexpr std::size_t MAX_SPECIES = 4;
+
   void serialize(mas::schema::model::monica::Voc::Emissions::Builder builder) const {
     {
-      auto isos = builder.initSpeciesIdToIsopreneEmission((capnp::uint)speciesId_2_isoprene_emission.size());
+      auto isos = builder.initSpeciesIdToIsopreneEmission((capnp::uint)speciesIds.count());
       capnp::uint i = 0;
-      for (auto p : speciesId_2_isoprene_emission) {
-        isos[i].setSpeciesId(p.first);
-        isos[i++].setEmission(p.second);;
+      for (std::size_t id = 0; id < MAX_SPECIES; id++) {
+        if (!speciesIds[id]) continue;
+        isos[i].setSpeciesId((int)id);
+        isos[i++].setEmission(speciesId_2_isoprene_emission[id]);
       }
     }
     {
-      auto monos = builder.initSpeciesIdToMonoterpeneEmission((capnp::uint)speciesId_2_monoterpene_emission.size());
+      auto monos = builder.initSpeciesIdToMonoterpeneEmission((capnp::uint)speciesIds.count());
       capnp::uint i = 0;
-      for (auto p : speciesId_2_monoterpene_emission) {
-        monos[i].setSpeciesId(p.first);
-        monos[i++].setEmission(p.second);;
+      for (std::size_t id = 0; id < MAX_SPECIES; id++) {
+        if (!speciesIds[id]) continue;
+        monos[i].setSpeciesId((int)id);
+        monos[i++].setEmission(speciesId_2_monoterpene_emission[id]);
       }
     }
     builder.setIsopreneEmission(isoprene_emission);
@@ -358,29 +368,49 @@ struct Emissions
   }
 
   void deserialize(mas::schema::model::monica::Voc::Emissions::Reader reader) {
-  speciesId_2_isoprene_emission.clear();
-  for (auto e : reader.getSpeciesIdToIsopreneEmission()) speciesId_2_isoprene_emission[(int)e.getSpeciesId()] = e.getEmission();
+    speciesIds.reset();
+    speciesId_2_isoprene_emission.fill(0.0);
+    speciesId_2_monoterpene_emission.fill(0.0);
+    for (auto e : reader.getSpeciesIdToIsopreneEmission()) {
+      auto id = (std::size_t)e.getSpeciesId();
+      KJ_REQUIRE(id < MAX_SPECIES, "isoprene emission of unsupported species id", e.getSpeciesId(), MAX_SPECIES);
+      speciesIds.set(id);
+      speciesId_2_isoprene_emission[id] = e.getEmission();
+    }
+    for (auto e : reader.getSpeciesIdToMonoterpeneEmission()) {
+      auto id = (std::size_t)e.getSpeciesId();
+      KJ_REQUIRE(id < MAX_SPECIES, "monoterpene emission of unsupported species id", e.getSpeciesId(), MAX_SPECIES);
+      speciesIds.set(id);
+      speciesId_2_monoterpene_emission[id] = e.getEmission();
+    }
 
-    speciesId_2_monoterpene_emission.clear();
-    for (auto e : reader.getSpeciesIdToMonoterpeneEmission()) speciesId_2_monoterpene_emission[(int)e.getSpeciesId()] = e.getEmission();
-    
     isoprene_emission = reader.getIsopreneEmission();
     monoterpene_emission = reader.getMonoterpeneEmission();
   }
 
+  void setSpeciesEmissions(int speciesId, double isoprene, double monoterpene) {
+    auto id = (std::size_t)speciesId;
+    KJ_REQUIRE(id < MAX_SPECIES, "emissions of unsupported species id", speciesId, MAX_SPECIES);
+    speciesIds.set(id);
+    speciesId_2_isoprene_emission[id] = isoprene;
+    speciesId_2_monoterpene_emission[id] = monoterpene;
+  }
+
   Emissions& operator+=(const Emissions& other)
   {
-    for(auto p : other.speciesId_2_isoprene_emission)
-      speciesId_2_isoprene_emission[p.first] += p.second;
-    for(auto p : other.speciesId_2_monoterpene_emission)
-      speciesId_2_monoterpene_emission[p.first] += p.second;
+    for (std::size_t id = 0; id < MAX_SPECIES; id++) {
+      speciesId_2_isoprene_emission[id] += other.speciesId_2_isoprene_emission[id];
+      speciesId_2_monoterpene_emission[id] += other.speciesId_2_monoterpene_emission[id];
+    }
+    speciesIds |= other.speciesIds;
     isoprene_emission += other.isoprene_emission;
     monoterpene_emission += other.monoterpene_emission;
     return *this;
   }
 
-  std::map<int, double> speciesId_2_isoprene_emission; //!< [umol m-2Ground ts-1] isoprene emissions per timestep and plant
-  std::map<int, double> speciesId_2_monoterpene_emission; //!< [umol m-2Ground ts-1] monoterpene emissions per timestep and plant
+  std::array<double, MAX_SPECIES> speciesId_2_isoprene_emission{}; //!< [umol m-2Ground ts-1] isoprene emissions per timestep and plant
+  std::array<double, MAX_SPECIES> speciesId_2_monoterpene_emission{}; //!< [umol m-2Ground ts-1] monoterpene emissions per timestep and plant
+  std::bitset<MAX_SPECIES> speciesIds; //!< the species which have emissions set
 
   double isoprene_emission{0.0}; //!< [umol m-2Ground ts-1] isoprene emissions per timestep
   double monoterpene_emission{0.0}; //!< [umol m-2Ground ts-1] monoterpene emissions per timestep
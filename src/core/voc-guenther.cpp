@@ -70,54 +70,67 @@ LeafEmissions calcLeafEmission(const leaf_emission_t& lemi,
   return lems;
 }
 
+namespace {
+
+void addSpeciesEmissions(Emissions& ems,
+                         const SpeciesData& species,
+                         const MicroClimateData& mcd,
+                         double tslength) {
+  if(species.mFol > 0.0) {
+    leaf_emission_t lemi;
+
+    // conversion of enzyme activity (umol m-2 s-1) in emission factor (ugC g-1 h-1)
+    // specific leaf weight (g m-2)
+    double const lsw = G_IN_KG / species.sla;
+    static double const  C0 = SEC_IN_HR * MC * UG_IN_NG;
+    lemi.enz_act.ef_iso = species.EF_ISO; //5.0 * C0 * species.phys_isoAct_vtfl.at(fl) / (lsw * species.SCALE_I);
+    lemi.enz_act.ef_mono = species.EF_MONO; //10.0 * C0 * species.phys_monoAct_vtfl.at(fl) / (lsw * species.SCALE_M);
+
+    // conversion of microclimate variables
+    lemi.pho.par = mcd.rad * FPAR * W_IN_UMOL; // par [umol m-2 s-1 pa-radiation] = rad_fl [W m-2 global radiation] * 0.45 * 4.57
+    //lemi.pho.par24 = mcd.rad24 * FPAR * W_IN_UMOL;
+    //lemi.pho.par240 = mcd.rad240 * FPAR * W_IN_UMOL;
+    lemi.fol.tempK = mcd.tFol + D_IN_K;
+    //lemi.fol.tempK24 = mcd.tFol24 + D_IN_K;
+    //lemi.fol.tempK240 = mcd.tFol240 + D_IN_K;
+
+    // emission in dependence on light and temperature, weighted over canopy layers
+    auto lems = calcLeafEmission(lemi, species.EF_MONOS);
+
+    // conversion from (ugC g-1 h-1) to (umol m-2 s-1) and weighting with leaf area and time
+    double const  C1 = (lsw / (SEC_IN_HR * MC)) * species.lai * tslength;
+    double ts_isoprene_em = (1.0 / C_ISO) * C1 * lems.isoprene;
+    double ts_monoterpene_em = (1.0 / C_MONO) * C1 * lems.monoterp;
+    //std::cout << C1 << " " << lems.isoprene << " " << ts_isoprene_em << std::endl;
+
+    // works only with 24 hour time step???        ph_.cUpt_vtfl[vt][fl] -= ((ph_.ts_isoprene_emission_vtfl[vt][fl] * 5.0 + ph_.ts_monoterpene_emission_vtfl[vt][fl] * 10.0) * MC / (UMOL_IN_MOL * G_IN_KG));  // rg 18.06.10
+
+    ems.setSpeciesEmissions(species.id, ts_isoprene_em, ts_monoterpene_em);
+    ems.isoprene_emission += ts_isoprene_em;
+    ems.monoterpene_emission += ts_monoterpene_em;
+  } else {
+    ems.setSpeciesEmissions(species.id, 0.0, 0.0);
+  }
+}
+
+} // namespace
+
 Voc::Emissions
-Voc::calculateGuentherVOCEmissionsMultipleSpecies(std::vector<SpeciesData> sds,
+Voc::calculateGuentherVOCEmissionsMultipleSpecies(const std::vector<SpeciesData>& sds,
                                                   const MicroClimateData& mcd,
                                                   double dayFraction) {
   Emissions ems;
-
   double const tslength = SEC_IN_DAY * dayFraction;
+  for(const SpeciesData& species : sds) addSpeciesEmissions(ems, species, mcd, tslength);
+  return ems;
+}
 
-  for(const SpeciesData& species : sds) {
-    if(species.mFol > 0.0) {
-      leaf_emission_t lemi;
-
-      // conversion of enzyme activity (umol m-2 s-1) in emission factor (ugC g-1 h-1)
-      // specific leaf weight (g m-2)
-      double const lsw = G_IN_KG / species.sla;
-      static double const  C0 = SEC_IN_HR * MC * UG_IN_NG;
-      lemi.enz_act.ef_iso = species.EF_ISO; //5.0 * C0 * species.phys_isoAct_vtfl.at(fl) / (lsw * species.SCALE_I);
-      lemi.enz_act.ef_mono = species.EF_MONO; //10.0 * C0 * species.phys_monoAct_vtfl.at(fl) / (lsw * species.SCALE_M);
-
-      // conversion of microclimate variables
-      lemi.pho.par = mcd.rad * FPAR * W_IN_UMOL; // par [umol m-2 s-1 pa-radiation] = rad_fl [W m-2 global radiation] * 0.45 * 4.57
-      //lemi.pho.par24 = mcd.rad24 * FPAR * W_IN_UMOL;
-      //lemi.pho.par240 = mcd.rad240 * FPAR * W_IN_UMOL;
-      lemi.fol.tempK = mcd.tFol + D_IN_K;
-      //lemi.fol.tempK24 = mcd.tFol24 + D_IN_K;
-      //lemi.fol.tempK240 = mcd.tFol240 + D_IN_K;
-
-      // emission in dependence on light and temperature, weighted over canopy layers
-      auto lems = calcLeafEmission(lemi, species.EF_MONOS);
-
-      // conversion from (ugC g-1 h-1) to (umol m-2 s-1) and weighting with leaf area and time
-      double const  C1 = (lsw / (SEC_IN_HR * MC)) * species.lai * tslength;
-      double ts_isoprene_em = (1.0 / C_ISO) * C1 * lems.isoprene;
-      double ts_monoterpene_em = (1.0 / C_MONO) * C1 * lems.monoterp;
-      //std::cout << C1 << " " << lems.isoprene << " " << ts_isoprene_em << std::endl;
-
-      // works only with 24 hour time step???        ph_.cUpt_vtfl[vt][fl] -= ((ph_.ts_isoprene_emission_vtfl[vt][fl] * 5.0 + ph_.ts_monoterpene_emission_vtfl[vt][fl] * 10.0) * MC / (UMOL_IN_MOL * G_IN_KG));  // rg 18.06.10
-
-      ems.speciesId_2_isoprene_emission[species.id] = ts_isoprene_em;
-      ems.isoprene_emission += ts_isoprene_em;
-      ems.speciesId_2_monoterpene_emission[species.id] = ts_monoterpene_em;
-      ems.monoterpene_emission += ts_monoterpene_em;
-    } else {
-      ems.speciesId_2_isoprene_emission[species.id] = 0.0;
-      ems.speciesId_2_monoterpene_emission[species.id] = 0.0;
-    }
-  }
-
+Voc::Emissions
+Voc::calculateGuentherVOCEmissions(const SpeciesData& species,
+                                   const MicroClimateData& mcd,
+                                   double dayFraction) {
+  Emissions ems;
+  addSpeciesEmissions(ems, species, mcd, SEC_IN_DAY * dayFraction);
   return ems;
 }
 
@@ -36,15 +36,13 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 namespace Voc {
 
-Emissions calculateGuentherVOCEmissionsMultipleSpecies(std::vector<SpeciesData> sds,
+Emissions calculateGuentherVOCEmissionsMultipleSpecies(const std::vector<SpeciesData>& sds,
                                                         const MicroClimateData& mc,
                                                         double dayFraction = 1.0);
 
-inline Emissions calculateGuentherVOCEmissions(const SpeciesData& species,
-                                                const MicroClimateData& mc,
-                                                double dayFraction = 1.0) {
-  return calculateGuentherVOCEmissionsMultipleSpecies({species}, mc, dayFraction);
-}
+Emissions calculateGuentherVOCEmissions(const SpeciesData& species,
+                                        const MicroClimateData& mc,
+                                        double dayFraction = 1.0);
 
 } // namespace Voc
 
@@ -194,88 +194,101 @@ LeafEmissions calcLeafEmission(const leaf_emission_t& lemi,
   return lems;
 }
 
-Voc::Emissions Voc::calculateJJVVOCEmissionsMultipleSpecies(std::vector<std::pair<SpeciesData, CPData>> sds,
+namespace {
+
+void addSpeciesEmissions(Emissions& ems,
+                         const SpeciesData& species,
+                         const CPData& cpData,
+                         const MicroClimateData& mcd,
+                         double tslength) {
+  if(species.mFol > 0.0) {
+    leaf_emission_t lemi;
+    leaf_emission_t leminorm;
+
+    // factors for conversion from enzyme activity (umol m-2 (leaf area) s-1) to emission factor (ugC g-1 h-1)
+    double const lsw = G_IN_KG / species.sla;
+    double const C0 = SEC_IN_HR * MC * UMOL_IN_NMOL; // C0 means carbon zero;
+    
+    //double const fCO2( 370.0 * 1.0 / this->ac->nd_co2_concentration_fl[fl]);
+    //double  lsw_gsim( lconst::NG_IN_UG * ( 1.0 / ( lconst::SEC_IN_HR * lconst::MC) * ( 1000.0 / this->vs->sla_vtfl[vt][fl])));
+    //this->phys->isoAct_vtfl[vt][fl]  = s->SCALE_I() * s->EF_ISO()  * lsw_gsim * ( 1.0 / 5.0) * fCO2;
+    //this->phys->monoAct_vtfl[vt][fl] = s->SCALE_M() * s->EF_MONO() * lsw_gsim * ( 1.0 / 10.0) * fCO2;
+
+    // VOCMEGAN USES THIS RECALCULATION:
+    // emission activity recalculated from growthpsim calculations
+    // enz_act.ef_iso/mono can be calculated more exactly (see seasonality comment below), but cancels out to 
+    // just EF_ISO/MONO for static co2 concentration
+    double nd_co2_concentration_fl = mcd.co2concentration; //CO2 concentration per canopy layer
+    double const fCO2 = (370.0 * 1.0 / nd_co2_concentration_fl);
+    double lsw_gsim = NG_IN_UG * (1.0 / (SEC_IN_HR * MC) * (1000.0 / species.sla));
+    
+    // "isoAct_vtfl"/"monoAct_vtfl" [nmol m-2 leaf area s-1] activity state of isoprene/monterpene synthase
+    double isoAct = species.SCALE_I * species.EF_ISO * lsw_gsim * (1.0 / 5.0) * fCO2;
+    double monoAct = species.SCALE_M * species.EF_MONO * lsw_gsim * (1.0 / 10.0) * fCO2;
+
+    // "enz_act.ef_iso/mono" --> emission factor (including seasonality!!!; similar to EF_ISO() and EF_MONO() but they provide no info about seasonality) 
+    lemi.enz_act.ef_iso = C_ISO * C0 * isoAct / (lsw * species.SCALE_I); // (ugC gDW-1 h-1)
+    //lemi.enz_act.ef_iso = species.EF_ISO;
+    lemi.enz_act.ef_mono = C_MONO * C0 * monoAct / (lsw * species.SCALE_M);  // (ugC gDW-1 h-1)
+    //lemi.enz_act.ef_mono = species.EF_MONO;
+    
+    // conversion of microclimate variables 
+    lemi.pho.par = mcd.rad * FPAR * UMOL_IN_W;    // fw: par (umol m-2 s-1 pa-radiation)] = rad_fl (W m-2 global radiation) * 0.45 * 4.57 ..
+    lemi.pho.par24 = mcd.rad24 * FPAR * UMOL_IN_W;
+    lemi.pho.par240 = mcd.rad240 * FPAR * UMOL_IN_W;
+    lemi.fol.tempK = mcd.tFol + D_IN_K;
+    lemi.fol.tempK24 = mcd.tFol24 + D_IN_K;
+    lemi.fol.tempK240 = mcd.tFol240 + D_IN_K;
+
+    // normalized microclimate variables 
+    leminorm.pho.par = PPFD0;
+    leminorm.fol.tempK = TREF;
+
+    // emission in dependence on light and temperature for photosynthesis and enzyme activity, weighted over canopy layers 
+    auto lems = calcLeafEmission(lemi, leminorm, species, mcd, cpData);
+
+    // conversion from (ugC g-1 h-1) to (umol m-2 ground s-1) and weighting with leaf area and time step length in seconds
+    //(reciprocal to the input conversion) 
+    // TODO(fw#): check if area correction is for m-2 ground or m-2 lai
+    double const C = (lsw / (SEC_IN_HR * MC)) * species.lai * tslength;
+
+    // TODO(fw#): check if area correction is for m-2 ground or m-2 lai
+    // fw: "isopr/ts_monoterpene_emission_vtfl": species and layer specific isoprene/monterpene emission (umol m-2Ground ts-1). 
+    double ts_isoprene_em = (1.0 / C_ISO)  * C * lems.isoprene;
+    double ts_monoterpene_em = (1.0 / C_MONO) * C * lems.monoterp;
+    //std::cout << C1 << " " << lems.isoprene << " " << ts_isoprene_em << std::endl;
+
+    //TODO(fw#): implement this!!!
+    //ph_.ts_carbonuptake_vtfl[vt][fl] -= ((ph_.ts_isoprene_emission_vtfl[vt][fl] * C_ISO + ph_.ts_monoterpene_emission_vtfl[vt][fl] * C_MONO) * MC / (UMOL_IN_MOL * G_IN_KG));  // rg 18.06.10;
+
+    // "ts_isoprene_emission/ts_monoterpene_emission": isoprene/monoterpene emission from the whole canopy and all species (umol m-2 ground). 
+    ems.setSpeciesEmissions(species.id, ts_isoprene_em, ts_monoterpene_em);
+    ems.isoprene_emission += ts_isoprene_em;
+    ems.monoterpene_emission += ts_monoterpene_em;
+  } else {
+    ems.setSpeciesEmissions(species.id, 0.0, 0.0);
+  }
+}
+
+} // namespace
+
+Voc::Emissions Voc::calculateJJVVOCEmissionsMultipleSpecies(const std::vector<std::pair<SpeciesData, CPData>>& sds,
                                                             const MicroClimateData& mcd,
                                                             double dayFraction,
                                                             bool calculateParTempTerm) {
   Emissions ems;
-
   double const tslength = SEC_IN_DAY * dayFraction;
+  for(const auto& p : sds) addSpeciesEmissions(ems, p.first, p.second, mcd, tslength);
+  return ems;
+}
 
-  for(const auto& p : sds) {
-    const SpeciesData& species = p.first;
-    const auto& cpData = p.second;
-
-    if(species.mFol > 0.0) {
-      leaf_emission_t lemi;
-      leaf_emission_t leminorm;
-
-      // factors for conversion from enzyme activity (umol m-2 (leaf area) s-1) to emission factor (ugC g-1 h-1)
-      double const lsw = G_IN_KG / species.sla;
-      double const C0 = SEC_IN_HR * MC * UMOL_IN_NMOL; // C0 means carbon zero;
-      
-      //double const fCO2( 370.0 * 1.0 / this->ac->nd_co2_concentration_fl[fl]);
-      //double  lsw_gsim( lconst::NG_IN_UG * ( 1.0 / ( lconst::SEC_IN_HR * lconst::MC) * ( 1000.0 / this->vs->sla_vtfl[vt][fl])));
-      //this->phys->isoAct_vtfl[vt][fl]  = s->SCALE_I() * s->EF_ISO()  * lsw_gsim * ( 1.0 / 5.0) * fCO2;
-      //this->phys->monoAct_vtfl[vt][fl] = s->SCALE_M() * s->EF_MONO() * lsw_gsim * ( 1.0 / 10.0) * fCO2;
-
-      // VOCMEGAN USES THIS RECALCULATION:
-      // emission activity recalculated from growthpsim calculations
-      // enz_act.ef_iso/mono can be calculated more exactly (see seasonality comment below), but cancels out to 
-      // just EF_ISO/MONO for static co2 concentration
-      double nd_co2_concentration_fl = mcd.co2concentration; //CO2 concentration per canopy layer
-      double const fCO2 = (370.0 * 1.0 / nd_co2_concentration_fl);
-      double lsw_gsim = NG_IN_UG * (1.0 / (SEC_IN_HR * MC) * (1000.0 / species.sla));
-      
-      // "isoAct_vtfl"/"monoAct_vtfl" [nmol m-2 leaf area s-1] activity state of isoprene/monterpene synthase
-      double isoAct = species.SCALE_I * species.EF_ISO * lsw_gsim * (1.0 / 5.0) * fCO2;
-      double monoAct = species.SCALE_M * species.EF_MONO * lsw_gsim * (1.0 / 10.0) * fCO2;
-
-      // "enz_act.ef_iso/mono" --> emission factor (including seasonality!!!; similar to EF_ISO() and EF_MONO() but they provide no info about seasonality) 
-      lemi.enz_act.ef_iso = C_ISO * C0 * isoAct / (lsw * species.SCALE_I); // (ugC gDW-1 h-1)
-      //lemi.enz_act.ef_iso = species.EF_ISO;
-      lemi.enz_act.ef_mono = C_MONO * C0 * monoAct / (lsw * species.SCALE_M);  // (ugC gDW-1 h-1)
-      //lemi.enz_act.ef_mono = species.EF_MONO;
-      
-      // conversion of microclimate variables 
-      lemi.pho.par = mcd.rad * FPAR * UMOL_IN_W;    // fw: par (umol m-2 s-1 pa-radiation)] = rad_fl (W m-2 global radiation) * 0.45 * 4.57 ..
-      lemi.pho.par24 = mcd.rad24 * FPAR * UMOL_IN_W;
-      lemi.pho.par240 = mcd.rad240 * FPAR * UMOL_IN_W;
-      lemi.fol.tempK = mcd.tFol + D_IN_K;
-      lemi.fol.tempK24 = mcd.tFol24 + D_IN_K;
-      lemi.fol.tempK240 = mcd.tFol240 + D_IN_K;
-
-      // normalized microclimate variables 
-      leminorm.pho.par = PPFD0;
-      leminorm.fol.tempK = TREF;
-
-      // emission in dependence on light and temperature for photosynthesis and enzyme activity, weighted over canopy layers 
-      auto lems = calcLeafEmission(lemi, leminorm, species, mcd, cpData);
-
-      // conversion from (ugC g-1 h-1) to (umol m-2 ground s-1) and weighting with leaf area and time step length in seconds
-      //(reciprocal to the input conversion) 
-      // TODO(fw#): check if area correction is for m-2 ground or m-2 lai
-      double const C = (lsw / (SEC_IN_HR * MC)) * species.lai * tslength;
-
-      // TODO(fw#): check if area correction is for m-2 ground or m-2 lai
-      // fw: "isopr/ts_monoterpene_emission_vtfl": species and layer specific isoprene/monterpene emission (umol m-2Ground ts-1). 
-      double ts_isoprene_em = (1.0 / C_ISO)  * C * lems.isoprene;
-      double ts_monoterpene_em = (1.0 / C_MONO) * C * lems.monoterp;
-      //std::cout << C1 << " " << lems.isoprene << " " << ts_isoprene_em << std::endl;
-
-      //TODO(fw#): implement this!!!
-      //ph_.ts_carbonuptake_vtfl[vt][fl] -= ((ph_.ts_isoprene_emission_vtfl[vt][fl] * C_ISO + ph_.ts_monoterpene_emission_vtfl[vt][fl] * C_MONO) * MC / (UMOL_IN_MOL * G_IN_KG));  // rg 18.06.10;
-
-      // "ts_isoprene_emission/ts_monoterpene_emission": isoprene/monoterpene emission from the whole canopy and all species (umol m-2 ground). 
-      ems.speciesId_2_isoprene_emission[species.id] = ts_isoprene_em;
-      ems.isoprene_emission += ts_isoprene_em;
-      ems.speciesId_2_monoterpene_emission[species.id] = ts_monoterpene_em;
-      ems.monoterpene_emission += ts_monoterpene_em;
-    } else {
-      ems.speciesId_2_isoprene_emission[species.id] = 0.0;
-      ems.speciesId_2_monoterpene_emission[species.id] = 0.0;
-    }
-  }
+Voc::Emissions Voc::calculateJJVVOCEmissions(const SpeciesData& species,
+                                            const MicroClimateData& mcd,
+                                            const CPData& cpData,
+                                            double dayFraction,
+                                            bool calculateParTempTerm) {
+  Emissions ems;
+  addSpeciesEmissions(ems, species, cpData, mcd, SEC_IN_DAY * dayFraction);
   return ems;
 }
 
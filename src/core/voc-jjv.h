@@ -40,17 +40,15 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 namespace Voc {
 
-Emissions calculateJJVVOCEmissionsMultipleSpecies(std::vector<std::pair<SpeciesData, CPData>> speciesData,
+Emissions calculateJJVVOCEmissionsMultipleSpecies(const std::vector<std::pair<SpeciesData, CPData>>& speciesData,
                                                   const MicroClimateData& mcd,
                                                   double dayFraction = 1.0,
                                                   bool calculateParTempTerm = false);
 
-inline Emissions calculateJJVVOCEmissions(SpeciesData sd,
-                                          const MicroClimateData& mcd,
-                                          CPData cpdata,
-                                          double dayFraction = 1.0,
-                                          bool calculateParTempTerm = false) {
-  return calculateJJVVOCEmissionsMultipleSpecies({std::make_pair(sd, cpdata)}, mcd, dayFraction, calculateParTempTerm);
-}
+Emissions calculateJJVVOCEmissions(const SpeciesData& sd,
+                                   const MicroClimateData& mcd,
+                                   const CPData& cpdata,
+                                   double dayFraction = 1.0,
+                                   bool calculateParTempTerm = false);
 
 } // namespace Voc
@@ -18,10 +18,12 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include <fstream>
 #include <algorithm>
-#include <mutex>
 #include <numeric>
 #include <iterator>
+#include <cctype>
 #include <climits>
+#include <iostream>
+#include <limits>
 
 #include "json11/json11-helper.h"
 #include "tools/debug.h"
@@ -33,6 +35,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "../core/soiltemperature.h"
 #include "../core/soiltransport.h"
 #include "../core/soilorganic.h"
+#include "expression.h"
 
 using namespace monica;
 using namespace Tools;
@@ -109,7 +112,145 @@ Json monica::applyOIdOP(OId::OP op, const vector<Json>& js)
   return res;
 }
 
-vector<OId> monica::parseOutputIds(const J11Array& oidArray)
+void StreamingOIdOP::add(double v)
+{
+  if (_count == 0) _first = _min = _max = v;
+  _last = v;
+  _sum += v;
+  _min = min(_min, v);
+  _max = max(_max, v);
+  if (_op == OId::MEDIAN) addToMedian(v);
+  ++_count;
+}
+
+void StreamingOIdOP::addToMedian(double v)
+{
+  //keep the first 5 values and init the markers with them
+  if (_count < 5)
+  {
+    _q[_count] = v;
+    if (_count == 4)
+    {
+      sort(begin(_q), end(_q));
+      for (int i = 0; i < 5; i++)
+      {
+        _n[i] = i;
+        _np[i] = i;
+      }
+    }
+    return;
+  }
+
+  //find the cell v falls into and adjust the extreme markers
+  int k = 0;
+  if (v < _q[0]) { _q[0] = v; k = 0; }
+  else if (v < _q[1]) k = 0;
+  else if (v < _q[2]) k = 1;
+  else if (v < _q[3]) k = 2;
+  else if (v <= _q[4]) k = 3;
+  else { _q[4] = v; k = 3; }
+
+  for (int i = k + 1; i < 5; i++) _n[i] += 1;
+  //desired positions for p = 0.5 grow by 0, 1/4, 1/2, 3/4, 1
+  for (int i = 0; i < 5; i++) _np[i] += i / 4.0;
+
+  //move the middle markers towards their desired positions, parabolic if possible, else linear
+  for (int i = 1; i < 4; i++)
+  {
+    double d = _np[i] - _n[i];
+    if ((d >= 1 && _n[i + 1] - _n[i] > 1) || (d <= -1 && _n[i - 1] - _n[i] < -1))
+    {
+      int s = d >= 0 ? 1 : -1;
+      double qp = _q[i] + s / (_n[i + 1] - _n[i - 1])
+        * ((_n[i] - _n[i - 1] + s) * (_q[i + 1] - _q[i]) / (_n[i + 1] - _n[i])
+           + (_n[i + 1] - _n[i] - s) * (_q[i] - _q[i - 1]) / (_n[i] - _n[i - 1]));
+      if (_q[i - 1] < qp && qp < _q[i + 1]) _q[i] = qp;
+      else _q[i] += s * (_q[i + s] - _q[i]) / (_n[i + s] - _n[i]);
+      _n[i] += s;
+    }
+  }
+}
+
+double StreamingOIdOP::value() const
+{
+  if (_count == 0) return 0.0;
+
+  switch (_op)
+  {
+  case OId::AVG: return _sum / _count;
+  case OId::MEDIAN: return _count < 5 ? median(vector<double>(_q, _q + _count)) : _q[2];
+  case OId::SUM: return _sum;
+  case OId::MIN: return _min;
+  case OId::MAX: return _max;
+  case OId::FIRST: return _first;
+  case OId::LAST:
+  case OId::NONE:
+  default: return _last;
+  }
+}
+
+void OIdAggregator::add(const Json& j)
+{
+  //the first value decides how the values are being aggregated
+  if (_count == 0)
+  {
+    _type = j.type();
+    if (_type == Json::STRING) _first = j;
+    else _ops.assign(_type == Json::ARRAY ? j.array_items().size() : 1, StreamingOIdOP(_op));
+  }
+  ++_count;
+
+  if (_type == Json::STRING) _last = j;
+  else if (_type == Json::ARRAY)
+  {
+    const auto& items = j.array_items();
+    for (size_t i = 0, size = min(items.size(), _ops.size()); i < size; i++)
+      _ops[i].add(items[i].number_value());
+  }
+  else _ops.front().add(j.number_value());
+}
+
+void OIdAggregator::add(double v)
+{
+  if (_count == 0)
+  {
+    _type = Json::NUMBER;
+    _ops.assign(1, StreamingOIdOP(_op));
+  }
+  ++_count;
+  _ops.front().add(v);
+}
+
+void OIdAggregator::add(const vector<double>& vs)
+{
+  if (_count == 0)
+  {
+    _type = Json::ARRAY;
+    _ops.assign(vs.size(), StreamingOIdOP(_op));
+  }
+  ++_count;
+  for (size_t i = 0, size = min(vs.size(), _ops.size()); i < size; i++)
+    _ops[i].add(vs[i]);
+}
+
+Json OIdAggregator::value() const
+{
+  if (_count == 0) return Json();
+
+  switch (_type)
+  {
+  case Json::STRING: return _op == OId::LAST ? _last : _first;
+  case Json::ARRAY:
+  {
+    J11Array r;
+    for (const auto& op : _ops) r.push_back(op.value());
+    return r;
+  }
+  default: return _ops.front().value();
+  }
+}
+
+vector<OId> monica::parseOutputIds(const J11Array& oidArray, Tools::Errors* errors)
 {
   vector<OId> outputIds;
 
@@ -161,9 +302,68 @@ vector<OId> monica::parseOutputIds(const J11Array& oidArray)
   };
 
   const auto& name2metadata = buildOutputTable().name2metadata;
+
+  //derived output "=<expression>|<display name>", the display name separator must not be part of a ||
+  auto parseDerivedOId = [&](const string& name, OId& oid)
+  {
+    auto text = name.substr(1);
+    string displayName;
+    auto p = text.rfind('|');
+    if (p != string::npos && p > 0 && text[p - 1] != '|' && (p + 1 == text.size() || text[p + 1] != '|'))
+    {
+      displayName = text.substr(p + 1);
+      text = text.substr(0, p);
+    }
+
+    auto res = Expression::compile(text);
+    if (!res.success())
+    {
+      for (const auto& e : res.errors)
+      {
+        auto msg = "Derived output '" + name + "': " + e;
+        if (errors)
+          errors->errors.push_back(msg);
+        else
+          cerr << "Error: " << msg << endl;
+      }
+      return false;
+    }
+
+    const auto& data = name2metadata.at("Expression");
+    oid.id = data.id;
+    oid.name = "=" + text;
+    oid.displayName = displayName;
+    oid.jsonInput = name;
+    oid.expression = res.result;
+    return true;
+  };
+
   for (Json idj : oidArray)
   {
-    if (idj.is_string())
+    if (idj.is_string() && idj.string_value().substr(0, 1) == "=")
+    {
+      OId oid;
+      if (parseDerivedOId(idj.string_value(), oid))
+        outputIds.push_back(oid);
+    }
+    else if (idj.is_array() && !idj.array_items().empty()
+             && idj[0].is_string() && idj[0].string_value().substr(0, 1) == "=")
+    {
+      //just the time aggregation operation is possible for derived outputs
+      OId oid;
+      if (parseDerivedOId(idj[0].string_value(), oid))
+      {
+        auto arr = idj.array_items();
+        for (size_t i = 1; i < arr.size(); i++)
+        {
+          auto op = getAggregationOp(arr, uint8_t(i));
+          if (op != OId::_UNDEFINED_OP_)
+            oid.timeAggOp = op;
+        }
+        outputIds.push_back(oid);
+      }
+    }
+    else if (idj.is_string())
     {
       string name = idj.string_value();
       auto names = splitString(name, "|");
@@ -255,6 +455,55 @@ vector<OId> monica::parseOutputIds(const J11Array& oidArray)
   return outputIds;
 }
 
+namespace
+{
+  bool isNameChar(char c) { return isalnum((unsigned char)c) || c == '_' || c == '-'; }
+
+  //! does text contain name as a whole word (e.g. "N2O" in "=N2O * 2", but not in "N2Onit")
+  bool mentions(const string& text, const string& name)
+  {
+    for (auto pos = text.find(name); pos != string::npos; pos = text.find(name, pos + 1))
+    {
+      auto end = pos + name.size();
+      if ((pos == 0 || !isNameChar(text[pos - 1])) && (end == text.size() || !isNameChar(text[end])))
+        return true;
+    }
+    return false;
+  }
+
+  void collectStrings(const Json& j, vector<const string*>& strings)
+  {
+    if (j.is_string()) strings.push_back(&j.string_value());
+    else if (j.is_array()) for (const auto& v : j.array_items()) collectStrings(v, strings);
+    else if (j.is_object()) for (const auto& p : j.object_items()) collectStrings(p.second, strings);
+  }
+}
+
+Diagnostics monica::requiredDiagnostics(const Json& j)
+{
+  static const vector<string> vocOutputs = {"guenther-isoprene-emission", "guenther-monoterpene-emission",
+                                            "jjv-isoprene-emission", "jjv-monoterpene-emission"};
+  static const vector<string> n2oOutputs = {"N2O", "N2Onit", "N2Odenit"};
+  //! worksteps whose saved state may be resumed by a run requesting any output
+  static const vector<string> stateSavers = {"SaveMonicaState"};
+
+  vector<const string*> strings;
+  collectStrings(j, strings);
+  auto anyMentioned = [&](const vector<string>& names)
+  {
+    for (const auto* s : strings)
+      for (const auto& name : names)
+        if (mentions(*s, name)) return true;
+    return false;
+  };
+
+  Diagnostics ds;
+  if (anyMentioned(stateSavers)) return ds;
+  ds.vocEmissions = anyMentioned(vocOutputs);
+  ds.n2oProduction = anyMentioned(n2oOutputs);
+  return ds;
+}
+
 template<typename T, typename Vector>
 void store(OId oid, Vector& into, function<T(int)> getValue, int roundToDigits = 0)
 {
@@ -282,13 +531,21 @@ void store(OId oid, Vector& into, function<T(int)> getValue, int roundToDigits =
     into.push_back(applyOIdOP(oid.layerAggOp, vs));
 }
 
-template<typename T>
-Json getComplexValues(OId oid, function<T(int)> getValue, int roundToDigits = 0)
+//! getValue is any callable int -> T, taken as template parameter to avoid the std::function call per layer
+template<typename T, typename GetValue>
+Json getComplexValues(OId oid, GetValue getValue, int roundToDigits = 0)
 {
   J11Array multipleValues;
   vector<double> vs;
   if (oid.isOrgan())
     oid.toLayer = oid.fromLayer = int(oid.organ);
+  if (oid.toLayer >= oid.fromLayer)
+  {
+    if (oid.layerAggOp == OId::NONE)
+      multipleValues.reserve(oid.toLayer - oid.fromLayer + 1);
+    else
+      vs.reserve(oid.toLayer - oid.fromLayer + 1);
+  }
 
   for (int i = oid.fromLayer; i <= oid.toLayer; i++)
   {
@@ -306,6 +563,62 @@ Json getComplexValues(OId oid, function<T(int)> getValue, int roundToDigits = 0)
   return oid.layerAggOp == OId::NONE ? Json(multipleValues) : Json(applyOIdOP(oid.layerAggOp, vs));
 }
 
+//! writes the values of the layers [oid.fromLayer, oid.toLayer] of a variable with noOfLayers layers to into,
+//! copyLayers(from, to, into) copies the available layers [from, to] contiguously, the missing layers are 0
+template<typename CopyLayers>
+void sliceLayerValues(const OId& oid, size_t noOfLayers, CopyLayers copyLayers, vector<double>& into)
+{
+  into.clear();
+  if (oid.toLayer < oid.fromLayer)
+    return;
+
+  into.resize(size_t(oid.toLayer - oid.fromLayer) + 1, 0.0);
+  if (oid.fromLayer < 0)
+    debug() << "Error: " << oid.toString(true) << " has no or negative layer defined! Returning 0." << endl;
+  if (oid.toLayer < 0 || noOfLayers == 0)
+    return;
+
+  auto from = size_t(max(oid.fromLayer, 0));
+  auto to = min(size_t(oid.toLayer), noOfLayers - 1);
+  if (from <= to)
+    copyLayers(from, to, into.data() + (int(from) - oid.fromLayer));
+}
+
+//! per layer output of the values of a per layer vector (of a process module)
+void vectorLayerValues(const OId& oid, const vector<double>& layerValues, vector<double>& into)
+{
+  sliceLayerValues(oid, layerValues.size(), [&](size_t from, size_t to, double* p)
+  {
+    copy(layerValues.begin() + from, layerValues.begin() + to + 1, p);
+  }, into);
+}
+
+//! per layer output of a variable of the soil layers
+template<typename Get>
+void soilLayerValues(const MonicaModel& monica, const OId& oid, Get get, vector<double>& into)
+{
+  const auto& sc = monica.soilColumn();
+  sliceLayerValues(oid, sc.size(), [&](size_t from, size_t to, double* p) { sc.layerValues(get, from, to, p); }, into);
+}
+
+void monica::layerOutputValues(const BOTRes::LayerOutput& lo, const MonicaModel& monica, OId oid, vector<double>& into)
+{
+  if (oid.isOrgan())
+    oid.toLayer = oid.fromLayer = int(oid.organ);
+
+  lo.values(monica, oid, into);
+  if (oid.layerAggOp == OId::NONE)
+  {
+    for (auto& v : into)
+      v = Tools::round(v, lo.roundToDigits);
+  }
+  else
+  {
+    auto v = applyOIdOP(oid.layerAggOp, into);
+    into.assign(1, v);
+  }
+}
+
 void setComplexValues(OId oid, function<void(int, json11::Json)> setValue, Json value)
 {
   if (oid.isOrgan())
@@ -328,1255 +641,1280 @@ void setComplexValues(OId oid, function<void(int, json11::Json)> setValue, Json
   }
 }
 
-BOTRes& monica::buildOutputTable()
+//! builds the table of all outputs, the output functions are indexed by the output ids
+static BOTRes createOutputTable()
 {
-  static mutex lockable;
+  BOTRes m;
 
-  //map of output ids to outputfunction
-  static BOTRes m;
-  static bool tableBuilt = false;
-
-  typedef decltype(m.setfs)::mapped_type SETF_T;
   auto build = [&](OutputMetadata r,
-    decltype(m.ofs)::mapped_type of,
-    decltype(m.setfs)::mapped_type setf = SETF_T())
+    BOTRes::OutputFunc of,
+    BOTRes::SetFunc setf = BOTRes::SetFunc())
   {
+    if (size_t(r.id) >= m.ofs.size())
+    {
+      m.ofs.resize(r.id + 1);
+      m.setfs.resize(r.id + 1);
+    }
     m.ofs[r.id] = of;
-    if (setf)
-      m.setfs[r.id] = setf;
+    m.setfs[r.id] = setf;
     m.name2metadata[r.name] = r;
     return r;
   };
 
-  // only initialize once
-  if (!tableBuilt)
+  //! per layer output, the output function returns the values of the layer output as json11 value
+  auto buildLayered = [&](OutputMetadata r,
+    BOTRes::LayerOutput lo,
+    BOTRes::SetFunc setf = BOTRes::SetFunc())
   {
-    lock_guard<mutex> lock(lockable);
-
-    //test if after waiting for the lock the other thread
-    //already initialized the whole thing
-    if (!tableBuilt)
+    if (size_t(r.id) >= m.layerOutputs.size())
+      m.layerOutputs.resize(r.id + 1);
+    m.layerOutputs[r.id] = lo;
+    return build(r, [lo](const MonicaModel& monica, OId oid) -> Json
     {
-      int id = 0;
+      thread_local vector<double> vs;
+      layerOutputValues(lo, monica, oid, vs);
+      if (oid.layerAggOp != OId::NONE)
+        return vs.front();
+      return J11Array(vs.begin(), vs.end());
+    }, setf);
+  };
 
-      build({ id++, "Count", "", "output 1 for counting things" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return 1;
-      });
+  int id = 0;
 
-      build({ id++, "CM-count", "", "output the order number of the current cultivation method" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cultivationMethodCount();
-      });
+  build({ id++, "Count", "", "output 1 for counting things" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return 1;
+  });
 
-      build({ id++, "Date", "", "output current date" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.currentStepDate().toIsoDateString();
-      });
+  build({ id++, "CM-count", "", "output the order number of the current cultivation method" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cultivationMethodCount();
+  });
 
-      build({ id++, "days-since-start", "", "output number of days since simulation start" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.currentStepDate() - monica.simulationParameters().startDate;
-      });
+  build({ id++, "Date", "", "output current date" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.currentStepDate().toIsoDateString();
+  });
 
-      build({ id++, "DOY", "", "output current day of year" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return int(monica.currentStepDate().dayOfYear());
-      });
+  build({ id++, "days-since-start", "", "output number of days since simulation start" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.currentStepDate() - monica.simulationParameters().startDate;
+  });
 
-      build({ id++, "Month", "", "output current Month" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return int(monica.currentStepDate().month());
-      });
+  build({ id++, "DOY", "", "output current day of year" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return int(monica.currentStepDate().dayOfYear());
+  });
 
-      build({ id++, "Year", "", "output current Year" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return int(monica.currentStepDate().year());
-      });
+  build({ id++, "Month", "", "output current Month" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return int(monica.currentStepDate().month());
+  });
 
-      build({ id++, "Crop", "", "crop name" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? monica.cropGrowth()->get_CropName() : "";
-      });
+  build({ id++, "Year", "", "output current Year" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return int(monica.currentStepDate().year());
+  });
 
-      build({ id++, "TraDef", "0;1", "Transpiration deficit" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_TranspirationDeficit(), 2) : 0.0;
-      });
+  build({ id++, "Crop", "", "crop name" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? monica.cropGrowth()->get_CropName() : "";
+  });
 
-      build({ id++, "NDef", "0;1", "Crop nitrogen deficit" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_CropNRedux(), 5) : 0.0;
-      });
+  build({ id++, "TraDef", "0;1", "Transpiration deficit" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_TranspirationDeficit(), 2) : 0.0;
+  });
 
-      build({ id++, "RootNDef", "0;1", "Root nitrogen deficit" },
-      [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->rootNRedux, 2) : 0.0;
-      });
+  build({ id++, "NDef", "0;1", "Crop nitrogen deficit" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_CropNRedux(), 5) : 0.0;
+  });
 
-      build({ id++, "HeatRed", "0;1", " HeatStressRedux" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_HeatStressRedux(), 2) : 0.0;
-      });
+  build({ id++, "RootNDef", "0;1", "Root nitrogen deficit" },
+  [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->rootNRedux, 2) : 0.0;
+  });
 
-      build({ id++, "FrostRed", "0;1", "FrostStressRedux" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_FrostStressRedux(), 2) : 0.0;
-      });
+  build({ id++, "HeatRed", "0;1", " HeatStressRedux" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_HeatStressRedux(), 2) : 0.0;
+  });
 
-      build({ id++, "OxRed", "0;1", "OxygenDeficit" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_OxygenDeficit(), 2) : 0.0;
-      });
+  build({ id++, "FrostRed", "0;1", "FrostStressRedux" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_FrostStressRedux(), 2) : 0.0;
+  });
 
-      build({ id++, "TimeUnderAnoxia", "0;1", "TimeUnderAnoxia" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->vc_TimeUnderAnoxia, 2) : 0.0;
-      });
+  build({ id++, "OxRed", "0;1", "OxygenDeficit" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_OxygenDeficit(), 2) : 0.0;
+  });
 
-      build({ id++, "Stage", "1-6/7", "DevelopmentalStage" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? int(monica.cropGrowth()->get_DevelopmentalStage()) + 1 : 0;
-      },
-        [](MonicaModel& monica, OId oid, Json value)
-      {
-        if (value.is_number() && monica.cropGrowth())
-          monica.cropGrowth()->setStage(max(0, int(value.number_value()) - 1));
-      });
+  build({ id++, "TimeUnderAnoxia", "0;1", "TimeUnderAnoxia" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->vc_TimeUnderAnoxia, 2) : 0.0;
+  });
 
-      build({ id++, "TempSum", "�Cd", "CurrentTemperatureSum" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_CurrentTemperatureSum(), 1) : 0.0;
-      });
+  build({ id++, "Stage", "1-6/7", "DevelopmentalStage" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? int(monica.cropGrowth()->get_DevelopmentalStage()) + 1 : 0;
+  },
+    [](MonicaModel& monica, OId oid, Json value)
+  {
+    if (value.is_number() && monica.cropGrowth())
+      monica.cropGrowth()->setStage(max(0, int(value.number_value()) - 1));
+  });
 
-      build({ id++, "VernF", "0;1", "VernalisationFactor" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_VernalisationFactor(), 2) : 0.0;
-      });
+  build({ id++, "TempSum", "�Cd", "CurrentTemperatureSum" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_CurrentTemperatureSum(), 1) : 0.0;
+  });
 
-      build({ id++, "DaylF", "0;1", "DaylengthFactor" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_DaylengthFactor(), 2) : 0.0;
-      });
+  build({ id++, "VernF", "0;1", "VernalisationFactor" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_VernalisationFactor(), 2) : 0.0;
+  });
 
-      build({ id++, "IncRoot", "kg ha-1", "OrganGrowthIncrement root" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_OrganGrowthIncrement(OId::ROOT), 2) : 0.0;
-      });
+  build({ id++, "DaylF", "0;1", "DaylengthFactor" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_DaylengthFactor(), 2) : 0.0;
+  });
 
-      build({ id++, "IncLeaf", "kg ha-1", "OrganGrowthIncrement leaf" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_OrganGrowthIncrement(OId::LEAF), 2) : 0.0;
-      });
+  build({ id++, "IncRoot", "kg ha-1", "OrganGrowthIncrement root" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_OrganGrowthIncrement(OId::ROOT), 2) : 0.0;
+  });
 
-      build({ id++, "IncShoot", "kg ha-1", "OrganGrowthIncrement shoot" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_OrganGrowthIncrement(OId::SHOOT), 2) : 0.0;
-      });
+  build({ id++, "IncLeaf", "kg ha-1", "OrganGrowthIncrement leaf" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_OrganGrowthIncrement(OId::LEAF), 2) : 0.0;
+  });
 
-      build({ id++, "IncFruit", "kg ha-1", "OrganGrowthIncrement fruit" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_OrganGrowthIncrement(OId::FRUIT), 2) : 0.0;
-      });
+  build({ id++, "IncShoot", "kg ha-1", "OrganGrowthIncrement shoot" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_OrganGrowthIncrement(OId::SHOOT), 2) : 0.0;
+  });
 
-      build({ id++, "RelDev", "0;1", "RelativeTotalDevelopment" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_RelativeTotalDevelopment(), 2) : 0.0;
-      });
+  build({ id++, "IncFruit", "kg ha-1", "OrganGrowthIncrement fruit" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_OrganGrowthIncrement(OId::FRUIT), 2) : 0.0;
+  });
 
-      build({ id++, "LT50", "°C", "LT50" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_LT50(), 1) : 0.0;
-      });
+  build({ id++, "RelDev", "0;1", "RelativeTotalDevelopment" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_RelativeTotalDevelopment(), 2) : 0.0;
+  });
 
-      build({ id++, "AbBiom", "kgDM ha-1", "AbovegroundBiomass" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_AbovegroundBiomass(), 1) : 0.0;
-      });
+  build({ id++, "LT50", "°C", "LT50" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_LT50(), 1) : 0.0;
+  });
 
-      build({ id++, "OrgBiom", "kgDM ha-1", "get_OrganBiomass(i)" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        if (oid.isOrgan()
-          && monica.cropGrowth()
-          && monica.cropGrowth()->get_NumberOfOrgans() > oid.organ)
-          return round(monica.cropGrowth()->get_OrganBiomass(oid.organ), 1);
-        else
-          return 0.0;
-      });
+  build({ id++, "AbBiom", "kgDM ha-1", "AbovegroundBiomass" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_AbovegroundBiomass(), 1) : 0.0;
+  });
 
-      build({ id++, "OrgGreenBiom", "kgDM ha-1", "get_OrganGreenBiomass(i)" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        if (oid.isOrgan()
-          && monica.cropGrowth()
-          && monica.cropGrowth()->get_NumberOfOrgans() > oid.organ)
-          return round(monica.cropGrowth()->get_OrganGreenBiomass(oid.organ), 1);
-        else
-          return 0.0;
-      });
+  build({ id++, "OrgBiom", "kgDM ha-1", "get_OrganBiomass(i)" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    if (oid.isOrgan()
+      && monica.cropGrowth()
+      && monica.cropGrowth()->get_NumberOfOrgans() > oid.organ)
+      return round(monica.cropGrowth()->get_OrganBiomass(oid.organ), 1);
+    else
+      return 0.0;
+  });
 
-      build({ id++, "Yield", "kgDM ha-1", "get_PrimaryCropYield" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_PrimaryCropYield(), 1) : 0.0;
-      });
+  build({ id++, "OrgGreenBiom", "kgDM ha-1", "get_OrganGreenBiomass(i)" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    if (oid.isOrgan()
+      && monica.cropGrowth()
+      && monica.cropGrowth()->get_NumberOfOrgans() > oid.organ)
+      return round(monica.cropGrowth()->get_OrganGreenBiomass(oid.organ), 1);
+    else
+      return 0.0;
+  });
 
-      build({id++, "SecondaryYield", "kgDM ha-1", "get_SecondaryCropYield"},
-            [](const MonicaModel &monica, OId oid) {
-              return monica.cropGrowth() ? round(monica.cropGrowth()->get_SecondaryCropYield(), 3) : 0.0;
-            });
+  build({ id++, "Yield", "kgDM ha-1", "get_PrimaryCropYield" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_PrimaryCropYield(), 1) : 0.0;
+  });
 
-      build({ id++, "sumExportedCutBiomass", "kgDM ha-1", "return sum (across cuts) of exported cut biomass for current crop" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->sumExportedCutBiomass(), 1) : 0.0;
-      });
+  build({id++, "SecondaryYield", "kgDM ha-1", "get_SecondaryCropYield"},
+        [](const MonicaModel &monica, OId oid) {
+          return monica.cropGrowth() ? round(monica.cropGrowth()->get_SecondaryCropYield(), 3) : 0.0;
+        });
 
-      build({ id++, "exportedCutBiomass", "kgDM ha-1", "return exported cut biomass for current crop and cut" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->exportedCutBiomass(), 1) : 0.0;
-      });
+  build({ id++, "sumExportedCutBiomass", "kgDM ha-1", "return sum (across cuts) of exported cut biomass for current crop" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->sumExportedCutBiomass(), 1) : 0.0;
+  });
 
-      build({ id++, "sumResidueCutBiomass", "kgDM ha-1", "return sum (across cuts) of residue cut biomass for current crop" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->sumResidueCutBiomass(), 1) : 0.0;
-      });
+  build({ id++, "exportedCutBiomass", "kgDM ha-1", "return exported cut biomass for current crop and cut" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->exportedCutBiomass(), 1) : 0.0;
+  });
 
-      build({ id++, "residueCutBiomass", "kgDM ha-1", "return residue cut biomass for current crop and cut" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->residueCutBiomass(), 1) : 0.0;
-      });
+  build({ id++, "sumResidueCutBiomass", "kgDM ha-1", "return sum (across cuts) of residue cut biomass for current crop" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->sumResidueCutBiomass(), 1) : 0.0;
+  });
 
-      build({ id++, "optCarbonExportedResidues", "kgDM ha-1", "return exported part of the residues according to optimal carbon balance" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.optCarbonExportedResidues(), 1);
-      });
+  build({ id++, "residueCutBiomass", "kgDM ha-1", "return residue cut biomass for current crop and cut" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->residueCutBiomass(), 1) : 0.0;
+  });
 
-      build({ id++, "optCarbonReturnedResidues", "kgDM ha-1", "return returned to soil part of the residues according to optimal carbon balance" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.optCarbonReturnedResidues(), 1);
-      });
+  build({ id++, "optCarbonExportedResidues", "kgDM ha-1", "return exported part of the residues according to optimal carbon balance" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.optCarbonExportedResidues(), 1);
+  });
 
-      build({ id++, "humusBalanceCarryOver", "Heq-NRW ha-1", "return humus balance carry over according to optimal carbon balance" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.humusBalanceCarryOver(), 1);
-      });
+  build({ id++, "optCarbonReturnedResidues", "kgDM ha-1", "return returned to soil part of the residues according to optimal carbon balance" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.optCarbonReturnedResidues(), 1);
+  });
 
+  build({ id++, "humusBalanceCarryOver", "Heq-NRW ha-1", "return humus balance carry over according to optimal carbon balance" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.humusBalanceCarryOver(), 1);
+  });
 
-      build({ id++, "GroPhot", "kgCH2O ha-1", "GrossPhotosynthesisHaRate" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_GrossPhotosynthesisHaRate(), 4) : 0.0;
-      });
 
-      build({ id++, "NetPhot", "kgCH2O ha-1", "NetPhotosynthesis" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_NetPhotosynthesis(), 2) : 0.0;
-      });
+  build({ id++, "GroPhot", "kgCH2O ha-1", "GrossPhotosynthesisHaRate" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_GrossPhotosynthesisHaRate(), 4) : 0.0;
+  });
 
-      build({ id++, "MaintR", "kgCH2O ha-1", "MaintenanceRespirationAS" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_MaintenanceRespirationAS(), 4) : 0.0;
-      });
+  build({ id++, "NetPhot", "kgCH2O ha-1", "NetPhotosynthesis" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_NetPhotosynthesis(), 2) : 0.0;
+  });
 
-      build({ id++, "GrowthR", "kgCH2O ha-1", "GrowthRespirationAS" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_GrowthRespirationAS(), 4) : 0.0;
-      });
+  build({ id++, "MaintR", "kgCH2O ha-1", "MaintenanceRespirationAS" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_MaintenanceRespirationAS(), 4) : 0.0;
+  });
 
-      build({ id++, "StomRes", "s m-1", "StomataResistance" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_StomataResistance(), 2) : 0.0;
-      });
+  build({ id++, "GrowthR", "kgCH2O ha-1", "GrowthRespirationAS" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_GrowthRespirationAS(), 4) : 0.0;
+  });
 
-      build({ id++, "Height", "m", "CropHeight" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_CropHeight(), 2) : 0.0;
-      });
-
-      build({ id++, "LAI", "m2 m-2", "LeafAreaIndex" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_LeafAreaIndex(), 4) : 0.0;
-      });
-
-      build({ id++, "RootDep", "layer#", "RootingDepth" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? int(monica.cropGrowth()->get_RootingDepth()) : 0;
-      });
-
-      build({ id++, "EffRootDep", "m", "Effective RootingDepth" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->getEffectiveRootingDepth(), 2) : 0.0;
-      });
+  build({ id++, "StomRes", "s m-1", "StomataResistance" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_StomataResistance(), 2) : 0.0;
+  });
 
-      build({ id++, "TotBiomN", "kgN ha-1", "TotalBiomassNContent" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_TotalBiomassNContent(), 1) : 0.0;
-      });
+  build({ id++, "Height", "m", "CropHeight" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_CropHeight(), 2) : 0.0;
+  });
 
-      build({ id++, "AbBiomN", "kgN ha-1", "AbovegroundBiomassNContent" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_AbovegroundBiomassNContent(), 1) : 0.0;
-      });
+  build({ id++, "LAI", "m2 m-2", "LeafAreaIndex" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_LeafAreaIndex(), 4) : 0.0;
+  });
 
-      build({ id++, "SumNUp", "kgN ha-1", "SumTotalNUptake" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_SumTotalNUptake(), 2) : 0.0;
-      });
+  build({ id++, "RootDep", "layer#", "RootingDepth" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? int(monica.cropGrowth()->get_RootingDepth()) : 0;
+  });
 
-      build({ id++, "ActNup", "kgN ha-1", "ActNUptake" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActNUptake(), 2) : 0.0;
-      });
+  build({ id++, "EffRootDep", "m", "Effective RootingDepth" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->getEffectiveRootingDepth(), 2) : 0.0;
+  });
 
-      build({ id++, "RootWaUptak", "KgN ha-1", "RootWatUptakefromLayer" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.cropGrowth() ? monica.cropGrowth()->get_Transpiration(i) : 0.0; }, 4);
-      });
+  build({ id++, "TotBiomN", "kgN ha-1", "TotalBiomassNContent" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_TotalBiomassNContent(), 1) : 0.0;
+  });
 
-      build({id++, "PotNup", "kgN ha-1", "PotNUptake"},
-            [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_PotNUptake(), 2) : 0.0;
-      });
+  build({ id++, "AbBiomN", "kgN ha-1", "AbovegroundBiomassNContent" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_AbovegroundBiomassNContent(), 1) : 0.0;
+  });
 
-      build({ id++, "NFixed", "kgN ha-1", "NFixed" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_BiologicalNFixation(), 2) : 0.0;
-      });
+  build({ id++, "SumNUp", "kgN ha-1", "SumTotalNUptake" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_SumTotalNUptake(), 2) : 0.0;
+  });
 
-      build({ id++, "Target", "kgN ha-1", "TargetNConcentration" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_TargetNConcentration(), 3) : 0.0;
-      });
+  build({ id++, "ActNup", "kgN ha-1", "ActNUptake" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActNUptake(), 2) : 0.0;
+  });
 
-      build({ id++, "CritN", "kgN ha-1", "CriticalNConcentration" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_CriticalNConcentration(), 5) : 0.0;
-      });
+  buildLayered({ id++, "RootWaUptak", "KgN ha-1", "RootWatUptakefromLayer" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    if (monica.cropGrowth())
+      vectorLayerValues(oid, monica.cropGrowth()->transpirations(), into);
+    else
+      sliceLayerValues(oid, 0, [](size_t, size_t, double*) {}, into);
+  }, 4});
 
-      build({ id++, "AbBiomNc", "kgN ha-1", "AbovegroundBiomassNConcentration" },
+  build({id++, "PotNup", "kgN ha-1", "PotNUptake"},
         [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_AbovegroundBiomassNConcentration(), 5) : 0.0;
-      });
-
-      build({ id++, "Nstress", "-", "NitrogenStressIndex" }
-
-        , [](const MonicaModel& monica, OId oid)
-      {
-        double Nstress = 0;
-        double AbBiomNc = monica.cropGrowth() ? round(monica.cropGrowth()->get_AbovegroundBiomassNConcentration(), 5) : 0.0;
-        double CritN = monica.cropGrowth() ? round(monica.cropGrowth()->get_CriticalNConcentration(), 5) : 0.0;
-
-        if (monica.cropGrowth())
-        {
-          Nstress = AbBiomNc < CritN ? round((AbBiomNc / CritN), 5) : 1;
-        }
-        return Nstress;
-      });
-
-      build({id++, "YieldNc", "kgN ha-1", "PrimaryYieldNConcentration"},
-            [](const MonicaModel &monica, OId oid) {
-              return monica.cropGrowth() ? round(monica.cropGrowth()->get_PrimaryYieldNConcentration(), 3) : 0.0;
-            });
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_PotNUptake(), 2) : 0.0;
+  });
 
+  build({ id++, "NFixed", "kgN ha-1", "NFixed" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_BiologicalNFixation(), 2) : 0.0;
+  });
 
-      build({ id++, "YieldN", "kgN ha-1", "PrimaryYieldNContent" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_PrimaryYieldNContent(), 3) : 0.0;
-      });
+  build({ id++, "Target", "kgN ha-1", "TargetNConcentration" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_TargetNConcentration(), 3) : 0.0;
+  });
 
-      build({id++, "Protein", "kg kg-1", "RawProteinConcentration"},
-            [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_RawProteinConcentration(), 3) : 0.0;
-      });
+  build({ id++, "CritN", "kgN ha-1", "CriticalNConcentration" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_CriticalNConcentration(), 5) : 0.0;
+  });
 
-      build({ id++, "NPP", "kgC ha-1", "NPP" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_NetPrimaryProduction(), 5) : 0.0;
-      });
+  build({ id++, "AbBiomNc", "kgN ha-1", "AbovegroundBiomassNConcentration" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_AbovegroundBiomassNConcentration(), 5) : 0.0;
+  });
 
-      build({ id++, "NPP-Organs", "kgC ha-1", "organ specific NPP" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        if (oid.isOrgan()
-          && monica.cropGrowth()
-          && monica.cropGrowth()->get_NumberOfOrgans() > oid.organ)
-          return round(monica.cropGrowth()->get_OrganSpecificNPP(oid.organ), 4);
-        else
-          return 0.0;
-      });
+  build({ id++, "Nstress", "-", "NitrogenStressIndex" }
 
-      build({ id++, "GPP", "kgC ha-1", "GPP" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_GrossPrimaryProduction(), 5) : 0.0;
-      });
+    , [](const MonicaModel& monica, OId oid)
+  {
+    double Nstress = 0;
+    double AbBiomNc = monica.cropGrowth() ? round(monica.cropGrowth()->get_AbovegroundBiomassNConcentration(), 5) : 0.0;
+    double CritN = monica.cropGrowth() ? round(monica.cropGrowth()->get_CriticalNConcentration(), 5) : 0.0;
 
-      build({ id++, "LightInterception1", "", "LightInterception of single crop or top layer of taller crop" },
-        [](const MonicaModel& monica, OId oid)
-        {
-          return monica.cropGrowth() ? round(monica.cropGrowth()->getFractionOfInterceptedRadiation1(), 5) : 0.0;
-        });
+    if (monica.cropGrowth())
+    {
+      Nstress = AbBiomNc < CritN ? round((AbBiomNc / CritN), 5) : 1;
+    }
+    return Nstress;
+  });
 
-      build({ id++, "LightInterception2", "", "LightInterception of lower layer of taller crop" },
-        [](const MonicaModel& monica, OId oid)
-        {
-          return monica.cropGrowth() ? round(monica.cropGrowth()->getFractionOfInterceptedRadiation2(), 5) : 0.0;
+  build({id++, "YieldNc", "kgN ha-1", "PrimaryYieldNConcentration"},
+        [](const MonicaModel &monica, OId oid) {
+          return monica.cropGrowth() ? round(monica.cropGrowth()->get_PrimaryYieldNConcentration(), 3) : 0.0;
         });
 
-      build({ id++, "Ra", "kgC ha-1", "autotrophic respiration" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_AutotrophicRespiration(), 5) : 0.0;
-      });
-
-      build({ id++, "Ra-Organs", "kgC ha-1", "organ specific autotrophic respiration" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        if (oid.isOrgan()
-          && monica.cropGrowth()
-          && monica.cropGrowth()->get_NumberOfOrgans() > oid.organ)
-          return round(monica.cropGrowth()->get_OrganSpecificTotalRespired(oid.organ), 4);
-        else
-          return 0.0;
-      });
 
-      build({ id++, "Mois", "m3 m-3", "Soil moisture content" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilMoisture().get_SoilMoisture(i); }, 3);
-      },
-        [](MonicaModel& monica, OId oid, Json value)
-      {
-        setComplexValues(oid, [&](int i, Json j)
-        {
-          if (j.is_number())
-            monica.soilColumnNC()[i].set_Vs_SoilMoisture_m3(j.number_value());
-        }, value);
-      });
+  build({ id++, "YieldN", "kgN ha-1", "PrimaryYieldNContent" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_PrimaryYieldNContent(), 3) : 0.0;
+  });
 
-      build({ id++, "ActNupLayer", "KgN ha-1", "ActNUptakefromLayer" },
+  build({id++, "Protein", "kg kg-1", "RawProteinConcentration"},
         [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.cropGrowth() ? monica.cropGrowth()->get_NUptakeFromLayer(i) * 10000.0 : 0.0; }, 4);
-      });
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_RawProteinConcentration(), 3) : 0.0;
+  });
 
+  build({ id++, "NPP", "kgC ha-1", "NPP" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_NetPrimaryProduction(), 5) : 0.0;
+  });
 
-      build({id++, "Irrig", "mm", "Irrigation"},
-            [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.dailySumIrrigationWater(), 3);
-      });
+  build({ id++, "NPP-Organs", "kgC ha-1", "organ specific NPP" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    if (oid.isOrgan()
+      && monica.cropGrowth()
+      && monica.cropGrowth()->get_NumberOfOrgans() > oid.organ)
+      return round(monica.cropGrowth()->get_OrganSpecificNPP(oid.organ), 4);
+    else
+      return 0.0;
+  });
 
-      build({ id++, "Infilt", "mm", "Infiltration" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_Infiltration(), 1);
-      });
+  build({ id++, "GPP", "kgC ha-1", "GPP" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_GrossPrimaryProduction(), 5) : 0.0;
+  });
 
-      build({ id++, "Surface", "mm", "Surface water storage" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_SurfaceWaterStorage(), 1);
-      });
+  build({ id++, "LightInterception1", "", "LightInterception of single crop or top layer of taller crop" },
+    [](const MonicaModel& monica, OId oid)
+    {
+      return monica.cropGrowth() ? round(monica.cropGrowth()->getFractionOfInterceptedRadiation1(), 5) : 0.0;
+    });
 
-      build({ id++, "RunOff", "mm", "Surface runoff of current day" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_SurfaceRunOff(), 1);
-      });
+  build({ id++, "LightInterception2", "", "LightInterception of lower layer of taller crop" },
+    [](const MonicaModel& monica, OId oid)
+    {
+      return monica.cropGrowth() ? round(monica.cropGrowth()->getFractionOfInterceptedRadiation2(), 5) : 0.0;
+    });
 
-      build({ id++, "SnowD", "mm", "Snow depth" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_SnowDepth(), 1);
-      });
+  build({ id++, "Ra", "kgC ha-1", "autotrophic respiration" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_AutotrophicRespiration(), 5) : 0.0;
+  });
 
-      build({ id++, "FrostD", "m", "Frost front depth in soil" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_FrostDepth(), 1);
-      });
+  build({ id++, "Ra-Organs", "kgC ha-1", "organ specific autotrophic respiration" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    if (oid.isOrgan()
+      && monica.cropGrowth()
+      && monica.cropGrowth()->get_NumberOfOrgans() > oid.organ)
+      return round(monica.cropGrowth()->get_OrganSpecificTotalRespired(oid.organ), 4);
+    else
+      return 0.0;
+  });
 
-      build({ id++, "ThawD", "m", "Thaw front depth in soil" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_ThawDepth(), 1);
-      });
+  buildLayered({ id++, "Mois", "m3 m-3", "Soil moisture content" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    soilLayerValues(monica, oid, &SoilLayer::get_Vs_SoilMoisture_m3, into);
+  }, 3},
+    [](MonicaModel& monica, OId oid, Json value)
+  {
+    setComplexValues(oid, [&](int i, Json j)
+    {
+      if (j.is_number())
+        monica.soilColumnNC()[i].set_Vs_SoilMoisture_m3(j.number_value());
+    }, value);
+  });
 
-      build({ id++, "PASW", "m3 m-3", "PASW" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i)
-        {
-          return monica.soilMoisture().get_SoilMoisture(i) - monica.soilColumn().at(i).vs_PermanentWiltingPoint();
-        }, 3);
-      });
+  build({ id++, "ActNupLayer", "KgN ha-1", "ActNUptakefromLayer" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return getComplexValues<double>(oid, [&](int i) { return monica.cropGrowth() ? monica.cropGrowth()->get_NUptakeFromLayer(i) * 10000.0 : 0.0; }, 4);
+  });
 
-      build({ id++, "SurfTemp", "�C", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilTemperature().getSoilSurfaceTemperature(), 1);
-      });
 
-      build({ id++, "STemp", "�C", "" },
+  build({id++, "Irrig", "mm", "Irrigation"},
         [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilTemperature().getSoilTemperature(i); }, 1);
-      });
+  {
+    return round(monica.dailySumIrrigationWater(), 3);
+  });
 
-      build({ id++, "Act_Ev", "mm", "Actual evaporation" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_ActualEvaporation(), 1);
-      });
+  build({ id++, "Infilt", "mm", "Infiltration" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_Infiltration(), 1);
+  });
 
-      build({ id++, "Pot_ET", "mm", "potential evapotranspiration = ET0 * Kc = the plants water use" }
-        , [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_PotentialEvapotranspiration(), 1);
-      });
+  build({ id++, "Surface", "mm", "Surface water storage" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_SurfaceWaterStorage(), 1);
+  });
 
-      build({ id++, "Evaporated_from_surface", "mm", "evaporated from surface" },
-      [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().vm_EvaporatedFromSurface, 1);
-      });
+  build({ id++, "RunOff", "mm", "Surface runoff of current day" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_SurfaceRunOff(), 1);
+  });
 
-      build({ id++, "Act_ET", "mm", "actual evapotranspiration = Act_Trans + Act_Ev + Evaporation_from_intercept + Evaporated_from_surface" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_ActualEvapotranspiration(), 1);
-      });
+  build({ id++, "SnowD", "mm", "Snow depth" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_SnowDepth(), 1);
+  });
 
-      //build({ id++, "Act_ET2", "mm", "" },
-      //	[](const MonicaModel& monica, OId oid)
-      //{
-      //	return round((monica.soilMoisture().get_ActualEvaporation() + monica.getTranspiration()), 2);
-      //});
+  build({ id++, "FrostD", "m", "Frost front depth in soil" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_FrostDepth(), 1);
+  });
 
-      build({ id++, "ET0", "mm", "Reference evapotranspiration" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_ET0(), 1);
-      });
+  build({ id++, "ThawD", "m", "Thaw front depth in soil" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_ThawDepth(), 1);
+  });
 
-      build({ id++, "Kc", "", "plant coefficient to calculate with ET0 the plants water use (ET0 * Kc)" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_KcFactor(), 3);
-      });
+  buildLayered({ id++, "PASW", "m3 m-3", "PASW" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    soilLayerValues(monica, oid, [](const SoilLayer& l)
+    {
+      return l.get_Vs_SoilMoisture_m3() - l.vs_PermanentWiltingPoint();
+    }, into);
+  }, 3});
 
-      build({ id++, "AtmCO2", "ppm", "Atmospheric CO2 concentration" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.get_AtmosphericCO2Concentration(), 0);
-      });
+  build({ id++, "SurfTemp", "�C", "" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilTemperature().getSoilSurfaceTemperature(), 1);
+  });
 
-      build({ id++, "AtmO3", "ppb", "Atmospheric O3 concentration" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.get_AtmosphericO3Concentration(), 0);
-      });
+  buildLayered({ id++, "STemp", "�C", "" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    //the layers below the soil column are the ground and bottom layer of the temperature module
+    sliceLayerValues(oid, numeric_limits<size_t>::max(), [&](size_t from, size_t to, double* p)
+    {
+      monica.soilTemperature().soilTemperatures(from, to, p);
+    }, into);
+  }, 1});
 
-      build({ id++, "Groundw", "m", "rounded according to interna usage" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.get_GroundwaterDepth(), 2);
-      });
+  build({ id++, "Act_Ev", "mm", "Actual evaporation" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_ActualEvaporation(), 1);
+  });
 
-      build({ id++, "Recharge", "mm", "Groundwater recharge" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_GroundwaterRecharge(), 3);
-      });
+  build({ id++, "Pot_ET", "mm", "potential evapotranspiration = ET0 * Kc = the plants water use" }
+    , [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_PotentialEvapotranspiration(), 1);
+  });
 
-      build({ id++, "NLeach", "kgN ha-1", "N leaching" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilTransport().get_NLeaching(), 3);
-      });
+  build({ id++, "Evaporated_from_surface", "mm", "evaporated from surface" },
+  [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().vm_EvaporatedFromSurface, 1);
+  });
 
-      build({ id++, "NO3", "kgN m-3", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i){ return monica.soilColumn().at(i).get_SoilNO3(); }, 6);
-      },
-        [](MonicaModel& monica, OId oid, Json value)
-      {
-        setComplexValues(oid, [&](int i, Json j)
-        {
-          if (j.is_number())
-            monica.soilColumnNC()[i].vs_SoilNO3 = j.number_value();
-        }, value);
-      });
+  build({ id++, "Act_ET", "mm", "actual evapotranspiration = Act_Trans + Act_Ev + Evaporation_from_intercept + Evaporated_from_surface" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_ActualEvapotranspiration(), 1);
+  });
 
-      build({ id++, "Carb", "kgN m-3", "Soil Carbamid" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        //return round(monica.soilColumn().at(0).get_SoilCarbamid(), 4);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).get_SoilCarbamid(); }, 4);
+  //build({ id++, "Act_ET2", "mm", "" },
+  //	[](const MonicaModel& monica, OId oid)
+  //{
+  //	return round((monica.soilMoisture().get_ActualEvaporation() + monica.getTranspiration()), 2);
+  //});
 
-      },
-        [](MonicaModel& monica, OId oid, Json value)
-      {
-        setComplexValues(oid, [&](int i, Json j)
-        {
-          if (j.is_number())
-            monica.soilColumnNC()[i].vs_SoilCarbamid = j.number_value();
-        }, value);
-      });
+  build({ id++, "ET0", "mm", "Reference evapotranspiration" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_ET0(), 1);
+  });
 
-      build({ id++, "NH4", "kgN m-3", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i){ return monica.soilColumn().at(i).get_SoilNH4(); }, 6);
-      },
-        [](MonicaModel& monica, OId oid, Json value)
-      {
-        setComplexValues(oid, [&](int i, Json j)
-        {
-          if (j.is_number())
-            monica.soilColumnNC()[i].vs_SoilNH4 = j.number_value();
-        }, value);
-      });
+  build({ id++, "Kc", "", "plant coefficient to calculate with ET0 the plants water use (ET0 * Kc)" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_KcFactor(), 3);
+  });
 
-      build({ id++, "NO2", "kgN m-3", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i){ return monica.soilColumn().at(i).get_SoilNO2(); }, 6);
-      },
-        [](MonicaModel& monica, OId oid, Json value)
-      {
-        setComplexValues(oid, [&](int i, Json j)
-        {
-          if (j.is_number())
-            monica.soilColumnNC()[i].vs_SoilNO2 = j.number_value();
-        }, value);
-      });
+  build({ id++, "AtmCO2", "ppm", "Atmospheric CO2 concentration" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.get_AtmosphericCO2Concentration(), 0);
+  });
 
-      build({ id++, "SOC", "kgC kg-1", "get soil organic carbon content" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_SoilOrganicCarbon(); }, 6);
-      });
+  build({ id++, "AtmO3", "ppb", "Atmospheric O3 concentration" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.get_AtmosphericO3Concentration(), 0);
+  });
 
-      build({ id++, "SOC-X-Y", "gC m-2", "SOC-X-Y" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i)
-        {
-          return monica.soilColumn().at(i).vs_SoilOrganicCarbon()
-            * monica.soilColumn().at(i).vs_SoilBulkDensity()
-            * monica.soilColumn().at(i).vs_LayerThickness
-            * 1000;
-        }, 4);
-      });
+  build({ id++, "Groundw", "m", "rounded according to interna usage" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.get_GroundwaterDepth(), 2);
+  });
 
-      build({ id++, "OrgN", "kg N m-3", "get_Organic_N" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_Organic_N(i); }, 4);
-      });
+  build({ id++, "Recharge", "mm", "Groundwater recharge" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_GroundwaterRecharge(), 3);
+  });
 
-      build({ id++, "AOMf", "kgC m-3", "get_AOM_FastSum" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_AOM_FastSum(i); }, 4);
-      });
+  build({ id++, "NLeach", "kgN ha-1", "N leaching" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilTransport().get_NLeaching(), 3);
+  });
 
-      build({ id++, "AOMs", "kgC m-3", "get_AOM_SlowSum" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_AOM_SlowSum(i); }, 4);
-      });
+  buildLayered({ id++, "NO3", "kgN m-3", "" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    soilLayerValues(monica, oid, &SoilLayer::get_SoilNO3, into);
+  }, 6},
+    [](MonicaModel& monica, OId oid, Json value)
+  {
+    setComplexValues(oid, [&](int i, Json j)
+    {
+      if (j.is_number())
+        monica.soilColumnNC()[i].vs_SoilNO3 = j.number_value();
+    }, value);
+  });
 
-      build({ id++, "SMBf", "kgC m-3", "get_SMB_Fast" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_SMB_Fast(i); }, 4);
-      });
+  buildLayered({ id++, "Carb", "kgN m-3", "Soil Carbamid" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    soilLayerValues(monica, oid, &SoilLayer::get_SoilCarbamid, into);
+  }, 4},
+    [](MonicaModel& monica, OId oid, Json value)
+  {
+    setComplexValues(oid, [&](int i, Json j)
+    {
+      if (j.is_number())
+        monica.soilColumnNC()[i].vs_SoilCarbamid = j.number_value();
+    }, value);
+  });
 
-      build({ id++, "SMBs", "kgC m-3", "get_SMB_Slow" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_SMB_Slow(i); }, 4);
-      });
+  buildLayered({ id++, "NH4", "kgN m-3", "" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    soilLayerValues(monica, oid, &SoilLayer::get_SoilNH4, into);
+  }, 6},
+    [](MonicaModel& monica, OId oid, Json value)
+  {
+    setComplexValues(oid, [&](int i, Json j)
+    {
+      if (j.is_number())
+        monica.soilColumnNC()[i].vs_SoilNH4 = j.number_value();
+    }, value);
+  });
 
-      build({ id++, "SOMf", "kgC m-3", "get_SOM_Fast" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_SOM_Fast(i); }, 4);
-      });
+  buildLayered({ id++, "NO2", "kgN m-3", "" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    soilLayerValues(monica, oid, &SoilLayer::get_SoilNO2, into);
+  }, 6},
+    [](MonicaModel& monica, OId oid, Json value)
+  {
+    setComplexValues(oid, [&](int i, Json j)
+    {
+      if (j.is_number())
+        monica.soilColumnNC()[i].vs_SoilNO2 = j.number_value();
+    }, value);
+  });
 
-      build({ id++, "SOMs", "kgC m-3", "get_SOM_Slow" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_SOM_Slow(i); }, 4);
-      });
+  buildLayered({ id++, "SOC", "kgC kg-1", "get soil organic carbon content" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    soilLayerValues(monica, oid, &SoilLayer::vs_SoilOrganicCarbon, into);
+  }, 6});
 
-      build({ id++, "CBal", "kgC m-3", "get_CBalance" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_CBalance(i); }, 4);
-      });
+  buildLayered({ id++, "SOC-X-Y", "gC m-2", "SOC-X-Y" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    soilLayerValues(monica, oid, [](const SoilLayer& l)
+    {
+      return l.vs_SoilOrganicCarbon() * l.vs_SoilBulkDensity() * l.vs_LayerThickness * 1000;
+    }, into);
+  }, 4});
 
-      build({ id++, "Nmin", "kgN ha-1", "NetNMineralisationRate" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_NetNMineralisationRate(i); }, 6);
-      });
+  build({ id++, "OrgN", "kg N m-3", "get_Organic_N" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_Organic_N(i); }, 4);
+  });
+
+  build({ id++, "AOMf", "kgC m-3", "get_AOM_FastSum" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_AOM_FastSum(i); }, 4);
+  });
+
+  build({ id++, "AOMs", "kgC m-3", "get_AOM_SlowSum" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_AOM_SlowSum(i); }, 4);
+  });
+
+  build({ id++, "SMBf", "kgC m-3", "get_SMB_Fast" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_SMB_Fast(i); }, 4);
+  });
+
+  build({ id++, "SMBs", "kgC m-3", "get_SMB_Slow" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_SMB_Slow(i); }, 4);
+  });
+
+  build({ id++, "SOMf", "kgC m-3", "get_SOM_Fast" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_SOM_Fast(i); }, 4);
+  });
+
+  build({ id++, "SOMs", "kgC m-3", "get_SOM_Slow" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_SOM_Slow(i); }, 4);
+  });
+
+  buildLayered({ id++, "CBal", "kgC m-3", "get_CBalance" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    vectorLayerValues(oid, monica.soilOrganic().cBalances(), into);
+  }, 4});
+
+  build({ id++, "Nmin", "kgN ha-1", "NetNMineralisationRate" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_NetNMineralisationRate(i); }, 6);
+  });
+
+  build({ id++, "NetNmin", "kgN ha-1", "NetNmin" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilOrganic().get_NetNMineralisation(), 5);
+  });
 
-      build({ id++, "NetNmin", "kgN ha-1", "NetNmin" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilOrganic().get_NetNMineralisation(), 5);
-      });
+  build({ id++, "Denit", "kgN ha-1", "Denit" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilOrganic().get_Denitrification(), 5);
+  });
 
-      build({ id++, "Denit", "kgN ha-1", "Denit" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilOrganic().get_Denitrification(), 5);
-      });
+  build({ id++, "N2O", "kgN ha-1", "N2O" },
+  [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilOrganic().get_N2O_Produced(), 5);
+  });
+  build({ id++, "N2Onit", "kgN ha-1", "N2O from nitrification" },
+  [](const MonicaModel& monica, OId oid) {
+    return round(monica.soilOrganic().get_N2O_Produced_Nit(), 5);
+  });
+  build({ id++, "N2Odenit", "kgN ha-1", "N2O from denitrification" },
+  [](const MonicaModel& monica, OId oid) {
+    return round(monica.soilOrganic().get_N2O_Produced_Denit(), 5);
+  });
+
+  build({ id++, "SoilpH", "", "SoilpH" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilColumn().at(0).get_SoilpH(), 1);
+  });
 
-    build({ id++, "N2O", "kgN ha-1", "N2O" },
-      [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilOrganic().get_N2O_Produced(), 5);
-      });
-    build({ id++, "N2Onit", "kgN ha-1", "N2O from nitrification" },
-      [](const MonicaModel& monica, OId oid) {
-        return round(monica.soilOrganic().get_N2O_Produced_Nit(), 5);
-      });
-    build({ id++, "N2Odenit", "kgN ha-1", "N2O from denitrification" },
-      [](const MonicaModel& monica, OId oid) {
-        return round(monica.soilOrganic().get_N2O_Produced_Denit(), 5);
-      });
-
-      build({ id++, "SoilpH", "", "SoilpH" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilColumn().at(0).get_SoilpH(), 1);
-      });
+  build({ id++, "NEP", "kgC ha-1", "NEP" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilOrganic().get_NetEcosystemProduction(), 5);
+  });
 
-      build({ id++, "NEP", "kgC ha-1", "NEP" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilOrganic().get_NetEcosystemProduction(), 5);
-      });
+  build({ id++, "NEE", "kgC ha-", "NEE" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilOrganic().get_NetEcosystemExchange(), 5);
+  });
 
-      build({ id++, "NEE", "kgC ha-", "NEE" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilOrganic().get_NetEcosystemExchange(), 5);
-      });
+  build({ id++, "Rh", "kgC ha-", "Rh" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilOrganic().get_DecomposerRespiration(), 5);
+  });
 
-      build({ id++, "Rh", "kgC ha-", "Rh" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilOrganic().get_DecomposerRespiration(), 5);
-      });
+  build({ id++, "Tmin", "", "" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    const auto& cd = monica.currentStepClimateData();
+    auto ci = cd.find(Climate::tmin);
+    return ci == cd.end() ? 0.0 : round(ci->second, 4);
+  });
 
-      build({ id++, "Tmin", "", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        const auto& cd = monica.currentStepClimateData();
-        auto ci = cd.find(Climate::tmin);
-        return ci == cd.end() ? 0.0 : round(ci->second, 4);
-      });
+  build({ id++, "Tavg", "", "" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    const auto& cd = monica.currentStepClimateData();
+    auto ci = cd.find(Climate::tavg);
+    return ci == cd.end() ? 0.0 : round(ci->second, 4);
+  });
 
-      build({ id++, "Tavg", "", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        const auto& cd = monica.currentStepClimateData();
-        auto ci = cd.find(Climate::tavg);
-        return ci == cd.end() ? 0.0 : round(ci->second, 4);
-      });
+  build({ id++, "Tmax", "", "" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    const auto& cd = monica.currentStepClimateData();
+    auto ci = cd.find(Climate::tmax);
+    return ci == cd.end() ? 0.0 : round(ci->second, 4);
+  });
 
-      build({ id++, "Tmax", "", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        const auto& cd = monica.currentStepClimateData();
-        auto ci = cd.find(Climate::tmax);
-        return ci == cd.end() ? 0.0 : round(ci->second, 4);
-      });
+  build({ id++, "Tmax>=40", "0|1", "if Tmax >= 40�C then 1 else 0" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    const auto& cd = monica.currentStepClimateData();
+    auto ci = cd.find(Climate::tmax);
+    return ci == cd.end() ? 0 : (ci->second >= 40 ? 1 : 0);
+  });
 
-      build({ id++, "Tmax>=40", "0|1", "if Tmax >= 40�C then 1 else 0" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        const auto& cd = monica.currentStepClimateData();
-        auto ci = cd.find(Climate::tmax);
-        return ci == cd.end() ? 0 : (ci->second >= 40 ? 1 : 0);
-      });
+  build({ id++, "Precip", "mm", "Precipitation" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    const auto& cd = monica.currentStepClimateData();
+    auto ci = cd.find(Climate::precip);
+    return ci == cd.end() ? 0.0 : round(ci->second, 4);
+  });
 
-      build({ id++, "Precip", "mm", "Precipitation" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        const auto& cd = monica.currentStepClimateData();
-        auto ci = cd.find(Climate::precip);
-        return ci == cd.end() ? 0.0 : round(ci->second, 4);
-      });
+  build({ id++, "Wind", "", "" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    const auto& cd = monica.currentStepClimateData();
+    auto ci = cd.find(Climate::wind);
+    return ci == cd.end() ? 0.0 : round(ci->second, 4);
+  });
 
-      build({ id++, "Wind", "", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        const auto& cd = monica.currentStepClimateData();
-        auto ci = cd.find(Climate::wind);
-        return ci == cd.end() ? 0.0 : round(ci->second, 4);
-      });
+  build({ id++, "Globrad", "", "" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    const auto& cd = monica.currentStepClimateData();
+    auto ci = cd.find(Climate::globrad);
+    return ci == cd.end() ? 0.0 : round(ci->second, 4);
+  });
 
-      build({ id++, "Globrad", "", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        const auto& cd = monica.currentStepClimateData();
-        auto ci = cd.find(Climate::globrad);
-        return ci == cd.end() ? 0.0 : round(ci->second, 4);
-      });
+  build({ id++, "Relhumid", "", "" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    const auto& cd = monica.currentStepClimateData();
+    auto ci = cd.find(Climate::relhumid);
+    return ci == cd.end() ? 0.0 : round(ci->second, 4);
+  });
 
-      build({ id++, "Relhumid", "", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        const auto& cd = monica.currentStepClimateData();
-        auto ci = cd.find(Climate::relhumid);
-        return ci == cd.end() ? 0.0 : round(ci->second, 4);
-      });
+  build({ id++, "Sunhours", "", "" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    const auto& cd = monica.currentStepClimateData();
+    auto ci = cd.find(Climate::sunhours);
+    return ci == cd.end() ? 0.0 : round(ci->second, 4);
+  });
 
-      build({ id++, "Sunhours", "", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        const auto& cd = monica.currentStepClimateData();
-        auto ci = cd.find(Climate::sunhours);
-        return ci == cd.end() ? 0.0 : round(ci->second, 4);
-      });
+  build({ id++, "BedGrad", "0;1", "" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilMoisture().get_PercentageSoilCoverage(), 3);
+  });
 
-      build({ id++, "BedGrad", "0;1", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilMoisture().get_PercentageSoilCoverage(), 3);
-      });
+  build({ id++, "N", "kgN m-3", "" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).get_SoilNmin(); }, 3);
+  });
 
-      build({ id++, "N", "kgN m-3", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).get_SoilNmin(); }, 3);
-      });
+  build({ id++, "Co", "kgC m-3", "" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_SoilOrganicC(i); }, 2);
+  });
+
+  build({ id++, "NH3", "kgN ha-1", "NH3_Volatilised" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.soilOrganic().get_NH3_Volatilised(), 3);
+  });
 
-      build({ id++, "Co", "kgC m-3", "" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_SoilOrganicC(i); }, 2);
-      });
+  build({ id++, "NFert", "kgN ha-1", "dailySumFertiliser" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.dailySumFertiliser(), 1);
+  });
 
-      build({ id++, "NH3", "kgN ha-1", "NH3_Volatilised" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.soilOrganic().get_NH3_Volatilised(), 3);
-      });
+  build({ id++, "SumNFert", "kgN ha-1", "sum of N fertilizer applied during cropping period" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.sumFertiliser(), 1);
+  });
 
-      build({ id++, "NFert", "kgN ha-1", "dailySumFertiliser" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.dailySumFertiliser(), 1);
-      });
+  build({ id++, "NOrgFert", "kgN ha-1", "dailySumOrgFertiliser" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.dailySumOrgFertiliser(), 1);
+  });
 
-      build({ id++, "SumNFert", "kgN ha-1", "sum of N fertilizer applied during cropping period" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.sumFertiliser(), 1);
-      });
+  build({ id++, "SumNOrgFert", "kgN ha-1", "sum of N of organic fertilizer applied during cropping period" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return round(monica.sumOrgFertiliser(), 1);
+  });
 
-      build({ id++, "NOrgFert", "kgN ha-1", "dailySumOrgFertiliser" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.dailySumOrgFertiliser(), 1);
-      });
 
-      build({ id++, "SumNOrgFert", "kgN ha-1", "sum of N of organic fertilizer applied during cropping period" },
+  build({id++, "WaterContent", "fraction nFC", "soil water content in % of available soil water"},
         [](const MonicaModel& monica, OId oid)
-      {
-        return round(monica.sumOrgFertiliser(), 1);
-      });
-
-
-      build({id++, "WaterContent", "fraction nFC", "soil water content in % of available soil water"},
-            [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i)
+  {
+    return getComplexValues<double>(oid, [&](int i)
+    {
+      double smm3 = monica.soilMoisture().get_SoilMoisture(i);
+      double fc = monica.soilColumn().at(i).vs_FieldCapacity();
+      double pwp = monica.soilColumn().at(i).vs_PermanentWiltingPoint();
+      return (smm3 - pwp) / (fc - pwp); //[%nFK]
+    }, 4);
+  });
+
+  build({ id++, "AWC", "m3 m-3", "available water capacity" },
+    [](const MonicaModel& monica, OId oid)
+    {
+      return getComplexValues<double>(oid, [&](int i)
         {
-          double smm3 = monica.soilMoisture().get_SoilMoisture(i);
           double fc = monica.soilColumn().at(i).vs_FieldCapacity();
           double pwp = monica.soilColumn().at(i).vs_PermanentWiltingPoint();
-          return (smm3 - pwp) / (fc - pwp); //[%nFK]
+          return fc - pwp; 
         }, 4);
-      });
-
-      build({ id++, "AWC", "m3 m-3", "available water capacity" },
-        [](const MonicaModel& monica, OId oid)
-        {
-          return getComplexValues<double>(oid, [&](int i)
-            {
-              double fc = monica.soilColumn().at(i).vs_FieldCapacity();
-              double pwp = monica.soilColumn().at(i).vs_PermanentWiltingPoint();
-              return fc - pwp; 
-            }, 4);
-        });
-
-      build({id++, "CapillaryRise", "mm", "capillary rise"},
-            [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilMoisture().get_CapillaryRise(i); }, 3);
-      });
-
-      build({ id++, "PercolationRate", "mm", "percolation rate" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilMoisture().get_PercolationRate(i); }, 3);
-      });
-
-      build({ id++, "SMB-CO2-ER", "", "soilOrganic.get_SMB_CO2EvolutionRate" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().get_SMB_CO2EvolutionRate(i); }, 1);
-      });
+    });
 
-      build({ id++, "Evapotranspiration", "mm", "Remaining evapotranspiration" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_RemainingEvapotranspiration(), 1) : 0.0;
-      });
+  buildLayered({id++, "CapillaryRise", "mm", "capillary rise"},
+        {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    vectorLayerValues(oid, monica.soilMoisture().capillaryRises(), into);
+  }, 3});
 
-      build({ id++, "Evaporation_from_intercept", "mm", "Evaporation from intercepted water" },
-      [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_EvaporatedFromIntercept(), 1) : 0.0;
-      });
+  buildLayered({ id++, "PercolationRate", "mm", "percolation rate" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    vectorLayerValues(oid, monica.soilMoisture().percolationRates(), into);
+  }, 3});
 
-      build({ id++, "Evaporation", "mm", "Evaporation from intercepted water" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_EvaporatedFromIntercept(), 1) : 0.0;
-      });
+  buildLayered({ id++, "SMB-CO2-ER", "", "soilOrganic.get_SMB_CO2EvolutionRate" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    vectorLayerValues(oid, monica.soilOrganic().smbCO2EvolutionRates(), into);
+  }, 1});
+
+  build({ id++, "Evapotranspiration", "mm", "Remaining evapotranspiration" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_RemainingEvapotranspiration(), 1) : 0.0;
+  });
 
-      build({ id++, "ETa/ETc", "", "Act_ET / Pot_ET" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        auto potET = monica.soilMoisture().get_PotentialEvapotranspiration();
-        auto actET = monica.soilMoisture().get_ActualEvapotranspiration();
-        return potET > 0 ? round(actET / potET, 2) : 1.0;
-      });
+  build({ id++, "Evaporation_from_intercept", "mm", "Evaporation from intercepted water" },
+  [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_EvaporatedFromIntercept(), 1) : 0.0;
+  });
 
-      build({ id++, "Tra", "mm", "ActualTranspiration" },
-      [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActualTranspiration(), 2) : 0.0;
-      });
+  build({ id++, "Evaporation", "mm", "Evaporation from intercepted water" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_EvaporatedFromIntercept(), 1) : 0.0;
+  });
 
-      build({ id++, "Act_Trans", "mm", "actual transpiration" },
-      [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActualTranspiration(), 1) : 0.0;
-      });
+  build({ id++, "ETa/ETc", "", "Act_ET / Pot_ET" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    auto potET = monica.soilMoisture().get_PotentialEvapotranspiration();
+    auto actET = monica.soilMoisture().get_ActualEvapotranspiration();
+    return potET > 0 ? round(actET / potET, 2) : 1.0;
+  });
 
-      build({ id++, "Transpiration", "mm", "actual transpiration" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActualTranspiration(), 1) : 0.0;
-      });
+  build({ id++, "Tra", "mm", "ActualTranspiration" },
+  [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActualTranspiration(), 2) : 0.0;
+  });
 
-      build({ id++, "GrainN", "kg ha-1", "get_FruitBiomassNContent" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_FruitBiomassNContent(), 5) : 0.0;
-      });
+  build({ id++, "Act_Trans", "mm", "actual transpiration" },
+  [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActualTranspiration(), 1) : 0.0;
+  });
 
-      build({ id++, "Fc", "m3 m-3", "field capacity" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_FieldCapacity(); }, 4);
-      });
+  build({ id++, "Transpiration", "mm", "actual transpiration" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_ActualTranspiration(), 1) : 0.0;
+  });
 
-      build({ id++, "Pwp", "m3 m-3", "permanent wilting point" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_PermanentWiltingPoint(); }, 4);
-      });
+  build({ id++, "GrainN", "kg ha-1", "get_FruitBiomassNContent" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_FruitBiomassNContent(), 5) : 0.0;
+  });
 
-      build({ id++, "Sat", "m3 m-3", "saturation" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_Saturation(); }, 4);
-      });
+  buildLayered({ id++, "Fc", "m3 m-3", "field capacity" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    soilLayerValues(monica, oid, &SoilLayer::vs_FieldCapacity, into);
+  }, 4});
 
-      build({ id++, "guenther-isoprene-emission", "umol m-2Ground d-1", "daily isoprene-emission of all species from Guenther model" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->guentherEmissions().isoprene_emission, 5) : 0.0;
-      });
+  buildLayered({ id++, "Pwp", "m3 m-3", "permanent wilting point" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    soilLayerValues(monica, oid, &SoilLayer::vs_PermanentWiltingPoint, into);
+  }, 4});
 
-      build({ id++, "guenther-monoterpene-emission", "umol m-2Ground d-1", "daily monoterpene emission of all species from Guenther model" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->guentherEmissions().monoterpene_emission, 5) : 0.0;
-      });
+  buildLayered({ id++, "Sat", "m3 m-3", "saturation" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    soilLayerValues(monica, oid, &SoilLayer::vs_Saturation, into);
+  }, 4});
 
-      build({ id++, "jjv-isoprene-emission", "umol m-2Ground d-1", "daily isoprene-emission of all species from JJV model" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->jjvEmissions().isoprene_emission, 5) : 0.0;
-      });
+  build({ id++, "guenther-isoprene-emission", "umol m-2Ground d-1", "daily isoprene-emission of all species from Guenther model" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->guentherEmissions().isoprene_emission, 5) : 0.0;
+  });
 
-      build({ id++, "jjv-monoterpene-emission", "umol m-2Ground d-1", "daily monoterpene emission of all species from JJV model" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->jjvEmissions().monoterpene_emission, 5) : 0.0;
-      });
+  build({ id++, "guenther-monoterpene-emission", "umol m-2Ground d-1", "daily monoterpene emission of all species from Guenther model" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->guentherEmissions().monoterpene_emission, 5) : 0.0;
+  });
 
-      build({ id++, "Nresid", "kg N ha-1", "Nitrogen content in crop residues" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_ResiduesNContent(), 1) : 0.0;
-      });
+  build({ id++, "jjv-isoprene-emission", "umol m-2Ground d-1", "daily isoprene-emission of all species from JJV model" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->jjvEmissions().isoprene_emission, 5) : 0.0;
+  });
 
-      build({ id++, "Sand", "kg kg-1", "Soil sand content" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_SoilSandContent(); }, 2);
-      });
+  build({ id++, "jjv-monoterpene-emission", "umol m-2Ground d-1", "daily monoterpene emission of all species from JJV model" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->jjvEmissions().monoterpene_emission, 5) : 0.0;
+  });
 
-      build({ id++, "Clay", "kg kg-1", "Soil clay content" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_SoilClayContent(); }, 2);
-      });
+  build({ id++, "Nresid", "kg N ha-1", "Nitrogen content in crop residues" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_ResiduesNContent(), 1) : 0.0;
+  });
 
-      build({ id++, "Silt", "kg kg-1", "Soil silt content" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_SoilSiltContent(); }, 2);
-      });
+  build({ id++, "Sand", "kg kg-1", "Soil sand content" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_SoilSandContent(); }, 2);
+  });
 
-      build({ id++, "Stone", "kg kg-1", "Soil stone content" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_SoilStoneContent(); }, 2);
-      });
+  build({ id++, "Clay", "kg kg-1", "Soil clay content" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_SoilClayContent(); }, 2);
+  });
 
-      build({ id++, "pH", "kg kg-1", "Soil pH content" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_SoilpH(); }, 2);
-      });
+  build({ id++, "Silt", "kg kg-1", "Soil silt content" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_SoilSiltContent(); }, 2);
+  });
 
-      build({ id++, "O3-short-damage", "unitless", "short term ozone induced reduction of Ac" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_O3_shortTermDamage(), 2) : 0.0;
-      });
+  build({ id++, "Stone", "kg kg-1", "Soil stone content" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_SoilStoneContent(); }, 2);
+  });
 
-      build({ id++, "O3-long-damage", "unitless", "long term ozone induced senescence" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_O3_longTermDamage(), 2) : 0.0;
-      });
+  build({ id++, "pH", "kg kg-1", "Soil pH content" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return getComplexValues<double>(oid, [&](int i) { return monica.soilColumn().at(i).vs_SoilpH(); }, 2);
+  });
 
-      build({ id++, "O3-WS-gs-reduction", "unitless", "water stress impact on stomatal conductance" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_O3_WStomatalClosure(), 2) : 0.0;
-      });
+  build({ id++, "O3-short-damage", "unitless", "short term ozone induced reduction of Ac" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_O3_shortTermDamage(), 2) : 0.0;
+  });
 
-      build({ id++, "O3-total-uptake", "�mol m-2", "total O3 uptake" }, //TODO units are not correct
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->get_O3_sumUptake(), 2) : 0.0;
-      });
+  build({ id++, "O3-long-damage", "unitless", "long term ozone induced senescence" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_O3_longTermDamage(), 2) : 0.0;
+  });
 
-      build({ id++, "NO3conv", "", "get_vq_Convection" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilTransport().get_vq_Convection(i); }, 8);
-      });
+  build({ id++, "O3-WS-gs-reduction", "unitless", "water stress impact on stomatal conductance" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_O3_WStomatalClosure(), 2) : 0.0;
+  });
 
-      build({ id++, "NO3disp", "", "get_vq_Dispersion" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilTransport().get_vq_Dispersion(i); }, 8);
-      });
+  build({ id++, "O3-total-uptake", "�mol m-2", "total O3 uptake" }, //TODO units are not correct
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->get_O3_sumUptake(), 2) : 0.0;
+  });
 
-      build({ id++, "noOfAOMPools", "", "number of AOM pools in existence currently" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return int(monica.soilColumn().at(0).vo_AOM_Pool.size());
-      });
+  buildLayered({ id++, "NO3conv", "", "get_vq_Convection" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    vectorLayerValues(oid, monica.soilTransport().vq_Convections(), into);
+  }, 8});
 
-      build({ id++, "CN_Ratio_AOM_Fast", "", "CN_Ratio_AOM_Fast" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) {
-          const auto& layer = monica.soilColumn().at(i);
-          return layer.vo_AOM_Pool.empty() ? 0.0 : layer.vo_AOM_Pool.at(0).vo_CN_Ratio_AOM_Fast;
-        }, 5);
-      });
+  buildLayered({ id++, "NO3disp", "", "get_vq_Dispersion" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+  {
+    vectorLayerValues(oid, monica.soilTransport().vq_Dispersions(), into);
+  }, 8});
 
-      build({ id++, "AOM_Fast", "", "AOM_Fast" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) {
-          const auto& layer = monica.soilColumn().at(i);
-          return layer.vo_AOM_Pool.empty() ? 0.0 : layer.vo_AOM_Pool.at(0).vo_AOM_Fast;
-        }, 5);
-      });
+  build({ id++, "noOfAOMPools", "", "number of AOM pools in existence currently" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return int(monica.soilColumn().at(0).vo_AOM_Pool.size());
+  });
 
-      build({ id++, "AOM_Slow", "", "AOM_Slow" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return getComplexValues<double>(oid, [&](int i) {
-          const auto& layer = monica.soilColumn().at(i);
-          return layer.vo_AOM_Pool.empty() ? 0.0 : layer.vo_AOM_Pool.at(0).vo_AOM_Slow;
-        }, 5);
-      });
+  build({ id++, "CN_Ratio_AOM_Fast", "", "CN_Ratio_AOM_Fast" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return getComplexValues<double>(oid, [&](int i) {
+      const auto& layer = monica.soilColumn().at(i);
+      return layer.vo_AOM_Pool.empty() ? 0.0 : layer.vo_AOM_Pool.at(0).vo_CN_Ratio_AOM_Fast;
+    }, 5);
+  });
+
+  build({ id++, "AOM_Fast", "", "AOM_Fast" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return getComplexValues<double>(oid, [&](int i) {
+      const auto& layer = monica.soilColumn().at(i);
+      return layer.vo_AOM_Pool.empty() ? 0.0 : layer.vo_AOM_Pool.at(0).vo_AOM_Fast;
+    }, 5);
+  });
+
+  build({ id++, "AOM_Slow", "", "AOM_Slow" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return getComplexValues<double>(oid, [&](int i) {
+      const auto& layer = monica.soilColumn().at(i);
+      return layer.vo_AOM_Pool.empty() ? 0.0 : layer.vo_AOM_Pool.at(0).vo_AOM_Slow;
+    }, 5);
+  });
+
+  build({ id++, "rootNConcentration", "", "rootNConcentration" },
+    [](const MonicaModel& monica, OId oid)
+  {
+    return monica.cropGrowth() ? round(monica.cropGrowth()->rootNConcentration(), 4) : 0.0;
+  });
+  buildLayered({ id++, "actammoxrate", "kgN/m3/d", "actual ammonia oxidation rate in layer" },
+  {[](const MonicaModel& monica, OId oid, vector<double>& into) {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    vectorLayerValues(oid, monica.soilOrganic().actAmmoniaOxidationRates(), into);
+  }, 6});
+
+  buildLayered({ id++, "actnitrate", "kgN/m3/d", "actual nitrification rate in layer" },
+  {[](const MonicaModel& monica, OId oid, vector<double>& into) {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    vectorLayerValues(oid, monica.soilOrganic().actNitrificationRates(), into);
+  }, 6});
+
+  buildLayered({ id++, "actdenitrate", "kgN/m3/d", "actual denitrification rate in layer" },
+  {[](const MonicaModel& monica, OId oid, vector<double>& into) {
+    auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
+    oid.fromLayer = min(oid.fromLayer, nools - 1);
+    oid.toLayer = min(oid.toLayer, nools - 1);
+    vectorLayerValues(oid, monica.soilOrganic().actDenitrificationRates(), into);
+  }, 6});
+  build({ id++, "rootDensity", "", "cropGrowth->vc_RootDensity" },
+  [](const MonicaModel& monica, OId oid) 
+    {
+  return getComplexValues<double>(oid, [&](int i) {
+  return monica.cropGrowth() ? monica.cropGrowth()->getRootDensity(i) : 0.0; }, 4);
+  });
+  build({ id++, "rootingZone", "", "cropGrowth->vc_RootingZone" },
+  [](const MonicaModel& monica, OId oid) {
+  return monica.cropGrowth() ? monica.cropGrowth()->rootingZone() : 0.0;
+  });
+  buildLayered({ id++, "WaterFlux", "mm/d", "waterflux in layer" },
+    {[](const MonicaModel& monica, OId oid, vector<double>& into)
+    {
+      vectorLayerValues(oid, monica.soilMoisture().waterFluxes(), into);
+    }, 1});
 
-      build({ id++, "rootNConcentration", "", "rootNConcentration" },
-        [](const MonicaModel& monica, OId oid)
-      {
-        return monica.cropGrowth() ? round(monica.cropGrowth()->rootNConcentration(), 4) : 0.0;
-      });
-    build({ id++, "actammoxrate", "kgN/m3/d", "actual ammonia oxidation rate in layer" },
-      [](const MonicaModel& monica, OId oid) {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().actAmmoniaOxidationRate(i); }, 6);
-      });
-
-    build({ id++, "actnitrate", "kgN/m3/d", "actual nitrification rate in layer" },
-      [](const MonicaModel& monica, OId oid) {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().actNitrificationRate(i); }, 6);
-      });
-
-    build({ id++, "actdenitrate", "kgN/m3/d", "actual denitrification rate in layer" },
-      [](const MonicaModel& monica, OId oid) {
-        auto nools = int(monica.soilColumn().vs_NumberOfOrganicLayers());
-        oid.fromLayer = min(oid.fromLayer, nools - 1);
-        oid.toLayer = min(oid.toLayer, nools - 1);
-        return getComplexValues<double>(oid, [&](int i) { return monica.soilOrganic().actDenitrificationRate(i); }, 6);
-      });
-      build({ id++, "rootDensity", "", "cropGrowth->vc_RootDensity" },
-    [](const MonicaModel& monica, OId oid) 
-        {
-      return getComplexValues<double>(oid, [&](int i) {
-      return monica.cropGrowth() ? monica.cropGrowth()->getRootDensity(i) : 0.0; }, 4);
-    });
-    build({ id++, "rootingZone", "", "cropGrowth->vc_RootingZone" },
-    [](const MonicaModel& monica, OId oid) {
-      return monica.cropGrowth() ? monica.cropGrowth()->rootingZone() : 0.0;
+  build({ id++, "Expression", "", "value of a derived output, defined as \"=<expression>\" (see Expression)" },
+    [](const MonicaModel& monica, OId oid) -> Json
+    {
+      if (oid.expression)
+        return oid.expression->value(monica);
+      return Json();
     });
-      build({ id++, "WaterFlux", "mm/d", "waterflux in layer" },
-        [](const MonicaModel& monica, OId oid)
-        {
-          return getComplexValues<double>(oid, [&](int i)
-            {
-              return monica.soilMoisture().waterFlux(i);
-            }, 1);
-        });
-
-      tableBuilt = true;
-    }
-  }
 
   return m;
 }
 
+const BOTRes& monica::buildOutputTable()
+{
+  //built exactly once (thread safe initialization of a function local static), immutable afterwards
+  static const BOTRes table = createOutputTable();
+  return table;
+}
+
+namespace
+{
+  //build the table already when the library is being loaded, not on the first request
+  [[maybe_unused]] const BOTRes& eagerlyBuiltOutputTable = buildOutputTable();
+}
+
 std::function<bool(double, double)> monica::getCompareOp(std::string ops)
 {
   function<bool(double, double)> op = [](double, double) { return false; };
@@ -44,15 +44,120 @@ namespace monica
 
   json11::Json applyOIdOP(OId::OP op, const std::vector<json11::Json>& js);
 
-  DLL_API std::vector<OId> parseOutputIds(const Tools::J11Array& oidArray);
+  //! streaming version of applyOIdOP(op, vs), updates the aggregate in place and needs constant memory
+  //! the median is exact up to 5 values and estimated by the P² algorithm (Jain & Chlamtac 1985) beyond
+  class DLL_API StreamingOIdOP
+  {
+  public:
+    explicit StreamingOIdOP(OId::OP op = OId::NONE) : _op(op) {}
+
+    void add(double v);
+
+    double value() const;
+
+    size_t count() const { return _count; }
+
+    void reset() { *this = StreamingOIdOP(_op); }
+
+  private:
+    void addToMedian(double v);
+
+    OId::OP _op{OId::NONE};
+    size_t _count{0};
+    double _first{0.0};
+    double _last{0.0};
+    double _sum{0.0};
+    double _min{0.0};
+    double _max{0.0};
+    //P² markers: heights, actual and desired positions
+    double _q[5]{};
+    double _n[5]{};
+    double _np[5]{};
+  };
+
+  //! aggregates the values of an output id (numbers, strings or arrays of layer/organ values) over time
+  //! like applyOIdOP, but in place instead of buffering all values of the aggregation period
+  class DLL_API OIdAggregator
+  {
+  public:
+    explicit OIdAggregator(OId::OP op = OId::NONE) : _op(op) {}
+
+    void add(const json11::Json& j);
+
+    //! the same as adding a number or an array of numbers, but without json11 values
+    void add(double v);
+    void add(const std::vector<double>& vs);
+
+    json11::Json value() const;
+
+    bool empty() const { return _count == 0; }
+
+    void reset() { *this = OIdAggregator(_op); }
+
+  private:
+    OId::OP _op{OId::NONE};
+    size_t _count{0};
+    json11::Json::Type _type{json11::Json::NUL};
+    json11::Json _first; //!< first and last value, just for strings
+    json11::Json _last;
+    std::vector<StreamingOIdOP> _ops; //!< one per array element or just one for numbers
+  };
+
+  //! parse output ids, derived outputs (expressions) which don't compile are dropped and their errors
+  //! appended to errors (or printed to cerr if errors is null)
+  DLL_API std::vector<OId> parseOutputIds(const Tools::J11Array& oidArray, Tools::Errors* errors = nullptr);
+
+  //! the diagnostics needed to calculate the outputs mentioned anywhere in j (output specs, expressions,
+  //! workstep conditions), errs on the side of calculating a diagnostic,
+  //! a SaveMonicaState workstep requires all of them, so the saved state is complete
+  DLL_API Diagnostics requiredDiagnostics(const json11::Json& j);
 
   struct DLL_API BOTRes
   {
-    std::map<int, std::function<json11::Json(const MonicaModel&, OId)>> ofs;
-    std::map<int, std::function<void(MonicaModel&, OId, json11::Json)>> setfs;
+    typedef std::function<json11::Json(const MonicaModel&, OId)> OutputFunc;
+    typedef std::function<void(MonicaModel&, OId, json11::Json)> SetFunc;
+
+    //! per layer outputs provide their values as doubles, too, written to a reused buffer
+    //! instead of being boxed into json11 values (see layerOutputValues)
+    struct LayerOutput
+    {
+      //! writes the values of the layers oid.fromLayer to oid.toLayer contiguously to into (missing layers as 0)
+      std::function<void(const MonicaModel&, OId, std::vector<double>& into)> values;
+      int roundToDigits{0};
+    };
+
+    //! output function of output id or nullptr if there is none
+    const OutputFunc* outputFunc(int id) const
+    {
+      return id >= 0 && size_t(id) < ofs.size() && ofs[id] ? &ofs[id] : nullptr;
+    }
+
+    //! set function of output id or nullptr if the output can't be set
+    const SetFunc* setFunc(int id) const
+    {
+      return id >= 0 && size_t(id) < setfs.size() && setfs[id] ? &setfs[id] : nullptr;
+    }
+
+    //! per layer output of output id or nullptr if it isn't one
+    const LayerOutput* layerOutput(int id) const
+    {
+      return id >= 0 && size_t(id) < layerOutputs.size() && layerOutputs[id].values ? &layerOutputs[id] : nullptr;
+    }
+
+    //! indexed by output id
+    std::vector<OutputFunc> ofs;
+    std::vector<SetFunc> setfs;
+    std::vector<LayerOutput> layerOutputs;
     std::map<std::string, OutputMetadata> name2metadata;
   };
-  DLL_API BOTRes& buildOutputTable();
+
+  //! the immutable table of all outputs, built once per process (no locking on access)
+  DLL_API const BOTRes& buildOutputTable();
+
+  //! the values of the per layer output oid as its output function returns them, but as doubles:
+  //! the rounded values of the layers or (with a layer aggregation) just the aggregated value
+  DLL_API void layerOutputValues(const BOTRes::LayerOutput& lo, const MonicaModel& monica, OId oid,
+                                 std::vector<double>& into);
 
   //----------------------------------------------------------------------------
 
@@ -80,8 +185,8 @@ namespace monica
 
       auto op = getOp(ops);
 
-      const auto& ofs = buildOutputTable().ofs;
-      typename decltype(buildOutputTable().ofs)::mapped_type lf, rf;
+      const auto& bot = buildOutputTable();
+      BOTRes::OutputFunc lf, rf;
       monica::OId loid, roid;
       if(!leftj.is_number())
       {
@@ -89,9 +194,8 @@ namespace monica
         if(!loids.empty())
         {
           loid = loids.front();
-          auto ofi = ofs.find(loid.id);
-          if(ofi != ofs.end())
-            lf = ofi->second;
+          if(auto of = bot.outputFunc(loid.id))
+            lf = *of;
         }
       }
       if(!rightj.is_number())
@@ -100,9 +204,8 @@ namespace monica
         if(!roids.empty())
         {
           roid = roids.front();
-          auto ofi = ofs.find(roid.id);
-          if(ofi != ofs.end())
-            rf = ofi->second;
+          if(auto of = bot.outputFunc(roid.id))
+            rf = *of;
         }
       }
 
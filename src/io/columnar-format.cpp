@@ -0,0 +1,305 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "columnar-format.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace monica;
+using namespace Tools;
+using namespace std;
+using namespace json11;
+
+namespace {
+
+const char MAGIC[8] = {'M', 'O', 'N', 'C', 'O', 'L', '1', '\0'};
+const char BLOCK_MAGIC[8] = {'M', 'O', 'N', 'B', 'L', 'K', '1', '\0'};
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool bigEndianHost = true;
+#else
+constexpr bool bigEndianHost = false;
+#endif
+
+//! the files hold little endian values, so on big endian hosts the bytes of every value are swapped
+template<typename T>
+T toLittleEndian(T v) {
+  if (bigEndianHost) {
+    auto bytes = reinterpret_cast<unsigned char*>(&v);
+    reverse(bytes, bytes + sizeof(T));
+  }
+  return v;
+}
+
+//! writes the buffers to the stream, keeping track of their (8 byte aligned) offsets
+class BufferWriter {
+public:
+  explicit BufferWriter(ostream& out) : _out(out) {}
+
+  void writeRaw(const void* data, size_t length) {
+    _out.write(static_cast<const char*>(data), streamsize(length));
+    _pos += length;
+  }
+
+  Json write(const void* data, size_t length) {
+    auto offset = _pos;
+    writeRaw(data, length);
+    static const char zeros[8] = {0};
+    if (_pos % 8 != 0) writeRaw(zeros, 8 - _pos % 8);
+    return J11Object{{"offset", double(offset)}, {"length", double(length)}};
+  }
+
+  template<typename T>
+  Json write(const vector<T>& vs) {
+    if (!bigEndianHost || sizeof(T) == 1) return write(vs.data(), vs.size() * sizeof(T));
+    vector<T> le(vs.size());
+    transform(vs.begin(), vs.end(), le.begin(), toLittleEndian<T>);
+    return write(le.data(), le.size() * sizeof(T));
+  }
+
+  void writeUInt64(uint64_t v) {
+    v = toLittleEndian(v);
+    writeRaw(&v, sizeof(v));
+  }
+
+private:
+  ostream& _out;
+  uint64_t _pos{0};
+};
+
+//! the values of a column, either from the column oriented or the row oriented (object) results
+class ColumnValues {
+public:
+  ColumnValues(const Output::Data& d, size_t col)
+    : _d(d), _col(col), _name(d.outputIds.at(col).outputName()) {}
+
+  size_t size() const {
+    return _d.results.empty() ? _d.resultsObj.size() : _d.results.at(_col).size();
+  }
+
+  const Json& operator[](size_t row) const {
+    static const Json null;
+    if (!_d.results.empty()) return _d.results[_col][row];
+    const auto& o = _d.resultsObj[row];
+    auto it = o.find(_name);
+    return it == o.end() ? null : it->second;
+  }
+
+private:
+  const Output::Data& _d;
+  size_t _col;
+  string _name;
+};
+
+Json writeColumn(BufferWriter& bw, const OId& oid, const ColumnValues& vs) {
+  auto rows = vs.size();
+
+  //the first non null value decides the type of the column, the longest array the size of a list column
+  auto type = Json::NUL;
+  size_t listSize = 0;
+  bool hasNulls = false;
+  for (size_t r = 0; r < rows; r++) {
+    const auto& j = vs[r];
+    if (j.is_null()) hasNulls = true;
+    else if (type == Json::NUL) type = j.type();
+    if (j.is_array()) listSize = max(listSize, j.array_items().size());
+  }
+
+  J11Object col{{"name", oid.displayName.empty() ? oid.outputName() : oid.displayName},
+                {"oid", oid.toString(true)},
+                {"unit", oid.unit}};
+
+  if (hasNulls) {
+    vector<uint8_t> validity((rows + 7) / 8, 0);
+    for (size_t r = 0; r < rows; r++) {
+      if (!vs[r].is_null()) validity[r / 8] |= uint8_t(1 << (r % 8));
+    }
+    col["validity"] = bw.write(validity);
+  }
+
+  const double nan = numeric_limits<double>::quiet_NaN();
+  switch (type) {
+    case Json::BOOL: {
+      col["type"] = "bool";
+      vector<uint8_t> data(rows, 0);
+      for (size_t r = 0; r < rows; r++) data[r] = vs[r].bool_value() ? 1 : 0;
+      col["data"] = bw.write(data);
+      break;
+    }
+    case Json::STRING: {
+      col["type"] = "utf8";
+      vector<int32_t> offsets(rows + 1, 0);
+      string data;
+      for (size_t r = 0; r < rows; r++) {
+        data += vs[r].string_value();
+        offsets[r + 1] = int32_t(data.size());
+      }
+      col["offsets"] = bw.write(offsets);
+      col["data"] = bw.write(data.data(), data.size());
+      break;
+    }
+    case Json::ARRAY: {
+      col["type"] = "fixed_size_list<float64>";
+      col["listSize"] = double(listSize);
+      vector<double> data(rows * listSize, nan);
+      for (size_t r = 0; r < rows; r++) {
+        const auto& items = vs[r].array_items();
+        for (size_t i = 0; i < items.size(); i++) {
+          if (items[i].is_number()) data[r * listSize + i] = items[i].number_value();
+        }
+      }
+      col["data"] = bw.write(data);
+      break;
+    }
+    default: { //numbers and columns with just nulls
+      col["type"] = "float64";
+      vector<double> data(rows, nan);
+      for (size_t r = 0; r < rows; r++) {
+        if (vs[r].is_number()) data[r] = vs[r].number_value();
+      }
+      col["data"] = bw.write(data);
+    }
+  }
+
+  return col;
+}
+
+void writeTables(ostream& out, const vector<const Output::Data*>& sections, J11Object footer) {
+  BufferWriter bw(out);
+  bw.writeRaw(MAGIC, sizeof(MAGIC));
+
+  J11Array tables;
+  for (const auto* d : sections) {
+    J11Array cols;
+    size_t rows = 0;
+    for (size_t i = 0; i < d->outputIds.size(); i++) {
+      ColumnValues vs(*d, i);
+      rows = vs.size();
+      cols.push_back(writeColumn(bw, d->outputIds[i], vs));
+    }
+    tables.push_back(J11Object{{"spec", d->origSpec}, {"rows", double(rows)}, {"columns", cols}});
+  }
+
+  footer["format"] = "monica-columnar";
+  footer["version"] = 1;
+  footer["tables"] = tables;
+  auto fs = Json(footer).dump();
+  bw.writeRaw(fs.data(), fs.size());
+  bw.writeUInt64(fs.size());
+  bw.writeRaw(MAGIC, sizeof(MAGIC));
+  out.flush();
+}
+
+} // namespace
+
+void monica::writeColumnarOutput(ostream& out, const Output& output) {
+  vector<const Output::Data*> sections;
+  for (const auto& d : output.data) sections.push_back(&d);
+  writeTables(out, sections, J11Object{{"customId", output.customId},
+                                       {"errors", toPrimJsonArray(output.errors)},
+                                       {"warnings", toPrimJsonArray(output.warnings)}});
+}
+
+void monica::writeColumnarOutput(ostream& out, const Output::Data& section) {
+  writeTables(out, {&section}, J11Object());
+}
+
+ColumnarContainerWriter::ColumnarContainerWriter(string pathToFile, size_t flushThreshold)
+  : _pathToFile(move(pathToFile)), _flushThreshold(flushThreshold) {}
+
+ColumnarContainerWriter::~ColumnarContainerWriter() {
+  if (!flush()) cerr << "Error while appending to output container \"" << _pathToFile << "\"" << endl;
+}
+
+bool ColumnarContainerWriter::add(const string& runId, const Output& output) {
+  string blocks;
+  auto appendBlock = [&](J11Object header, const string& tableBytes) {
+    header["run"] = runId;
+    header["length"] = double(tableBytes.size());
+    auto hs = Json(header).dump();
+    if (hs.size() % 8 != 0) hs.append(8 - hs.size() % 8, ' ');
+    auto headerSize = toLittleEndian(uint64_t(hs.size()));
+
+    blocks.append(BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+    blocks.append(reinterpret_cast<const char*>(&headerSize), sizeof(headerSize));
+    blocks += hs;
+    blocks += tableBytes;
+    if (blocks.size() % 8 != 0) blocks.append(8 - blocks.size() % 8, '\0');
+  };
+
+  // the errors and warnings of the run go into the header of its first block
+  J11Object runInfo;
+  if (!output.errors.empty()) runInfo["errors"] = toPrimJsonArray(output.errors);
+  if (!output.warnings.empty()) runInfo["warnings"] = toPrimJsonArray(output.warnings);
+
+  ostringstream table;
+  for (size_t i = 0; i < output.data.size(); i++) {
+    const auto& d = output.data[i];
+    table.str(string());
+    writeColumnarOutput(table, d);
+
+    auto header = i == 0 ? runInfo : J11Object();
+    header["section"] = int(i);
+    header["spec"] = d.origSpec;
+    appendBlock(header, table.str());
+  }
+  // a run without outputs (e.g. failed) still leaves its errors and warnings
+  if (output.data.empty() && !runInfo.empty()) {
+    runInfo["section"] = -1;
+    appendBlock(runInfo, string());
+  }
+
+  lock_guard<mutex> lock(_mutex);
+  _buffer += blocks;
+  return _buffer.size() < _flushThreshold || flushBuffer();
+}
+
+bool ColumnarContainerWriter::flush() {
+  lock_guard<mutex> lock(_mutex);
+  return flushBuffer();
+}
+
+bool ColumnarContainerWriter::flushBuffer() {
+  if (_failed) return false;
+  if (_buffer.empty()) return true;
+
+  // a partially appended buffer has to be cut off again, otherwise the next try would append it a second time
+  error_code ec;
+  auto sizeBefore = filesystem::exists(_pathToFile, ec) ? filesystem::file_size(_pathToFile, ec) : 0;
+  if (ec) return false;
+
+  ofstream out(_pathToFile, ios::out | ios::binary | ios::app);
+  if (out.fail()) return false;
+  out.write(_buffer.data(), streamsize(_buffer.size()));
+  out.close();
+  if (out.fail()) {
+    filesystem::resize_file(_pathToFile, sizeBefore, ec);
+    if (ec) {
+      cerr << "Error: couldn't truncate output container \"" << _pathToFile << "\" after a failed write: "
+           << ec.message() << endl;
+      _failed = true;
+    }
+    return false;
+  }
+  _buffer.clear();
+  return true;
+}
@@ -0,0 +1,94 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <iostream>
+#include <mutex>
+#include <string>
+
+#include "../io/output.h"
+
+namespace monica {
+  /**
+   * Columnar binary output format, modelled on the Arrow IPC file layout, but with a JSON footer.
+   *
+   * file   := MAGIC buffer* footer footer-length:uint64 MAGIC
+   * MAGIC  := "MONCOL1\0"
+   *
+   * All buffers start at 8 byte aligned file offsets and hold little endian values.
+   * The footer is a JSON object ({"format": "monica-columnar", "version": 1, "customId", "errors", "warnings",
+   * "tables": [{"spec", "rows", "columns": [...]}]}) with one table per output section.
+   * A column has "name", "oid", "unit", "type" and the buffers as {"offset", "length"} pairs:
+   * - "float64": "data" double[rows]
+   * - "bool": "data" uint8[rows]
+   * - "utf8": "offsets" int32[rows + 1], "data" the concatenated strings
+   * - "fixed_size_list<float64>" (layer/organ arrays): "listSize" n, "data" double[rows * n]
+   *   (missing elements are NaN)
+   * and the optional "validity" bitmap (bit i = row i not null, least significant bit first),
+   * which is only present if the column contains nulls.
+   */
+  void writeColumnarOutput(std::ostream& out, const Output& output);
+
+  //! write a single output section as a file with one table
+  void writeColumnarOutput(std::ostream& out, const Output::Data& section);
+
+  /**
+   * Appendable container of the columnar output sections of many runs in a single file, instead of one file
+   * per run and output section.
+   *
+   * container   := block*
+   * block       := BLOCK_MAGIC header-length:uint64 header columnar-file padding
+   * BLOCK_MAGIC := "MONBLK1\0"
+   *
+   * The header length is little endian, the header is a JSON object {"run": run id, "section": index,
+   * "spec": orig spec, "length": byte length of the columnar file} padded with spaces, the columnar file is
+   * a complete file as written by writeColumnarOutput(out, section), padded with zeros, so every block and
+   * file starts 8 byte aligned.
+   * The header of the first block of a run also holds its "errors" and "warnings" (if any), a run without
+   * output sections, but with errors or warnings, is written as a single block with "section": -1 and no
+   * columnar file ("length": 0).
+   * The blocks are collected in memory and appended to the file in a single write as soon as flushThreshold
+   * bytes are buffered (and on flush/destruction), so a block is never split across writes.
+   * A failed write truncates the file back to its previous size and keeps the blocks buffered for the next
+   * try, if the file can't be truncated, the writer fails from then on instead of risking torn or duplicated
+   * blocks.
+   * The writer can be shared by threads, the sections are encoded outside of the lock.
+   */
+  class ColumnarContainerWriter {
+  public:
+    explicit ColumnarContainerWriter(std::string pathToFile, size_t flushThreshold = 16 * 1024 * 1024);
+
+    ~ColumnarContainerWriter();
+
+    //! add one block per output section of the run, returns false if the file couldn't be written
+    //! (when the buffer reached the flush threshold)
+    bool add(const std::string& runId, const Output& output);
+
+    //! append the buffered blocks to the file, returns false if the file couldn't be written
+    bool flush();
+
+    const std::string& pathToFile() const { return _pathToFile; }
+
+  private:
+    bool flushBuffer();
+
+    std::string _pathToFile;
+    size_t _flushThreshold;
+    std::string _buffer;
+    bool _failed{false}; //!< a write failed and the file couldn't be truncated to its previous size
+    std::mutex _mutex;
+  };
+} // namespace monica
@@ -17,6 +17,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include "csv-format.h"
 
+#include <charconv>
 #include <string>
 
 #include "tools/debug.h"
@@ -32,6 +33,137 @@ inline string operator "" _s(const char *_Str, size_t _Len)
   return (string(_Str, _Len));
 }
 
+namespace
+{
+  //! collects the formatted rows and hands them to the stream in large chunks,
+  //! numbers are formatted like the stream would do (same precision and float field)
+  class CsvBuffer
+  {
+  public:
+    explicit CsvBuffer(ostream& out, size_t capacity = 1 << 16)
+      : _out(out)
+      , _capacity(capacity)
+      , _precision(int(out.precision()))
+    {
+      _buf.reserve(capacity + 128);
+      auto ff = out.flags() & ios::floatfield;
+      if(ff == ios::fixed)
+        _format = chars_format::fixed;
+      else if(ff == ios::scientific)
+        _format = chars_format::scientific;
+      else if(ff == (ios::fixed | ios::scientific))
+        _useStream = true; // hexfloat is formatted differently by to_chars
+      // to_chars knows nothing about these flags (showpos affects bools, too)
+      if(out.flags() & (ios::showpoint | ios::showpos | ios::uppercase))
+        _useStream = true;
+      _boolAlpha = bool(out.flags() & ios::boolalpha);
+    }
+
+    ~CsvBuffer() { flush(); }
+
+    void append(const string& s) { _buf.append(s); }
+
+    void append(const char* s) { _buf.append(s); }
+
+    void append(char c) { _buf.push_back(c); }
+
+    void appendNumber(double d)
+    {
+      char cs[128];
+      auto res = _useStream ? to_chars_result{cs, errc::value_too_large}
+                            : to_chars(cs, cs + sizeof(cs), d, _format, _precision);
+      if(res.ec == errc())
+        _buf.append(cs, res.ptr);
+      else
+        appendStreamed(d);
+    }
+
+    void appendBool(bool b)
+    {
+      if(_useStream)
+        appendStreamed(b);
+      else if(_boolAlpha)
+        _buf.append(b ? "true" : "false");
+      else
+        _buf.push_back(b ? '1' : '0');
+    }
+
+    //! to be called at row ends
+    void endRow()
+    {
+      _buf.push_back('\n');
+      if(_buf.size() >= _capacity)
+        flush();
+    }
+
+    void flush()
+    {
+      _out.write(_buf.data(), streamsize(_buf.size()));
+      _buf.clear();
+    }
+
+  private:
+    template<typename T>
+    void appendStreamed(T v)
+    {
+      ostringstream oss;
+      oss.copyfmt(_out);
+      oss << v;
+      _buf.append(oss.str());
+    }
+
+    ostream& _out;
+    string _buf;
+    size_t _capacity{0};
+    chars_format _format{chars_format::general};
+    int _precision{6};
+    bool _useStream{false};
+    bool _boolAlpha{false};
+  };
+
+  void appendString(CsvBuffer& buf, const string& s, const string& escapeTokens)
+  {
+    if(s.find_first_of(escapeTokens) == string::npos)
+      buf.append(s);
+    else
+    {
+      buf.append('"');
+      buf.append(s);
+      buf.append('"');
+    }
+  }
+
+  //! same output as formerly streaming the value
+  void appendValue(CsvBuffer& buf, const Json& j, const string& csvSep, const string& escapeTokens)
+  {
+    switch(j.type())
+    {
+    case Json::NUMBER: buf.appendNumber(j.number_value()); break;
+    case Json::STRING: appendString(buf, j.string_value(), escapeTokens); break;
+    case Json::BOOL: buf.appendBool(j.bool_value()); break;
+    case Json::ARRAY:
+    {
+      size_t jvi = 0;
+      auto jSize = j.array_items().size();
+      for(const Json& jv : j.array_items())
+      {
+        switch(jv.type())
+        {
+        case Json::NUMBER: buf.appendNumber(jv.number_value()); break;
+        case Json::STRING: appendString(buf, jv.string_value(), escapeTokens); break;
+        case Json::BOOL: buf.appendBool(jv.bool_value()); break;
+        default: buf.append("UNKNOWN");
+        }
+        if(++jvi < jSize)
+          buf.append(csvSep);
+      }
+      break;
+    }
+    default: buf.append("UNKNOWN");
+    }
+  }
+}
+
 void monica::writeOutputHeaderRows(ostream& out,
                                    const vector<OId>& outputIds,
                                    string csvSep,
@@ -80,13 +212,13 @@ void monica::writeOutputHeaderRows(ostream& out,
   }
   
   if(includeHeaderRow)
-    out << oss1.str() << endl;
+    out << oss1.str() << '\n';
   if(includeUnitsRow)
-    out << oss2.str() << endl;
+    out << oss2.str() << '\n';
   if(includeTimeAgg)
     out 
-    << oss3.str() << endl
-    << oss4.str() << endl;
+    << oss3.str() << '\n'
+    << oss4.str() << '\n';
 }
 
 void monica::writeOutput(ostream& out,
@@ -99,54 +231,17 @@ void monica::writeOutput(ostream& out,
 
   if(!values.empty())
   {
+    CsvBuffer buf(out);
+    auto oidsSize = outputIds.size();
     for(size_t k = 0, size = values.begin()->size(); k < size; k++)
     {
-      size_t i = 0;
-      auto oidsSize = outputIds.size();
-      for(auto oid : outputIds)
+      for(size_t i = 0; i < oidsSize; i++)
       {
-        auto csvSep_ = i + 1 ==  oidsSize ? "" : csvSep;
-        Json j = values.at(i).at(k);
-        switch(j.type())
-        {
-        case Json::NUMBER: out << j.number_value() << csvSep_; break;
-        case Json::STRING: 
-          out 
-          << (j.string_value().find_first_of(escapeTokens) == string::npos 
-                                   ? j.string_value() 
-                                   : "\""_s + j.string_value() + "\""_s) 
-          << csvSep_; break;
-        case Json::BOOL: out << j.bool_value() << csvSep_; break;
-        case Json::ARRAY:
-        {
-          size_t jvi = 0;
-          auto jSize = j.array_items().size();
-          for(Json jv : j.array_items())
-          {
-            auto csvSep__ = jvi + 1 == jSize ? "" : csvSep;
-            switch(jv.type())
-            {
-            case Json::NUMBER: out << jv.number_value() << csvSep__; break;
-            case Json::STRING: 
-              out 
-                << (jv.string_value().find_first_of(escapeTokens) == string::npos
-                    ? jv.string_value()
-                    : "\""_s + jv.string_value() + "\""_s)
-                << csvSep__; break;
-            case Json::BOOL: out << jv.bool_value() << csvSep__; break;
-            default: out << "UNKNOWN" << csvSep__;
-            }
-            ++jvi;
-          }
-          out << csvSep_; 
-          break;
-        }
-        default: out << "UNKNOWN" << csvSep_;
-        }
-
-        ++i;
+        appendValue(buf, values.at(i).at(k), csvSep, escapeTokens);
+        if(i + 1 < oidsSize)
+          buf.append(csvSep);
       }
-      out << endl;
+      buf.endRow();
     }
   }
   out.flush();
@@ -162,62 +257,25 @@ void monica::writeOutputObj(ostream& out,
 
   if(!values.empty())
   {
+    CsvBuffer buf(out);
+    vector<string> outputNames;
+    for(const auto& oid : outputIds)
+      outputNames.push_back(oid.outputName());
+    auto oidsSize = outputIds.size();
     for(const auto& o : values)
     {
-      size_t i = 0;
-      auto oidsSize = outputIds.size();
-      for(auto oid : outputIds)
+      for(size_t i = 0; i < oidsSize; i++)
       {
-        auto csvSep_ = i + 1 == oidsSize ? "" : csvSep;
-        auto oi = o.find(oid.outputName());
+        auto oi = o.find(outputNames[i]);
         if(oi != o.end())
         {
-          Json j = oi->second;
-          switch(j.type())
-          {
-          case Json::NUMBER: out << j.number_value() << csvSep_; break;
-          case Json::STRING:
-            out
-              << (j.string_value().find_first_of(escapeTokens) == string::npos
-                  ? j.string_value()
-                  : "\""_s + j.string_value() + "\""_s)
-              << csvSep_; break;
-          case Json::BOOL: out << j.bool_value() << csvSep_; break;
-          case Json::ARRAY:
-          {
-            size_t jvi = 0;
-            auto jSize = j.array_items().size();
-            for(Json jv : j.array_items())
-            {
-              auto csvSep__ = jvi + 1 == jSize ? "" : csvSep;
-              switch(jv.type())
-              {
-              case Json::NUMBER: out << jv.number_value() << csvSep__; break;
-              case Json::STRING:
-                out
-                  << (jv.string_value().find_first_of(escapeTokens) == string::npos
-                      ? jv.string_value()
-                      : "\""_s + jv.string_value() + "\""_s)
-                  << csvSep__; break;
-              case Json::BOOL: out << jv.bool_value() << csvSep__; break;
-              default: out << "UNKNOWN" << csvSep__;
-              }
-              ++jvi;
-            }
-            out << csvSep_;
-            break;
-          }
-          default: out << "UNKNOWN" << csvSep_;
-          }
+          appendValue(buf, oi->second, csvSep, escapeTokens);
+          if(i + 1 < oidsSize)
+            buf.append(csvSep);
         }
-        ++i;
       }
-      out << endl;
-
-
+      buf.endRow();
     }
   }
   out.flush();
 }
-
-
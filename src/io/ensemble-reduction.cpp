@@ -0,0 +1,246 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "ensemble-reduction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#include "json11/json11-helper.h"
+
+using namespace monica;
+using namespace Tools;
+using namespace std;
+using namespace json11;
+
+namespace {
+
+string quantileName(double q) {
+  ostringstream oss;
+  oss << "p" << q * 100;
+  return oss.str();
+}
+
+//! linear interpolation between the closest ranks (like numpy's default), vs has to be sorted
+double quantile(const vector<double>& vs, double q) {
+  auto h = (vs.size() - 1) * q;
+  auto lo = size_t(floor(h));
+  auto hi = min(lo + 1, vs.size() - 1);
+  return vs[lo] + (h - lo) * (vs[hi] - vs[lo]);
+}
+
+} // namespace
+
+EnsembleReducer::EnsembleReducer(json11::Json spec) {
+  static const vector<string> knownStats = {"mean", "var", "std", "min", "max", "count"};
+  for (const auto& s : spec["stats"].array_items()) {
+    auto name = s.string_value();
+    if (find(knownStats.begin(), knownStats.end(), name) != knownStats.end()) _stats.push_back(name);
+    else _warnings.push_back("Unknown ensemble statistic '" + (s.is_string() ? name : s.dump()) + "', ignored it.");
+  }
+  if (!spec["stats"].is_array()) _stats = {"mean", "var", "min", "max"};
+  for (const auto& q : spec["quantiles"].array_items()) _quantiles.push_back(min(1.0, max(0.0, q.number_value())));
+}
+
+void EnsembleReducer::addValue(Column& col, size_t row, const Json& j) {
+  if (j.is_null()) return;
+  if (col.type == Json::NUL) {
+    col.type = j.type();
+    if (j.is_array()) col.listSize = max(size_t(1), j.array_items().size());
+  }
+
+  if (col.type == Json::NUMBER || col.type == Json::ARRAY) {
+    if (col.values.size() <= row) col.values.resize(row + 1);
+    auto& cells = col.values[row];
+    if (cells.size() < col.listSize) cells.resize(col.listSize);
+    if (j.is_number()) cells[0].push_back(j.number_value());
+    else if (j.is_array()) {
+      const auto& items = j.array_items();
+      for (size_t k = 0, size = min(items.size(), col.listSize); k < size; k++) {
+        if (items[k].is_number()) cells[k].push_back(items[k].number_value());
+      }
+    }
+  } else {
+    if (col.firstValues.size() <= row) col.firstValues.resize(row + 1);
+    if (col.firstValues[row].is_null()) col.firstValues[row] = j;
+  }
+}
+
+void EnsembleReducer::add(const Output& member) {
+  auto memberNo = to_string(++_noOfAddedMembers);
+  for (const auto& e : member.errors) _errors.push_back("Ensemble member " + memberNo + ": " + e);
+  for (const auto& w : member.warnings) _warnings.push_back("Ensemble member " + memberNo + ": " + w);
+
+  // failed members (just errors, no outputs) don't define the layout and aren't reduced
+  if (member.data.empty()) {
+    _warnings.push_back("Ensemble member " + memberNo + " has no outputs, ignored it.");
+    return;
+  }
+
+  // the first member with outputs defines the sections and columns
+  if (_sections.empty()) {
+    for (const auto& d : member.data) {
+      Section s;
+      s.origSpec = d.origSpec;
+      s.isObj = d.results.empty() && !d.resultsObj.empty();
+      for (const auto& oid : d.outputIds) {
+        Column col;
+        col.oid = oid;
+        s.columns.push_back(col);
+      }
+      _sections.push_back(s);
+    }
+  }
+
+  // members with different output specs can't be reduced together
+  bool sameLayout = member.data.size() == _sections.size();
+  for (size_t si = 0; sameLayout && si < _sections.size(); si++) {
+    sameLayout = member.data[si].outputIds.size() == _sections[si].columns.size();
+  }
+  if (!sameLayout) {
+    _warnings.push_back("Ensemble member " + memberNo + " has different output sections, ignored it.");
+    return;
+  }
+  _noOfMembers++;
+
+  for (size_t si = 0; si < _sections.size(); si++) {
+    auto& s = _sections[si];
+    const auto& d = member.data[si];
+
+    size_t noOfRows = d.resultsObj.size();
+    for (const auto& rows : d.results) noOfRows = max(noOfRows, rows.size());
+    if (!s.hasRows) {
+      s.noOfRows = noOfRows;
+      s.hasRows = true;
+    } else if (noOfRows != s.noOfRows) {
+      _warnings.push_back("Ensemble member " + memberNo + " has " + to_string(noOfRows) + " instead of "
+                          + to_string(s.noOfRows) + " rows in section " + s.origSpec + ", ignored it there.");
+      continue;
+    }
+
+    if (!d.results.empty()) {
+      for (size_t c = 0; c < min(s.columns.size(), d.results.size()); c++) {
+        const auto& rows = d.results[c];
+        for (size_t r = 0; r < rows.size(); r++) addValue(s.columns[c], r, rows[r]);
+      }
+    } else {
+      for (size_t r = 0; r < d.resultsObj.size(); r++) {
+        const auto& row = d.resultsObj[r];
+        for (auto& col : s.columns) {
+          auto it = row.find(col.oid.outputName());
+          if (it != row.end()) addValue(col, r, it->second);
+        }
+      }
+    }
+  }
+}
+
+Output EnsembleReducer::result() const {
+  Output out;
+  out.errors = _errors;
+  out.warnings = _warnings;
+  out.warnings.push_back("Reduced outputs of " + to_string(_noOfMembers) + " of " + to_string(_noOfAddedMembers)
+                         + " ensemble members.");
+
+  const double nan = numeric_limits<double>::quiet_NaN();
+  vector<string> statNames = _stats;
+  for (auto q : _quantiles) statNames.push_back(quantileName(q));
+
+  for (const auto& s : _sections) {
+    Output::Data d;
+    d.origSpec = s.origSpec;
+    vector<J11Array> columns;
+
+    for (const auto& col : s.columns) {
+      if (col.type != Json::NUMBER && col.type != Json::ARRAY) {
+        d.outputIds.push_back(col.oid);
+        J11Array vs(col.firstValues.begin(), col.firstValues.end());
+        vs.resize(s.noOfRows);
+        columns.push_back(vs);
+        continue;
+      }
+
+      auto first = columns.size();
+      for (const auto& name : statNames) {
+        auto oid = col.oid;
+        oid.displayName = col.oid.outputName() + "_" + name;
+        d.outputIds.push_back(oid);
+        columns.emplace_back();
+        columns.back().reserve(s.noOfRows);
+      }
+
+      vector<double> sorted;
+      for (size_t r = 0; r < s.noOfRows; r++) {
+        // statistics of every layer/organ element, in the order of statNames
+        vector<J11Array> elements(statNames.size());
+        auto listSize = col.type == Json::ARRAY ? col.listSize : 1;
+        for (size_t k = 0; k < listSize; k++) {
+          const vector<double>* vs = nullptr;
+          if (r < col.values.size() && k < col.values[r].size()) vs = &col.values[r][k];
+          auto n = vs ? vs->size() : 0;
+
+          double sum = 0, mean = nan, var = nan;
+          if (n > 0) {
+            for (auto v : *vs) sum += v;
+            mean = sum / n;
+            if (n > 1) {
+              double ss = 0;
+              for (auto v : *vs) ss += (v - mean) * (v - mean);
+              var = ss / (n - 1);
+            }
+            sorted.assign(vs->begin(), vs->end());
+            sort(sorted.begin(), sorted.end());
+          }
+
+          size_t i = 0;
+          for (const auto& stat : _stats) {
+            double v = nan;
+            if (n > 0) {
+              if (stat == "mean") v = mean;
+              else if (stat == "var") v = var;
+              else if (stat == "std") v = sqrt(var);
+              else if (stat == "min") v = sorted.front();
+              else if (stat == "max") v = sorted.back();
+              else if (stat == "count") v = double(n);
+            }
+            elements[i++].push_back(v);
+          }
+          for (auto q : _quantiles) elements[i++].push_back(n > 0 ? quantile(sorted, q) : nan);
+        }
+
+        for (size_t i = 0; i < statNames.size(); i++) {
+          if (col.type == Json::ARRAY) columns[first + i].push_back(elements[i]);
+          else columns[first + i].push_back(elements[i].front());
+        }
+      }
+    }
+
+    if (s.isObj) {
+      for (size_t r = 0; r < s.noOfRows; r++) {
+        J11Object row;
+        for (size_t c = 0; c < columns.size(); c++) {
+          if (!columns[c][r].is_null()) row[d.outputIds[c].outputName()] = columns[c][r];
+        }
+        d.resultsObj.push_back(row);
+      }
+    } else d.results = columns;
+
+    out.data.push_back(d);
+  }
+
+  return out;
+}
@@ -0,0 +1,85 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "json11/json11.hpp"
+
+#include "common/dll-exports.h"
+#include "output.h"
+
+namespace monica {
+
+/**
+ * @brief Reduces the outputs of the members of an ensemble (runs with identical output specs) to statistics.
+ *
+ * The members are added one after another, just their numbers are being kept (per section, output id, row and
+ * layer/organ element), so the member outputs can be dropped right after adding them.
+ * The result has the same sections and rows as the members, but every numeric output id is replaced by one
+ * output id per statistic, named <output name>_<statistic>, e.g. Yield_mean, Yield_p90.
+ * Other outputs (dates, crop names ...) are the first non null value of the members.
+ * Rows are aligned by their position, so the k-th row of an event section (e.g. crop) is the k-th event of
+ * every member. A member with a different number of rows in a section isn't reduced in that section
+ * (with a warning), as its rows can't be matched up with the others.
+ * Members without outputs (failed runs) or with a different layout of sections and output ids are not being
+ * reduced, the errors and warnings of all members are kept (prefixed by the member number).
+ */
+class DLL_API EnsembleReducer {
+public:
+  /**
+   * @param spec {"stats": ["mean", "var", "std", "min", "max"], "quantiles": [0.1, 0.5, 0.9]},
+   * defaults to mean, var, min and max and no quantiles, unknown statistics are ignored with a warning
+   */
+  explicit EnsembleReducer(json11::Json spec = json11::Json());
+
+  void add(const Output& member);
+
+  //! number of members reduced (not counting the ignored ones)
+  size_t size() const { return _noOfMembers; }
+
+  Output result() const;
+
+private:
+  struct Column {
+    OId oid;
+    json11::Json::Type type{json11::Json::NUL};
+    size_t listSize{1};
+    std::vector<json11::Json> firstValues; //!< first non null value of the members, for non numeric outputs
+    std::vector<std::vector<std::vector<double>>> values; //!< [row][layer/organ element][member]
+  };
+
+  struct Section {
+    std::string origSpec;
+    bool isObj{false};
+    std::vector<Column> columns;
+    size_t noOfRows{0}; //!< fixed by the first member reduced in this section
+    bool hasRows{false};
+  };
+
+  void addValue(Column& col, size_t row, const json11::Json& j);
+
+  std::vector<std::string> _stats;
+  std::vector<double> _quantiles;
+  std::vector<Section> _sections;
+  size_t _noOfMembers{0};
+  size_t _noOfAddedMembers{0};
+  std::vector<std::string> _errors;
+  std::vector<std::string> _warnings;
+};
+
+} // namespace monica
@@ -0,0 +1,316 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <map>
+
+#include "build-output.h"
+#include "../core/monica-model.h"
+
+using namespace monica;
+using namespace Tools;
+using namespace std;
+using namespace json11;
+
+namespace monica {
+
+//! recursive descent compiler emitting the stack machine code of an expression
+class ExpressionCompiler {
+public:
+  explicit ExpressionCompiler(Expression& e) : _e(e), _s(e._text) {}
+
+  void compile() {
+    parseBinary(0);
+    skipSpace();
+    if (_pos < _s.size()) error("unexpected '" + _s.substr(_pos, 1) + "'");
+  }
+
+  const vector<string>& errors() const { return _errors; }
+
+private:
+  struct BinOp { const char* token; int precedence; Expression::OpCode op; };
+
+  void error(const string& msg) {
+    if (_errors.empty()) _errors.push_back("Expression '" + _s + "' at " + to_string(_pos) + ": " + msg);
+    _pos = _s.size();
+  }
+
+  void skipSpace() { while (_pos < _s.size() && isspace((unsigned char)_s[_pos])) _pos++; }
+
+  bool accept(const char* token) {
+    skipSpace();
+    auto len = char_traits<char>::length(token);
+    if (_s.compare(_pos, len, token) != 0) return false;
+    _pos += len;
+    return true;
+  }
+
+  void expect(const char* token) { if (!accept(token)) error(string("expected '") + token + "'"); }
+
+  bool isNameStart(char c) const { return isalpha((unsigned char)c) || c == '_' || c == '\''; }
+
+  string parseName() {
+    skipSpace();
+    string name;
+    if (_pos < _s.size() && _s[_pos] == '\'') {
+      auto end = _s.find('\'', _pos + 1);
+      if (end == string::npos) { error("unterminated quoted name"); return name; }
+      name = _s.substr(_pos + 1, end - _pos - 1);
+      _pos = end + 1;
+    } else {
+      while (_pos < _s.size() && (isalnum((unsigned char)_s[_pos]) || _s[_pos] == '_')) name.push_back(_s[_pos++]);
+    }
+    return name;
+  }
+
+  void emit(Expression::OpCode op, int pops, int pushes, uint16_t arg = 0, double value = 0) {
+    _e._code.push_back({op, arg, value});
+    _depth += pushes - pops;
+    _e._maxStackSize = max(_e._maxStackSize, size_t(max(_depth, 0)));
+  }
+
+  //! precedence climbing for the binary operators, the longer tokens have to come first
+  void parseBinary(int minPrecedence) {
+    static const BinOp ops[] = {
+      {"||", 1, Expression::OR}, {"&&", 2, Expression::AND},
+      {"==", 3, Expression::EQ}, {"!=", 3, Expression::NE},
+      {"<=", 4, Expression::LE}, {">=", 4, Expression::GE}, {"<", 4, Expression::LT}, {">", 4, Expression::GT},
+      {"+", 5, Expression::ADD}, {"-", 5, Expression::SUB},
+      {"*", 6, Expression::MUL}, {"/", 6, Expression::DIV}
+    };
+
+    parseUnary();
+    while (_errors.empty()) {
+      skipSpace();
+      const BinOp* found = nullptr;
+      for (const auto& bop : ops) {
+        if (bop.precedence >= minPrecedence && _s.compare(_pos, char_traits<char>::length(bop.token), bop.token) == 0) {
+          found = &bop;
+          break;
+        }
+      }
+      if (!found) break;
+      _pos += char_traits<char>::length(found->token);
+      parseBinary(found->precedence + 1);
+      emit(found->op, 2, 1);
+    }
+  }
+
+  void parseUnary() {
+    if (accept("-")) { parseUnary(); emit(Expression::NEG, 1, 1); }
+    else if (accept("!")) { parseUnary(); emit(Expression::NOT, 1, 1); }
+    else if (accept("+")) parseUnary();
+    else {
+      parsePrimary();
+      if (accept("^")) { parseUnary(); emit(Expression::POW, 2, 1); }
+    }
+  }
+
+  void parsePrimary() {
+    skipSpace();
+    if (_pos >= _s.size()) return error("unexpected end");
+
+    char c = _s[_pos];
+    if (accept("(")) {
+      parseBinary(0);
+      expect(")");
+    } else if (isdigit((unsigned char)c) || c == '.') {
+      char* end = nullptr;
+      double v = strtod(_s.c_str() + _pos, &end);
+      if (end == _s.c_str() + _pos) return error("invalid number");
+      _pos = end - _s.c_str();
+      emit(Expression::CONST, 0, 1, 0, v);
+    } else if (isNameStart(c)) {
+      auto quoted = c == '\'';
+      auto name = parseName();
+      if (!quoted && accept("(")) parseCall(name);
+      else parseReference(name);
+    } else error("unexpected '" + string(1, c) + "'");
+  }
+
+  void parseCall(const string& name) {
+    static const map<string, pair<Expression::OpCode, int>> funcs = {
+      {"min", {Expression::MIN, -1}}, {"max", {Expression::MAX, -1}},
+      {"abs", {Expression::ABS, 1}}, {"sqrt", {Expression::SQRT, 1}},
+      {"exp", {Expression::EXP, 1}}, {"log", {Expression::LOG, 1}},
+      {"pow", {Expression::POW, 2}}, {"if", {Expression::IF, 3}}
+    };
+    auto it = funcs.find(name);
+    if (it == funcs.end()) return error("unknown function '" + name + "'");
+
+    int noOfArgs = 0;
+    if (!accept(")")) {
+      do {
+        parseBinary(0);
+        noOfArgs++;
+      } while (_errors.empty() && accept(","));
+      expect(")");
+    }
+    auto arity = it->second.second;
+    if ((arity < 0 && noOfArgs < 1) || (arity >= 0 && noOfArgs != arity)) {
+      return error("wrong number of arguments for '" + name + "'");
+    }
+    emit(it->second.first, noOfArgs, 1, uint16_t(noOfArgs));
+  }
+
+  //! a reference to an output, the layer/organ spec is translated to the usual JSON output id syntax
+  void parseReference(const string& name) {
+    J11Array spec;
+    if (accept("[")) {
+      while (_errors.empty()) {
+        skipSpace();
+        if (_pos < _s.size() && (isdigit((unsigned char)_s[_pos]))) {
+          char* end = nullptr;
+          spec.push_back(int(strtol(_s.c_str() + _pos, &end, 10)));
+          _pos = end - _s.c_str();
+        } else {
+          auto n = parseName();
+          if (n.empty()) return error("expected layer, organ or aggregation operation");
+          spec.push_back(n);
+        }
+        if (!accept(",")) break;
+      }
+      expect("]");
+    }
+    if (!_errors.empty()) return;
+
+    J11Array oidj{name};
+    if (spec.size() == 1) oidj.push_back(spec.front());
+    else if (spec.size() >= 2) {
+      //a layer range [from, to] is averaged by default, [layer, op] already names its operation
+      if (spec.size() == 2 && spec[1].is_number()) spec.push_back("AVG");
+      oidj.push_back(spec);
+    }
+
+    auto oids = parseOutputIds(J11Array{Json(oidj)});
+    if (oids.empty()) return error("unknown output '" + name + "'");
+
+    auto oid = oids.front();
+    auto it = find_if(_e._refs.begin(), _e._refs.end(), [&](const OId& r) { return r.jsonInput == oid.jsonInput; });
+    auto index = it - _e._refs.begin();
+    if (it == _e._refs.end()) _e._refs.push_back(oid);
+    emit(Expression::LOAD, 0, 1, uint16_t(index));
+  }
+
+  Expression& _e;
+  const string& _s;
+  size_t _pos{0};
+  int _depth{0};
+  vector<string> _errors;
+};
+
+} // namespace monica
+
+EResult<shared_ptr<const Expression>> Expression::compile(const string& text) {
+  auto e = make_shared<Expression>();
+  e->_text = text;
+  ExpressionCompiler c(*e);
+  c.compile();
+  if (!c.errors().empty()) return {shared_ptr<const Expression>(), c.errors()};
+  return {shared_ptr<const Expression>(e)};
+}
+
+namespace {
+
+double numberValue(const Json& j) {
+  switch (j.type()) {
+    case Json::NUMBER: return j.number_value();
+    case Json::BOOL: return j.bool_value() ? 1.0 : 0.0;
+    case Json::ARRAY:
+      if (j.array_items().size() == 1) return numberValue(j.array_items().front());
+      [[fallthrough]];
+    default: return numeric_limits<double>::quiet_NaN();
+  }
+}
+
+} // namespace
+
+template<typename Load>
+double Expression::evaluate(Load load) const {
+  // the expressions are usually tiny, so keep the stack on the stack
+  double fixedStack[32];
+  vector<double> dynStack;
+  double* stack = fixedStack;
+  if (_maxStackSize > 32) {
+    dynStack.resize(_maxStackSize);
+    stack = dynStack.data();
+  }
+
+  size_t sp = 0;
+  for (const auto& in : _code) {
+    switch (in.op) {
+      case CONST: stack[sp++] = in.value; break;
+      case LOAD: stack[sp++] = load(in.arg); break;
+      case NEG: stack[sp - 1] = -stack[sp - 1]; break;
+      case NOT: stack[sp - 1] = isTrue(stack[sp - 1]) ? 0.0 : 1.0; break;
+      case ABS: stack[sp - 1] = abs(stack[sp - 1]); break;
+      case SQRT: stack[sp - 1] = sqrt(stack[sp - 1]); break;
+      case EXP: stack[sp - 1] = exp(stack[sp - 1]); break;
+      case LOG: stack[sp - 1] = log(stack[sp - 1]); break;
+      case MIN:
+      case MAX: {
+        sp -= in.arg;
+        auto first = stack + sp, last = first + in.arg;
+        stack[sp++] = in.op == MIN ? *min_element(first, last) : *max_element(first, last);
+        break;
+      }
+      case IF:
+        sp -= 2;
+        stack[sp - 1] = isTrue(stack[sp - 1]) ? stack[sp] : stack[sp + 1];
+        break;
+      default: {
+        auto r = stack[--sp];
+        auto& l = stack[sp - 1];
+        switch (in.op) {
+          case ADD: l = l + r; break;
+          case SUB: l = l - r; break;
+          case MUL: l = l * r; break;
+          case DIV: l = l / r; break;
+          case POW: l = pow(l, r); break;
+          case LT: l = l < r ? 1.0 : 0.0; break;
+          case LE: l = l <= r ? 1.0 : 0.0; break;
+          case GT: l = l > r ? 1.0 : 0.0; break;
+          case GE: l = l >= r ? 1.0 : 0.0; break;
+          case EQ: l = l == r ? 1.0 : 0.0; break;
+          case NE: l = l != r ? 1.0 : 0.0; break;
+          case AND: l = isTrue(l) && isTrue(r) ? 1.0 : 0.0; break;
+          case OR: l = isTrue(l) || isTrue(r) ? 1.0 : 0.0; break;
+          default:;
+        }
+      }
+    }
+  }
+
+  return sp > 0 ? stack[sp - 1] : numeric_limits<double>::quiet_NaN();
+}
+
+double Expression::value(const MonicaModel& monica) const {
+  const auto& bot = buildOutputTable();
+  return evaluate([&](size_t i) {
+    const auto& oid = _refs[i];
+    auto of = bot.outputFunc(oid.id);
+    return of ? numberValue((*of)(monica, oid)) : numeric_limits<double>::quiet_NaN();
+  });
+}
+
+double Expression::value(const vector<double>& refValues) const {
+  return evaluate([&](size_t i) { return i < refValues.size() ? refValues[i] : numeric_limits<double>::quiet_NaN(); });
+}
@@ -0,0 +1,91 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "json11/json11.hpp"
+
+#include "common/dll-exports.h"
+#include "json11/json11-helper.h"
+#include "output.h"
+
+namespace monica {
+
+class MonicaModel;
+
+/**
+ * @brief Small expression language for derived outputs and output conditions, compiled to stack machine code.
+ *
+ * Grammar (usual C precedence, ^ binds strongest and is right associative):
+ *   expr    := expr ("||" | "&&" | "==" | "!=" | "<" | "<=" | ">" | ">=" | "+" | "-" | "*" | "/" | "^") expr
+ *            | ("-" | "!") expr | "(" expr ")" | number | func "(" expr ("," expr)* ")" | ref
+ *   func    := min | max | abs | sqrt | exp | log | pow | if
+ *   ref     := name ("[" layer ("," layerAggOp)? "]" | "[" from "," to ("," layerAggOp)? "]" | "[" organ "]")?
+ *   name    := an output name, quoted with '...' if it contains other characters than letters, digits and _
+ *
+ * E.g. "Yield / (Act_ET + 1)", "Mois[1, 3, AVG] < 0.2 && Stage >= 3", "if(LAI > 0, NLeach / LAI, 0)".
+ * Layer numbers start at 1 and a layer range without aggregation operation is averaged.
+ * Comparisons and logical operators yield 1 or 0, a value is true if it is not 0 and not NaN.
+ * Referenced outputs which aren't a single number (e.g. strings or missing layers) yield NaN.
+ */
+class DLL_API Expression {
+public:
+  //! compile text (without a leading =) into an expression
+  static Tools::EResult<std::shared_ptr<const Expression>> compile(const std::string& text);
+
+  double value(const MonicaModel& monica) const;
+
+  //! value with the referenced outputs given in the order of references() (missing ones are NaN)
+  double value(const std::vector<double>& refValues) const;
+
+  bool isTrue(const MonicaModel& monica) const { return isTrue(value(monica)); }
+
+  static bool isTrue(double v) { return v == v && v != 0.0; }
+
+  const std::string& text() const { return _text; }
+
+  //! output ids the expression depends on
+  const std::vector<OId>& references() const { return _refs; }
+
+  enum OpCode : uint8_t {
+    CONST, LOAD, NEG, NOT,
+    ADD, SUB, MUL, DIV, POW,
+    LT, LE, GT, GE, EQ, NE, AND, OR,
+    MIN, MAX, ABS, SQRT, EXP, LOG, IF
+  };
+
+  struct Instr {
+    OpCode op;
+    uint16_t arg{0}; //!< index into the reference table for LOAD, number of arguments for MIN/MAX
+    double value{0}; //!< constant for CONST
+  };
+
+private:
+  friend class ExpressionCompiler;
+
+  template<typename Load>
+  double evaluate(Load load) const;
+
+  std::string _text;
+  std::vector<Instr> _code;
+  std::vector<OId> _refs;
+  size_t _maxStackSize{0};
+};
+
+} // namespace monica
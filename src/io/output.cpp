@@ -18,6 +18,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <fstream>
 #include <algorithm>
 #include <mutex>
+#include <functional>
 
 #include "json11/json11-helper.h"
 #include "tools/debug.h"
@@ -212,3 +213,146 @@ json11::Json Output::to_json() const
   ,{"warnings", toPrimJsonArray(warnings)}
   };
 }
+
+namespace
+{
+  //! writes the JSON of an Output the same way json11 dumps the tree of Output::to_json()
+  //! (objects with sorted keys, ", " and ": " separators), the leaf values are dumped by json11 itself
+  class OutputJsonWriter
+  {
+  public:
+    //! flush is called with the buffer whenever it grew beyond flushAt, it has to empty the buffer
+    OutputJsonWriter(string& buf, function<void(string&)> flush = function<void(string&)>(), size_t flushAt = 1 << 16)
+      : _buf(buf), _flush(flush), _flushAt(flushAt) {}
+
+    void write(const Output& o)
+    {
+      // keys in the (sorted) order of the json11 object
+      _buf += "{";
+      key("customId", true);
+      o.customId.dump(_buf);
+      key("data");
+      _buf += "[";
+      for(size_t i = 0; i < o.data.size(); i++)
+      {
+        if(i > 0) _buf += ", ";
+        write(o.data[i]);
+      }
+      _buf += "]";
+      key("errors");
+      write(o.errors);
+      key("type");
+      Json("Output").dump(_buf);
+      key("warnings");
+      write(o.warnings);
+      _buf += "}";
+      maybeFlush();
+    }
+
+  private:
+    void key(const string& k, bool first = false)
+    {
+      if(!first) _buf += ", ";
+      Json(k).dump(_buf);
+      _buf += ": ";
+    }
+
+    void maybeFlush()
+    {
+      if(_flush && _buf.size() >= _flushAt) _flush(_buf);
+    }
+
+    void write(const vector<string>& ss)
+    {
+      _buf += "[";
+      for(size_t i = 0; i < ss.size(); i++)
+      {
+        if(i > 0) _buf += ", ";
+        Json(ss[i]).dump(_buf);
+      }
+      _buf += "]";
+    }
+
+    void write(const Output::Data& d)
+    {
+      _buf += "{";
+      key("origSpec", true);
+      Json(d.origSpec).dump(_buf);
+      key("outputIds");
+      _buf += "[";
+      for(size_t i = 0; i < d.outputIds.size(); i++)
+      {
+        if(i > 0) _buf += ", ";
+        d.outputIds[i].to_json().dump(_buf);
+      }
+      _buf += "]";
+      key("results");
+      _buf += "[";
+      bool first = true;
+      if(!d.results.empty())
+      {
+        for(const auto& r : d.results)
+        {
+          if(!first) _buf += ", ";
+          first = false;
+          _buf += "[";
+          for(size_t i = 0; i < r.size(); i++)
+          {
+            if(i > 0) _buf += ", ";
+            r[i].dump(_buf);
+            maybeFlush();
+          }
+          _buf += "]";
+        }
+      }
+      else
+      {
+        for(const auto& o : d.resultsObj)
+        {
+          if(!first) _buf += ", ";
+          first = false;
+          _buf += "{";
+          bool firstKey = true;
+          for(const auto& p : o)
+          {
+            key(p.first, firstKey);
+            firstKey = false;
+            p.second.dump(_buf);
+          }
+          _buf += "}";
+          maybeFlush();
+        }
+      }
+      _buf += "]}";
+    }
+
+    string& _buf;
+    function<void(string&)> _flush;
+    size_t _flushAt{1 << 16};
+  };
+}
+
+std::string Output::toString() const
+{
+  string s;
+  writeJson(s);
+  return s;
+}
+
+void Output::writeJson(std::string& into) const
+{
+  OutputJsonWriter(into).write(*this);
+}
+
+void Output::writeJson(std::ostream& out) const
+{
+  string buf;
+  auto flush = [&out](string& b)
+  {
+    out.write(b.data(), streamsize(b.size()));
+    b.clear();
+  };
+  buf.reserve(1 << 16);
+  OutputJsonWriter(buf, flush).write(*this);
+  flush(buf);
+}
@@ -17,6 +17,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #pragma once
 
+#include <memory>
+#include <ostream>
 #include <string>
 
 #include "json11/json11.hpp"
@@ -27,6 +29,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "tools/date.h"
 
 namespace monica {
+  class Expression;
+
   struct DLL_API OId : public Tools::Json11Serializable {
     enum OP { AVG, MEDIAN, SUM, MIN, MAX, FIRST, LAST, NONE, _UNDEFINED_OP_ };
 
@@ -90,6 +94,7 @@ namespace monica {
     OP timeAggOp{AVG}; //! aggregate values in a second time range (e.g. monthly)
     ORGAN organ{_UNDEFINED_ORGAN_};
     int fromLayer{-1}, toLayer{-1};
+    std::shared_ptr<const Expression> expression; //! just for derived outputs ("=..." output ids)
   };
 
   //---------------------------------------------------------------------------
@@ -105,6 +110,15 @@ namespace monica {
     virtual Tools::Errors merge(json11::Json j);
 
     virtual json11::Json to_json() const;
+
+    //! JSON text of the output, byte identical to to_json().dump(), but without building the json11 tree first
+    std::string toString() const override;
+
+    //! append the JSON text to into
+    void writeJson(std::string& into) const;
+
+    //! write the JSON text to out incrementally in chunks
+    void writeJson(std::ostream& out) const;
     
     //std::string customId;
     json11::Json customId;
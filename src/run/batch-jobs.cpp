@@ -0,0 +1,160 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "batch-jobs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <tuple>
+
+#include "json11/json11.hpp"
+#include "tools/helper.h"
+
+using namespace monica;
+using namespace Tools;
+using namespace std;
+using namespace json11;
+
+bool monica::matchesWildcard(const string& name, const string& pattern) {
+  size_t n = 0, p = 0, starP = string::npos, starN = 0;
+  while (n < name.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) n++, p++;
+    else if (p < pattern.size() && pattern[p] == '*') starP = p++, starN = n;
+    else if (starP != string::npos) p = starP + 1, n = ++starN;
+    else return false;
+  }
+  while (p < pattern.size() && pattern[p] == '*') p++;
+  return p == pattern.size();
+}
+
+namespace {
+
+string fileStem(const string& path) { return filesystem::path(path).stem().string(); }
+
+} // namespace
+
+EResult<vector<BatchJob>> monica::readBatchJobs(const string& batch, const RunOptions& defaultOpts) {
+  EResult<vector<BatchJob>> res;
+  string dir, fileName;
+  tie(dir, fileName) = splitPathToFile(batch);
+
+  auto ext = filesystem::path(batch).extension().string();
+  if (ext == ".jsonl" || ext == ".ndjson") {
+    ifstream in(batch);
+    if (in.fail()) {
+      res.errors.push_back(string("Error: couldn't open batch file ") + batch);
+      return res;
+    }
+
+    string line;
+    for (size_t lineNo = 1; getline(in, line); lineNo++) {
+      if (line.find_first_not_of(" \t\r") == string::npos) continue;
+      string err;
+      auto j = Json::parse(line, err);
+      if (!err.empty()) {
+        res.errors.push_back(batch + ":" + to_string(lineNo) + ": " + err);
+        continue;
+      }
+
+      BatchJob job{j.is_string() ? j.string_value() : j["sim"].string_value(), defaultOpts};
+      if (j.is_object()) {
+        auto set = [&](const char* key, string& opt) { if (j[key].is_string()) opt = j[key].string_value(); };
+        set("run-id", job.opts.runId);
+        set("crop", job.opts.crop);
+        set("site", job.opts.site);
+        set("climate", job.opts.climate);
+        set("start-date", job.opts.startDate);
+        set("end-date", job.opts.endDate);
+        set("output-file", job.opts.pathToOutputFile);
+        set("output-dir", job.opts.pathToOutput);
+      }
+      if (job.pathToSimJson.empty()) {
+        res.errors.push_back(batch + ":" + to_string(lineNo) + ": missing path to sim.json");
+        continue;
+      }
+      if (!isAbsolutePath(job.pathToSimJson)) job.pathToSimJson = dir + job.pathToSimJson;
+      if (!j["output-file"].is_string()) {
+        job.opts.batchJobName = j["run-id"].is_string() ? job.opts.runId : fileStem(job.pathToSimJson);
+      }
+      res.result.push_back(job);
+    }
+  } else {
+    error_code ec;
+    for (const auto& entry : filesystem::directory_iterator(dir.empty() ? "." : dir, ec)) {
+      auto name = entry.path().filename().string();
+      if (entry.is_regular_file() && matchesWildcard(name, fileName)) {
+        BatchJob job{dir + name, defaultOpts};
+        job.opts.batchJobName = fileStem(name);
+        res.result.push_back(job);
+      }
+    }
+    if (ec) res.errors.push_back(string("Error: couldn't list directory of batch glob ") + batch + ": " + ec.message());
+    sort(res.result.begin(), res.result.end(),
+         [](const BatchJob& l, const BatchJob& r) { return l.pathToSimJson < r.pathToSimJson; });
+  }
+  return res;
+}
+
+string monica::withNameSuffix(const string& pathToFile, const string& suffix) {
+  string s = suffix;
+  for (auto& c : s) if (string("/\\:*?\"<>|").find(c) != string::npos) c = '_';
+
+  auto sep = pathToFile.find_last_of("/\\");
+  auto dot = pathToFile.find_last_of('.');
+  if (dot == string::npos || (sep != string::npos && dot < sep) || dot == (sep == string::npos ? 0 : sep + 1)) {
+    return pathToFile + "-" + s;
+  }
+  return pathToFile.substr(0, dot) + "-" + s + pathToFile.substr(dot);
+}
+
+size_t monica::runBatchJobs(const vector<BatchJob>& jobs, size_t noOfThreads,
+                            const function<int(const BatchJob&)>& runJob) {
+  if (jobs.empty()) return 0;
+
+  atomic<size_t> nextJob{0};
+  atomic<size_t> noOfFailedJobs{0};
+  auto work = [&]() {
+    for (size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+      const auto& job = jobs[i];
+      int exitCode = 1;
+      try {
+        exitCode = runJob(job);
+      } catch (const exception& e) {
+        cerr << "Error: job " << job.pathToSimJson << " threw exception: " << e.what() << endl;
+      } catch (...) {
+        cerr << "Error: job " << job.pathToSimJson << " threw an unknown exception" << endl;
+      }
+      if (exitCode != 0) {
+        noOfFailedJobs++;
+        cerr << "Error: job " << (i + 1) << " (" << job.pathToSimJson << ") failed" << endl;
+      }
+    }
+  };
+
+  noOfThreads = min(noOfThreads > 0 ? noOfThreads : max(size_t(1), size_t(thread::hardware_concurrency())),
+                    jobs.size());
+  vector<thread> threads;
+  threads.reserve(noOfThreads - 1);
+  for (size_t t = 1; t < noOfThreads; t++) threads.emplace_back(work);
+  work();
+  for (auto& t : threads) t.join();
+
+  return noOfFailedJobs;
+}
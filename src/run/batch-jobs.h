@@ -0,0 +1,67 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "json11/json11-helper.h"
+
+namespace monica {
+
+//! the command line options of a monica-run job, in batch mode a job may override some of them
+struct RunOptions {
+  bool debug = false, debugSet = false;
+  std::string startDate, endDate;
+  std::string pathToOutput;
+  std::string pathToOutputFile, pathToOutputFile2;
+  bool writeMultipleOutputFiles = false;
+  std::string outputFormat;
+  std::string runId;
+  std::string crop, site, climate;
+  std::string icReaderSr, icWriterSr;
+  //! in batch mode the name of the job, appended to the output file names, which the jobs share otherwise
+  //! (empty if the job has its own output file)
+  std::string batchJobName;
+};
+
+struct BatchJob {
+  std::string pathToSimJson;
+  RunOptions opts;
+};
+
+//! simple wildcard matching (* and ?) as used for the file name part of a batch glob
+bool matchesWildcard(const std::string& name, const std::string& pattern);
+
+//! read the jobs of a batch, either from a JSON lines file, one job per line, as path to a sim.json
+//! or as object {"sim", "run-id", "crop", "site", "climate", "start-date", "end-date", "output-file", "output-dir"}
+//! (relative paths of sim.json are relative to the JSON lines file),
+//! or from the sim.json files matching a glob in the file name (e.g. sims/sim-*.json),
+//! lines which can't be parsed are reported as errors and skipped
+Tools::EResult<std::vector<BatchJob>> readBatchJobs(const std::string& batch, const RunOptions& defaultOpts);
+
+//! insert -suffix in front of the extension of the file name of pathToFile (characters not allowed in file
+//! names are replaced by _), e.g. out/sim.csv -> out/sim-suffix.csv
+std::string withNameSuffix(const std::string& pathToFile, const std::string& suffix);
+
+//! run the jobs on noOfThreads threads (0 = number of hardware threads), a job failing (exit code != 0)
+//! or throwing is reported, but doesn't stop the others
+//! @return the number of failed jobs
+size_t runBatchJobs(const std::vector<BatchJob>& jobs, size_t noOfThreads,
+                    const std::function<int(const BatchJob&)>& runJob);
+
+} // namespace monica
@@ -15,6 +15,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include "capnp-helper.h"
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 #include <kj/common.h>
@@ -227,3 +229,98 @@ kj::Promise<J11Array> monica::fromCapnpSoilProfile(mas::schema::soil::Profile::C
     return J11Array();
   });
 }
+
+namespace {
+
+void setColumn(const Output::Data& d, size_t col, schema::Output::Column::Builder cb) {
+  const auto& oid = d.outputIds.at(col);
+  auto name = oid.outputName();
+  auto rows = d.results.empty() ? d.resultsObj.size() : d.results.at(col).size();
+  static const Json null;
+  auto cell = [&](size_t row) -> const Json& {
+    if (!d.results.empty()) return d.results[col][row];
+    const auto& o = d.resultsObj[row];
+    auto it = o.find(name);
+    return it == o.end() ? null : it->second;
+  };
+
+  cb.setName(oid.displayName.empty() ? name.c_str() : oid.displayName.c_str());
+  cb.setOid(oid.toString(true).c_str());
+  cb.setUnit(oid.unit.c_str());
+
+  //the first non null value decides the type of the column, the longest array the size of a layer column
+  auto type = Json::NUL;
+  size_t listSize = 0;
+  bool hasNulls = false;
+  for (size_t r = 0; r < rows; r++) {
+    const auto& j = cell(r);
+    if (j.is_null()) hasNulls = true;
+    else if (type == Json::NUL) type = j.type();
+    if (j.is_array()) listSize = std::max(listSize, j.array_items().size());
+  }
+
+  if (hasNulls) {
+    auto valid = cb.initValid(rows);
+    for (size_t r = 0; r < rows; r++) valid.set(r, !cell(r).is_null());
+  }
+
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  auto vsb = cb.initValues();
+  switch (type) {
+    case Json::NUL: vsb.setNone(); break;
+    case Json::BOOL: {
+      auto vs = vsb.initBool(rows);
+      for (size_t r = 0; r < rows; r++) vs.set(r, cell(r).bool_value());
+      break;
+    }
+    case Json::STRING: {
+      auto vs = vsb.initText(rows);
+      for (size_t r = 0; r < rows; r++) vs.set(r, cell(r).string_value().c_str());
+      break;
+    }
+    case Json::ARRAY: {
+      auto lb = vsb.initLayers();
+      lb.setListSize(uint16_t(listSize));
+      auto vs = lb.initData(rows * listSize);
+      for (size_t r = 0; r < rows; r++) {
+        const auto& items = cell(r).array_items();
+        for (size_t i = 0; i < listSize; i++) {
+          vs.set(r * listSize + i, i < items.size() && items[i].is_number() ? items[i].number_value() : nan);
+        }
+      }
+      break;
+    }
+    default: {
+      auto vs = vsb.initFloat64(rows);
+      for (size_t r = 0; r < rows; r++) {
+        const auto& j = cell(r);
+        vs.set(r, j.is_number() ? j.number_value() : nan);
+      }
+    }
+  }
+}
+
+} // namespace
+
+void monica::toCapnpOutput(const Output& output, schema::Output::Builder builder) {
+  builder.setCustomId(output.customId.dump().c_str());
+
+  auto errs = builder.initErrors(output.errors.size());
+  for (size_t i = 0; i < output.errors.size(); i++) errs.set(i, output.errors[i].c_str());
+  auto warns = builder.initWarnings(output.warnings.size());
+  for (size_t i = 0; i < output.warnings.size(); i++) warns.set(i, output.warnings[i].c_str());
+
+  auto sections = builder.initSections(output.data.size());
+  for (size_t si = 0; si < output.data.size(); si++) {
+    const auto& d = output.data[si];
+    auto sb = sections[si];
+    sb.setOrigSpec(d.origSpec.c_str());
+    auto cols = sb.initColumns(d.outputIds.size());
+    size_t rows = 0;
+    for (size_t c = 0; c < d.outputIds.size(); c++) {
+      setColumn(d, c, cols[c]);
+      rows = std::max(rows, size_t(d.results.empty() ? d.resultsObj.size() : d.results.at(c).size()));
+    }
+    sb.setRows(uint32_t(rows));
+  }
+}
@@ -22,6 +22,9 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "soil.capnp.h"
 #include "climate.capnp.h"
 #include "monica_management.capnp.h"
+#include "monica-output.capnp.h"
+
+#include "../io/output.h"
 
 namespace monica {
 
@@ -44,4 +47,7 @@ kj::Promise<Climate::DataAccessor> dataAccessorFromTimeSeries(mas::schema::clima
 
 kj::Promise<Tools::J11Array> fromCapnpSoilProfile(mas::schema::soil::Profile::Client profile);
 
+//! copy the output into the typed capnp result structure (see monica-output.capnp), column by column
+void toCapnpOutput(const Output& output, schema::Output::Builder builder);
+
 }
@@ -14,7 +14,9 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 */
 
 #include <iostream>
+#include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <set>
 
@@ -36,8 +38,34 @@ using namespace Climate;
 
 const map<string, function<EResult<Json>(const Json&, const Json&)>>& supportedPatterns();
 
+namespace {
+  //! resolved ["ref", key1, key2] references of the root currently being processed,
+  //! per thread, as e.g. the jobs of a monica-run batch create their envs in parallel
+  thread_local map<pair<string, string>, EResult<Json>> refCache;
+
+  //! parsed include files shared by all envs created in the process, keyed by path and modification time
+  mutex includeFilesMutex;
+  map<pair<string, filesystem::file_time_type>, EResult<Json>> includeFiles;
+
+  EResult<Json> readAndParseIncludeFile(const string& pathToFile) {
+    error_code ec;
+    auto key = make_pair(pathToFile, filesystem::last_write_time(pathToFile, ec));
+    if (ec) return readAndParseJsonFile(pathToFile);
+
+    {
+      lock_guard<mutex> lock(includeFilesMutex);
+      auto it = includeFiles.find(key);
+      if (it != includeFiles.end()) return it->second;
+    }
+    auto res = readAndParseJsonFile(pathToFile);
+    lock_guard<mutex> lock(includeFilesMutex);
+    includeFiles[key] = res;
+    return res;
+  }
+}
+
 EResult<Json> monica::findAndReplaceReferences(const Json& root, const Json& j) {
-  auto sp = supportedPatterns();
+  const auto& sp = supportedPatterns();
 
   //auto jstr = j.dump();
   bool success = true;
@@ -105,18 +133,17 @@ EResult<Json> monica::findAndReplaceReferences(const Json& root, const Json& j)
 
 const map<string, function<EResult<Json>(const Json&, const Json&)>>& supportedPatterns() {
   auto ref = [](const Json& root, const Json& j) -> EResult<Json> {
-    static map<pair<string, string>, EResult<Json>> cache;
     if(j.array_items().size() == 3
        && j[1].is_string()
        && j[2].is_string()) {
       string key1 = j[1].string_value();
       string key2 = j[2].string_value();
 
-      auto it = cache.find(make_pair(key1, key2));
-      if(it != cache.end()) return it->second;
+      auto it = refCache.find(make_pair(key1, key2));
+      if(it != refCache.end()) return it->second;
       
       auto res = findAndReplaceReferences(root, root[key1][key2]);
-      cache[make_pair(key1, key2)] = res;
+      refCache[make_pair(key1, key2)] = res;
       return res;
     }
     return{j, string("Couldn't resolve reference: ") + j.dump() + "!"};
@@ -278,7 +305,7 @@ const map<string, function<EResult<Json>(const Json&, const Json&)>>& supportedP
       if(!isAbsolutePath(pathToFile)) pathToFile = basePath + "/" + pathToFile;
       pathToFile = replaceEnvVars(pathToFile);
       pathToFile = fixSystemSeparator(pathToFile);
-      auto jo = readAndParseJsonFile(pathToFile);
+      auto jo = readAndParseIncludeFile(pathToFile);
       if(jo.success() && !jo.result.is_null()) return{jo.result};
       
       return{j, string("Couldn't include file with path: '") + pathToFile + "'!"};
@@ -394,6 +421,8 @@ Json monica::createEnvJsonFromJsonObjects(std::map<std::string, json11::Json> pa
   set<string> errors;
   for (auto& j : cropSiteSim) {
     addBasePath(j, pathToParameters);
+    // the references are keyed just by name, so they are only valid within one root
+    refCache.clear();
     auto r = findAndReplaceReferences(j, j);
     if (r.success()) cropSiteSim2.push_back(r.result);
     else errors.insert(r.errors.begin(), r.errors.end());
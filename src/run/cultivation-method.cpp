@@ -31,6 +31,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "model/monica/monica_state.capnp.h"
 #include "tools/algorithms.h"
 #include "../core/monica-model.h"
+#include "../io/expression.h"
 #include "tools/debug.h"
 #include "soil/conversion.h"
 #include "../io/build-output.h"
@@ -95,6 +96,40 @@ string organNameFromId(int organId) {
   return res;
 };
 
+DailyValuesWindow::DailyValuesWindow(size_t windowSize)
+    : _values(windowSize, 0.0) {}
+
+void DailyValuesWindow::push(double value) {
+  auto ws = _values.size();
+  //a window of 0 days holds no values (like the former function averaging over the last 0 days, it never has data)
+  if (ws == 0) return;
+  double dropped = _size == ws ? _values[_next] : 0.0;
+  _values[_next] = value;
+  _next = (_next + 1) % ws;
+  _size = std::min(_size + 1, ws);
+  _noOfPushes++;
+  //sum up anew once per round to not accumulate rounding errors
+  if (_next == 0) _sum = accumulate(_values.begin(), _values.end(), 0.0);
+  else _sum += value - dropped;
+
+  //the values pushed before firstInWindow are out of the window
+  size_t firstInWindow = _noOfPushes - _size;
+  while (!_mins.empty() && _mins.back().second >= value) _mins.pop_back();
+  _mins.emplace_back(_noOfPushes - 1, value);
+  while (_mins.front().first < firstInWindow) _mins.pop_front();
+  while (!_maxs.empty() && _maxs.back().second <= value) _maxs.pop_back();
+  _maxs.emplace_back(_noOfPushes - 1, value);
+  while (_maxs.front().first < firstInWindow) _maxs.pop_front();
+}
+
+void DailyValuesWindow::clear() {
+  fill(_values.begin(), _values.end(), 0.0);
+  _next = _size = _noOfPushes = 0;
+  _sum = 0.0;
+  _mins.clear();
+  _maxs.clear();
+}
+
 Workstep::Workstep(const Tools::Date &d)
     : _date(d) {}
 
@@ -299,12 +334,12 @@ bool isSoilMoistureOk(MonicaModel *model,
   return soilMoistureOk;
 }
 
-bool isPrecipitationOk(const std::vector<std::map<Climate::ACD, double>> &climateData,
+bool isPrecipitationOk(const std::pmr::vector<MonicaModel::StepClimateData> &climateData,
                        double max3dayPrecipSum,
                        double maxCurrentDayPrecipSum) {
   bool precipOk = false;
   double psum3d = accumulate(climateData.rbegin(), climateData.rbegin() + 3, 0.0,
-                             [](double acc, const map<ACD, double> &d) {
+                             [](double acc, const MonicaModel::StepClimateData &d) {
                                auto it = d.find(Climate::precip);
                                return acc + (it == d.end() ? 0 : it->second);
                              });
@@ -314,20 +349,12 @@ bool isPrecipitationOk(const std::vector<std::map<Climate::ACD, double>> &climat
   return precipOk;
 }
 
-bool isSoilTemperatureOk(
-    const std::vector<double> &soilTemps,
-    int windowDays,
-    double targetAvgSoilTemp) {
-  if (soilTemps.empty())
+bool isSoilTemperatureOk(const DailyValuesWindow *soilTemps, double targetAvgSoilTemp) {
+  //the window holds just the requested number of days
+  if (!soilTemps || soilTemps->empty())
     return false;
 
-  double sum = 0;
-  auto size = soilTemps.size();
-  for (int i = int(size - 1); i >= 0 && i >= size - windowDays; i--)
-    sum += soilTemps[i];
-  double avg = sum / (size > windowDays ? windowDays : size);
-  //cout << "avg: " << avg << endl;
-  return avg >= targetAvgSoilTemp;
+  return soilTemps->mean() >= targetAvgSoilTemp;
 }
 
 
@@ -346,11 +373,11 @@ bool AutomaticSowing::apply(MonicaModel *model) {
 }
 
 std::function<double(MonicaModel *)>
-AutomaticSowing::registerDailyFunction(std::function<std::vector<double> &()> getDailyValues) {
+AutomaticSowing::registerDailyFunction(std::function<DailyValuesWindow &(size_t windowSize)> createDailyValues) {
   if (!_checkForSoilTemperature)
     return std::function<double(MonicaModel *)>();
 
-  _getAvgSoilTemps = getDailyValues;
+  _avgSoilTemps = &createDailyValues(size_t(_daysInSoilTempWindow));
   return [this](MonicaModel *model) -> double {
     double avgSoilTemp = 0;
     size_t i = 0;
@@ -377,7 +404,7 @@ bool AutomaticSowing::condition(MonicaModel *model) {
 
   // check soil temperature if requested
   if (_checkForSoilTemperature) {
-    if (!isSoilTemperatureOk(_getAvgSoilTemps(), _daysInSoilTempWindow, _sowingIfAboveAvgSoilTemp))
+    if (!isSoilTemperatureOk(_avgSoilTemps, _sowingIfAboveAvgSoilTemp))
       return false;
   }
 
@@ -386,7 +413,7 @@ bool AutomaticSowing::condition(MonicaModel *model) {
 
   auto avg = [&](Climate::ACD acd) {
     return accumulate(cd.rbegin(), cd.rbegin() + std::min(int(cd.size()), _daysInTempWindow),
-                      0.0, [acd](double acc, const map<ACD, double> &d) {
+                      0.0, [acd](double acc, const MonicaModel::StepClimateData &d) {
                         auto it = d.find(acd);
                         return acc + (it == d.end() ? 0 : it->second);
                       }) / min(int(cd.size()), _daysInTempWindow);
@@ -418,7 +445,7 @@ bool AutomaticSowing::condition(MonicaModel *model) {
   //check temperature sum
   double baseTemp = _baseTemp;
   double tempSum = accumulate(cd.begin(), cd.end(), 0.0,
-                              [baseTemp](double acc, const map<ACD, double> &d) {
+                              [baseTemp](double acc, const MonicaModel::StepClimateData &d) {
                                 auto it = d.find(Climate::tavg);
                                 return acc + (it == d.end() ? 0 : max(0.0, it->second - baseTemp));
                               });
@@ -833,7 +860,7 @@ OrganicFertilization(const Tools::Date &at,
                      const OrganicMatterParameters &params,
                      double amount,
                      bool incorp)
-    : Workstep(at), _params(params), _amount(amount), _incorporation(incorp) {}
+    : Workstep(at), _params(make_shared<OrganicMatterParameters>(params)), _amount(amount), _incorporation(incorp) {}
 
 OrganicFertilization::OrganicFertilization(json11::Json j) {
   _errors.append(OrganicFertilization::merge(kj::mv(j)));
@@ -841,7 +868,8 @@ OrganicFertilization::OrganicFertilization(json11::Json j) {
 
 Errors OrganicFertilization::merge(json11::Json j) {
   Errors res = Workstep::merge(j);
-  _params.merge(j["parameters"]);
+  if (j["parameters"].is_object())
+    _params = ParameterStore<OrganicMatterParameters>::instance().merge(_params, j["parameters"]);
   set_double_value(_amount, j, "amount");
   set_bool_value(_incorporation, j, "incorporation");
   return res;
@@ -852,7 +880,7 @@ json11::Json OrganicFertilization::to_json() const {
       {"type",          type()},
       {"date",          date().toIsoDateString()},
       {"amount",        _amount},
-      {"parameters",    _params.to_json()},
+      {"parameters",    _params->to_json()},
       {"incorporation", _incorporation}};
 }
 
@@ -860,7 +888,7 @@ bool OrganicFertilization::apply(MonicaModel *model) {
   Workstep::apply(model);
 
   debug() << toString() << endl;
-  model->applyOrganicFertiliser(_params, _amount, _incorporation);
+  model->applyOrganicFertiliser(*_params, _amount, _incorporation);
   model->addEvent("OrganicFertilization");
 
   return true;
@@ -929,15 +957,21 @@ Errors SetValue::merge(json11::Json j) {
         auto oids = parseOutputIds({_value});
         if (!oids.empty()) {
           auto oid = oids[0];
-          const auto &ofs = buildOutputTable().ofs;
-          auto ofi = ofs.find(oid.id);
-          if (ofi != ofs.end()) {
-            auto f = ofi->second;
+          if (auto of = buildOutputTable().outputFunc(oid.id)) {
+            auto f = *of;
             _getValue = [=](const MonicaModel *mm) { return f(*mm, oid); };
           }
         }
       }
     }
+  } else if (_value.is_string() && _value.string_value().substr(0, 1) == "=") {
+    auto er = Expression::compile(_value.string_value().substr(1));
+    if (er.success()) {
+      auto e = er.result;
+      _getValue = [=](const MonicaModel *mm) { return json11::Json(e->value(*mm)); };
+    } else {
+      for (const auto &err: er.errors) res.append(Errors(Errors::ERR, err));
+    }
   } else
     _getValue = [=](const MonicaModel *) { return _value; };
 
@@ -959,11 +993,9 @@ bool SetValue::apply(MonicaModel *model) {
   if (!_getValue)
     return true;
 
-  const auto &setfs = buildOutputTable().setfs;
-  auto ci = setfs.find(_oid.id);
-  if (ci != setfs.end()) {
+  if (auto setf = buildOutputTable().setFunc(_oid.id)) {
     auto v = _getValue(model);
-    ci->second(*model, _oid, v);
+    (*setf)(*model, _oid, v);
   }
 
   model->addEvent("SetValue");
@@ -1224,15 +1256,28 @@ void CultivationMethod::apply(const Date &date,
 
 void CultivationMethod::absApply(const Date &date,
                                  MonicaModel *model) const {
-  for (auto ws: absWorkstepsAt(date)) ws->apply(model);
+  auto p = _absDate2worksteps.equal_range(date);
+  for (auto it = p.first; it != p.second; ++it) it->second->apply(model);
 }
 
 void CultivationMethod::apply(MonicaModel *model, bool runOnlyAtStartOfDayWorksteps) {
   auto &udws = _unfinishedDynamicWorksteps;
+
+  //dynamic worksteps with an earliest date (e.g. automatic sowing) join the daily checked ones
+  //when their window opens, but keep their position in the cultivation method
+  auto currentDate = model->currentStepDate();
+  auto &wdws = _waitingDynamicWorksteps;
+  while (!wdws.empty() && !(currentDate < wdws.begin()->first)) {
+    const auto &ows = wdws.begin()->second;
+    udws.insert(upper_bound(udws.begin(), udws.end(), ows,
+                            [](const OrderedWS &l, const OrderedWS &r) { return l.first < r.first; }), ows);
+    wdws.erase(wdws.begin());
+  }
+
   udws.erase(remove_if(udws.begin(), udws.end(),
-                       [model, runOnlyAtStartOfDayWorksteps](WSPtr wsp) {
-                         return runOnlyAtStartOfDayWorksteps == wsp->runAtStartOfDay() &&
-                                wsp->applyWithPossibleCondition(model);
+                       [model, runOnlyAtStartOfDayWorksteps](const OrderedWS &ows) {
+                         return runOnlyAtStartOfDayWorksteps == ows.second->runAtStartOfDay() &&
+                                ows.second->applyWithPossibleCondition(model);
                        }), udws.end());
 }
 
@@ -1248,14 +1293,8 @@ Date CultivationMethod::nextDate(const Date &date) const {
 }
 
 Date CultivationMethod::nextAbsDate(const Date &date) const {
-  //auto ci = _allAbsWorksteps.upper_bound(date);
-  //return ci != _allAbsWorksteps.end() ? ci->first : Date();
-  for (auto ws: _allAbsWorksteps) {
-    auto ad = ws->absDate();
-    if (ad.isValid() && ad > date)
-      return ad;
-  }
-  return Date();
+  auto ci = _absDate2worksteps.upper_bound(date);
+  return ci != _absDate2worksteps.end() ? ci->first : Date();
 }
 
 
@@ -1276,15 +1315,10 @@ vector<WSPtr> CultivationMethod::workstepsAt(const Date &date) const {
 
 vector<WSPtr> CultivationMethod::absWorkstepsAt(const Date &date) const {
   vector<WSPtr> apps;
-  //auto p = _allAbsWorksteps.equal_range(date);
-  //while(p.first != p.second)
-  //{
-  //	apps.push_back(p.first->second);
-  //	p.first++;
-  //}
-  for (auto ws: _allAbsWorksteps)
-    if (ws->absDate().isValid() && ws->absDate() == date)
-      apps.push_back(ws);
+  if (!date.isValid()) return apps;
+
+  auto p = _absDate2worksteps.equal_range(date);
+  for (auto it = p.first; it != p.second; ++it) apps.push_back(it->second);
 
   return apps;
 }
@@ -1312,14 +1346,23 @@ vector<WSPtr> CultivationMethod::allDynamicWorksteps() const {
   return workstepsAt(Date());
 }
 
+vector<WSPtr> CultivationMethod::unfinishedDynamicWorksteps() const {
+  vector<OrderedWS> owss(_unfinishedDynamicWorksteps);
+  for (const auto &p: _waitingDynamicWorksteps) owss.push_back(p.second);
+  sort(owss.begin(), owss.end(), [](const OrderedWS &l, const OrderedWS &r) { return l.first < r.first; });
+
+  vector<WSPtr> wss;
+  for (const auto &ows: owss) wss.push_back(ows.second);
+  return wss;
+}
+
 bool CultivationMethod::allDynamicWorkstepsFinished() const {
-  if (_unfinishedDynamicWorksteps.empty()) return true;
-  else {
-    return all_of(_unfinishedDynamicWorksteps.begin(), _unfinishedDynamicWorksteps.end(),
-                  [](const WSPtr &wsp) {
-                    return wsp->type() == "NDemandFertilization";
-                  });
-  }
+  auto isNDemandFertilization = [](const OrderedWS &ows) {
+    return ows.second->type() == "NDemandFertilization";
+  };
+  return all_of(_unfinishedDynamicWorksteps.begin(), _unfinishedDynamicWorksteps.end(), isNDemandFertilization)
+         && all_of(_waitingDynamicWorksteps.begin(), _waitingDynamicWorksteps.end(),
+                   [&](const pair<const Date, OrderedWS> &p) { return isNDemandFertilization(p.second); });
 }
 
 Date CultivationMethod::startDate() const {
@@ -1506,17 +1549,23 @@ std::string CultivationMethod::toString() const {
 
 bool CultivationMethod::reinit(Tools::Date date, bool forceInitYear) {
   _allAbsWorksteps.clear();
+  _absDate2worksteps.clear();
   _unfinishedDynamicWorksteps.clear();
+  _waitingDynamicWorksteps.clear();
   bool addedYear = false;
-  //for(auto p : _allWorksteps)
+  size_t i = 0;
   for (auto ws: _allWorksteps) {
-    //auto ws = p.second;
     addedYear = ws->reinit(date, addedYear, forceInitYear) || addedYear;
-    //_allAbsWorksteps.insert(make_pair(ws->absDate(), p.second));
     _allAbsWorksteps.push_back(ws);
-    if (!ws->absDate().isValid())
-      //_unfinishedDynamicWorksteps.push_back(p.second);
-      _unfinishedDynamicWorksteps.push_back(ws);
+    auto ad = ws->absDate();
+    if (ad.isValid()) _absDate2worksteps.insert(make_pair(ad, ws));
+    else {
+      //a dynamic workstep can't apply before its earliest date (if it has one), so don't check it daily until then
+      auto aed = ws->absEarliestDate();
+      if (aed.isValid()) _waitingDynamicWorksteps.insert(make_pair(aed, make_pair(i, ws)));
+      else _unfinishedDynamicWorksteps.push_back(make_pair(i, ws));
+    }
+    i++;
   }
 
   return addedYear;
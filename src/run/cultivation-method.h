@@ -17,6 +17,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #pragma once
 
+#include <deque>
 #include <map>
 #include <string>
 #include <vector>
@@ -34,12 +35,44 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "soil/soil.h"
 #include "../core/monica-parameters.h"
 #include "../core/crop.h"
+#include "../core/parameter-store.h"
 #include "../io/output.h"
 
 namespace monica {
 
 class MonicaModel;
 
+//! the values of a daily function over the last windowSize days,
+//! with the aggregates being updated in constant (amortized) time per day
+//! (a window of 0 days stays empty)
+class DLL_API DailyValuesWindow {
+public:
+  explicit DailyValuesWindow(size_t windowSize = 1);
+
+  void push(double value);
+
+  void clear();
+
+  //! number of values currently in the window (less than the window size in the first days)
+  size_t size() const { return _size; }
+  size_t windowSize() const { return _values.size(); }
+  bool empty() const { return _size == 0; }
+
+  double sum() const { return _sum; }
+  double mean() const { return _size > 0 ? _sum / double(_size) : 0.0; }
+  double min() const { return _mins.empty() ? 0.0 : _mins.front().second; }
+  double max() const { return _maxs.empty() ? 0.0 : _maxs.front().second; }
+
+private:
+  std::vector<double> _values; //!< ring buffer
+  size_t _next{0}; //!< position of the next value in the ring buffer
+  size_t _size{0};
+  size_t _noOfPushes{0};
+  double _sum{0.0};
+  //! candidates for the window's minimum/maximum (push count, value), the front is the current one
+  std::deque<std::pair<size_t, double>> _mins, _maxs;
+};
+
 class DLL_API Workstep : public Tools::Json11Serializable {
 public:
   Workstep() = default;
@@ -95,8 +128,10 @@ public:
   //! reinit potential state of workstep
   virtual bool reinit(Tools::Date date, bool addYear = false, bool forceInitYear = false);
 
+  //! a workstep may return a function to be run after each day's step, whose values will be kept for
+  //! the window size the workstep requests via createDailyValues
   virtual std::function<double(MonicaModel *)>
-  registerDailyFunction(std::function<std::vector<double> &()> getDailyValues) {
+  registerDailyFunction(std::function<DailyValuesWindow &(size_t windowSize)> createDailyValues) {
     return std::function<double(MonicaModel *)>();
   };
 
@@ -193,7 +228,7 @@ public:
   Tools::Date absLatestDate() const override { return _absLatestDate; }
 
   std::function<double(MonicaModel *)>
-  registerDailyFunction(std::function<std::vector<double> &()> getDailyValues) override;
+  registerDailyFunction(std::function<DailyValuesWindow &(size_t windowSize)> createDailyValues) override;
 
 private:
   Tools::Date _absEarliestDate;
@@ -213,7 +248,7 @@ private:
   double _soilDepthForAveraging{0.30}; //= 30 cm
   int _daysInSoilTempWindow{0};
   double _sowingIfAboveAvgSoilTemp{0};
-  std::function<std::vector<double> &()> _getAvgSoilTemps;
+  const DailyValuesWindow *_avgSoilTemps{nullptr};
 
   bool _inSowingRange{false};
   bool _cropSeeded{false};
@@ -462,7 +497,7 @@ public:
   bool apply(MonicaModel *model) override;
 
   //! Returns parameter for organic fertilizer
-  const OrganicMatterParameters &parameters() const { return _params; }
+  const OrganicMatterParameters &parameters() const { return *_params; }
 
   //! Returns fertilization amount
   double amount() const { return _amount; }
@@ -471,7 +506,7 @@ public:
   bool incorporation() const { return _incorporation; }
 
 private:
-  OrganicMatterParameters _params;
+  std::shared_ptr<const OrganicMatterParameters> _params{ParameterStore<OrganicMatterParameters>::defaults()};
   double _amount{0.0};
   bool _incorporation{false};
 };
@@ -619,7 +654,7 @@ public:
 
   std::vector<WSPtr> allDynamicWorksteps() const;
 
-  std::vector<WSPtr> unfinishedDynamicWorksteps() const { return _unfinishedDynamicWorksteps; }
+  std::vector<WSPtr> unfinishedDynamicWorksteps() const;
 
   bool allDynamicWorkstepsFinished() const;
 
@@ -670,9 +705,17 @@ public:
   bool repeat() const { return _repeat; }
 
 private:
+  //! a workstep and its position in the cultivation method
+  typedef std::pair<size_t, WSPtr> OrderedWS;
+
   std::vector<WSPtr> _allWorksteps;
   std::vector<WSPtr> _allAbsWorksteps;
-  std::vector<WSPtr> _unfinishedDynamicWorksteps;
+  //! the static worksteps by their absolute dates (after reinit)
+  std::multimap<Tools::Date, WSPtr> _absDate2worksteps;
+  //! the dynamic worksteps which have to be checked every day, in the order of _allWorksteps
+  std::vector<OrderedWS> _unfinishedDynamicWorksteps;
+  //! the dynamic worksteps which are not checked before their earliest date
+  std::multimap<Tools::Date, OrderedWS> _waitingDynamicWorksteps;
   int _customId{0};
   std::string _name;
   const Crop *_crop{nullptr};
@@ -134,12 +134,13 @@ public:
       for (auto& cm : cr.cropRotation) {
         for (const auto& wsptr : cm.getWorksteps()) {
           auto df = wsptr->registerDailyFunction(
-                                                 [this, dailyFuncId]() -> vector<double>& {
-                                                   return dailyValues[dailyFuncId];
+                                                 [this, dailyFuncId](size_t windowSize) -> DailyValuesWindow& {
+                                                   return dailyValues[dailyFuncId] = DailyValuesWindow(windowSize);
                                                  });
           if (df) {
-            applyDailyFuncs.emplace_back([this, df, dailyFuncId] {
-              dailyValues[dailyFuncId].push_back(df(monica.get()));
+            auto& dvs = dailyValues[dailyFuncId];
+            applyDailyFuncs.emplace_back([this, df, &dvs] {
+              dvs.push(df(monica.get()));
             });
           }
           dailyFuncId++;
@@ -414,7 +415,7 @@ public:
             auto wrq = ports.out(RESULT_OUT).writeRequest();
             auto st = wrq.initValue().initContent().initAs<mas::schema::common::StructuredText>();
             st.getStructure().setJson();
-            st.setValue(out.to_json().dump());
+            st.setValue(out.toString());
             wrq.send().wait(ioContext.waitScope);
             KJ_LOG(INFO, "sent MONICA result on output channel");
             waitForMoreEvents = false;
@@ -639,7 +640,7 @@ private:
   std::vector<StoreData> store;
   Output out;
   //std::list<Workstep> dynamicWorksteps;
-  std::map<int, std::vector<double>> dailyValues;
+  std::map<int, DailyValuesWindow> dailyValues;
   std::vector<std::function<void()>> applyDailyFuncs;
   bool interactive{false};
 };
@@ -0,0 +1,160 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#include "ensemble.h"
+
+#include <algorithm>
+
+#include <kj/debug.h>
+
+#include "../core/crop-module.h"
+#include "../core/soilcolumn.h"
+
+using namespace std;
+using namespace monica;
+
+Ensemble::Ensemble(const MonicaModel& initial,
+                   size_t noOfMembers,
+                   size_t noOfSoilMoistureLayers,
+                   size_t noOfThreads,
+                   std::pmr::memory_resource* mr)
+  : _climateData(noOfMembers)
+  , _noOfSoilMoistureLayers(min(noOfSoilMoistureLayers, initial.soilColumn().size()))
+  , _noOfThreads(max(size_t(1), min(noOfThreads > 0 ? noOfThreads : max(1u, thread::hardware_concurrency()),
+                                    noOfMembers))) {
+  _members.reserve(noOfMembers);
+  for (size_t i = 0; i < noOfMembers; i++) _members.push_back(initial.clone(mr));
+
+  _exceptions.resize(_noOfThreads);
+  _threads.reserve(_noOfThreads - 1);
+  for (size_t t = 1; t < _noOfThreads; t++) _threads.emplace_back([this, t]() { runThread(t); });
+}
+
+Ensemble::~Ensemble() {
+  {
+    lock_guard<mutex> lock(_mutex);
+    _stop = true;
+  }
+  _stepStarted.notify_all();
+  for (auto& t : _threads) t.join();
+}
+
+std::exception_ptr Ensemble::stepMembers(size_t first) {
+  exception_ptr e;
+  for (size_t i = first; i < _members.size(); i += _noOfThreads) {
+    // a failing member doesn't keep the others from being stepped
+    try {
+      auto& m = *_members[i];
+      m.setCurrentStepClimateData(_climateData[i]);
+      if (m.cropGrowth() && m.cropGrowth()->isDying()) m.incorporateCurrentCrop();
+      m.step();
+    } catch (...) {
+      if (!e) e = current_exception();
+    }
+  }
+  return e;
+}
+
+void Ensemble::runThread(size_t t) {
+  size_t stepNo = 0;
+  while (true) {
+    {
+      unique_lock<mutex> lock(_mutex);
+      _stepStarted.wait(lock, [&]() { return _stop || _stepNo != stepNo; });
+      if (_stop) return;
+      stepNo = _stepNo;
+    }
+
+    // the members' exceptions must not leave the thread (that would terminate the process), step() rethrows them
+    auto e = stepMembers(t);
+
+    {
+      lock_guard<mutex> lock(_mutex);
+      _exceptions[t] = e;
+      if (--_noOfBusyThreads == 0) _stepDone.notify_one();
+    }
+  }
+}
+
+void Ensemble::step(const Tools::Date& date,
+                    const std::map<Climate::ACD, double>& climateData,
+                    const BeforeStepFunc& beforeStep) {
+  // same order as in runMonica, beforeStep is called serially
+  for (size_t i = 0; i < _members.size(); i++) {
+    auto& m = *_members[i];
+    m.dailyReset();
+    m.setCurrentStepDate(date);
+    _climateData[i] = climateData;
+    if (beforeStep) beforeStep(i, m, _climateData[i]);
+  }
+
+  if (_threads.empty()) {
+    if (auto e = stepMembers(0)) rethrow_exception(e);
+    return;
+  }
+
+  // the members are independent, so every thread steps every _noOfThreads-th member
+  {
+    lock_guard<mutex> lock(_mutex);
+    _noOfBusyThreads = _threads.size();
+    _stepNo++;
+  }
+  _stepStarted.notify_all();
+
+  auto e = stepMembers(0);
+
+  unique_lock<mutex> lock(_mutex);
+  _stepDone.wait(lock, [&]() { return _noOfBusyThreads == 0; });
+  for (auto& te : _exceptions) {
+    if (!e) e = te;
+    te = nullptr;
+  }
+  lock.unlock();
+  if (e) rethrow_exception(e);
+}
+
+std::vector<double> Ensemble::stateVector(size_t i) const {
+  const auto& m = member(i);
+  vector<double> x;
+  x.reserve(stateSize());
+  x.push_back(m.cropGrowth() ? m.cropGrowth()->getLeafAreaIndex() : 0.0);
+  for (size_t l = 0; l < _noOfSoilMoistureLayers; l++) {
+    x.push_back(m.soilColumn()[l].get_Vs_SoilMoisture_m3());
+  }
+  return x;
+}
+
+void Ensemble::setStateVector(size_t i, const std::vector<double>& x) {
+  KJ_REQUIRE(x.size() == stateSize(), "state vector has wrong size", x.size(), stateSize());
+
+  auto& m = member(i);
+  if (m.cropGrowth()) m.cropGrowth()->setLeafAreaIndex(max(0.0, x[0]));
+  for (size_t l = 0; l < _noOfSoilMoistureLayers; l++) {
+    m.soilColumnNC()[l].set_Vs_SoilMoisture_m3(max(0.0, x[1 + l]));
+  }
+}
+
+std::vector<std::vector<double>> Ensemble::stateMatrix() const {
+  vector<vector<double>> xs;
+  xs.reserve(_members.size());
+  for (size_t i = 0; i < _members.size(); i++) xs.push_back(stateVector(i));
+  return xs;
+}
+
+void Ensemble::setStateMatrix(const std::vector<std::vector<double>>& xs) {
+  KJ_REQUIRE(xs.size() == _members.size(), "state matrix has wrong number of members", xs.size(), _members.size());
+
+  for (size_t i = 0; i < xs.size(); i++) setStateVector(i, xs[i]);
+}
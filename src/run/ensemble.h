@@ -0,0 +1,112 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <kj/memory.h>
+
+#include "common/dll-exports.h"
+#include "climate/climate-common.h"
+#include "tools/date.h"
+#include "../core/monica-model.h"
+
+namespace monica {
+
+/**
+ * @brief Ensemble of MONICA models stepped forward together, e.g. for an Ensemble Kalman Filter.
+ *
+ * The members start as deep copies of an initial model and are stepped in parallel by a pool of threads
+ * living as long as the ensemble.
+ * Between the steps (at the observation dates) the state vectors of the members can be read
+ * and written back, the analysis itself is left to the caller.
+ * A member's state vector consists of the leaf area index (0 without a crop)
+ * and the volumetric soil moisture of the first noOfSoilMoistureLayers layers.
+ */
+class DLL_API Ensemble {
+public:
+  //! called for every member before it's being stepped, e.g. to apply (perturbed) management or to
+  //! perturb the member's climate data of the day
+  //! (the calls happen one after the other on the thread calling step(), so it doesn't need to be thread-safe)
+  typedef std::function<void(size_t member, MonicaModel& model, std::map<Climate::ACD, double>& climateData)> BeforeStepFunc;
+
+  //! @param noOfThreads threads to step the members with, 0 = number of hardware threads
+  //! @param mr memory resource of the members, is used concurrently, so it has to be synchronized
+  Ensemble(const MonicaModel& initial,
+           size_t noOfMembers,
+           size_t noOfSoilMoistureLayers = 3,
+           size_t noOfThreads = 0,
+           std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+
+  ~Ensemble();
+
+  // the pool threads refer to the ensemble
+  Ensemble(const Ensemble&) = delete;
+  Ensemble& operator=(const Ensemble&) = delete;
+
+  size_t size() const { return _members.size(); }
+
+  MonicaModel& member(size_t i) { return *_members.at(i); }
+  const MonicaModel& member(size_t i) const { return *_members.at(i); }
+
+  //! step all members through a day, every member gets its own copy of the climate data
+  //! (an exception of a member is rethrown here, after all members have been stepped)
+  void step(const Tools::Date& date,
+            const std::map<Climate::ACD, double>& climateData,
+            const BeforeStepFunc& beforeStep = BeforeStepFunc());
+
+  size_t stateSize() const { return 1 + _noOfSoilMoistureLayers; }
+
+  std::vector<double> stateVector(size_t i) const;
+
+  void setStateVector(size_t i, const std::vector<double>& x);
+
+  //! state vectors of all members (one row per member)
+  std::vector<std::vector<double>> stateMatrix() const;
+
+  void setStateMatrix(const std::vector<std::vector<double>>& xs);
+
+private:
+  //! step every _noOfThreads-th member, starting with member first
+  //! @return the exception of the first failing member (if any)
+  std::exception_ptr stepMembers(size_t first);
+
+  //! loop of the pool thread t, stepping its members whenever a new step starts
+  void runThread(size_t t);
+
+  std::vector<kj::Own<MonicaModel>> _members;
+  std::vector<std::map<Climate::ACD, double>> _climateData; //!< of the members in the current step
+  size_t _noOfSoilMoistureLayers{3};
+  size_t _noOfThreads{1};
+
+  // the pool threads step the members together with the thread calling step() (which is thread 0)
+  std::vector<std::thread> _threads;
+  std::mutex _mutex;
+  std::condition_variable _stepStarted, _stepDone;
+  size_t _stepNo{0};
+  size_t _noOfBusyThreads{0};
+  bool _stop{false};
+  std::vector<std::exception_ptr> _exceptions; //!< per thread, of the current step
+};
+
+} // namespace monica
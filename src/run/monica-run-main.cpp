@@ -3,19 +3,24 @@
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 /*
-Authors: 
+Authors:
 Michael Berg <michael.berg@zalf.de>
 
-Maintainers: 
+Maintainers:
 Currently maintained by the authors.
 
-This file is part of the MONICA model. 
+This file is part of the MONICA model.
 Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 */
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <sstream>
 #include <string>
 #include <tuple>
 
@@ -30,6 +35,8 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "run-monica.h"
 #include "create-env-from-json-config.h"
 #include "../io/csv-format.h"
+#include "../io/columnar-format.h"
+#include "batch-jobs.h"
 #include "common/rpc-connection-manager.h"
 #include "capnp-helper.h"
 #include "climate/climate-file-io.h"
@@ -46,22 +53,448 @@ using namespace json11;
 string appName = "monica-run";
 string version = VER_FILE_VERSION_STR;
 
+namespace {
+
+//! the state shared by the jobs of a process, in batch mode by all threads
+struct JobContext {
+  //! just in single job mode, the batch mode doesn't support capnp sturdy refs
+  mas::infrastructure::common::ConnectionManager* conMan{nullptr};
+  kj::AsyncIoContext* ioContext{nullptr};
+
+  bool isBatch{false};
+  std::function<Errors(Soil::SoilParameters*)> ka5PwpFcSatFunction;
+
+  //! the aggregated sink of the batch jobs if the output format is container
+  ColumnarContainerWriter* container{nullptr};
+
+  //! outputs of batch jobs without output file are written to cout as a whole
+  mutex coutMutex;
+
+  //! the output files of the batch jobs, so no two jobs write into the same file
+  mutex outputPathsMutex;
+  set<string> outputPaths;
+
+  bool claimOutputPath(const string& path) {
+    lock_guard<mutex> lock(outputPathsMutex);
+    return outputPaths.insert(path).second;
+  }
+
+  //! parsed crop/site files, in batch mode shared by all jobs
+  mutex jsonFilesMutex;
+  map<string, Json> jsonFiles;
+
+  Json parsedJsonFile(const string& path) {
+    if (isBatch) {
+      lock_guard<mutex> lock(jsonFilesMutex);
+      auto it = jsonFiles.find(path);
+      if (it != jsonFiles.end()) return it->second;
+    }
+    auto j = printPossibleErrors(parseJsonString(printPossibleErrors(readFile(path), activateDebug)), activateDebug);
+    if (isBatch) {
+      lock_guard<mutex> lock(jsonFilesMutex);
+      jsonFiles[path] = j;
+    }
+    return j;
+  }
+};
+
+string containerPath(string pathToOutputFile, const string& pathToOutputDir) {
+  if (pathToOutputFile.empty()) pathToOutputFile = (pathToOutputDir.empty() ? string(".") : pathToOutputDir) + "/";
+  auto k = pathToOutputFile.find_last_of('.');
+  if (k != string::npos && pathToOutputFile.find_first_of("/\\", k) == string::npos) pathToOutputFile.erase(k);
+  if (pathToOutputFile.back() == '/' || pathToOutputFile.back() == '\\') pathToOutputFile += "monica-outputs";
+  return fixSystemSeparator(pathToOutputFile + ".mcon");
+}
+
+//! write the sections of output as CSV or columnar files, either into a single file (or cout)
+//! or into one file per section
+void writeOutputs(ostream& cout_,
+                  const Output& output,
+                  const Json& outputConfig,
+                  string pathToOutputFile,
+                  string pathToOutputDir,
+                  bool writeMultipleOutputFiles,
+                  const string& fileNameKey,
+                  const string& sectionInfix,
+                  bool writeColumnar,
+                  bool returnObjOutputs) {
+  auto openMode = writeColumnar ? ios::out | ios::binary : ios::out;
+  string outputFileExt = writeColumnar ? ".mcol" : ".csv";
+
+  string csvSep = outputConfig["csv-options"]["csv-separator"].string_value();
+  bool includeHeaderRow = outputConfig["csv-options"]["include-header-row"].bool_value();
+  bool includeUnitsRow = outputConfig["csv-options"]["include-units-row"].bool_value();
+  bool includeAggRows = outputConfig["csv-options"]["include-aggregation-rows"].bool_value();
+
+  if (writeMultipleOutputFiles) {
+    string filename = outputConfig[fileNameKey].string_value();
+    string filenameWithoutExt;
+    if (!pathToOutputFile.empty()) {
+      auto i = pathToOutputFile.find_last_of('/');
+      if (i != string::npos) {
+        pathToOutputDir = pathToOutputFile.substr(0, i);
+        filename = pathToOutputFile.substr(i + 1);
+      }
+    }
+    auto k = filename.find_last_of('.');
+    if (k != string::npos) filenameWithoutExt = filename.substr(0, k);
+
+    ofstream fout;
+    bool writeOutputFile = true;
+    if (!ensureDirExists(pathToOutputDir)) {
+      cerr << "Error failed to create path: '" << pathToOutputDir << "'." << endl;
+      writeOutputFile = false;
+    }
+
+    for (const auto &d: output.data) {
+      if (writeOutputFile) {
+        auto sanitizedFileName = replace(d.origSpec, "\"", "");
+        sanitizedFileName = replace(sanitizedFileName, "*", "_star_");
+        sanitizedFileName = replace(sanitizedFileName, "?", "_qm_");
+        sanitizedFileName = replace(sanitizedFileName, "|", "_bar_");
+        sanitizedFileName = replace(sanitizedFileName, "<", "_lb_");
+        sanitizedFileName = replace(sanitizedFileName, ">", "_rb_");
+        sanitizedFileName = replace(sanitizedFileName, ":", "_colon_");
+        pathToOutputFile = fixSystemSeparator(pathToOutputDir + "/" + filenameWithoutExt + sectionInfix + sanitizedFileName + outputFileExt);
+        fout.open(pathToOutputFile, openMode);
+        if (fout.fail()) {
+          cerr << "Error while opening output file \"" << pathToOutputFile << "\"" << endl;
+          writeOutputFile = false;
+        }
+      }
+      ostream &out = writeOutputFile ? fout : cout_;
+      if (writeColumnar) {
+        writeColumnarOutput(out, d);
+      } else {
+        if (!writeOutputFile) out << "\"" << replace(d.origSpec, "\"", "") << "\"" << endl;
+        writeOutputHeaderRows(out, d.outputIds, csvSep, includeHeaderRow, includeUnitsRow, includeAggRows);
+        if (returnObjOutputs) writeOutputObj(out, d.outputIds, d.resultsObj, csvSep);
+        else writeOutput(out, d.outputIds, d.results, csvSep);
+      }
+
+      if (writeOutputFile) fout.close();
+    }
+  }
+  else
+  {
+    bool writeOutputFile = !pathToOutputFile.empty();
+    ofstream fout;
+    if (writeOutputFile) {
+      string path, filename;
+      tie(path, filename) = splitPathToFile(pathToOutputFile);
+      if (!Tools::ensureDirExists(path)) {
+        cerr << "Error failed to create path: '" << path << "'." << endl;
+      }
+      fout.open(pathToOutputFile, openMode);
+      if (fout.fail()) {
+        cerr << "Error while opening output file \"" << pathToOutputFile << "\"" << endl;
+        writeOutputFile = false;
+      }
+    }
+
+    ostream &out = writeOutputFile ? fout : cout_;
+
+    if (writeColumnar) writeColumnarOutput(out, output);
+    else {
+      for (const auto &d: output.data) {
+        out << "\"" << replace(d.origSpec, "\"", "") << "\"" << endl;
+        writeOutputHeaderRows(out, d.outputIds, csvSep, includeHeaderRow, includeUnitsRow, includeAggRows);
+        if (returnObjOutputs)
+          writeOutputObj(out, d.outputIds, d.resultsObj, csvSep);
+        else
+          writeOutput(out, d.outputIds, d.results, csvSep);
+        out << endl;
+      }
+    }
+
+    if (writeOutputFile) fout.close();
+  }
+}
+
+//! run the simulation defined by the sim.json at pathToSimJson and write its outputs
+//! @return the exit code of the job
+int runJob(const string& pathToSimJson, RunOptions opts, JobContext& ctx) {
+  string pathOfSimJson, simFileName;
+  tie(pathOfSimJson, simFileName) = splitPathToFile(pathToSimJson);
+
+  auto simj = readAndParseJsonFile(pathToSimJson);
+  if (simj.failure()) for (const auto &e: simj.errors) cerr << e << endl;
+  auto simm = simj.result.object_items();
+
+  auto csvos = simm["climate.csv-options"].object_items();
+  if (!opts.startDate.empty()) csvos["start-date"] = opts.startDate;
+  if (!opts.endDate.empty()) csvos["end-date"] = opts.endDate;
+  simm["climate.csv-options"] = csvos;
+
+  if (opts.debugSet) simm["debug?"] = opts.debug;
+
+  //set debug mode in run-monica ... in libmonica has to be set separately in runMonica
+  //(the jobs of a batch share the setting of the command line)
+  if (!ctx.isBatch) activateDebug = simm["debug?"].bool_value();
+
+  if (!opts.pathToOutput.empty())
+    simm["path-to-output"] = opts.pathToOutput;
+
+  //if(!pathToOutputFile.empty())
+  //	simm["path-to-output-file"] = pathToOutputFile;
+
+  simm["sim.json"] = pathToSimJson;
+
+  if (!opts.crop.empty()) simm["crop.json"] = opts.crop;
+  auto pathToCropJson = simm["crop.json"].string_value();
+  if (!isAbsolutePath(pathToCropJson)) simm["crop.json"] = pathOfSimJson + pathToCropJson;
+
+  if (!opts.site.empty()) simm["site.json"] = opts.site;
+  auto pathToSiteJson = simm["site.json"].string_value();
+  if (!isAbsolutePath(pathToSiteJson)) simm["site.json"] = pathOfSimJson + pathToSiteJson;
+
+  if (!opts.climate.empty()) simm["climate.csv"] = opts.climate;
+  if (simm["climate.csv"].is_string() && simm["climate.csv"].string_value().find("capnp://") == string::npos) {
+    auto pathToClimateCSV = simm["climate.csv"].string_value();
+    if (!isAbsolutePath(pathToClimateCSV)) simm["climate.csv"] = pathOfSimJson + pathToClimateCSV;
+  } else if (simm["climate.csv"].is_array()) {
+    vector<string> ps;
+    for (const auto &j: simm["climate.csv"].array_items()) {
+      const auto &pathToClimateCSV = j.string_value();
+      if (pathToClimateCSV.find("capnp://") == 0 || isAbsolutePath(pathToClimateCSV)) {
+        ps.push_back(pathToClimateCSV); // is a sturdy ref or absolute path
+      } else ps.push_back(pathOfSimJson + pathToClimateCSV); // is relative path
+    }
+    simm["climate.csv"] = toPrimJsonArray(ps);
+  }
+
+  map<string, Json> ps;
+  ps["sim"] = json11::Json(simm);
+  ps["crop"] = ctx.parsedJsonFile(simm["crop.json"].string_value());
+  ps["site"] = ctx.parsedJsonFile(simm["site.json"].string_value());
+
+  auto requireConnection = [&](const string& sr) {
+    if (ctx.conMan) return true;
+    cerr << "Error: " << pathToSimJson << " refers to sturdy ref " << sr
+         << ", but capnp sturdy refs aren't supported in batch mode." << endl;
+    return false;
+  };
+
+  // if the soil profile parameters refer to a sturdy ref, try to connect to it
+  if (ps["site"]["SiteParameters"]["SoilProfileParameters"].is_string()) {
+    auto soilSR = ps["site"]["SiteParameters"]["SoilProfileParameters"].string_value();
+    //no soil data have been loaded, but there might be a capnp sturdy ref
+    if (!soilSR.empty()) {
+      if (!requireConnection(soilSR)) return 1;
+      auto sp = ctx.conMan->tryConnectB(soilSR).castAs<mas::schema::soil::Profile>();
+      auto soilpsj = fromCapnpSoilProfile(kj::mv(sp)).wait(ctx.ioContext->waitScope);
+      auto siteMap = ps["site"].object_items();
+      siteMap["SoilProfileParameters"] = soilpsj;
+    }
+  }
+
+  Env env;
+
+  // set available functions to calculate pwp, fc and sat before env creation
+  env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Wessolek2009"] = ctx.ka5PwpFcSatFunction;
+  env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchten"] = Soil::updateUnsetPwpFcSatFromVanGenuchten;
+  env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Toth"] = Soil::updateUnsetPwpFcSatFromToth;
+
+
+  // merge the json objects into the env
+  auto mergeResult = env.merge(createEnvJsonFromJsonObjects(ps));
+  printPossibleErrors(mergeResult);
+  if (mergeResult.failure()) return 1;
+
+  //check if there were sturdy refs to time-series
+  Climate::DataAccessor finalDA = kj::mv(env.climateData);
+  for (const auto &sr: env.pathsToClimateCSV) {
+    if (sr.find("capnp://") == 0) {
+      if (!requireConnection(sr)) return 1;
+      auto ts = ctx.conMan->tryConnectB(sr).castAs<mas::schema::climate::TimeSeries>();
+      auto da = dataAccessorFromTimeSeries(kj::mv(ts)).wait(ctx.ioContext->waitScope);
+      if (!finalDA.isValid()) {
+        finalDA = kj::mv(da);
+      } else {
+        finalDA.mergeClimateData(kj::mv(da), true);
+      }
+    }
+  }
+  Climate::CSVViaHeaderOptions options(simm["climate.csv-options"]);
+  if (options.startDate.isValid() && options.endDate.isValid()) {
+    int noOfDays = options.endDate - options.startDate + 1;
+    if (finalDA.noOfStepsPossible() < size_t(noOfDays)) {
+      cerr << "Read time-series data between " << options.startDate.toIsoDateString()
+          << " and " << options.endDate.toIsoDateString()
+          << " (" << noOfDays << " days) is incomplete. There are just "
+          << finalDA.noOfStepsPossible() << " days in read dataset.";
+    }
+  }
+  env.climateData = kj::mv(finalDA);
+
+  if (opts.icReaderSr.empty()) opts.icReaderSr = env.params.userCropParameters.pc_intercropping_reader_sr;
+  if (opts.icWriterSr.empty()) opts.icWriterSr = env.params.userCropParameters.pc_intercropping_writer_sr;
+
+  for (const auto& sr : {opts.icReaderSr, opts.icWriterSr}) if (!sr.empty() && !requireConnection(sr)) return 1;
+  if (!opts.icReaderSr.empty()) env.ic.reader = ctx.conMan->tryConnectB(opts.icReaderSr).castAs<Intercropping::Reader>();
+  if (!opts.icWriterSr.empty()) env.ic.writer = ctx.conMan->tryConnectB(opts.icWriterSr).castAs<Intercropping::Writer>();
+  if (!opts.icReaderSr.empty() && !opts.icWriterSr.empty()) env.ic.ioContext = ctx.ioContext;
+
+  env.params.userSoilMoistureParameters.getCapillaryRiseRate =
+      [](const string &soilTexture, size_t distance) {
+        return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
+      };
+
+  if (activateDebug) cout << "starting MONICA with JSON input files" << endl;
+
+  bool isIC = env.params.userCropParameters.isIntercropping;
+  bool isAsyncIC = env.ic.isAsync();
+  bool returnObjOutputs = env.returnObjOutputs();
+  Output output, output2;
+  tie(output, output2) = runMonicaIC(kj::mv(env), isIC);
+
+  auto outputConfig = simm["output"].object_items();
+  auto outputFormat = opts.outputFormat;
+  if (outputFormat.empty()) outputFormat = outputConfig["format"].string_value();
+  bool writeColumnar = outputFormat == "columnar";
+
+  // the jobs of a batch share the output file of the command line, and e.g. the sim.json files of a glob made
+  // from one template the file name of their output config, so every job writes into files of its own name
+  // (the container keeps the runs apart by their run id instead)
+  if (!opts.batchJobName.empty() && outputFormat != "container") {
+    for (auto key : {"file-name", "file-name2"}) {
+      if (outputConfig[key].is_string() && !outputConfig[key].string_value().empty()) {
+        outputConfig[key] = withNameSuffix(outputConfig[key].string_value(), opts.batchJobName);
+      }
+    }
+    for (auto path : {&opts.pathToOutputFile, &opts.pathToOutputFile2}) {
+      if (!path->empty()) *path = withNameSuffix(*path, opts.batchJobName);
+    }
+  }
+
+  string pathToOutputDir, pathToOutputDir2;
+  auto pathToOutputFile = opts.pathToOutputFile, pathToOutputFile2 = opts.pathToOutputFile2;
+  if (pathToOutputFile.empty() && outputConfig["write-file?"].bool_value()) {
+    pathToOutputDir = fixSystemSeparator(outputConfig["path-to-output"].string_value());
+    pathToOutputFile = fixSystemSeparator(pathToOutputDir + "/"
+                                          + outputConfig["file-name"].string_value());
+  }
+  if (pathToOutputFile2.empty() && outputConfig["write-file?"].bool_value()) {
+    pathToOutputDir2 = fixSystemSeparator(outputConfig["path-to-output"].string_value());
+    pathToOutputFile2 = fixSystemSeparator(pathToOutputDir2 + "/"
+                                           + outputConfig["file-name2"].string_value());
+  }
+
+  if (outputFormat == "container") {
+    // all sections (of both crops when intercropping) go as blocks into one file, keyed by run id
+    auto runId = opts.runId;
+    if (runId.empty()) {
+      if (output.customId.is_string()) runId = output.customId.string_value();
+      else if (!output.customId.is_null()) runId = output.customId.dump();
+      else runId = pathToSimJson;
+    }
+
+    bool ok = true;
+    auto addToContainer = [&](ColumnarContainerWriter& cw) {
+      auto added = cw.add(runId, output);
+      if (isIC && !isAsyncIC) added = cw.add(runId + "/2", output2) && added;
+      return added;
+    };
+    if (ctx.container) {
+      ok = addToContainer(*ctx.container);
+      if (!ok) cerr << "Error while appending to output container \"" << ctx.container->pathToFile() << "\"" << endl;
+    } else {
+      ColumnarContainerWriter cw(containerPath(pathToOutputFile,
+                                               !pathToOutputDir.empty() ? pathToOutputDir : opts.pathToOutput));
+      string path, filename;
+      tie(path, filename) = splitPathToFile(cw.pathToFile());
+      if (!Tools::ensureDirExists(path)) cerr << "Error failed to create path: '" << path << "'." << endl;
+      ok = addToContainer(cw);
+      ok = cw.flush() && ok;
+      if (!ok) cerr << "Error while appending to output container \"" << cw.pathToFile() << "\"" << endl;
+    }
+
+    if (activateDebug) cout << "finished MONICA" << endl;
+    return ok ? 0 : 1;
+  }
+
+  // jobs which still end up with the same output file (e.g. two lines of a batch file with the same sim.json
+  // and neither run-id nor output-file) fail instead of overwriting each other's outputs
+  if (ctx.isBatch) {
+    vector<string> paths = {pathToOutputFile.empty() && opts.writeMultipleOutputFiles
+                            ? pathToOutputDir + "/" + outputConfig["file-name"].string_value() : pathToOutputFile};
+    if (isIC && !isAsyncIC) {
+      paths.push_back(pathToOutputFile2.empty() && opts.writeMultipleOutputFiles
+                      ? pathToOutputDir2 + "/" + outputConfig["file-name2"].string_value() : pathToOutputFile2);
+    }
+    for (const auto& path : paths) {
+      if (path.empty() || path == "/" || ctx.claimOutputPath(fixSystemSeparator(path))) continue;
+      cerr << "Error: job " << pathToSimJson << " would write into the output file \"" << path
+           << "\" of another job of the batch, give the jobs a distinct \"run-id\" or \"output-file\"." << endl;
+      return 1;
+    }
+  }
+
+  // the outputs of parallel batch jobs mustn't be interleaved on cout
+  ostringstream bufferedCout;
+  ostream& out = ctx.isBatch ? bufferedCout : cout;
+
+  writeOutputs(out, output, outputConfig, pathToOutputFile, pathToOutputDir, opts.writeMultipleOutputFiles,
+               "file-name", "_section_", writeColumnar, returnObjOutputs);
+
+  if (isIC && !isAsyncIC) {
+    writeOutputs(out, output2, outputConfig, pathToOutputFile2, pathToOutputDir2, opts.writeMultipleOutputFiles,
+                 "file-name2", "_2_section_", writeColumnar, returnObjOutputs);
+  }
+
+  if (ctx.isBatch && bufferedCout.tellp() > 0) {
+    lock_guard<mutex> lock(ctx.coutMutex);
+    cout << bufferedCout.str();
+  }
+
+  if (activateDebug) cout << "finished MONICA" << endl;
+  return 0;
+}
+
+//! run the jobs of a batch on noOfThreads threads, failing jobs are reported but don't stop the batch
+int runBatch(const string& batch, size_t noOfThreads, const RunOptions& opts, JobContext& ctx) {
+  auto jobs = readBatchJobs(batch, opts);
+  printPossibleErrors(jobs);
+  if (jobs.result.empty()) return 1;
+
+  // initialize the lazily loaded tables once, before the jobs use them concurrently
+  Soil::readCapillaryRiseRates();
+
+  unique_ptr<ColumnarContainerWriter> container;
+  if (opts.outputFormat == "container") {
+    container = make_unique<ColumnarContainerWriter>(containerPath(opts.pathToOutputFile, opts.pathToOutput));
+    string path, filename;
+    tie(path, filename) = splitPathToFile(container->pathToFile());
+    if (!Tools::ensureDirExists(path)) cerr << "Error failed to create path: '" << path << "'." << endl;
+    ctx.container = container.get();
+  }
+
+  auto noOfFailedJobs = runBatchJobs(jobs.result, noOfThreads, [&](const BatchJob& job) {
+    return runJob(job.pathToSimJson, job.opts, ctx);
+  });
+
+  if (container && !container->flush()) {
+    cerr << "Error while appending to output container \"" << container->pathToFile() << "\"" << endl;
+    return 1;
+  }
+
+  if (noOfFailedJobs > 0) {
+    cerr << noOfFailedJobs << " of " << jobs.result.size() << " jobs failed" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace
+
 int main(int argc, char **argv) {
   setlocale(LC_ALL, "");
   setlocale(LC_NUMERIC, "C");
 
-  auto ioContext = kj::setupAsyncIo();
-  mas::infrastructure::common::ConnectionManager conMan(ioContext);
-
-  bool debug = false, debugSet = false;
-  string startDate, endDate;
-  string pathToOutput;
-  string pathToOutputFile, pathToOutputFile2;
-  string pathToOutputDir, pathToOutputDir2;
-  bool writeMultipleOutputFiles = false, writeMultipleOutputFiles2 = false;
-  string pathToSimJson = "./sim.json", crop, site, climate;
-  string icReaderSr;
-  string icWriterSr;
+  RunOptions opts;
+  string pathToSimJson = "./sim.json";
+  string batch;
+  size_t noOfThreads = 0;
 
   auto printHelp = [=]() {
     cout
@@ -80,6 +513,15 @@ int main(int argc, char **argv) {
         << " -m   | --write-multiple-output-files ... write one output file per output section " << endl
         << " -op  | --path-to-output DIRECTORY (default: .) ... path to output directory" << endl
         << " -o   | --path-to-output-file FILE ... path to output file" << endl
+        << " -of  | --output-format csv | columnar | container (default: csv) ... format of the output file(s), "
+           "container appends all sections of the run to a single (.mcon) file shared by many runs" << endl
+        << " -rid | --run-id ID (default: customId or path to sim.json) ... key of the run in a container file" << endl
+        << " -b   | --batch FILE.jsonl | GLOB ... run the jobs listed in a JSON lines file (a path to a sim.json "
+           "or an object with \"sim\" and optional \"run-id\", \"crop\", \"site\", \"climate\", \"start-date\", "
+           "\"end-date\", \"output-file\", \"output-dir\" per line) or all sim.json files matching the glob "
+           "(e.g. sims/sim-*.json) instead of a single sim.json" << endl
+        << " -t   | --threads N (default: number of hardware threads) ... number of threads running the batch jobs"
+        << endl
         << " -c   | --path-to-crop FILE (default: ./crop.json) ... path to crop.json file" << endl
         << " -s   | --path-to-site FILE (default: ./site.json) ... path to site.json file" << endl
         << " -w   | --path-to-climate FILE (default: ./climate.csv) ... path to climate.csv" << endl;
@@ -89,351 +531,60 @@ int main(int argc, char **argv) {
     for (auto i = 1; i < argc; i++) {
       string arg = argv[i];
       if (arg == "-d" || arg == "--debug")
-        debug = debugSet = true;
+        opts.debug = opts.debugSet = true;
       else if ((arg == "-sd" || arg == "--start-date") && i + 1 < argc)
-        startDate = argv[++i];
+        opts.startDate = argv[++i];
       else if ((arg == "-ed" || arg == "--end-date") && i + 1 < argc)
-        endDate = argv[++i];
+        opts.endDate = argv[++i];
       else if ((arg == "-op" || arg == "--path-to-output") && i + 1 < argc)
-        pathToOutput = argv[++i];
+        opts.pathToOutput = argv[++i];
       else if ((arg == "-o" || arg == "--path-to-output-file") && i + 1 < argc)
-        pathToOutputFile = argv[++i];
+        opts.pathToOutputFile = argv[++i];
       else if ((arg == "-o2" || arg == "--path-to-output-file2") && i + 1 < argc)
-        pathToOutputFile2 = argv[++i];
+        opts.pathToOutputFile2 = argv[++i];
       else if ((arg == "-m" || arg == "--write-multiple-output-files") && i + 1 < argc)
-        writeMultipleOutputFiles = writeMultipleOutputFiles2 = true;
+        opts.writeMultipleOutputFiles = true;
+      else if ((arg == "-of" || arg == "--output-format") && i + 1 < argc)
+        opts.outputFormat = argv[++i];
+      else if ((arg == "-rid" || arg == "--run-id") && i + 1 < argc)
+        opts.runId = argv[++i];
+      else if ((arg == "-b" || arg == "--batch") && i + 1 < argc)
+        batch = argv[++i];
+      else if ((arg == "-t" || arg == "--threads") && i + 1 < argc)
+        noOfThreads = size_t(max(0, atoi(argv[++i])));
       else if ((arg == "-c" || arg == "--path-to-crop") && i + 1 < argc)
-        crop = argv[++i];
+        opts.crop = argv[++i];
       else if ((arg == "-s" || arg == "--path-to-site") && i + 1 < argc)
-        site = argv[++i];
+        opts.site = argv[++i];
       else if ((arg == "-w" || arg == "--path-to-climate") && i + 1 < argc)
-        climate = argv[++i];
+        opts.climate = argv[++i];
       else if (arg == "-h" || arg == "--help")
         printHelp(), exit(0);
       else if (arg == "-v" || arg == "--version")
         cout << appName << " version " << version << endl, exit(0);
       else if ((arg == "-icrsr" || arg == "--intercropping-reader-sr") && i + 1 < argc)
-        icReaderSr = argv[++i];
+        opts.icReaderSr = argv[++i];
       else if ((arg == "-icwsr" || arg == "--intercropping-writer-sr") && i + 1 < argc)
-        icWriterSr = argv[++i];
+        opts.icWriterSr = argv[++i];
       else
         pathToSimJson = argv[i];
     }
 
-    string pathOfSimJson, simFileName;
-    tie(pathOfSimJson, simFileName) = splitPathToFile(pathToSimJson);
-
-    auto simj = readAndParseJsonFile(pathToSimJson);
-    if (simj.failure()) for (const auto &e: simj.errors) cerr << e << endl;
-    auto simm = simj.result.object_items();
-
-    auto csvos = simm["climate.csv-options"].object_items();
-    if (!startDate.empty()) csvos["start-date"] = startDate;
-    if (!endDate.empty()) csvos["end-date"] = endDate;
-    simm["climate.csv-options"] = csvos;
-
-    if (debugSet) simm["debug?"] = debug;
-
-    //set debug mode in run-monica ... in libmonica has to be set separately in runMonica
-    activateDebug = simm["debug?"].bool_value();
-
-    if (!pathToOutput.empty())
-      simm["path-to-output"] = pathToOutput;
-
-    //if(!pathToOutputFile.empty())
-    //	simm["path-to-output-file"] = pathToOutputFile;
-
-    simm["sim.json"] = pathToSimJson;
-
-    if (!crop.empty()) simm["crop.json"] = crop;
-    auto pathToCropJson = simm["crop.json"].string_value();
-    if (!isAbsolutePath(pathToCropJson)) simm["crop.json"] = pathOfSimJson + pathToCropJson;
-
-    if (!site.empty()) simm["site.json"] = site;
-    auto pathToSiteJson = simm["site.json"].string_value();
-    if (!isAbsolutePath(pathToSiteJson)) simm["site.json"] = pathOfSimJson + pathToSiteJson;
-
-    if (!climate.empty()) simm["climate.csv"] = climate;
-    if (simm["climate.csv"].is_string() && simm["climate.csv"].string_value().find("capnp://") == string::npos) {
-      auto pathToClimateCSV = simm["climate.csv"].string_value();
-      if (!isAbsolutePath(pathToClimateCSV)) simm["climate.csv"] = pathOfSimJson + pathToClimateCSV;
-    } else if (simm["climate.csv"].is_array()) {
-      vector<string> ps;
-      for (const auto &j: simm["climate.csv"].array_items()) {
-        const auto &pathToClimateCSV = j.string_value();
-        if (pathToClimateCSV.find("capnp://") == 0 || isAbsolutePath(pathToClimateCSV)) {
-          ps.push_back(pathToClimateCSV); // is a sturdy ref or absolute path
-        } else ps.push_back(pathOfSimJson + pathToClimateCSV); // is relative path
-      }
-      simm["climate.csv"] = toPrimJsonArray(ps);
-    }
-
-    map<string, Json> ps;
-    ps["sim"] = json11::Json(simm);
-    ps["crop"] = printPossibleErrors(parseJsonString(printPossibleErrors(readFile(simm["crop.json"].string_value()), activateDebug)), activateDebug);
-    ps["site"] = printPossibleErrors(parseJsonString(printPossibleErrors(readFile(simm["site.json"].string_value()), activateDebug)), activateDebug);
-
-    // if the soil profile parameters refer to a sturdy ref, try to connect to it
-    if (ps["site"]["SiteParameters"]["SoilProfileParameters"].is_string()) {
-      auto soilSR = ps["site"]["SiteParameters"]["SoilProfileParameters"].string_value();
-      //no soil data have been loaded, but there might be a capnp sturdy ref
-      if (!soilSR.empty()) {
-        auto sp = conMan.tryConnectB(soilSR).castAs<mas::schema::soil::Profile>();
-        auto soilpsj = fromCapnpSoilProfile(kj::mv(sp)).wait(ioContext.waitScope);
-        auto siteMap = ps["site"].object_items();
-        siteMap["SoilProfileParameters"] = soilpsj;
-      }
-    }
-
-    Env env;
-
-    // set available functions to calculate pwp, fc and sat before env creation
+    JobContext ctx;
     auto pathToSoilDir = fixSystemSeparator(replaceEnvVars("${MONICA_PARAMETERS}/soil/"));
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Wessolek2009"] = Soil::getInitializedUpdateUnsetPwpFcSatfromKA5textureClassFunction(pathToSoilDir);
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchten"] = Soil::updateUnsetPwpFcSatFromVanGenuchten;
-    env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Toth"] = Soil::updateUnsetPwpFcSatFromToth;
-
-
-    // merge the json objects into the env
-    auto mergeResult = env.merge(createEnvJsonFromJsonObjects(ps));
-    printPossibleErrors(mergeResult);
-    if (mergeResult.failure()) return 1;
-
-    //check if there were sturdy refs to time-series
-    Climate::DataAccessor finalDA = kj::mv(env.climateData);
-    for (const auto &sr: env.pathsToClimateCSV) {
-      if (sr.find("capnp://") == 0) {
-        auto ts = conMan.tryConnectB(sr).castAs<mas::schema::climate::TimeSeries>();
-        auto da = dataAccessorFromTimeSeries(kj::mv(ts)).wait(ioContext.waitScope);
-        if (!finalDA.isValid()) {
-          finalDA = kj::mv(da);
-        } else {
-          finalDA.mergeClimateData(kj::mv(da), true);
-        }
-      }
-    }
-    Climate::CSVViaHeaderOptions options(simm["climate.csv-options"]);
-    if (options.startDate.isValid() && options.endDate.isValid()) {
-      int noOfDays = options.endDate - options.startDate + 1;
-      if (finalDA.noOfStepsPossible() < size_t(noOfDays)) {
-        cerr << "Read time-series data between " << options.startDate.toIsoDateString()
-            << " and " << options.endDate.toIsoDateString()
-            << " (" << noOfDays << " days) is incomplete. There are just "
-            << finalDA.noOfStepsPossible() << " days in read dataset.";
-      }
-    }
-    env.climateData = kj::mv(finalDA);
-
-    if (icReaderSr.empty()) icReaderSr = env.params.userCropParameters.pc_intercropping_reader_sr;
-    if (icWriterSr.empty()) icWriterSr = env.params.userCropParameters.pc_intercropping_writer_sr;
-
-    if (!icReaderSr.empty()) env.ic.reader = conMan.tryConnectB(icReaderSr).castAs<Intercropping::Reader>();
-    if (!icWriterSr.empty()) env.ic.writer = conMan.tryConnectB(icWriterSr).castAs<Intercropping::Writer>();
-    if (!icReaderSr.empty() && !icWriterSr.empty()) env.ic.ioContext = &ioContext;
+    ctx.ka5PwpFcSatFunction = Soil::getInitializedUpdateUnsetPwpFcSatfromKA5textureClassFunction(pathToSoilDir);
 
-    env.params.userSoilMoistureParameters.getCapillaryRiseRate =
-        [](const string &soilTexture, size_t distance) {
-          return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
-        };
-
-    if (activateDebug) cout << "starting MONICA with JSON input files" << endl;
-
-    bool isIC = env.params.userCropParameters.isIntercropping;
-    bool isAsyncIC = env.ic.isAsync();
-    bool returnObjOutputs = env.returnObjOutputs();
-    Output output, output2;
-    tie(output, output2) = runMonicaIC(kj::mv(env), isIC);
-
-    if (pathToOutputFile.empty() && simm["output"]["write-file?"].bool_value()) {
-      pathToOutputDir = fixSystemSeparator(simm["output"]["path-to-output"].string_value());
-      pathToOutputFile = fixSystemSeparator(pathToOutputDir + "/"
-                                            + simm["output"]["file-name"].string_value());
+    if (!batch.empty()) {
+      ctx.isBatch = true;
+      activateDebug = opts.debug;
+      return runBatch(batch, noOfThreads, opts, ctx);
     }
-    if (pathToOutputFile2.empty() && simm["output"]["write-file?"].bool_value()) {
-      pathToOutputDir2 = fixSystemSeparator(simm["output"]["path-to-output"].string_value());
-      pathToOutputFile2 = fixSystemSeparator(pathToOutputDir2 + "/"
-                                             + simm["output"]["file-name2"].string_value());
-    }
-
-    if (writeMultipleOutputFiles) {
-      string filename = simm["output"]["file-name"].string_value();
-      string filenameWithoutExt;
-      if (!pathToOutputFile.empty()) {
-        auto i = pathToOutputFile.find_last_of('/');
-        if (i != string::npos) {
-          pathToOutputDir = pathToOutputFile.substr(0, i);
-          filename = pathToOutputFile.substr(i + 1);
-        }
-      }
-      auto k = filename.find_last_of('.');
-      if (k != string::npos) filenameWithoutExt = filename.substr(0, k);
-
-      ofstream fout;
-      bool writeOutputFile = true;
-      if (!ensureDirExists(pathToOutputDir)) {
-        cerr << "Error failed to create path: '" << pathToOutputDir << "'." << endl;
-        writeOutputFile = false;
-      }
-
-      string csvSep = simm["output"]["csv-options"]["csv-separator"].string_value();
-      bool includeHeaderRow = simm["output"]["csv-options"]["include-header-row"].bool_value();
-      bool includeUnitsRow = simm["output"]["csv-options"]["include-units-row"].bool_value();
-      bool includeAggRows = simm["output"]["csv-options"]["include-aggregation-rows"].bool_value();
 
-      for (const auto &d: output.data) {
-        if (writeOutputFile) {
-          auto sanitizedFileName = replace(d.origSpec, "\"", "");
-          sanitizedFileName = replace(sanitizedFileName, "*", "_star_");
-          sanitizedFileName = replace(sanitizedFileName, "?", "_qm_");
-          sanitizedFileName = replace(sanitizedFileName, "|", "_bar_");
-          sanitizedFileName = replace(sanitizedFileName, "<", "_lb_");
-          sanitizedFileName = replace(sanitizedFileName, ">", "_rb_");
-          sanitizedFileName = replace(sanitizedFileName, ":", "_colon_");
-          pathToOutputFile = fixSystemSeparator(pathToOutputDir + "/" + filenameWithoutExt + "_section_" + sanitizedFileName + ".csv");
-          fout.open(pathToOutputFile);
-          if (fout.fail()) {
-            cerr << "Error while opening output file \"" << pathToOutputFile << "\"" << endl;
-            writeOutputFile = false;
-          }
-        }
-        ostream &out = writeOutputFile ? fout : cout;
-        if (!writeOutputFile) out << "\"" << replace(d.origSpec, "\"", "") << "\"" << endl;
-        writeOutputHeaderRows(out, d.outputIds, csvSep, includeHeaderRow, includeUnitsRow, includeAggRows);
-        if (returnObjOutputs) writeOutputObj(out, d.outputIds, d.resultsObj, csvSep);
-        else writeOutput(out, d.outputIds, d.results, csvSep);
-
-        if (writeOutputFile) fout.close();
-      }
-    }
-    else
-    {
-      bool writeOutputFile = !pathToOutputFile.empty();
-      ofstream fout;
-      if (writeOutputFile) {
-        string path, filename;
-        tie(path, filename) = splitPathToFile(pathToOutputFile);
-        if (!Tools::ensureDirExists(path)) {
-          cerr << "Error failed to create path: '" << path << "'." << endl;
-        }
-        fout.open(pathToOutputFile);
-        if (fout.fail()) {
-          cerr << "Error while opening output file \"" << pathToOutputFile << "\"" << endl;
-          writeOutputFile = false;
-        }
-      }
-
-      ostream &out = writeOutputFile ? fout : cout;
-
-      string csvSep = simm["output"]["csv-options"]["csv-separator"].string_value();
-      bool includeHeaderRow = simm["output"]["csv-options"]["include-header-row"].bool_value();
-      bool includeUnitsRow = simm["output"]["csv-options"]["include-units-row"].bool_value();
-      bool includeAggRows = simm["output"]["csv-options"]["include-aggregation-rows"].bool_value();
-
-      for (const auto &d: output.data) {
-        out << "\"" << replace(d.origSpec, "\"", "") << "\"" << endl;
-        writeOutputHeaderRows(out, d.outputIds, csvSep, includeHeaderRow, includeUnitsRow, includeAggRows);
-        if (returnObjOutputs)
-          writeOutputObj(out, d.outputIds, d.resultsObj, csvSep);
-        else
-          writeOutput(out, d.outputIds, d.results, csvSep);
-        out << endl;
-
-      }
-
-      if (writeOutputFile) fout.close();
-    }
-
-    if (isIC && !isAsyncIC)
-    {
-      if (writeMultipleOutputFiles) {
-        string filename2 = simm["output"]["file-name2"].string_value();
-        string filenameWithoutExt2;
-        if (!pathToOutputFile2.empty()) {
-          auto i = pathToOutputFile2.find_last_of('/');
-          if (i != string::npos) {
-            pathToOutputDir2 = pathToOutputFile2.substr(0, i);
-            filename2 = pathToOutputFile2.substr(i + 1);
-          }
-        }
-        auto k = filename2.find_last_of('.');
-        if (k != string::npos) filenameWithoutExt2 = filename2.substr(0, k);
-
-        ofstream fout;
-        bool writeOutputFile = true;
-        if (!ensureDirExists(pathToOutputDir2)) {
-          cerr << "Error failed to create path: '" << pathToOutputDir2 << "'." << endl;
-          writeOutputFile = false;
-        }
-
-        string csvSep = simm["output"]["csv-options"]["csv-separator"].string_value();
-        bool includeHeaderRow = simm["output"]["csv-options"]["include-header-row"].bool_value();
-        bool includeUnitsRow = simm["output"]["csv-options"]["include-units-row"].bool_value();
-        bool includeAggRows = simm["output"]["csv-options"]["include-aggregation-rows"].bool_value();
-
-        for (const auto &d: output2.data) {
-          if (writeOutputFile) {
-            auto sanitizedFileName = replace(d.origSpec, "\"", "");
-            sanitizedFileName = replace(sanitizedFileName, "*", "_star_");
-            sanitizedFileName = replace(sanitizedFileName, "?", "_qm_");
-            sanitizedFileName = replace(sanitizedFileName, "|", "_bar_");
-            sanitizedFileName = replace(sanitizedFileName, "<", "_lb_");
-            sanitizedFileName = replace(sanitizedFileName, ">", "_rb_");
-            sanitizedFileName = replace(sanitizedFileName, ":", "_colon_");
-            pathToOutputFile = fixSystemSeparator(pathToOutputDir + "/" + filenameWithoutExt2 + "_2_section_" + sanitizedFileName + ".csv");
-            fout.open(pathToOutputFile);
-            if (fout.fail()) {
-              cerr << "Error while opening output file \"" << pathToOutputFile << "\"" << endl;
-              writeOutputFile = false;
-            }
-          }
-          ostream &out = writeOutputFile ? fout : cout;
-          if (!writeOutputFile) out << "\"" << replace(d.origSpec, "\"", "") << "\"" << endl;
-          writeOutputHeaderRows(out, d.outputIds, csvSep, includeHeaderRow, includeUnitsRow, includeAggRows);
-          if (returnObjOutputs) writeOutputObj(out, d.outputIds, d.resultsObj, csvSep);
-          else writeOutput(out, d.outputIds, d.results, csvSep);
-
-          if (writeOutputFile) fout.close();
-        }
-      }
-      else
-      {
-        bool writeOutputFile2 = !pathToOutputFile2.empty();
-        ofstream fout;
-        if (writeOutputFile2) {
-          string path, filename;
-          tie(path, filename) = splitPathToFile(pathToOutputFile2);
-          if (!Tools::ensureDirExists(path)) {
-            cerr << "Error failed to create path: '" << path << "'." << endl;
-          }
-          fout.open(pathToOutputFile2);
-          if (fout.fail()) {
-            cerr << "Error while opening output file \"" << pathToOutputFile2 << "\"" << endl;
-            writeOutputFile2 = false;
-          }
-        }
-
-        ostream &out = writeOutputFile2 ? fout : cout;
-
-        string csvSep = simm["output"]["csv-options"]["csv-separator"].string_value();
-        bool includeHeaderRow = simm["output"]["csv-options"]["include-header-row"].bool_value();
-        bool includeUnitsRow = simm["output"]["csv-options"]["include-units-row"].bool_value();
-        bool includeAggRows = simm["output"]["csv-options"]["include-aggregation-rows"].bool_value();
-
-        for (const auto &d: output2.data) {
-          out << "\"" << replace(d.origSpec, "\"", "") << "\"" << endl;
-          writeOutputHeaderRows(out, d.outputIds, csvSep, includeHeaderRow, includeUnitsRow, includeAggRows);
-          if (returnObjOutputs)
-            writeOutputObj(out, d.outputIds, d.resultsObj, csvSep);
-          else
-            writeOutput(out, d.outputIds, d.results, csvSep);
-          out << endl;
-        }
-
-        if (writeOutputFile2) fout.close();
-      }
-    }
-
-    if (activateDebug) cout << "finished MONICA" << endl;
+    auto ioContext = kj::setupAsyncIo();
+    mas::infrastructure::common::ConnectionManager conMan(ioContext);
+    ctx.conMan = &conMan;
+    ctx.ioContext = &ioContext;
+    return runJob(pathToSimJson, opts, ctx);
   }
   else
   {
@@ -17,6 +17,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <thread>
 #include <tuple>
 
 #include "zeromq/zmq-helper.h"
@@ -152,6 +153,7 @@ int main(int argc, char **argv) {
   bool usePipeline = false;
   bool useRouterOutputSocket = false;
   string controlAddress = defControlAddress;
+  size_t noOfWorkers = 1;
 
   SocketOp inputOp = monica::connect;
   SocketOp outputOp = monica::connect;
@@ -184,7 +186,9 @@ int main(int argc, char **argv) {
         << " -or | --router-output-address [ADDRESS1[,ADDRESS2,...]] (default: " << outputAddress
         << ")] ... send results to this address(es) but use a router socket" << endl
         << " -c | --control-address [ADDRESS] (default: " << controlAddress
-        << ")] ... connect MONICA server to this address for control messages" << endl;
+        << ")] ... connect MONICA server to this address for control messages" << endl
+        << " -w | --workers [N] (default: " << noOfWorkers
+        << ", without N: number of hardware threads)] ... run the jobs on N worker threads in this process" << endl;
   };
 
   zmq::context_t context(1);
@@ -226,6 +230,10 @@ int main(int argc, char **argv) {
       } else if (arg == "-c" || arg == "--control-address") {
         if (i + 1 < argc && argv[i + 1][0] != '-')
           controlAddress = argv[++i];
+      } else if (arg == "-w" || arg == "--workers") {
+        noOfWorkers = max(1u, thread::hardware_concurrency());
+        if (i + 1 < argc && argv[i + 1][0] != '-')
+          noOfWorkers = size_t(max(1, stoi(argv[++i])));
       } else if (arg == "-h" || arg == "--help")
         printHelp(), exit(0);
       else if (arg == "-v" || arg == "--version")
@@ -246,7 +254,7 @@ int main(int argc, char **argv) {
 
     addresses[Control] = {Subscribe, vector<string>{controlAddress}, monica::connect};
 
-    serveZmqMonicaFull(&context, addresses);
+    serveZmqMonicaWorkerPool(&context, addresses, noOfWorkers);
 
     debug() << "stopped ZeroMQ MONICA server" << endl;
   }
@@ -15,6 +15,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include "run-monica-capnp.h"
 
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -27,6 +28,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "run-monica.h"
 #include "climate/climate-file-io.h"
 #include "capnp-helper.h"
+#include "../io/columnar-format.h"
 #include "common/sole.hpp"
 
 #include "common.capnp.h"
@@ -58,10 +60,8 @@ kj::Promise<void> RunMonica::info(InfoContext context) //override
   return kj::READY_NOW;
 }
 
-kj::Promise<void> RunMonica::run(RunContext context)
+kj::Promise<Output> RunMonica::runEnv(mas::schema::model::Env<mas::schema::common::StructuredText>::Reader envR)
 {
-  auto envR = context.getParams().getEnv();
-
   auto runMonica =
     [envR, this](const DataAccessor& da = DataAccessor(), J11Array soilLayers = J11Array()) mutable {
     std::string err;
@@ -152,8 +152,14 @@ kj::Promise<void> RunMonica::run(RunContext context)
     proms.add(kj::READY_NOW);
   }
 
-  return kj::joinPromises(proms.finish()).then([context, runMonica, this]() mutable {
-    auto out = runMonica(_da, _soilLayers);
+  return kj::joinPromises(proms.finish()).then([runMonica, this]() mutable {
+    return runMonica(_da, _soilLayers);
+  });
+}
+
+kj::Promise<void> RunMonica::run(RunContext context)
+{
+  return runEnv(context.getParams().getEnv()).then([context](Output&& out) mutable {
     auto rs = context.getResults();
     auto res = rs.initResult();
     res.initStructure().setJson();
@@ -167,6 +173,32 @@ kj::Promise<void> RunMonica::run(RunContext context)
   });
 }
 
+kj::Promise<void> RunMonica::runColumnar(RunColumnarContext context)
+{
+  auto setColumnarOutput = [context](const Output& out) mutable {
+    std::ostringstream oss;
+    writeColumnarOutput(oss, out);
+    auto bytes = oss.str();
+    context.getResults().setOutput(kj::arrayPtr(reinterpret_cast<const capnp::byte*>(bytes.data()), bytes.size()));
+  };
+  return runEnv(context.getParams().getEnv()).then(setColumnarOutput, [setColumnarOutput](auto &&e) mutable {
+    KJ_LOG(INFO, "Error while trying to gather soil and/or time series data: ", e);
+    // the error ends up in the footer of the columnar file
+    setColumnarOutput(Output(kj::str("Error while trying to gather soil and/or time series data: ", e).cStr()));
+  });
+}
+
+kj::Promise<void> RunMonica::runTyped(RunTypedContext context)
+{
+  auto setTypedOutput = [context](const Output& out) mutable {
+    toCapnpOutput(out, context.getResults().initOutput());
+  };
+  return runEnv(context.getParams().getEnv()).then(setTypedOutput, [setTypedOutput](auto &&e) mutable {
+    KJ_LOG(INFO, "Error while trying to gather soil and/or time series data: ", e);
+    setTypedOutput(Output(kj::str("Error while trying to gather soil and/or time series data: ", e).cStr()));
+  });
+}
+
 /*
 kj::Promise<void> RunMonica::stop(StopContext context) //override
 {
@@ -28,12 +28,16 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "model.capnp.h"
 #include "common.capnp.h"
 #include "persistence.capnp.h"
+#include "monica-output.capnp.h"
+
+#include "../io/output.h"
 
 namespace monica {
 
 typedef mas::schema::model::EnvInstance<mas::schema::common::StructuredText, mas::schema::common::StructuredText> MonicaEnvInstance;
 
-class RunMonica final : public MonicaEnvInstance::Server {
+//! serves runs as MonicaEnvInstance (JSON text) and via the extra methods of schema::TypedEnvInstance
+class RunMonica final : public schema::TypedEnvInstance::Server {
 public:
   explicit RunMonica(bool startedServerInDebugMode = false, mas::infrastructure::common::Restorer *restorer = nullptr);
 
@@ -60,6 +64,10 @@ public:
 
   kj::Promise<void> run(RunContext context) override;
 
+  kj::Promise<void> runColumnar(RunColumnarContext context) override;
+
+  kj::Promise<void> runTyped(RunTypedContext context) override;
+
   //kj::Promise<void> stop(StopContext context) override;
 
   //save @0 () -> (sturdyRef :Text, unsaveSR :Text);
@@ -68,6 +76,10 @@ public:
   void setRestorer(mas::infrastructure::common::Restorer *restorer) { _restorer = restorer; }
 
 private:
+  //! gather the time series and soil profile of the env, then run it
+  //! (the reader has to stay valid until the promise resolves, e.g. by keeping the call context)
+  kj::Promise<Output> runEnv(mas::schema::model::Env<mas::schema::common::StructuredText>::Reader envR);
+
   // Implementation of the Model::Instance Cap'n Proto interface
   bool _startedServerInDebugMode{false};
   kj::String _id, _name, _description;
@@ -23,6 +23,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include <sstream>
 #include <mutex>
 #include <memory>
+#include <memory_resource>
 #include <chrono>
 #include <thread>
 #include <tuple>
@@ -41,6 +42,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "json11/json11-helper.h"
 #include "tools/algorithms.h"
 #include "../io/build-output.h"
+#include "../io/expression.h"
 #include "../core/crop-module.h"
 
 using namespace monica;
@@ -311,22 +313,37 @@ Tools::Errors Spec::merge(json11::Json j) {
   //init(to, j, "to");
   //Maybe<DMY> dummy;
   //init(dummy, j, "while");
-  startf = createExpressionFunc(j["start"]);
-  endf = createExpressionFunc(j["end"]);
-  atf = createExpressionFunc(j["at"]);
-  fromf = createExpressionFunc(j["from"]);
-  tof = createExpressionFunc(j["to"]);
-  whilef = createExpressionFunc(j["while"]);
+  Errors res;
+  startf = createExpressionFunc(j["start"], &res);
+  endf = createExpressionFunc(j["end"], &res);
+  atf = createExpressionFunc(j["at"], &res);
+  fromf = createExpressionFunc(j["from"], &res);
+  tof = createExpressionFunc(j["to"], &res);
+  whilef = createExpressionFunc(j["while"], &res);
 
-  return {};
+  return res;
 }
 
-std::function<bool(const MonicaModel &)> Spec::createExpressionFunc(Json j) {
+std::function<bool(const MonicaModel &)> Spec::createExpressionFunc(Json j, Errors* errors) {
   //is an expression event
   if (j.is_array()) {
     if (auto f = buildCompareExpression(j.array_items())) return f;
   } else if (j.is_string()) {
     auto jts = j.string_value();
+    //is a compiled expression, e.g. "=Stage >= 3 && Mois[1] < 0.2"
+    if (!jts.empty() && jts[0] == '=') {
+      auto res = Expression::compile(jts.substr(1));
+      if (res.success()) {
+        auto e = res.result;
+        return [e](const MonicaModel &monica) { return e->isTrue(monica); };
+      }
+      for (const auto &err: res.errors) {
+        auto msg = "Condition '" + jts + "': " + err;
+        if (errors) errors->errors.push_back(msg);
+        else cerr << "Error: " << msg << endl;
+      }
+      return {};
+    }
     if (!jts.empty()) {
       auto s = splitString(jts, "-");
       //is date event
@@ -368,13 +385,12 @@ std::function<bool(const MonicaModel &)> Spec::createExpressionFunc(Json j) {
 void storeResults(const vector<OId> &outputIds,
                   vector<J11Array> &results,
                   const MonicaModel &monica) {
-  const auto &ofs = buildOutputTable().ofs;
+  const auto &bot = buildOutputTable();
 
   size_t i = 0;
   results.resize(outputIds.size());
   for (auto oid: outputIds) {
-    auto ofi = ofs.find(oid.id);
-    if (ofi != ofs.end()) results[i].push_back(ofi->second(monica, oid));
+    if (auto of = bot.outputFunc(oid.id)) results[i].push_back((*of)(monica, oid));
     ++i;
   }
 };
@@ -382,74 +398,68 @@ void storeResults(const vector<OId> &outputIds,
 void storeResultsObj(const vector<OId> &outputIds,
                      vector<J11Object> &results,
                      const MonicaModel &monica) {
-  const auto &ofs = buildOutputTable().ofs;
+  const auto &bot = buildOutputTable();
 
   J11Object result;
   for (auto oid: outputIds) {
-    auto ofi = ofs.find(oid.id);
-    if (ofi != ofs.end()) result[oid.outputName()] = ofi->second(monica, oid);
+    if (auto of = bot.outputFunc(oid.id)) result[oid.outputName()] = (*of)(monica, oid);
   }
   results.push_back(result);
 };
 
 
+void aggregateResultsInPlace(const vector<OId> &outputIds,
+                             vector<OIdAggregator> &aggregators,
+                             const MonicaModel &monica) {
+  const auto &bot = buildOutputTable();
+
+  if (aggregators.empty()) {
+    aggregators.reserve(outputIds.size());
+    for (const auto &oid: outputIds) aggregators.emplace_back(oid.timeAggOp);
+  }
+
+  // per layer outputs go to the aggregators as doubles, without json11 values in between
+  thread_local vector<double> layerValues;
+  size_t i = 0;
+  for (const auto &oid: outputIds) {
+    if (auto lo = bot.layerOutput(oid.id)) {
+      layerOutputValues(*lo, monica, oid, layerValues);
+      if (oid.layerAggOp == OId::NONE) aggregators[i].add(layerValues);
+      else aggregators[i].add(layerValues.front());
+    } else if (auto of = bot.outputFunc(oid.id)) aggregators[i].add((*of)(monica, oid));
+    ++i;
+  }
+}
+
 void StoreData::aggregateResults() {
-  if (!intermediateResults.empty()) {
-    if (results.size() < intermediateResults.size()) {
-      results.resize(intermediateResults.size());
+  if (!aggregators.empty()) {
+    if (results.size() < aggregators.size()) {
+      results.resize(aggregators.size());
     }
 
-    assert(intermediateResults.size() == outputIds.size());
-
-    size_t i = 0;
-    for (auto oid: outputIds) {
-      auto &ivs = intermediateResults.at(i);
-      if (!ivs.empty()) {
-        if (ivs.front().is_string()) {
-          switch (oid.timeAggOp) {
-            case OId::FIRST:
-              results[i].push_back(ivs.front());
-              break;
-            case OId::LAST:
-              results[i].push_back(ivs.back());
-              break;
-            default:
-              results[i].push_back(ivs.front());
-          }
-        } else results[i].push_back(applyOIdOP(oid.timeAggOp, ivs));
+    assert(aggregators.size() == outputIds.size());
 
-        intermediateResults[i].clear();
+    for (size_t i = 0; i < aggregators.size(); ++i) {
+      auto &agg = aggregators[i];
+      if (!agg.empty()) {
+        results[i].push_back(agg.value());
+        agg.reset();
       }
-      ++i;
     }
   }
 }
 
 void StoreData::aggregateResultsObj() {
-  if (!intermediateResults.empty()) {
-    assert(intermediateResults.size() == outputIds.size());
+  if (!aggregators.empty()) {
+    assert(aggregators.size() == outputIds.size());
 
     J11Object result;
-    size_t i = 0;
-    for (auto oid: outputIds) {
-      auto &ivs = intermediateResults.at(i);
-      if (!ivs.empty()) {
-        if (ivs.front().is_string()) {
-          switch (oid.timeAggOp) {
-            case OId::FIRST:
-              result[oid.outputName()] = ivs.front();
-              break;
-            case OId::LAST:
-              result[oid.outputName()] = ivs.back();
-              break;
-            default:
-              result[oid.outputName()] = ivs.front();
-          }
-        } else result[oid.outputName()] = applyOIdOP(oid.timeAggOp, ivs);
-
-        intermediateResults[i].clear();
+    for (size_t i = 0; i < aggregators.size(); ++i) {
+      auto &agg = aggregators[i];
+      if (!agg.empty()) {
+        result[outputIds[i].outputName()] = agg.value();
+        agg.reset();
       }
-      ++i;
     }
     resultsObj.push_back(result);
   }
@@ -488,8 +498,8 @@ void StoreData::storeResultsIfSpecApplies(const MonicaModel &monica, bool storeO
         // but aggregate only if the range is left
         // this means the range specifies the extend of recording
         if (spec.whilef) {
-          if (spec.whilef(monica)) storeResults(outputIds, intermediateResults, monica);
-        } else storeResults(outputIds, intermediateResults, monica);
+          if (spec.whilef(monica)) aggregateResultsInPlace(outputIds, aggregators, monica);
+        } else aggregateResultsInPlace(outputIds, aggregators, monica);
 
         if (isCurrentlyToEvent) {
           if (storeObjOutputs) aggregateResultsObj();
@@ -500,8 +510,8 @@ void StoreData::storeResultsIfSpecApplies(const MonicaModel &monica, bool storeO
     }
       //or a single while aggregating expression
     else if (spec.whilef) {
-      if (spec.whilef(monica)) storeResults(outputIds, intermediateResults, monica);
-      else if (!intermediateResults.empty() && !intermediateResults.front().empty()) {
+      if (spec.whilef(monica)) aggregateResultsInPlace(outputIds, aggregators, monica);
+      else if (!aggregators.empty() && !aggregators.front().empty()) {
         //if while event was not successful but we got intermediate results, they should be aggregated
         if (storeObjOutputs) aggregateResultsObj();
         else aggregateResults();
@@ -512,7 +522,8 @@ void StoreData::storeResultsIfSpecApplies(const MonicaModel &monica, bool storeO
   if (isCurrentlyEndEvent) withinEventStartEndRange = false;
 }
 
-vector<StoreData> monica::setupStorage(const json11::Json& event2oids, const Date& startDate, const Date& endDate) {
+vector<StoreData> monica::setupStorage(const json11::Json& event2oids, const Date& startDate, const Date& endDate,
+                                       Errors* errors) {
   map<string, Json> shortcuts =
       {{"daily",   J11Object{{"at", "xxxx-xx-xx"}}},
        {"monthly", J11Object{{"from", "xxxx-xx-01"},
@@ -561,8 +572,13 @@ vector<StoreData> monica::setupStorage(const json11::Json& event2oids, const Dat
       spec = o;
     }
 
-    sd.spec.merge(spec);
-    sd.outputIds = parseOutputIds(e2os[i + 1].array_items());
+    Errors es = sd.spec.merge(spec);
+    sd.outputIds = parseOutputIds(e2os[i + 1].array_items(), &es);
+    for (const auto& err : es.errors) {
+      auto msg = "Output section " + sd.spec.origSpec.dump() + ": " + err;
+      if (errors) errors->errors.push_back(msg);
+      else cerr << "Error: " << msg << endl;
+    }
 
     storeData.push_back(sd);
   }
@@ -576,7 +592,8 @@ struct DFSRes {
   uint16_t cmitPos{0};
 };
 
-DFSRes deserializeFullState(kj::Own<const kj::ReadableFile> file, bool serializedMonicaStateIsJson) {
+DFSRes deserializeFullState(kj::Own<const kj::ReadableFile> file, bool serializedMonicaStateIsJson,
+                            std::pmr::memory_resource* mr) {
   DFSRes res;
   auto allBytes = file->readAllBytes();
   if (serializedMonicaStateIsJson) {
@@ -585,17 +602,23 @@ DFSRes deserializeFullState(kj::Own<const kj::ReadableFile> file, bool serialize
     auto runtimeStateBuilder = msg.initRoot<mas::schema::model::monica::RuntimeState>();
     json.decode(allBytes.asChars(), runtimeStateBuilder);
     auto runtimeState = runtimeStateBuilder.asReader();
-    res.monica = kj::heap<MonicaModel>(runtimeState.getModelState());
+    res.monica = kj::heap<MonicaModel>(runtimeState.getModelState(), mr);
   } else {
     kj::ArrayInputStream ais(allBytes);
     capnp::InputStreamMessageReader message(ais);
     auto runtimeState = message.getRoot<mas::schema::model::monica::RuntimeState>();
-    res.monica = kj::heap<MonicaModel>(runtimeState.getModelState());
+    res.monica = kj::heap<MonicaModel>(runtimeState.getModelState(), mr);
   }
   return res;
 }
 
-std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
+std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC, std::pmr::memory_resource* mr, bool perRunPool) {
+  // all per run allocations of the models are served from this pool and released in one go at the end of the run,
+  // the pool is not synchronized, so concurrent runs don't contend in the global allocator
+  if (!mr) mr = std::pmr::get_default_resource();
+  std::pmr::unsynchronized_pool_resource runPool(mr);
+  auto runMR = perRunPool ? &runPool : mr;
+
   Output out, out2;
   bool returnObjOutputs = env.returnObjOutputs();
   out.customId = env.customId;
@@ -624,10 +647,11 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
                 ? fs->getRoot().openFile(fs->getCurrentPath().eval(pathToSerFile))
                 : fs->getRoot().openFile(kj::Path::parse(pathToSerFile));
 
-    auto dserRes = deserializeFullState(kj::mv(file), env.params.simulationParameters.deserializedMonicaStateFromJson);
+    auto dserRes = deserializeFullState(kj::mv(file), env.params.simulationParameters.deserializedMonicaStateFromJson,
+                                        runMR);
     monica = kj::mv(dserRes.monica);
   } else {
-    monica = kj::heap<MonicaModel>(env.params);
+    monica = kj::heap<MonicaModel>(env.params, runMR);
     monica->simulationParametersNC().startDate = env.climateData.startDate();
   }
   bool isSyncIC = false;
@@ -635,7 +659,7 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
     monica->setIntercropping(env.ic);
     isSyncIC = !monica->intercropping().isAsync();
     if (isSyncIC) {
-      monica2 = kj::heap<MonicaModel>(env.params);
+      monica2 = kj::heap<MonicaModel>(env.params, runMR);
       monica2->simulationParametersNC().startDate = env.climateData.startDate();
     }
   }
@@ -652,19 +676,21 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
 
   // create a way for worksteps to let the runtime calculate at a daily basis things a workstep needs when being executed
   // e.g. to actually accumulate values from days before the workstep (for calculating a moving window of past values)
+  // the values are kept just for the window the workstep asked for, so memory and work per day stay constant
   int dailyFuncId = 0, dailyFuncId2 = 0;
-  map<int, vector<double>> dailyValues, dailyValues2;
+  map<int, DailyValuesWindow> dailyValues, dailyValues2;
   vector<function<void()>> applyDailyFuncs, applyDailyFuncs2;
 
   //iterate through all the worksteps in the croprotation(s) and check for functions which have to run daily
   for (auto &cr: env.cropRotations) {
     for (auto &cm: cr.cropRotation) {
       for (auto wsptr: cm.getWorksteps()) {
-        auto df = wsptr->registerDailyFunction(
-            [&dailyValues, dailyFuncId]() -> vector<double> & { return dailyValues[dailyFuncId]; });
+        auto df = wsptr->registerDailyFunction([&dailyValues, dailyFuncId](size_t windowSize) -> DailyValuesWindow & {
+          return dailyValues[dailyFuncId] = DailyValuesWindow(windowSize);
+        });
         if (df) {
-          applyDailyFuncs.push_back(
-              [&monica, df, dailyFuncId, &dailyValues] { dailyValues[dailyFuncId].push_back(df(monica.get())); });
+          auto &dvs = dailyValues[dailyFuncId];
+          applyDailyFuncs.push_back([&monica, df, &dvs] { dvs.push(df(monica.get())); });
         }
         dailyFuncId++;
       }
@@ -674,13 +700,12 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
     for (auto &cr: env.cropRotations2) {
       for (auto &cm: cr.cropRotation) {
         for (auto wsptr: cm.getWorksteps()) {
-          auto df = wsptr->registerDailyFunction([&dailyValues2, dailyFuncId2]() -> vector<double> & {
-            return dailyValues2[dailyFuncId2];
+          auto df = wsptr->registerDailyFunction([&dailyValues2, dailyFuncId2](size_t windowSize) -> DailyValuesWindow & {
+            return dailyValues2[dailyFuncId2] = DailyValuesWindow(windowSize);
           });
           if (df) {
-            applyDailyFuncs2.push_back([&monica2, df, dailyFuncId2, &dailyValues2] {
-              dailyValues2[dailyFuncId2].push_back(df(monica2.get()));
-            });
+            auto &dvs = dailyValues2[dailyFuncId2];
+            applyDailyFuncs2.push_back([&monica2, df, &dvs] { dvs.push(df(monica2.get())); });
           }
           dailyFuncId2++;
         }
@@ -813,9 +838,44 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
   //while (cmitPos-- > 0 && cmit + 1 != cropRotation.end())
   //	tie(currentCM, nextAbsoluteCMApplicationDate) = findNextCultivationMethod(currentDate, true);;
 
-  vector<StoreData> store = setupStorage(env.events, env.climateData.startDate(), env.climateData.endDate());
+  // broken conditions or derived outputs would otherwise silently never match or be missing from the output
+  Errors storageErrors, storageErrors2;
+  vector<StoreData> store = setupStorage(env.events, env.climateData.startDate(), env.climateData.endDate(),
+                                         &storageErrors);
+  out.errors = storageErrors.errors;
   vector<StoreData> store2;
-  if (isSyncIC) store2 = setupStorage(env.events2, env.climateData.startDate(), env.climateData.endDate());
+  if (isSyncIC) {
+    store2 = setupStorage(env.events2, env.climateData.startDate(), env.climateData.endDate(), &storageErrors2);
+    out2.errors = storageErrors2.errors;
+  }
+
+  // the results outlive the run, so they can't come from the run's pool, but the daily ones get a value every step
+  // and can be sized once up front instead of growing day by day
+  auto reserveDailyResults = [&](vector<StoreData>& sds) {
+    auto nods = env.climateData.noOfStepsPossible();
+    for (auto& sd : sds) {
+      auto spec = sd.spec.origSpec.string_value();
+      if (spec != "daily" && spec != "xxxx-xx-xx") continue;
+      if (returnObjOutputs) sd.resultsObj.reserve(nods);
+      else {
+        sd.results.resize(sd.outputIds.size());
+        for (auto& r : sd.results) r.reserve(nods);
+      }
+    }
+  };
+  reserveDailyResults(store);
+  if (isSyncIC) reserveDailyResults(store2);
+
+  // skip the purely diagnostic calculations nobody asked for, either as output or in a workstep condition,
+  // but not if the state is saved, as it has to contain the running sums (e.g. of the N2O production)
+  auto requiredDiagnosticsOf = [&](const Json& events, const vector<CropRotation>& cropRotations) {
+    if (env.params.simulationParameters.serializeMonicaStateAtEnd) return Diagnostics();
+    J11Array sources{events};
+    for (const auto& cr : cropRotations) sources.push_back(cr.to_json());
+    return requiredDiagnostics(sources);
+  };
+  monica->setDiagnostics(requiredDiagnosticsOf(env.events, env.cropRotations));
+  if (isSyncIC) monica2->setDiagnostics(requiredDiagnosticsOf(env.events2, env.cropRotations2));
 
   monica->addEvent("run-started");
   if (isSyncIC) monica2->addEvent("run-started");
@@ -989,14 +1049,14 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
     //aggregate results of while events or unfinished other from/to ranges (where to event didn't happen yet)
     if (returnObjOutputs) sd.aggregateResultsObj();
     else sd.aggregateResults();
-    out.data.push_back({sd.spec.origSpec.dump(), sd.outputIds, sd.results, sd.resultsObj});
+    out.data.push_back({sd.spec.origSpec.dump(), sd.outputIds, kj::mv(sd.results), kj::mv(sd.resultsObj)});
   }
   if (isSyncIC) {
     for (auto &sd: store2) {
       //aggregate results of while events or unfinished other from/to ranges (where to event didn't happen yet)
       if (returnObjOutputs) sd.aggregateResultsObj();
       else sd.aggregateResults();
-      out2.data.push_back({sd.spec.origSpec.dump(), sd.outputIds, sd.results, sd.resultsObj});
+      out2.data.push_back({sd.spec.origSpec.dump(), sd.outputIds, kj::mv(sd.results), kj::mv(sd.resultsObj)});
     }
   }
 
@@ -1009,4 +1069,6 @@ std::pair<Output, Output> monica::runMonicaIC(Env env, bool isIC) {
   return make_pair(out, out2);
 }
 
-Output monica::runMonica(Env env) { return runMonicaIC(kj::mv(env), false).first; }
+Output monica::runMonica(Env env, std::pmr::memory_resource* mr, bool perRunPool) {
+  return runMonicaIC(kj::mv(env), false, mr, perRunPool).first;
+}
@@ -19,6 +19,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include <ostream>
 #include <vector>
+#include <memory_resource>
 
 #include "json11/json11.hpp"
 
@@ -28,6 +29,7 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 #include "cultivation-method.h"
 #include "climate/climate-common.h"
 #include "../io/output.h"
+#include "../io/build-output.h"
 
 namespace monica
 {
@@ -61,6 +63,10 @@ struct DLL_API Env : public Tools::Json11Serializable {
   bool returnObjOutputs() const { return outputs["obj-outputs?"].bool_value(); }
   // is the output as a list (e.g. days) of an object (holding all the requested data)
 
+  bool returnColumnarOutputs() const { return outputs["format"].string_value() == "columnar"; }
+  // should the output be returned in the columnar binary format (see columnar-format.h) instead of JSON
+  // (the capnp service returns it from TypedEnvInstance.runColumnar, see monica-output.capnp)
+
   //! object holding the climate data
   Climate::DataAccessor climateData;
   // 1. priority, object holding the climate data
@@ -76,6 +82,8 @@ struct DLL_API Env : public Tools::Json11Serializable {
 
   std::vector<CultivationMethod> cropRotation, cropRotation2;
   // vector of elements holding the data of the single crops in the rotation
+  // (copies of an Env share the worksteps (WSPtr), which keep state during a run, so concurrent runs need
+  // independently created Envs, e.g. merged from the same json)
 
   std::vector<CropRotation> cropRotations, cropRotations2;
   // optionally
@@ -111,7 +119,8 @@ struct Spec : public Tools::Json11Serializable {
 
   Tools::Errors merge(json11::Json j) override;
 
-  static std::function<bool(const MonicaModel&)> createExpressionFunc(json11::Json j);
+  //! errors of conditions which don't compile are appended to errors (or printed to cerr if null)
+  static std::function<bool(const MonicaModel&)> createExpressionFunc(json11::Json j, Tools::Errors* errors = nullptr);
 
   json11::Json to_json() const override { return origSpec; }
 
@@ -134,17 +143,24 @@ struct StoreData {
   Tools::Maybe<bool> withinEventFromToRange;
   Spec spec;
   std::vector<OId> outputIds;
-  std::vector<Tools::J11Array> intermediateResults;
+  //! one aggregator per output id, accumulating the values of the current aggregation period
+  std::vector<OIdAggregator> aggregators;
   std::vector<Tools::J11Array> results;
   std::vector<Tools::J11Object> resultsObj;
 };
 
-std::vector<StoreData> setupStorage(const json11::Json& event2oids, const Tools::Date& startDate, const Tools::Date& endDate);
+//! errors in the output sections (conditions or derived outputs which don't compile) are appended to errors
+//! or printed to cerr if errors is null
+std::vector<StoreData> setupStorage(const json11::Json& event2oids, const Tools::Date& startDate, const Tools::Date& endDate,
+                                    Tools::Errors* errors = nullptr);
 
 //! main function for running monica under a given Env(ironment)
 //! @param env the environment completely defining what the model needs and gets
+//! @param mr optional upstream memory resource for the per run pool the models allocate from
+//! @param perRunPool if false, the models allocate directly from mr (or the default resource), e.g. for comparisons
 //! @return a structure with all the Monica results
-DLL_API std::pair<Output, Output> runMonicaIC(Env env, bool isIntercropping = true);
-DLL_API Output runMonica(Env env);
+DLL_API std::pair<Output, Output> runMonicaIC(Env env, bool isIntercropping = true,
+                                              std::pmr::memory_resource* mr = nullptr, bool perRunPool = true);
+DLL_API Output runMonica(Env env, std::pmr::memory_resource* mr = nullptr, bool perRunPool = true);
   
 } // namespace monica
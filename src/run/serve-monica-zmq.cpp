@@ -17,14 +17,20 @@ Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
 
 #include <iostream>
 #include <algorithm>
+#include <cstring>
+#include <functional>
 #include <map>
 #include <mutex>
+#include <thread>
 #include <tuple>
+#include <sstream>
 
 #include "zeromq/zmq-helper.h"
 #include "cultivation-method.h"
 #include "tools/debug.h"
 #include "run-monica.h"
+#include "../io/columnar-format.h"
+#include "../io/ensemble-reduction.h"
 #include "climate/climate-file-io.h"
 
 #ifdef INCLUDE_SR_SUPPORT
@@ -380,6 +386,30 @@ void Monica::ZmqServer::startZeroMQMonica(zmq::context_t* zmqContext,
 }
 */
 
+namespace {
+
+//! apply the JSON merge patch (RFC 7396) to base: objects are merged recursively, null members of the patch
+//! delete the member in base, everything else is replaced by the patch
+Json mergePatch(const Json& base, const Json& patch) {
+  if (!patch.is_object()) return patch;
+
+  auto merged = base.is_object() ? base.object_items() : J11Object();
+  for (const auto& p : patch.object_items()) {
+    if (p.second.is_null()) merged.erase(p.first);
+    else merged[p.first] = mergePatch(base[p.first], p.second);
+  }
+  return merged;
+}
+
+//! the KA5 texture class tables are read once per process and shared by all jobs (and workers)
+const std::function<Errors(Soil::SoilParameters*)>& ka5PwpFcSatFunction() {
+  static const auto f = Soil::getInitializedUpdateUnsetPwpFcSatfromKA5textureClassFunction(
+      fixSystemSeparator(replaceEnvVars("${MONICA_PARAMETERS}/soil/")));
+  return f;
+}
+
+} // namespace
+
 void monica::serveZmqMonicaFull(zmq::context_t *zmqContext,
                                            map<SocketRole, SocketConfig> socketAddresses) {
 #ifdef INCLUDE_SR_SUPPORT
@@ -401,6 +431,8 @@ void monica::serveZmqMonicaFull(zmq::context_t *zmqContext,
   int receiveSocketType = ZMQ_REP;
   if (rconfig.type == Pull) receiveSocketType = ZMQ_PULL;
   zmq::socket_t socket(*zmqContext, receiveSocketType);
+  bool isSequenced = rconfig.type == Pull && rconfig.sequenced;
+  if (rconfig.receiveHwm > 0) socket.setsockopt(ZMQ_RCVHWM, rconfig.receiveHwm);
 
   try {
     debug() << "MONICA: " << (rconfig.op == bind ? "binding" : "connecting")
@@ -443,7 +475,7 @@ void monica::serveZmqMonicaFull(zmq::context_t *zmqContext,
         int topicCharCount = 0;
         if (distinctControlSocket) {
           auto topic = "finish";
-          topicCharCount = sizeof(topic);
+          topicCharCount = int(strlen(topic));
           for (const auto& address: cAddresses)
             cconfig.op == bind ? controlSocket.bind(address) : controlSocket.connect(address);
           controlSocket.setsockopt(ZMQ_SUBSCRIBE, topic, topicCharCount);
@@ -452,9 +484,19 @@ void monica::serveZmqMonicaFull(zmq::context_t *zmqContext,
         while (true) {
           try {
             Msg msg;
+            string seq; // the sequence number frame of a sequenced job, sent back in front of the reply
+            bool isRequest = false; // a REP socket has to reply to the request it received
             zmq::poll(&items[0], distinctControlSocket ? 2 : 1, -1);
 
-            if (items[0].revents & ZMQ_POLLIN) msg = receiveMsg(socket);
+            if (items[0].revents & ZMQ_POLLIN) {
+              if (isSequenced) {
+                zmq::message_t seqPart;
+                socket.recv(&seqPart);
+                seq.assign(static_cast<const char*>(seqPart.data()), seqPart.size());
+              }
+              msg = receiveMsg(socket);
+              isRequest = receiveSocketType == ZMQ_REP;
+            }
             if (distinctControlSocket && items[1].revents & ZMQ_POLLIN) {
               msg = receiveMsg(controlSocket, topicCharCount);
             }
@@ -463,8 +505,18 @@ void monica::serveZmqMonicaFull(zmq::context_t *zmqContext,
 
             string msgType = msg.type();
             if (msgType == "finish") {
+              //a sequenced job gets at least its sequence number back, else the replies after it would wait for it
+              if (!seq.empty()) {
+                try {
+                  s_send(sendSocket, seq);
+                } catch (const zmq::error_t &e) {
+                  cerr << "Exception on trying to pass on the sequence number of a 'finish' job! Error: ["
+                       << e.what() << "]" << endl;
+                }
+              }
               //only send reply when not in pipeline configuration
-              if (rconfig.type != Pull) {
+              //(a REP socket can't send an 'ack' to a 'finish' from the control socket without pending request)
+              if (rconfig.type != Pull && (distinctSendSocket || isRequest)) {
                 J11Object resultMsg;
                 resultMsg["type"] = "ack";
                 try {
@@ -488,98 +540,139 @@ void monica::serveZmqMonicaFull(zmq::context_t *zmqContext,
 
               break;
             } else if (msgType == "Env") {
-              Env env;
-              auto sharedId = env.sharedId;
+              string sharedId;
               monica::Output out, out2;
               auto customId = msg.json["customId"];
-              out.customId = customId;
-              out2.customId = customId;
               bool isNoDataPassThrough = customId.is_object() && customId["nodata"].bool_value();
               bool isIC = msg.json["params"]["userCropParameters"]["intercropping"]["is_intercropping"].bool_value();
-              if (isNoDataPassThrough) {
-                debug() << "nodata pass through -> customId: " << customId.dump() << endl;
-              } else {
-                auto pathToSoilDir = fixSystemSeparator(replaceEnvVars("${MONICA_PARAMETERS}/soil/"));
-                env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Wessolek2009"] = Soil::getInitializedUpdateUnsetPwpFcSatfromKA5textureClassFunction(pathToSoilDir);
-                env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchten"] = Soil::updateUnsetPwpFcSatFromVanGenuchten;
-                env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Toth"] = Soil::updateUnsetPwpFcSatFromToth;
-
-                auto errors = env.merge(msg.json);
-                if(errors.success()) {
-                  EResult<DataAccessor> eda;
-                  try {
-                    if (!env.climateData.isValid()) {
-                      if (!env.climateCSV.empty()) {
-                        eda = readClimateDataFromCSVStringViaHeaders(env.climateCSV, env.csvViaHeaderOptions);
-                      } else if (!env.pathsToClimateCSV.empty()) {
-                        eda = readClimateDataFromCSVFilesViaHeaders(env.pathsToClimateCSV, env.csvViaHeaderOptions);
-
-#ifdef INCLUDE_SR_SUPPORT
-                        Climate::DataAccessor finalDA = kj::mv(eda.result);
-                        for (const auto &sr: env.pathsToClimateCSV) {
-                          if (sr.find("capnp://") == 0) {
-                            auto ts = conMan.tryConnectB(sr).castAs<mas::schema::climate::TimeSeries>();
-                            auto da = dataAccessorFromTimeSeries(ts).wait(ioContext.waitScope);
-                            if (!finalDA.isValid()) {
-                              finalDA = kj::mv(da);
-                            } else {
-                              finalDA.mergeClimateData(kj::mv(da), true);
+              bool returnColumnarOutputs = false;
+
+              auto runEnv = [&](const Json& envJson, monica::Output& out, monica::Output& out2) {
+                Env env;
+                sharedId = env.sharedId;
+                out.customId = customId;
+                out2.customId = customId;
+                if (isNoDataPassThrough) {
+                  debug() << "nodata pass through -> customId: " << customId.dump() << endl;
+                } else {
+                  env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Wessolek2009"] = ka5PwpFcSatFunction();
+                  env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchten"] = Soil::updateUnsetPwpFcSatFromVanGenuchten;
+                  env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Toth"] = Soil::updateUnsetPwpFcSatFromToth;
+
+                  auto errors = env.merge(envJson);
+                  returnColumnarOutputs = env.returnColumnarOutputs();
+                  if(errors.success()) {
+                    EResult<DataAccessor> eda;
+                    try {
+                      if (!env.climateData.isValid()) {
+                        if (!env.climateCSV.empty()) {
+                          eda = readClimateDataFromCSVStringViaHeaders(env.climateCSV, env.csvViaHeaderOptions);
+                        } else if (!env.pathsToClimateCSV.empty()) {
+                          eda = readClimateDataFromCSVFilesViaHeaders(env.pathsToClimateCSV, env.csvViaHeaderOptions);
+
+  #ifdef INCLUDE_SR_SUPPORT
+                          Climate::DataAccessor finalDA = kj::mv(eda.result);
+                          for (const auto &sr: env.pathsToClimateCSV) {
+                            if (sr.find("capnp://") == 0) {
+                              auto ts = conMan.tryConnectB(sr).castAs<mas::schema::climate::TimeSeries>();
+                              auto da = dataAccessorFromTimeSeries(ts).wait(ioContext.waitScope);
+                              if (!finalDA.isValid()) {
+                                finalDA = kj::mv(da);
+                              } else {
+                                finalDA.mergeClimateData(kj::mv(da), true);
+                              }
                             }
                           }
+                          eda.result = kj::mv(finalDA);
+  #endif
                         }
-                        eda.result = kj::mv(finalDA);
-#endif
                       }
-                    }
 
-#ifdef INCLUDE_SR_SUPPORT
-                    //no soil data have been loaded, but there might be a capnp sturdy ref
-                    string soilSR;
-                    if (msg.json["params"]["siteParameters"]["SoilProfileParameters"].is_string()) {
-                      soilSR = msg.json["params"]["siteParameters"]["SoilProfileParameters"].string_value();
-                    }
-                    if (!soilSR.empty()) {
-                      auto sp = conMan.tryConnectB(soilSR).castAs<mas::schema::soil::Profile>();
-                      auto soilpsj = fromCapnpSoilProfile(sp).wait(ioContext.waitScope);
-                      auto soilps = Soil::createSoilPMs(soilpsj);
-                      if (soilps.second.failure()) printPossibleErrors(soilps.second, activateDebug);
-                      else env.params.siteParameters.vs_SoilParameters = soilps.first;
-                    }
-#endif
+  #ifdef INCLUDE_SR_SUPPORT
+                      //no soil data have been loaded, but there might be a capnp sturdy ref
+                      string soilSR;
+                      if (envJson["params"]["siteParameters"]["SoilProfileParameters"].is_string()) {
+                        soilSR = envJson["params"]["siteParameters"]["SoilProfileParameters"].string_value();
+                      }
+                      if (!soilSR.empty()) {
+                        auto sp = conMan.tryConnectB(soilSR).castAs<mas::schema::soil::Profile>();
+                        auto soilpsj = fromCapnpSoilProfile(sp).wait(ioContext.waitScope);
+                        auto soilps = Soil::createSoilPMs(soilpsj);
+                        if (soilps.second.failure()) printPossibleErrors(soilps.second, activateDebug);
+                        else env.params.siteParameters.vs_SoilParameters = soilps.first;
+                      }
+  #endif
 
-                    if (eda.success()) {
-                      if (!env.climateData.isValid()) env.climateData = kj::mv(eda.result);
+                      if (eda.success()) {
+                        if (!env.climateData.isValid()) env.climateData = kj::mv(eda.result);
 
-                      env.debugMode = startedServerInDebugMode && env.debugMode;
+                        env.debugMode = startedServerInDebugMode && env.debugMode;
 
-                      env.params.userSoilMoistureParameters.getCapillaryRiseRate =
-                          [](const string &soilTexture, size_t distance) {
-                            return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
-                          };
+                        env.params.userSoilMoistureParameters.getCapillaryRiseRate =
+                            [](const string &soilTexture, size_t distance) {
+                              return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
+                            };
 
-                      //isIC = env.params.userCropParameters.isIntercropping;
-                      debug() << "running             -> customId: " << env.customId.dump() << endl;
-                      auto str = msg.json.dump();
-                      std::tie(out, out2) = runMonicaIC(kj::mv(env), isIC);
-                      //cout << "out: " << out.to_json().dump() << endl;
+                        //isIC = env.params.userCropParameters.isIntercropping;
+                        debug() << "running             -> customId: " << env.customId.dump() << endl;
+                        auto str = envJson.dump();
+                        std::tie(out, out2) = runMonicaIC(kj::mv(env), isIC);
+                        //cout << "out: " << out.to_json().dump() << endl;
+                      }
+                    } catch(std::exception& e) {
+                      eda.appendError(kj::str("Error while running MONICA: ", e.what()).cStr());
                     }
-                  } catch(std::exception& e) {
-                    eda.appendError(kj::str("Error while running MONICA: ", e.what()).cStr());
+                    out.errors = eda.errors;
+                    out.warnings = eda.warnings;
                   }
-                  out.errors = eda.errors;
-                  out.warnings = eda.warnings;
                 }
-              }
+              };
+
+              auto ensemble = msg.json["ensemble"];
+              if (!isNoDataPassThrough && ensemble["members"].is_array()) {
+                //"ensemble": {"members": [<patch>, ...], "stats": [...], "quantiles": [...]}
+                //run the members (the env patched by the member's JSON) and return just the reduced outputs
+                auto baseJson = msg.json.object_items();
+                baseJson.erase("ensemble");
+                EnsembleReducer reducer(ensemble), reducer2(ensemble);
+                for (const auto& patch : ensemble["members"].array_items()) {
+                  monica::Output mout, mout2;
+                  runEnv(mergePatch(baseJson, patch), mout, mout2);
+                  reducer.add(mout);
+                  if (isIC) reducer2.add(mout2);
+                }
+                out = reducer.result();
+                out.customId = customId;
+                if (isIC) {
+                  out2 = reducer2.result();
+                  out2.customId = customId;
+                }
+              } else runEnv(msg.json, out, out2);
 
               try {
+                if (!seq.empty()) s_sendmore(sendSocket, seq);
                 if (!sharedId.empty()) s_sendmore(distinctSendSocket ? sendSocket : socket, sharedId);
 
-                if (isIC) {
-                  auto outs = json11::Json(J11Object({{"1", out.to_json()},
-                                                      {"2", out2.to_json()}}));
-                  s_send(distinctSendSocket ? sendSocket : socket, outs.dump());
+                if (returnColumnarOutputs) {
+                  //the outputs of both intercropping crops are sent as two message parts
+                  ostringstream oss;
+                  writeColumnarOutput(oss, out);
+                  if (isIC) {
+                    s_sendmore(distinctSendSocket ? sendSocket : socket, oss.str());
+                    oss.str("");
+                    writeColumnarOutput(oss, out2);
+                  }
+                  s_send(distinctSendSocket ? sendSocket : socket, oss.str());
+                } else if (isIC) {
+                  // same as dumping {"1": out.to_json(), "2": out2.to_json()}
+                  string outs = "{\"1\": ";
+                  out.writeJson(outs);
+                  outs += ", \"2\": ";
+                  out2.writeJson(outs);
+                  outs += "}";
+                  s_send(distinctSendSocket ? sendSocket : socket, outs);
                 } else {
-                  s_send(distinctSendSocket ? sendSocket : socket, out.to_json().dump());
+                  s_send(distinctSendSocket ? sendSocket : socket, out.toString());
                 }
               } catch (const zmq::error_t &e) {
                 cerr << "Exception on trying to reply with result message on zmq socket with address: ";
@@ -592,6 +685,7 @@ void monica::serveZmqMonicaFull(zmq::context_t *zmqContext,
               debug() << "Error, original message was: " << msg.msg << endl;
 
               try {
+                if (!seq.empty()) s_sendmore(sendSocket, seq);
                 s_send(distinctSendSocket ? sendSocket : socket, Json(resultMsg).dump());
               } catch (const zmq::error_t& e) {
                 cerr
@@ -633,3 +727,295 @@ void monica::serveZmqMonicaFull(zmq::context_t *zmqContext,
 }
 
 
+
+namespace {
+
+const char* poolJobsAddress = "inproc://monica-pool-jobs";
+const char* poolResultsAddress = "inproc://monica-pool-results";
+const char* poolWorkersDoneAddress = "inproc://monica-pool-workers-done";
+const char* poolControlAddress = "inproc://monica-pool-control";
+
+//! forward the (multipart) messages already waiting on from to to, without blocking
+void forwardPendingMessages(zmq::socket_t& from, zmq::socket_t& to) {
+  zmq::message_t part;
+  while (from.recv(&part, ZMQ_DONTWAIT)) {
+    to.send(part, (from.getsockopt<int>(ZMQ_RCVMORE) ? ZMQ_SNDMORE : 0) | ZMQ_DONTWAIT);
+  }
+}
+
+//! zmq::proxy_steerable between from and to, running on its own thread until terminate() is called
+class SteerableProxy {
+public:
+  SteerableProxy(zmq::context_t* zmqContext, zmq::socket_t& from, zmq::socket_t& to, const string& steerAddress)
+      : _steer(*zmqContext, ZMQ_PAIR) {
+    _steer.bind(steerAddress);
+    _thread = thread([zmqContext, &from, &to, steerAddress]() {
+      zmq::socket_t control(*zmqContext, ZMQ_PAIR);
+      control.connect(steerAddress);
+      try {
+        zmq::proxy_steerable((void *) from, (void *) to, nullptr, (void *) control);
+      } catch (const zmq::error_t& e) {
+        cerr << "Proxy between MONICA worker pool sockets stopped! Error: [" << e.what() << "]" << endl;
+      }
+      control.setsockopt(ZMQ_LINGER, 0);
+    });
+  }
+
+  void terminate() {
+    s_send(_steer, "TERMINATE");
+    _thread.join();
+    _steer.setsockopt(ZMQ_LINGER, 0);
+    _steer.close();
+  }
+
+private:
+  zmq::socket_t _steer;
+  thread _thread;
+};
+
+//! in pipeline configuration the jobs are numbered in the order they arrive, the workers send the number back in
+//! front of their reply, so the replies can be sent on in the same order (the early ones wait for the missing ones)
+class PipelineSequencer {
+public:
+  PipelineSequencer(zmq::socket_t& frontend, zmq::socket_t& jobs, zmq::socket_t& results, zmq::socket_t& sendSocket)
+      : _frontend(frontend), _jobs(jobs), _results(results), _sendSocket(sendSocket) {}
+
+  //! pass on the next (multipart) job from the frontend to the workers, preceded by its sequence number
+  void forwardJob() {
+    auto seq = to_string(_nextJobSeq++);
+    _jobs.send(seq.data(), seq.size(), ZMQ_SNDMORE);
+    zmq::message_t part;
+    bool more = true;
+    while (more) {
+      _frontend.recv(&part);
+      more = _frontend.getsockopt<int>(ZMQ_RCVMORE) != 0;
+      _jobs.send(part, more ? ZMQ_SNDMORE : 0);
+    }
+  }
+
+  //! collect the replies waiting on the results socket and send on the ones which are next in order
+  void forwardReplies() {
+    zmq::message_t seqPart;
+    while (_results.recv(&seqPart, ZMQ_DONTWAIT)) {
+      auto seq = stoull(string(static_cast<const char*>(seqPart.data()), seqPart.size()));
+      auto& parts = _pendingReplies[seq];
+      while (_results.getsockopt<int>(ZMQ_RCVMORE)) {
+        parts.emplace_back();
+        _results.recv(&parts.back());
+      }
+    }
+    for (auto it = _pendingReplies.begin();
+         it != _pendingReplies.end() && it->first == _nextReplySeq;
+         it = _pendingReplies.erase(it)) {
+      send(it->second);
+      _nextReplySeq++;
+    }
+  }
+
+  //! send on all remaining replies, skipping the missing ones (of jobs dropped by finishing workers)
+  //! @return the number of missing replies
+  uint64_t flush() {
+    forwardReplies();
+    uint64_t missing = 0;
+    for (auto& p : _pendingReplies) {
+      missing += p.first - _nextReplySeq;
+      send(p.second);
+      _nextReplySeq = p.first + 1;
+    }
+    _pendingReplies.clear();
+    return missing + (_nextJobSeq - _nextReplySeq);
+  }
+
+private:
+  //! a job without reply ('finish') just returned its sequence number, so there are no parts to send
+  void send(vector<zmq::message_t>& parts) {
+    for (size_t i = 0; i < parts.size(); i++) _sendSocket.send(parts[i], i + 1 < parts.size() ? ZMQ_SNDMORE : 0);
+  }
+
+  zmq::socket_t& _frontend;
+  zmq::socket_t& _jobs;
+  zmq::socket_t& _results;
+  zmq::socket_t& _sendSocket;
+  uint64_t _nextJobSeq{0};
+  uint64_t _nextReplySeq{0};
+  map<uint64_t, vector<zmq::message_t>> _pendingReplies;
+};
+
+} // namespace
+
+void monica::serveZmqMonicaWorkerPool(zmq::context_t *zmqContext,
+                                      map<SocketRole, SocketConfig> socketAddresses,
+                                      size_t noOfWorkers) {
+  if (noOfWorkers <= 1) {
+    serveZmqMonicaFull(zmqContext, socketAddresses);
+    return;
+  }
+
+  auto rci = socketAddresses.find(ReceiveJob);
+  if (rci == socketAddresses.end()) {
+    cerr << "No supplied address for a receiving zmq socket! Exiting." << endl;
+    return;
+  }
+  const auto& rconfig = rci->second;
+  bool isPipeline = rconfig.type == Pull;
+
+  auto sci = socketAddresses.find(SendResult);
+  bool distinctSendSocket = sci != socketAddresses.end() && sci->second.addresses != rconfig.addresses;
+  auto cci = socketAddresses.find(Control);
+  bool distinctControlSocket = cci != socketAddresses.end() && cci->second.addresses != rconfig.addresses;
+  // the replies of a pipeline (sent via the distinct send socket) keep the order of the jobs
+  bool isSequenced = isPipeline && distinctSendSocket;
+
+  // read the tables shared by all workers before they start
+  ka5PwpFcSatFunction();
+  Soil::readCapillaryRiseRates();
+
+  // the configured sockets are served by this thread, the workers get the jobs via inproc sockets,
+  // replies travel back the same way, their routing envelope sends them to the right requester
+  zmq::socket_t frontend(*zmqContext, isPipeline ? ZMQ_PULL : rconfig.op == bind ? ZMQ_ROUTER : ZMQ_DEALER);
+  zmq::socket_t jobs(*zmqContext, isPipeline ? ZMQ_PUSH : ZMQ_DEALER);
+  zmq::socket_t results(*zmqContext, ZMQ_PULL);
+  zmq::socket_t sendSocket(*zmqContext, distinctSendSocket && sci->second.type == Router ? ZMQ_ROUTER : ZMQ_PUSH);
+  zmq::socket_t workersDone(*zmqContext, ZMQ_PULL);
+  zmq::socket_t workersControl(*zmqContext, ZMQ_PUB);
+  zmq::socket_t controlSocket(*zmqContext, ZMQ_SUB);
+  int topicCharCount = 0;
+
+  vector<zmq::socket_t*> sockets = {&frontend, &jobs, &results, &sendSocket, &workersDone, &workersControl,
+                                    &controlSocket};
+  auto closeSockets = [&]() {
+    for (auto s : sockets) s->setsockopt(ZMQ_LINGER, 0), s->close();
+  };
+
+  try {
+    for (const auto& address : rconfig.addresses) rconfig.op == bind ? frontend.bind(address) : frontend.connect(address);
+    if (distinctSendSocket) {
+      for (const auto& address : sci->second.addresses) {
+        sci->second.op == bind ? sendSocket.bind(address) : sendSocket.connect(address);
+      }
+    }
+    if (distinctControlSocket) {
+      auto topic = "finish";
+      topicCharCount = int(strlen(topic));
+      for (const auto& address : cci->second.addresses) {
+        cci->second.op == bind ? controlSocket.bind(address) : controlSocket.connect(address);
+      }
+      controlSocket.setsockopt(ZMQ_SUBSCRIBE, topic, topicCharCount);
+    }
+    // a job is just queued for a worker which is about to take it, the others wait in front of the pool
+    // (and are not lost when the pool finishes)
+    jobs.setsockopt(ZMQ_SNDHWM, 1);
+    jobs.bind(poolJobsAddress);
+    results.bind(poolResultsAddress);
+    workersDone.bind(poolWorkersDoneAddress);
+    workersControl.bind(poolControlAddress);
+  } catch (const zmq::error_t& e) {
+    cerr << "Couldn't set up the sockets of the MONICA worker pool! Error: [" << e.what() << "]" << endl;
+    closeSockets();
+    return;
+  }
+
+  // every worker has its own subscription to the finish message, so none can miss it in favour of another one
+  map<SocketRole, SocketConfig> workerAddresses;
+  workerAddresses[ReceiveJob] = {isPipeline ? Pull : Reply, {poolJobsAddress}, monica::connect, isSequenced, 1};
+  if (distinctSendSocket) workerAddresses[SendResult] = {Push, {poolResultsAddress}, monica::connect};
+  workerAddresses[Control] = {Subscribe, {poolControlAddress}, monica::connect};
+
+  debug() << "MONICA: starting " << noOfWorkers << " workers" << endl;
+  vector<thread> workers;
+  for (size_t i = 0; i < noOfWorkers; i++) {
+    workers.emplace_back([zmqContext, workerAddresses]() {
+      serveZmqMonicaFull(zmqContext, workerAddresses);
+      zmq::socket_t done(*zmqContext, ZMQ_PUSH);
+      done.connect(poolWorkersDoneAddress);
+      s_send(done, "done");
+    });
+  }
+
+  // a pipeline is served by this thread (numbering the jobs, ordering the replies), else proxies pass on
+  // the jobs and replies on their own threads
+  unique_ptr<PipelineSequencer> sequencer;
+  unique_ptr<SteerableProxy> jobsProxy, resultsProxy;
+  if (isSequenced) sequencer = make_unique<PipelineSequencer>(frontend, jobs, results, sendSocket);
+  else {
+    jobsProxy = make_unique<SteerableProxy>(zmqContext, frontend, jobs, "inproc://monica-pool-jobs-steer");
+    if (distinctSendSocket) {
+      resultsProxy = make_unique<SteerableProxy>(zmqContext, results, sendSocket, "inproc://monica-pool-results-steer");
+    }
+  }
+
+  size_t noOfFinishedWorkers = 0;
+  auto receiveWorkersDone = [&]() {
+    zmq::message_t m;
+    while (workersDone.recv(&m, ZMQ_DONTWAIT)) noOfFinishedWorkers++;
+  };
+
+  // wait for a finish message, either on the control socket or as job (then a worker has already finished)
+  zmq::pollitem_t items[] = {{(void *) workersDone, 0, ZMQ_POLLIN, 0},
+                             {(void *) controlSocket, 0, ZMQ_POLLIN, 0},
+                             {(void *) results, 0, ZMQ_POLLIN, 0},
+                             {(void *) frontend, 0, ZMQ_POLLIN, 0},
+                             {(void *) jobs, 0, 0, 0}
+  };
+  while (noOfFinishedWorkers == 0) {
+    try {
+      if (sequencer) {
+        // take the next job just if a worker can take it, else wait for one to make room
+        // (while passing on the replies, which the workers might be blocked on)
+        bool canSendJob = (jobs.getsockopt<int>(ZMQ_EVENTS) & ZMQ_POLLOUT) != 0;
+        items[3].events = canSendJob ? ZMQ_POLLIN : 0;
+        items[4].events = canSendJob ? 0 : ZMQ_POLLOUT;
+      }
+      zmq::poll(&items[0], sequencer ? 5 : 2, -1);
+      if (items[0].revents & ZMQ_POLLIN) receiveWorkersDone();
+      if (distinctControlSocket && items[1].revents & ZMQ_POLLIN
+          && receiveMsg(controlSocket, topicCharCount).type() == "finish") break;
+      if (sequencer && items[2].revents & ZMQ_POLLIN) sequencer->forwardReplies();
+      if (sequencer && items[3].revents & ZMQ_POLLIN) sequencer->forwardJob();
+    } catch (const zmq::error_t& e) {
+      cerr << "Exception while waiting for the MONICA worker pool to finish! Will stop the workers! Error: ["
+           << e.what() << "]" << endl;
+      break;
+    }
+  }
+
+  // stop receiving jobs
+  if (jobsProxy) jobsProxy->terminate();
+
+  // the finish message is published until every worker reported done (a worker might have subscribed just now),
+  // meanwhile the replies to the jobs they still run are passed on
+  auto passOnReplies = [&]() {
+    if (sequencer) sequencer->forwardReplies();
+    else if (!isPipeline) forwardPendingMessages(jobs, frontend);
+  };
+  auto finishMsg = string("finish") + Json(J11Object{{"type", "finish"}}).dump();
+  zmq::pollitem_t doneItems[] = {{(void *) workersDone, 0, ZMQ_POLLIN, 0},
+                                 {sequencer ? (void *) results : (void *) jobs, 0, ZMQ_POLLIN, 0}
+  };
+  while (noOfFinishedWorkers < noOfWorkers) {
+    try {
+      workersControl.send(finishMsg.data(), finishMsg.size(), ZMQ_DONTWAIT);
+      zmq::poll(&doneItems[0], 2, 100);
+      receiveWorkersDone();
+      passOnReplies();
+    } catch (const zmq::error_t& e) {
+      cerr << "Exception while stopping the MONICA workers! Error: [" << e.what() << "]" << endl;
+    }
+  }
+  for (auto& w : workers) w.join();
+
+  // the replies sent after the last check
+  passOnReplies();
+  if (resultsProxy) {
+    resultsProxy->terminate();
+    forwardPendingMessages(results, sendSocket);
+  }
+  if (sequencer) {
+    auto missing = sequencer->flush();
+    if (missing > 0) cerr << missing << " jobs were dropped by the finishing MONICA workers, they got no reply!" << endl;
+  }
+
+  closeSockets();
+
+  debug() << "exiting serveZmqMonicaWorkerPool" << endl;
+}
@@ -50,10 +50,22 @@ struct SocketConfig {
   SocketType type;
   std::vector<std::string> addresses;
   SocketOp op;
+  //! (Pull only) every job is preceded by a sequence number frame, which is sent back in front of its reply
+  //! (a 'finish' job is answered by the sequence number alone)
+  bool sequenced{false};
+  //! (if > 0) the receive high water mark of the socket, e.g. 1 for the workers of a pool, which then
+  //! don't queue jobs other workers could run
+  int receiveHwm{0};
 };
 
 void serveZmqMonicaFull(zmq::context_t *zmqContext,
                         std::map<SocketRole, SocketConfig> socketAddresses);
 
+//! serve the sockets of socketAddresses like serveZmqMonicaFull, but run the jobs on noOfWorkers threads
+//! which share the process wide tables, the calling thread distributes the jobs via inproc sockets
+void serveZmqMonicaWorkerPool(zmq::context_t *zmqContext,
+                              std::map<SocketRole, SocketConfig> socketAddresses,
+                              size_t noOfWorkers);
+
 } // namespace monica
 
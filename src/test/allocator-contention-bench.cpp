@@ -0,0 +1,118 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+// runs the same simulation concurrently on many threads, once with the models allocating directly from the
+// shared heap and once from per run pools, and reports the wall time and the number of container allocations
+// of the models which reached the shared heap
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test-env.h"
+
+using namespace std;
+using namespace monica;
+
+namespace {
+
+//! the shared heap all runs draw from, counting the allocations reaching it
+class CountingResource : public std::pmr::memory_resource {
+public:
+  size_t allocations() const { return _allocations.load(); }
+
+  void reset() { _allocations = 0; }
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    _allocations.fetch_add(1, memory_order_relaxed);
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+  atomic<size_t> _allocations{0};
+};
+
+struct Result {
+  double seconds{0};
+  size_t heapAllocations{0};
+};
+
+Result runConcurrently(const string& pathToSimJson, size_t noOfRuns, size_t noOfThreads, bool perRunPool,
+                       CountingResource& heap) {
+  // every run gets its own Env, copies would share the (stateful) worksteps of the crop rotation
+  vector<Env> envs;
+  for (size_t i = 0; i < noOfRuns; i++) envs.push_back(test::createEnvFromSimJson(pathToSimJson));
+  atomic<size_t> next{0};
+  heap.reset();
+
+  auto start = chrono::steady_clock::now();
+  vector<thread> threads;
+  for (size_t t = 0; t < noOfThreads; t++) {
+    threads.emplace_back([&]() {
+      for (size_t i = next++; i < noOfRuns; i = next++) runMonica(kj::mv(envs[i]), &heap, perRunPool);
+    });
+  }
+  for (auto& t : threads) t.join();
+  chrono::duration<double> d = chrono::steady_clock::now() - start;
+  return {d.count(), heap.allocations()};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  string pathToSimJson = MONICA_EXAMPLE_DIR "/sim.json";
+  size_t noOfRuns = 32, noOfThreads = 32;
+
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if ((arg == "-n" || arg == "--runs") && i + 1 < argc) noOfRuns = stoul(argv[++i]);
+    else if ((arg == "-t" || arg == "--threads") && i + 1 < argc) noOfThreads = stoul(argv[++i]);
+    else if (arg == "-h" || arg == "--help") {
+      cout << "allocator-contention-bench [-n | --runs N (default: 32)] [-t | --threads N (default: 32)] [sim.json]"
+           << endl;
+      return 0;
+    } else pathToSimJson = arg;
+  }
+
+  auto env = test::createEnvFromSimJson(pathToSimJson);
+  if (!env.climateData.isValid()) {
+    cerr << "Error: couldn't create the environment from " << pathToSimJson << endl;
+    return 2;
+  }
+
+  CountingResource heap;
+  // warm up the caches (output table, soil parameter tables) outside of the measurements
+  runConcurrently(pathToSimJson, 1, 1, true, heap);
+
+  cout << noOfRuns << " runs of " << pathToSimJson << " on " << noOfThreads << " threads" << endl;
+  for (bool perRunPool : {false, true}) {
+    auto res = runConcurrently(pathToSimJson, noOfRuns, noOfThreads, perRunPool, heap);
+    cout << (perRunPool ? "per run pools: " : "shared heap:   ")
+         << res.seconds << " s, " << (noOfRuns / res.seconds) << " runs/s, "
+         << res.heapAllocations << " allocations from the shared heap" << endl;
+  }
+  return 0;
+}
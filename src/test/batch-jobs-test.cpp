@@ -0,0 +1,195 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+// checks the batch mode of monica-run without running MONICA: reading the jobs from JSON lines files (paths,
+// objects overriding the options, parse errors) and globs, the wildcard matching, the names which keep the output
+// files of the jobs apart, and that failing or throwing jobs don't stop the others
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "run/batch-jobs.h"
+
+using namespace std;
+using namespace monica;
+
+namespace {
+
+int failures = 0;
+int checks = 0;
+
+void check(bool ok, const string& what) {
+  checks++;
+  if (ok) return;
+  failures++;
+  cerr << "FAILED: " << what << endl;
+}
+
+template<typename T>
+void checkEqual(const T& actual, const T& expected, const string& what) {
+  checks++;
+  if (actual == expected) return;
+  failures++;
+  cerr << "FAILED: " << what << ": got '" << actual << "', expected '" << expected << "'" << endl;
+}
+
+void writeFile(const filesystem::path& path, const string& content) {
+  filesystem::create_directories(path.parent_path());
+  ofstream out(path);
+  out << content;
+}
+
+void testMatchesWildcard() {
+  struct Case { string name, pattern; bool matches; };
+  vector<Case> cases = {
+    {"sim-1.json", "sim-*.json", true}, {"sim-.json", "sim-*.json", true}, {"sim.json", "sim-*.json", false},
+    {"sim-1.json.bak", "*.json", false}, {"abc", "a?c", true}, {"ac", "a?c", false}, {"abc", "*", true},
+    {"", "*", true}, {"", "", true}, {"a", "", false}, {"abcbd", "a*b?", true}, {"abcd", "a*c", false},
+    {"aaa", "a*a*a", true}, {"aa", "a*a*a", false}, {"sim-12.json", "sim-??.json", true}
+  };
+  for (const auto& c : cases) {
+    check(matchesWildcard(c.name, c.pattern) == c.matches,
+          "matchesWildcard(\"" + c.name + "\", \"" + c.pattern + "\") should be " + (c.matches ? "true" : "false"));
+  }
+}
+
+void testWithNameSuffix() {
+  checkEqual(withNameSuffix("out/sim.csv", "a"), string("out/sim-a.csv"), "suffix in front of the extension");
+  checkEqual(withNameSuffix("out/sim", "a"), string("out/sim-a"), "suffix without extension");
+  checkEqual(withNameSuffix("out.d/sim", "a"), string("out.d/sim-a"), "dot in the directory");
+  checkEqual(withNameSuffix("sim.tar.csv", "x"), string("sim.tar-x.csv"), "just the last extension");
+  checkEqual(withNameSuffix("out/.hidden", "a"), string("out/.hidden-a"), "hidden file without extension");
+  checkEqual(withNameSuffix("a.csv", "r/1:2"), string("a-r_1_2.csv"), "characters not allowed in file names");
+}
+
+void testJsonLines(const filesystem::path& dir) {
+  writeFile(dir / "jobs.jsonl",
+            "\"sim-a.json\"\n"
+            "{\"sim\": \"sims/sim-b.json\", \"run-id\": \"b\", \"crop\": \"crop-b.json\", \"site\": \"site-b.json\", "
+            "\"climate\": \"climate-b.csv\", \"start-date\": \"2000-01-01\", \"end-date\": \"2001-12-31\", "
+            "\"output-file\": \"out/b.csv\", \"output-dir\": \"out-b\"}\n"
+            "{\"sim\": \"sim-c.json\", \"broken\n"
+            "{\"run-id\": \"no sim\"}\n"
+            "   \r\n"
+            "{\"sim\": \"sims/sim-a.json\", \"run-id\": \"a2\"}\n");
+
+  RunOptions defaults;
+  defaults.crop = "default-crop.json";
+  defaults.outputFormat = "csv";
+  defaults.pathToOutputFile = "out.csv";
+  auto batch = (dir / "jobs.jsonl").string();
+  auto res = readBatchJobs(batch, defaults);
+
+  checkEqual(res.errors.size(), size_t(2), "errors of the JSON lines file (parse error, missing sim)");
+  if (res.errors.size() == 2) {
+    check(res.errors[0].find(":3:") != string::npos, "parse error names line 3: " + res.errors[0]);
+    check(res.errors[1].find(":4:") != string::npos, "missing sim names line 4: " + res.errors[1]);
+  }
+  checkEqual(res.result.size(), size_t(3), "jobs of the JSON lines file");
+  if (res.result.size() != 3) return;
+
+  auto dirPrefix = dir.string() + "/";
+  const auto& a = res.result[0];
+  checkEqual(a.pathToSimJson, dirPrefix + "sim-a.json", "path line, relative to the batch file");
+  checkEqual(a.opts.crop, string("default-crop.json"), "path line keeps the default options");
+  checkEqual(a.opts.pathToOutputFile, string("out.csv"), "path line keeps the default output file");
+  checkEqual(a.opts.batchJobName, string("sim-a"), "path line is named after the sim.json");
+
+  const auto& b = res.result[1];
+  checkEqual(b.pathToSimJson, dirPrefix + "sims/sim-b.json", "object line, relative to the batch file");
+  checkEqual(b.opts.runId, string("b"), "object overrides run-id");
+  checkEqual(b.opts.crop, string("crop-b.json"), "object overrides crop");
+  checkEqual(b.opts.site, string("site-b.json"), "object overrides site");
+  checkEqual(b.opts.climate, string("climate-b.csv"), "object overrides climate");
+  checkEqual(b.opts.startDate, string("2000-01-01"), "object overrides start-date");
+  checkEqual(b.opts.endDate, string("2001-12-31"), "object overrides end-date");
+  checkEqual(b.opts.pathToOutputFile, string("out/b.csv"), "object overrides output-file");
+  checkEqual(b.opts.pathToOutput, string("out-b"), "object overrides output-dir");
+  checkEqual(b.opts.outputFormat, string("csv"), "object keeps the options it doesn't override");
+  checkEqual(b.opts.batchJobName, string(), "a job with its own output file needs no name");
+
+  const auto& a2 = res.result[2];
+  checkEqual(a2.pathToSimJson, dirPrefix + "sims/sim-a.json", "object line with the same sim.json");
+  checkEqual(a2.opts.batchJobName, string("a2"), "object line is named after its run-id");
+
+  auto missing = readBatchJobs((dir / "missing.jsonl").string(), defaults);
+  check(missing.result.empty() && missing.errors.size() == 1, "missing JSON lines file is an error");
+}
+
+void testGlob(const filesystem::path& dir) {
+  for (auto name : {"sim-1.json", "sim-2.json", "sim-10.json", "other.json", "sim-x.txt"}) {
+    writeFile(dir / "glob" / name, "{}");
+  }
+  filesystem::create_directories(dir / "glob" / "sim-dir.json");
+
+  auto res = readBatchJobs((dir / "glob" / "sim-*.json").string(), RunOptions());
+  check(res.errors.empty(), "glob without errors");
+  checkEqual(res.result.size(), size_t(3), "jobs matching the glob (just regular files)");
+  if (res.result.size() != 3) return;
+  auto globDir = (dir / "glob").string() + "/";
+  checkEqual(res.result[0].pathToSimJson, globDir + "sim-1.json", "glob jobs sorted by path (1)");
+  checkEqual(res.result[1].pathToSimJson, globDir + "sim-10.json", "glob jobs sorted by path (2)");
+  checkEqual(res.result[2].pathToSimJson, globDir + "sim-2.json", "glob jobs sorted by path (3)");
+  checkEqual(res.result[1].opts.batchJobName, string("sim-10"), "glob job is named after its sim.json");
+}
+
+void testFailingJobsDontStopTheBatch() {
+  vector<BatchJob> jobs(20);
+  for (size_t i = 0; i < jobs.size(); i++) jobs[i].pathToSimJson = "job-" + to_string(i);
+
+  for (size_t noOfThreads : {1, 4}) {
+    atomic<size_t> noOfRunJobs{0};
+    auto noOfFailed = runBatchJobs(jobs, noOfThreads, [&](const BatchJob& job) {
+      noOfRunJobs++;
+      if (job.pathToSimJson == "job-3") throw runtime_error("job 3 throws");
+      if (job.pathToSimJson == "job-7") return 1;
+      if (job.pathToSimJson == "job-11") throw 11;
+      return 0;
+    });
+    auto threads = " (" + to_string(noOfThreads) + " threads)";
+    checkEqual(size_t(noOfRunJobs), jobs.size(), "all jobs run despite failing ones" + threads);
+    checkEqual(noOfFailed, size_t(3), "failed and throwing jobs are counted" + threads);
+  }
+
+  checkEqual(runBatchJobs({}, 4, [](const BatchJob&) { return 1; }), size_t(0), "an empty batch fails no job");
+}
+
+} // namespace
+
+int main() {
+  auto dir = filesystem::temp_directory_path() / "monica-batch-jobs-test";
+  filesystem::remove_all(dir);
+  filesystem::create_directories(dir);
+
+  testMatchesWildcard();
+  testWithNameSuffix();
+  testJsonLines(dir);
+  testGlob(dir);
+  testFailingJobsDontStopTheBatch();
+
+  filesystem::remove_all(dir);
+
+  if (failures > 0) {
+    cerr << failures << " of " << checks << " checks failed" << endl;
+    return 1;
+  }
+  cout << "all " << checks << " checks passed" << endl;
+  return 0;
+}
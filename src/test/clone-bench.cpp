@@ -0,0 +1,119 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+// brings a model of a simulation into the growing season, then reports the cost of cloning it
+// (member-wise vs. the former capnp state round trip) and the throughput of an ensemble of clones
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <capnp/message.h>
+
+#include "test-env.h"
+#include "core/crop.h"
+#include "core/monica-model.h"
+#include "run/ensemble.h"
+
+using namespace std;
+using namespace monica;
+
+namespace {
+
+void stepModel(MonicaModel& m, const Env& env, size_t d, Tools::Date date) {
+  m.dailyReset();
+  m.setCurrentStepDate(date);
+  m.setCurrentStepClimateData(env.climateData.allDataForStep(d, env.params.siteParameters.vs_Latitude));
+  if (m.cropGrowth() && m.cropGrowth()->isDying()) m.incorporateCurrentCrop();
+  m.step();
+}
+
+template<typename F>
+double secondsPer(size_t n, F f) {
+  auto start = chrono::steady_clock::now();
+  for (size_t i = 0; i < n; i++) f();
+  chrono::duration<double> d = chrono::steady_clock::now() - start;
+  return d.count() / n;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  string pathToSimJson = MONICA_EXAMPLE_DIR "/sim.json";
+  size_t noOfClones = 1000, noOfMembers = 64, noOfDays = 365, noOfThreads = 0;
+
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if ((arg == "-c" || arg == "--clones") && i + 1 < argc) noOfClones = stoul(argv[++i]);
+    else if ((arg == "-m" || arg == "--members") && i + 1 < argc) noOfMembers = stoul(argv[++i]);
+    else if ((arg == "-d" || arg == "--days") && i + 1 < argc) noOfDays = stoul(argv[++i]);
+    else if ((arg == "-t" || arg == "--threads") && i + 1 < argc) noOfThreads = stoul(argv[++i]);
+    else if (arg == "-h" || arg == "--help") {
+      cout << "clone-bench [-c | --clones N (default: 1000)] [-m | --members N (default: 64)] "
+              "[-d | --days N (default: 365)] [-t | --threads N (default: 0 = hardware threads)] [sim.json]" << endl;
+      return 0;
+    } else pathToSimJson = arg;
+  }
+
+  auto env = test::createEnvFromSimJson(pathToSimJson);
+  if (!env.climateData.isValid()) {
+    cerr << "Error: couldn't create the environment from " << pathToSimJson << endl;
+    return 2;
+  }
+
+  // 90 days bare soil, then sow the first crop of the rotation and let it grow for 120 days,
+  // so the clones carry a crop module and filled AOM pools
+  MonicaModel model(env.params);
+  model.simulationParametersNC().startDate = env.climateData.startDate();
+  model.simulationParametersNC().endDate = env.climateData.endDate();
+  auto date = env.climateData.startDate();
+  size_t d = 0, nods = env.climateData.noOfStepsPossible();
+  for (; d < 90 && d < nods; d++, ++date) stepModel(model, env, d, date);
+  for (const auto& cm : env.cropRotation) {
+    if (cm.isFallow()) continue;
+    Crop crop = cm.crop();
+    model.seedCrop(&crop);
+    break;
+  }
+  for (; d < 210 && d < nods; d++, ++date) stepModel(model, env, d, date);
+  cout << "cloning " << pathToSimJson << " at " << date.toIsoDateString()
+       << (model.isCropPlanted() ? " with " : " without ") << "crop" << endl;
+
+  auto memberWise = secondsPer(noOfClones, [&]() { model.clone(); });
+  auto roundTrip = secondsPer(noOfClones, [&]() {
+    capnp::MallocMessageBuilder message(16 * 1024);
+    auto state = message.initRoot<mas::schema::model::monica::MonicaModelState>();
+    model.serialize(state);
+    MonicaModel c(state.asReader());
+  });
+  cout << "member-wise clone:      " << (memberWise * 1e6) << " us" << endl
+       << "capnp state round trip: " << (roundTrip * 1e6) << " us" << endl;
+
+  auto start = chrono::steady_clock::now();
+  Ensemble ensemble(model, noOfMembers, 3, noOfThreads);
+  chrono::duration<double> setup = chrono::steady_clock::now() - start;
+
+  start = chrono::steady_clock::now();
+  size_t days = 0;
+  for (; days < noOfDays && d < nods; days++, d++, ++date) {
+    ensemble.step(date, env.climateData.allDataForStep(d, env.params.siteParameters.vs_Latitude));
+  }
+  chrono::duration<double> stepping = chrono::steady_clock::now() - start;
+  cout << "ensemble of " << noOfMembers << " members: setup " << setup.count() << " s, "
+       << days << " days in " << stepping.count() << " s, "
+       << (noOfMembers * days / stepping.count()) << " member days/s" << endl;
+  return 0;
+}
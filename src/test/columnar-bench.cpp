@@ -0,0 +1,147 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+// writes a synthetic daily output section of 100 years (the columns of a typical daily output spec, including
+// per layer arrays) as CSV and in the columnar format and reports the write times and file sizes
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "tools/date.h"
+#include "io/csv-format.h"
+#include "io/columnar-format.h"
+
+using namespace std;
+using namespace monica;
+using namespace Tools;
+
+namespace {
+
+const double pi = 3.14159265358979323846;
+
+OId makeOId(const string& name, const string& unit, int fromLayer = -1, int toLayer = -1) {
+  OId oid;
+  oid.name = name;
+  oid.unit = unit;
+  oid.fromLayer = fromLayer;
+  oid.toLayer = toLayer;
+  return oid;
+}
+
+Output::Data createDailySection(int years) {
+  Output::Data d;
+  d.origSpec = "\"daily\"";
+  d.outputIds = {makeOId("Date", ""), makeOId("Crop", ""), makeOId("Stage", ""),
+                 makeOId("Yield", "kg ha-1"), makeOId("LAI", "m2 m-2"), makeOId("AbBiom", "kg ha-1"),
+                 makeOId("Precip", "mm"), makeOId("Tavg", "°C"), makeOId("Globrad", "MJ m-2"),
+                 makeOId("ET0", "mm"), makeOId("Act_ET", "mm"), makeOId("RunOff", "mm"),
+                 makeOId("Recharge", "mm"), makeOId("NLeach", "kg N ha-1"),
+                 makeOId("Mois", "m3 m-3", 0, 19), makeOId("SOC", "%", 0, 2)};
+  d.results.resize(d.outputIds.size());
+
+  Date date(1, 1, 1921);
+  auto end = Date(31, 12, 1921 + years - 1);
+  for (size_t day = 0; date <= end; ++date, day++) {
+    auto doy = double(date.julianDay());
+    auto season = sin(2 * pi * (doy - 80) / 365.0);
+    bool crop = doy > 90 && doy < 220;
+    size_t c = 0;
+    d.results[c++].push_back(date.toIsoDateString());
+    d.results[c++].push_back(crop ? "winter wheat" : "");
+    d.results[c++].push_back(crop ? int((doy - 90) / 20) + 1 : 0);
+    d.results[c++].push_back(crop ? (doy - 90) * 61.3 : 0.0);
+    d.results[c++].push_back(crop ? 6 * sin(pi * (doy - 90) / 130) : 0.0);
+    d.results[c++].push_back(crop ? (doy - 90) * 112.7 : 0.0);
+    d.results[c++].push_back(day % 3 == 0 ? fmod(day * 0.37, 17.1) : 0.0);
+    d.results[c++].push_back(9 + 10 * season + fmod(day * 0.13, 3.0));
+    d.results[c++].push_back(11 + 9 * season);
+    d.results[c++].push_back(max(0.1, 2.2 + 2 * season));
+    d.results[c++].push_back(max(0.05, 1.7 + 1.5 * season));
+    d.results[c++].push_back(0.0);
+    d.results[c++].push_back(fmod(day * 0.011, 1.3));
+    d.results[c++].push_back(fmod(day * 0.0007, 0.05));
+    J11Array mois, soc;
+    for (int l = 0; l < 20; l++) mois.push_back(0.18 + 0.01 * l + 0.03 * season);
+    for (int l = 0; l < 3; l++) soc.push_back(1.1 - 0.3 * l + day * 1e-7);
+    d.results[c++].push_back(mois);
+    d.results[c++].push_back(soc);
+  }
+  return d;
+}
+
+struct Result {
+  double seconds{0};
+  size_t bytes{0};
+};
+
+template<typename F>
+Result bestOf(size_t repetitions, const string& pathToFile, F write) {
+  Result best{numeric_limits<double>::max(), 0};
+  for (size_t i = 0; i < repetitions; i++) {
+    auto start = chrono::steady_clock::now();
+    ofstream out(pathToFile, ios::out | ios::binary | ios::trunc);
+    write(out);
+    out.close();
+    chrono::duration<double> d = chrono::steady_clock::now() - start;
+    best.seconds = min(best.seconds, d.count());
+  }
+  ifstream in(pathToFile, ios::binary | ios::ate);
+  best.bytes = size_t(in.tellg());
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int years = 100;
+  size_t repetitions = 5;
+  string pathToDir = ".";
+
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if ((arg == "-y" || arg == "--years") && i + 1 < argc) years = stoi(argv[++i]);
+    else if ((arg == "-r" || arg == "--repetitions") && i + 1 < argc) repetitions = stoul(argv[++i]);
+    else if (arg == "-h" || arg == "--help") {
+      cout << "columnar-bench [-y | --years N (default: 100)] [-r | --repetitions N (default: 5)] [output dir]"
+           << endl;
+      return 0;
+    } else pathToDir = arg;
+  }
+
+  auto section = createDailySection(years);
+  auto rows = section.results.front().size();
+
+  auto csv = bestOf(repetitions, pathToDir + "/columnar-bench.csv", [&](ostream& out) {
+    writeOutputHeaderRows(out, section.outputIds, ",", true, true, false);
+    writeOutput(out, section.outputIds, section.results, ",");
+  });
+  auto columnar = bestOf(repetitions, pathToDir + "/columnar-bench.mcol", [&](ostream& out) {
+    writeColumnarOutput(out, section);
+  });
+
+  cout << years << " years daily output, " << rows << " rows, " << section.outputIds.size()
+       << " columns (best of " << repetitions << ")" << endl
+       << "csv:      " << csv.seconds << " s, " << csv.bytes << " bytes" << endl
+       << "columnar: " << columnar.seconds << " s, " << columnar.bytes << " bytes ("
+       << (csv.seconds / columnar.seconds) << "x faster, "
+       << (double(columnar.bytes) / double(csv.bytes)) << " of the csv size)" << endl;
+  return 0;
+}
@@ -0,0 +1,218 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+// compares two CSV files written by monica-run (single output file, header and units rows)
+// column by column and reports the deviations of the candidate from the reference
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct Section {
+  string name;
+  vector<string> header;
+  vector<vector<string>> rows;
+};
+
+vector<string> splitCsvLine(const string& line, char sep) {
+  vector<string> cells(1);
+  bool inQuotes = false;
+  for (char c : line) {
+    if (c == '"') inQuotes = !inQuotes;
+    else if (c == sep && !inQuotes) cells.emplace_back();
+    else if (c != '\r') cells.back().push_back(c);
+  }
+  return cells;
+}
+
+//! a section starts with a line holding just the quoted output spec, followed by the header row,
+//! an optional units row ([unit]) and the data rows up to the next empty line
+bool readSections(const string& path, char sep, vector<Section>& sections) {
+  ifstream in(path);
+  if (in.fail()) {
+    cerr << "Error: couldn't open " << path << endl;
+    return false;
+  }
+
+  string line;
+  Section* s = nullptr;
+  bool expectHeader = false;
+  while (getline(in, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line.empty()) {
+      s = nullptr;
+      continue;
+    }
+    auto cells = splitCsvLine(line, sep);
+    if (!s && cells.size() == 1 && line.front() == '"') {
+      sections.push_back({cells.front(), {}, {}});
+      s = &sections.back();
+      expectHeader = true;
+    } else if (s && expectHeader) {
+      s->header = cells;
+      expectHeader = false;
+    } else if (s && s->rows.empty() && !cells.front().empty() && cells.front().front() == '[') {
+      continue; // units row
+    } else if (s) {
+      s->rows.push_back(cells);
+    }
+  }
+  return true;
+}
+
+bool parseNumber(const string& s, double& d) {
+  if (s.empty()) return false;
+  char* end = nullptr;
+  d = strtod(s.c_str(), &end);
+  return end == s.c_str() + s.size();
+}
+
+struct Deviation {
+  size_t noOfCells{0}, noOfDifferentCells{0}, noOfFailedCells{0};
+  double maxAbs{0}, maxRel{0}, sumRel{0};
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  string refPath, candPath;
+  char sep = ',';
+  double absTol = 0, relTol = 0, absFloor = 1e-9;
+  bool reportOnly = false, commonColumnsOnly = false, quiet = false;
+
+  auto printHelp = [&]() {
+    cout
+        << "compare-csv-outputs [options] REFERENCE.csv CANDIDATE.csv" << endl
+        << endl
+        << " -s  | --separator CHAR (default: ,)" << endl
+        << " -at | --abs-tol X (default: 0) ... a cell fails if its absolute and relative deviation exceed the tolerances" << endl
+        << " -rt | --rel-tol X (default: 0)" << endl
+        << " -af | --abs-floor X (default: 1e-9) ... lower bound of |reference| when computing relative deviations" << endl
+        << " -r  | --report-only ... report the deviations, fail just on structural differences" << endl
+        << " -c  | --common-columns-only ... compare just the columns both files have" << endl
+        << " -q  | --quiet ... report just the failing or deviating columns" << endl;
+  };
+
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if ((arg == "-s" || arg == "--separator") && i + 1 < argc) sep = argv[++i][0];
+    else if ((arg == "-at" || arg == "--abs-tol") && i + 1 < argc) absTol = atof(argv[++i]);
+    else if ((arg == "-rt" || arg == "--rel-tol") && i + 1 < argc) relTol = atof(argv[++i]);
+    else if ((arg == "-af" || arg == "--abs-floor") && i + 1 < argc) absFloor = atof(argv[++i]);
+    else if (arg == "-r" || arg == "--report-only") reportOnly = true;
+    else if (arg == "-c" || arg == "--common-columns-only") commonColumnsOnly = true;
+    else if (arg == "-q" || arg == "--quiet") quiet = true;
+    else if (arg == "-h" || arg == "--help") return printHelp(), 0;
+    else if (refPath.empty()) refPath = arg;
+    else candPath = arg;
+  }
+  if (refPath.empty() || candPath.empty()) return printHelp(), 2;
+
+  vector<Section> ref, cand;
+  if (!readSections(refPath, sep, ref) || !readSections(candPath, sep, cand)) return 2;
+
+  bool structureOk = true, withinTolerance = true;
+  for (const auto& rs : ref) {
+    auto csi = find_if(cand.begin(), cand.end(), [&](const Section& s) { return s.name == rs.name; });
+    if (csi == cand.end()) {
+      cout << "section \"" << rs.name << "\": missing in candidate" << endl;
+      structureOk = false;
+      continue;
+    }
+    const auto& cs = *csi;
+    if (rs.rows.size() != cs.rows.size()) {
+      cout << "section \"" << rs.name << "\": " << rs.rows.size() << " reference rows, but "
+           << cs.rows.size() << " candidate rows" << endl;
+      structureOk = false;
+    }
+
+    map<string, size_t> candColumns;
+    for (size_t c = 0; c < cs.header.size(); c++) candColumns.emplace(cs.header[c], c);
+    if (!commonColumnsOnly && rs.header.size() != cs.header.size()) {
+      cout << "section \"" << rs.name << "\": different number of columns" << endl;
+      structureOk = false;
+    }
+
+    cout << "section \"" << rs.name << "\"" << endl;
+    for (size_t rc = 0; rc < rs.header.size(); rc++) {
+      const auto& name = rs.header[rc];
+      auto cci = candColumns.find(name);
+      if (cci == candColumns.end()) {
+        if (!commonColumnsOnly) {
+          cout << "  " << name << ": missing in candidate" << endl;
+          structureOk = false;
+        }
+        continue;
+      }
+
+      Deviation dev;
+      for (size_t r = 0, rows = min(rs.rows.size(), cs.rows.size()); r < rows; r++) {
+        const auto& rrow = rs.rows[r];
+        const auto& crow = cs.rows[r];
+        if (rc >= rrow.size() || cci->second >= crow.size()) continue;
+        const auto& rv = rrow[rc];
+        const auto& cv = crow[cci->second];
+        dev.noOfCells++;
+        if (rv == cv) continue;
+        dev.noOfDifferentCells++;
+
+        double rd, cd;
+        if (parseNumber(rv, rd) && parseNumber(cv, cd)) {
+          auto abs = fabs(cd - rd);
+          auto rel = abs / max(fabs(rd), absFloor);
+          dev.maxAbs = max(dev.maxAbs, abs);
+          dev.maxRel = max(dev.maxRel, rel);
+          dev.sumRel += rel;
+          if (abs > absTol && rel > relTol) dev.noOfFailedCells++;
+        } else {
+          dev.noOfFailedCells++; // text (dates, crop names) has to be identical
+          dev.maxAbs = dev.maxRel = numeric_limits<double>::infinity();
+        }
+      }
+
+      if (dev.noOfFailedCells > 0) withinTolerance = false;
+      if (quiet && dev.noOfDifferentCells == 0) continue;
+      cout << "  " << left << setw(24) << name << right
+           << " cells: " << dev.noOfCells
+           << " differing: " << dev.noOfDifferentCells
+           << " failing: " << dev.noOfFailedCells
+           << " max abs: " << dev.maxAbs
+           << " max rel: " << dev.maxRel
+           << " mean rel: " << (dev.noOfCells > 0 ? dev.sumRel / dev.noOfCells : 0.0) << endl;
+    }
+  }
+
+  if (!structureOk) {
+    cout << "outputs differ in structure" << endl;
+    return 1;
+  }
+  if (!withinTolerance) {
+    cout << "outputs differ beyond tolerance (abs: " << absTol << ", rel: " << relTol << ")" << endl;
+    return reportOnly ? 0 : 1;
+  }
+  cout << "outputs match within tolerance" << endl;
+  return 0;
+}
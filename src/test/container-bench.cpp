@@ -0,0 +1,162 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+// writes the synthetic outputs of many small runs (a year of daily outputs, a crop and a yearly section each)
+// once as one columnar file per run and section and once appended to a single container file shared by
+// a number of threads, and reports the write times and sizes
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tools/date.h"
+#include "io/columnar-format.h"
+
+using namespace std;
+using namespace monica;
+using namespace Tools;
+
+namespace {
+
+const double pi = 3.14159265358979323846;
+
+OId makeOId(const string& name, const string& unit, int fromLayer = -1, int toLayer = -1) {
+  OId oid;
+  oid.name = name;
+  oid.unit = unit;
+  oid.fromLayer = fromLayer;
+  oid.toLayer = toLayer;
+  return oid;
+}
+
+Output createRunOutput(size_t run) {
+  Output out;
+  out.customId = double(run);
+
+  Output::Data daily;
+  daily.origSpec = "\"daily\"";
+  daily.outputIds = {makeOId("Date", ""), makeOId("Yield", "kg ha-1"), makeOId("LAI", "m2 m-2"),
+                     makeOId("Precip", "mm"), makeOId("Tavg", "°C"), makeOId("Mois", "m3 m-3", 0, 19)};
+  daily.results.resize(daily.outputIds.size());
+  Date date(1, 1, 2000);
+  for (size_t day = 0; day < 366; ++date, day++) {
+    auto season = sin(2 * pi * (double(day) - 80) / 365.0);
+    bool crop = day > 90 && day < 220;
+    size_t c = 0;
+    daily.results[c++].push_back(date.toIsoDateString());
+    daily.results[c++].push_back(crop ? (double(day) - 90) * (61.3 + run % 7) : 0.0);
+    daily.results[c++].push_back(crop ? 6 * sin(pi * (double(day) - 90) / 130) : 0.0);
+    daily.results[c++].push_back(day % 3 == 0 ? fmod((day + run) * 0.37, 17.1) : 0.0);
+    daily.results[c++].push_back(9 + 10 * season + fmod((day + run) * 0.13, 3.0));
+    J11Array mois;
+    for (int l = 0; l < 20; l++) mois.push_back(0.18 + 0.01 * l + 0.03 * season);
+    daily.results[c++].push_back(mois);
+  }
+  out.data.push_back(daily);
+
+  Output::Data crop;
+  crop.origSpec = "\"crop\"";
+  crop.outputIds = {makeOId("Crop", ""), makeOId("Yield", "kg ha-1")};
+  crop.results = {{"winter wheat"}, {7800.0 + double(run % 100)}};
+  out.data.push_back(crop);
+
+  Output::Data yearly;
+  yearly.origSpec = "\"yearly\"";
+  yearly.outputIds = {makeOId("Year", ""), makeOId("Precip", "mm")};
+  yearly.results = {{2000}, {550.0 + double(run % 50)}};
+  out.data.push_back(yearly);
+  return out;
+}
+
+size_t sizeOfDir(const string& pathToDir) {
+  size_t bytes = 0;
+  for (const auto& e : filesystem::directory_iterator(pathToDir)) {
+    if (e.is_regular_file()) bytes += size_t(e.file_size());
+  }
+  return bytes;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  size_t noOfRuns = 1000, noOfThreads = 4;
+  string pathToDir = ".";
+
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if ((arg == "-n" || arg == "--runs") && i + 1 < argc) noOfRuns = stoul(argv[++i]);
+    else if ((arg == "-t" || arg == "--threads") && i + 1 < argc) noOfThreads = max(size_t(1), stoul(argv[++i]));
+    else if (arg == "-h" || arg == "--help") {
+      cout << "container-bench [-n | --runs N (default: 1000)] [-t | --threads N (default: 4)] [output dir]" << endl;
+      return 0;
+    } else pathToDir = arg;
+  }
+
+  vector<Output> outputs;
+  for (size_t r = 0; r < noOfRuns; r++) outputs.push_back(createRunOutput(r));
+
+  auto pathToFilesDir = pathToDir + "/container-bench-files";
+  filesystem::remove_all(pathToFilesDir);
+  filesystem::create_directories(pathToFilesDir);
+  auto start = chrono::steady_clock::now();
+  for (size_t r = 0; r < noOfRuns; r++) {
+    for (size_t i = 0; i < outputs[r].data.size(); i++) {
+      ofstream out(pathToFilesDir + "/run-" + to_string(r) + "-section-" + to_string(i) + ".mcol",
+                   ios::out | ios::binary | ios::trunc);
+      writeColumnarOutput(out, outputs[r].data[i]);
+    }
+  }
+  chrono::duration<double> files = chrono::steady_clock::now() - start;
+  auto filesBytes = sizeOfDir(pathToFilesDir);
+
+  auto pathToContainer = pathToDir + "/container-bench.mcon";
+  filesystem::remove(pathToContainer);
+  atomic<size_t> nextRun{0};
+  atomic<bool> failed{false};
+  start = chrono::steady_clock::now();
+  {
+    ColumnarContainerWriter cw(pathToContainer);
+    vector<thread> threads;
+    for (size_t t = 0; t < noOfThreads; t++) {
+      threads.emplace_back([&]() {
+        for (auto r = nextRun++; r < noOfRuns; r = nextRun++) {
+          if (!cw.add("run-" + to_string(r), outputs[r])) failed = true;
+        }
+      });
+    }
+    for (auto& t : threads) t.join();
+    if (!cw.flush()) failed = true;
+  }
+  chrono::duration<double> container = chrono::steady_clock::now() - start;
+  if (failed) {
+    cerr << "Error while appending to output container \"" << pathToContainer << "\"" << endl;
+    return 1;
+  }
+  auto containerBytes = size_t(filesystem::file_size(pathToContainer));
+
+  auto noOfFiles = noOfRuns * outputs.front().data.size();
+  cout << noOfRuns << " runs with " << outputs.front().data.size() << " output sections each" << endl
+       << "columnar files: " << files.count() << " s, " << noOfFiles << " files, " << filesBytes << " bytes" << endl
+       << "container:      " << container.count() << " s (" << noOfThreads << " threads), 1 file, "
+       << containerBytes << " bytes (" << (files.count() / container.count()) << "x faster)" << endl;
+  return 0;
+}
@@ -0,0 +1,215 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+// compares the buffered CSV writer byte by byte with the former writer, which streamed every value
+// with operator<< into the output stream, for several stream formats (precision, fixed/scientific, boolalpha)
+
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "io/csv-format.h"
+
+using namespace std;
+using namespace monica;
+using namespace Tools;
+using namespace json11;
+
+namespace {
+
+//! a single value as the former writer streamed it
+void streamValue(ostream& out, const Json& j, const string& csvSep, const string& escapeTokens) {
+  auto streamString = [&](const string& s) {
+    if (s.find_first_of(escapeTokens) == string::npos) out << s;
+    else out << "\"" << s << "\"";
+  };
+  switch (j.type()) {
+    case Json::NUMBER: out << j.number_value(); break;
+    case Json::STRING: streamString(j.string_value()); break;
+    case Json::BOOL: out << j.bool_value(); break;
+    case Json::ARRAY: {
+      size_t jvi = 0;
+      auto jSize = j.array_items().size();
+      for (const Json& jv : j.array_items()) {
+        switch (jv.type()) {
+          case Json::NUMBER: out << jv.number_value(); break;
+          case Json::STRING: streamString(jv.string_value()); break;
+          case Json::BOOL: out << jv.bool_value(); break;
+          default: out << "UNKNOWN";
+        }
+        if (++jvi < jSize) out << csvSep;
+      }
+      break;
+    }
+    default: out << "UNKNOWN";
+  }
+}
+
+void referenceWriteOutput(ostream& out, const vector<OId>& outputIds, const vector<J11Array>& values,
+                          const string& csvSep) {
+  string escapeTokens = "\n\"" + csvSep;
+  if (values.empty()) return;
+  for (size_t k = 0, size = values.front().size(); k < size; k++) {
+    for (size_t i = 0; i < outputIds.size(); i++) {
+      streamValue(out, values.at(i).at(k), csvSep, escapeTokens);
+      if (i + 1 < outputIds.size()) out << csvSep;
+    }
+    out << endl;
+  }
+}
+
+void referenceWriteOutputObj(ostream& out, const vector<OId>& outputIds, const vector<J11Object>& values,
+                             const string& csvSep) {
+  string escapeTokens = "\n\"" + csvSep;
+  for (const auto& o : values) {
+    for (size_t i = 0; i < outputIds.size(); i++) {
+      auto oi = o.find(outputIds[i].outputName());
+      if (oi == o.end()) continue;
+      streamValue(out, oi->second, csvSep, escapeTokens);
+      if (i + 1 < outputIds.size()) out << csvSep;
+    }
+    out << endl;
+  }
+}
+
+//! the numbers every format is checked with, including the special values
+vector<double> testNumbers() {
+  const auto inf = numeric_limits<double>::infinity();
+  const auto nan = numeric_limits<double>::quiet_NaN();
+  vector<double> ns = {0.0, -0.0, 1.0, -1.0, 0.5, 1.5, 2.5, -2.5, 0.1, 1.0 / 3, 2.0 / 3, 9.9999999, 99.5,
+                       123456.0, 1234567.0, 123456789.123456789, 1e15, 1e16, 1e21, 1e-4, 1e-5, 1.23e-7,
+                       1e300, -1e300, 1e-300, numeric_limits<double>::denorm_min(),
+                       numeric_limits<double>::max(), numeric_limits<double>::lowest(), numeric_limits<double>::epsilon(),
+                       inf, -inf, nan, -nan};
+  // numbers over a wide range of magnitudes and digits
+  for (int e = -20; e <= 20; e++) {
+    for (double m : {1.0, 1.25, 3.14159265358979, 7.77777, 9.995}) ns.push_back(m * pow(10.0, e));
+  }
+  return ns;
+}
+
+//! columns of all value types, enough rows to flush the internal buffer several times
+pair<vector<OId>, vector<J11Array>> testColumns() {
+  vector<OId> oids;
+  for (auto name : {"Number", "String", "Bool", "Array", "Null", "Object"}) {
+    OId oid;
+    oid.name = name;
+    oids.push_back(oid);
+  }
+  vector<J11Array> columns(oids.size());
+  auto ns = testNumbers();
+  vector<string> strings = {"", "plain", "with,comma", "with;semicolon", "with \"quotes\"", "with\nnewline",
+                            "UNKNOWN"};
+  for (size_t k = 0; k < 20000; k++) {
+    auto n = ns[k % ns.size()];
+    columns[0].push_back(n * (k < ns.size() ? 1.0 : 1.0 + double(k) * 1e-6));
+    columns[1].push_back(strings[k % strings.size()]);
+    columns[2].push_back(k % 3 == 0);
+    J11Array arr;
+    for (size_t l = 0; l < k % 5; l++) {
+      if (l == 3) arr.push_back(k % 2 == 0);
+      else if (l == 2) arr.push_back(strings[(k + l) % strings.size()]);
+      else if (l == 4) arr.push_back(Json());
+      else arr.push_back(ns[(k + l) % ns.size()]);
+    }
+    columns[3].push_back(arr);
+    columns[4].push_back(Json());
+    columns[5].push_back(J11Object{{"a", 1}});
+  }
+  return {oids, columns};
+}
+
+vector<J11Object> toRowObjects(const vector<OId>& oids, const vector<J11Array>& columns) {
+  vector<J11Object> rows;
+  for (size_t k = 0; k < columns.front().size(); k++) {
+    J11Object row;
+    for (size_t i = 0; i < oids.size(); i++) {
+      // leave out some fields, the writer then skips value and separator
+      if ((k + i) % 7 == 0) continue;
+      row[oids[i].outputName()] = columns[i][k];
+    }
+    rows.push_back(row);
+  }
+  return rows;
+}
+
+struct StreamFormat {
+  string name;
+  function<void(ostream&)> apply;
+};
+
+} // namespace
+
+int main() {
+  auto [oids, columns] = testColumns();
+  auto rows = toRowObjects(oids, columns);
+
+  vector<StreamFormat> formats = {
+    {"default", [](ostream&) {}},
+    {"precision 10", [](ostream& o) { o.precision(10); }},
+    {"precision 17", [](ostream& o) { o.precision(17); }},
+    {"precision 0", [](ostream& o) { o.precision(0); }},
+    {"fixed", [](ostream& o) { o << fixed; }},
+    {"fixed, precision 0", [](ostream& o) { o << fixed; o.precision(0); }},
+    {"fixed, precision 12", [](ostream& o) { o << fixed; o.precision(12); }},
+    {"scientific", [](ostream& o) { o << scientific; }},
+    {"scientific, precision 0", [](ostream& o) { o << scientific; o.precision(0); }},
+    {"scientific, precision 15", [](ostream& o) { o << scientific; o.precision(15); }},
+    {"boolalpha", [](ostream& o) { o << boolalpha; }},
+    {"showpos, showpoint, uppercase", [](ostream& o) { o << showpos << showpoint << uppercase; }},
+  };
+
+  int failures = 0;
+  auto check = [&](const string& what, const string& expected, const string& actual) {
+    if (expected == actual) return;
+    failures++;
+    size_t i = 0;
+    while (i < expected.size() && i < actual.size() && expected[i] == actual[i]) i++;
+    auto from = i < 40 ? 0 : i - 40;
+    cerr << "FAILED: " << what << ": outputs differ at byte " << i << " (sizes " << expected.size() << " vs. "
+         << actual.size() << ")" << endl
+         << "  expected: ..." << expected.substr(from, 80) << endl
+         << "  actual:   ..." << actual.substr(from, 80) << endl;
+  };
+
+  for (const auto& f : formats) {
+    for (string sep : {",", ";", "\t"}) {
+      ostringstream expected, actual;
+      f.apply(expected);
+      f.apply(actual);
+      referenceWriteOutput(expected, oids, columns, sep);
+      writeOutput(actual, oids, columns, sep);
+      check("writeOutput, " + f.name + ", separator '" + sep + "'", expected.str(), actual.str());
+
+      ostringstream expectedObj, actualObj;
+      f.apply(expectedObj);
+      f.apply(actualObj);
+      referenceWriteOutputObj(expectedObj, oids, rows, sep);
+      writeOutputObj(actualObj, oids, rows, sep);
+      check("writeOutputObj, " + f.name + ", separator '" + sep + "'", expectedObj.str(), actualObj.str());
+    }
+  }
+
+  if (failures > 0) {
+    cerr << failures << " comparisons failed" << endl;
+    return 1;
+  }
+  cout << "all " << formats.size() * 6 << " comparisons passed" << endl;
+  return 0;
+}
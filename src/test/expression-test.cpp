@@ -0,0 +1,201 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+// checks the expression language of derived outputs and output conditions: precedence, associativity,
+// unary operators, comparisons and logic, functions, the translation of references into output ids
+// and that expressions which don't compile are reported instead of silently dropped
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "io/expression.h"
+#include "io/build-output.h"
+#include "run/run-monica.h"
+
+using namespace std;
+using namespace monica;
+using namespace Tools;
+using namespace json11;
+
+namespace {
+
+int failures = 0;
+int checks = 0;
+
+void fail(const string& what) {
+  failures++;
+  cerr << "FAILED: " << what << endl;
+}
+
+void checkValue(const string& text, double expected, const vector<double>& refValues = {}) {
+  checks++;
+  auto res = Expression::compile(text);
+  if (!res.success()) {
+    fail("'" + text + "' doesn't compile: " + (res.errors.empty() ? string() : res.errors.front()));
+    return;
+  }
+  auto v = res.result->value(refValues);
+  auto same = isnan(expected) ? isnan(v) : abs(v - expected) < 1e-12;
+  if (!same) fail("'" + text + "' = " + to_string(v) + ", expected " + to_string(expected));
+}
+
+void checkError(const string& text) {
+  checks++;
+  auto res = Expression::compile(text);
+  if (res.success()) fail("'" + text + "' compiles, but should be an error");
+  else if (res.errors.empty()) fail("'" + text + "' fails without an error message");
+}
+
+//! the output id a single reference is translated to
+void checkReference(const string& text, const Json& expectedJsonInput, int fromLayer, int toLayer,
+                    OId::OP layerAggOp) {
+  checks++;
+  auto res = Expression::compile(text);
+  if (!res.success()) {
+    fail("'" + text + "' doesn't compile: " + (res.errors.empty() ? string() : res.errors.front()));
+    return;
+  }
+  const auto& refs = res.result->references();
+  if (refs.size() != 1) {
+    fail("'" + text + "' has " + to_string(refs.size()) + " references, expected 1");
+    return;
+  }
+  const auto& oid = refs.front();
+  if (oid.jsonInput != expectedJsonInput.dump())
+    fail("'" + text + "' references " + oid.jsonInput + ", expected " + expectedJsonInput.dump());
+  if (oid.fromLayer != fromLayer || oid.toLayer != toLayer || oid.layerAggOp != layerAggOp)
+    fail("'" + text + "' references layers " + to_string(oid.fromLayer) + "-" + to_string(oid.toLayer)
+         + " (" + oid.toString(oid.layerAggOp) + "), expected " + to_string(fromLayer) + "-" + to_string(toLayer)
+         + " (" + oid.toString(layerAggOp) + ")");
+}
+
+} // namespace
+
+int main() {
+  const auto nan = numeric_limits<double>::quiet_NaN();
+
+  // precedence
+  checkValue("1 + 2 * 3", 7);
+  checkValue("(1 + 2) * 3", 9);
+  checkValue("2 * 3 ^ 2", 18);
+  checkValue("1 + 2 < 4", 1);
+  checkValue("1 < 2 == 1", 1);
+  checkValue("1 || 0 && 0", 1);
+  checkValue("(1 || 0) && 0", 0);
+  checkValue("2 + 3 == 5 && 4 > 3", 1);
+
+  // associativity
+  checkValue("10 - 4 - 3", 3);
+  checkValue("8 / 4 / 2", 1);
+  checkValue("2 ^ 3 ^ 2", 512);
+
+  // unary operators
+  checkValue("-3 + 5", 2);
+  checkValue("--3", 3);
+  checkValue("-2 ^ 2", -4);
+  checkValue("2 ^ -1", 0.5);
+  checkValue("+4", 4);
+  checkValue("!0", 1);
+  checkValue("!2", 0);
+  checkValue("!!2", 1);
+  checkValue("3 - -2", 5);
+
+  // comparisons and logic, NaN is false
+  checkValue("1 <= 1", 1);
+  checkValue("1 >= 2", 0);
+  checkValue("1 != 2", 1);
+  checkValue("0 || 0", 0);
+  checkValue("0 / 0", nan);
+  checkValue("(0 / 0) || 0", 0);
+  checkValue("!(0 / 0)", 1);
+
+  // functions
+  checkValue("min(3, 1, 2)", 1);
+  checkValue("max(3, 1, 2)", 3);
+  checkValue("abs(-2.5)", 2.5);
+  checkValue("sqrt(16)", 4);
+  checkValue("pow(2, 10)", 1024);
+  checkValue("if(0, 1, 2)", 2);
+  checkValue("if(1 > 0, 1, 2)", 1);
+  checkValue("log(exp(2))", 2);
+
+  // references get their values in the order of references(), a reference used twice is loaded once
+  checkValue("Mois[1] * 2", 0.5, {0.25});
+  checkValue("Mois[1] + Mois[1] + Mois[2]", 0.7, {0.25, 0.2});
+  checkValue("Mois[1] < 0.2", 0);
+  checkValue("'Mois'[1] > 0.2", 1, {0.25});
+
+  // references are translated to the usual output id syntax
+  checkReference("Mois", Json(J11Array{"Mois"}), -1, -1, OId::NONE);
+  checkReference("Mois[2]", Json(J11Array{"Mois", 2}), 1, 1, OId::NONE);
+  checkReference("Mois[1, 3]", Json(J11Array{"Mois", J11Array{1, 3, "AVG"}}), 0, 2, OId::AVG);
+  checkReference("Mois[1, 3, SUM]", Json(J11Array{"Mois", J11Array{1, 3, "SUM"}}), 0, 2, OId::SUM);
+  checkReference("Mois[1, AVG]", Json(J11Array{"Mois", J11Array{1, "AVG"}}), 0, 0, OId::AVG);
+  checkReference("Mois[2, MAX]", Json(J11Array{"Mois", J11Array{2, "MAX"}}), 1, 1, OId::MAX);
+
+  // errors
+  checkError("");
+  checkError("1 +");
+  checkError("(1 + 2");
+  checkError("1 2");
+  checkError("1 + * 2");
+  checkError("foo(1)");
+  checkError("min()");
+  checkError("pow(1)");
+  checkError("if(1, 2)");
+  checkError("NoSuchOutput + 1");
+  checkError("'Mois");
+  checkError("Mois[1");
+  checkError("Mois[]");
+  checkError("1 $ 2");
+
+  // derived outputs and conditions which don't compile are reported
+  {
+    checks++;
+    Errors errors;
+    auto oids = parseOutputIds({"=Mois[1] +", J11Array{"=1 / ", "AVG"}, "=Mois[1] * 2|twice", "Mois"}, &errors);
+    if (oids.size() != 2) fail("parseOutputIds kept " + to_string(oids.size()) + " output ids, expected 2");
+    if (errors.errors.size() != 2)
+      fail("parseOutputIds reported " + to_string(errors.errors.size()) + " errors, expected 2");
+  }
+  {
+    checks++;
+    Spec spec;
+    auto errors = spec.merge(J11Object{{"from", "=Stage >="}, {"to", "Harvest"}});
+    if (errors.errors.size() != 1)
+      fail("Spec::merge reported " + to_string(errors.errors.size()) + " errors, expected 1");
+    if (!spec.tof) fail("Spec::merge dropped the valid 'to' condition");
+  }
+  {
+    checks++;
+    Errors errors;
+    auto store = setupStorage(J11Array{"daily", J11Array{"Date", "=Mois[1] +"},
+                                       J11Object{{"at", "=Mois[1] <"}}, J11Array{"Date"}},
+                              Date(1, 1, 2000), Date(31, 12, 2000), &errors);
+    if (store.size() != 2) fail("setupStorage created " + to_string(store.size()) + " sections, expected 2");
+    if (errors.errors.size() != 2)
+      fail("setupStorage reported " + to_string(errors.errors.size()) + " errors, expected 2");
+  }
+
+  if (failures > 0) {
+    cerr << failures << " of " << checks << " checks failed" << endl;
+    return 1;
+  }
+  cout << "all " << checks << " checks passed" << endl;
+  return 0;
+}
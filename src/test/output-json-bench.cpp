@@ -0,0 +1,176 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+// serializes a synthetic output (a daily section of 100 years with per layer arrays, plus a yearly object section)
+// to JSON, once by writing it directly into a stream and once by dumping the json11 tree of Output::to_json(),
+// and reports the serialization times and the growth of the peak resident set size
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "tools/date.h"
+#include "io/output.h"
+
+using namespace std;
+using namespace monica;
+using namespace Tools;
+
+namespace {
+
+const double pi = 3.14159265358979323846;
+
+OId makeOId(const string& name, const string& unit, int fromLayer = -1, int toLayer = -1) {
+  OId oid;
+  oid.name = name;
+  oid.unit = unit;
+  oid.fromLayer = fromLayer;
+  oid.toLayer = toLayer;
+  return oid;
+}
+
+Output createOutput(int years) {
+  Output out;
+  Output::Data d;
+  d.origSpec = "\"daily\"";
+  d.outputIds = {makeOId("Date", ""), makeOId("Crop", ""), makeOId("Yield", "kg ha-1"), makeOId("LAI", "m2 m-2"),
+                 makeOId("Precip", "mm"), makeOId("Tavg", "°C"), makeOId("Act_ET", "mm"), makeOId("Recharge", "mm"),
+                 makeOId("NLeach", "kg N ha-1"), makeOId("Mois", "m3 m-3", 0, 19), makeOId("SOC", "%", 0, 2)};
+  d.results.resize(d.outputIds.size());
+
+  Output::Data y;
+  y.origSpec = "\"yearly\"";
+  y.outputIds = {makeOId("Year", ""), makeOId("Precip", "mm"), makeOId("Tavg", "°C")};
+
+  Date date(1, 1, 1921);
+  auto end = Date(31, 12, 1921 + years - 1);
+  for (size_t day = 0; date <= end; ++date, day++) {
+    auto doy = double(date.julianDay());
+    auto season = sin(2 * pi * (doy - 80) / 365.0);
+    bool crop = doy > 90 && doy < 220;
+    size_t c = 0;
+    d.results[c++].push_back(date.toIsoDateString());
+    d.results[c++].push_back(crop ? "winter wheat" : "");
+    d.results[c++].push_back(crop ? (doy - 90) * 61.3 : 0.0);
+    d.results[c++].push_back(crop ? 6 * sin(pi * (doy - 90) / 130) : 0.0);
+    d.results[c++].push_back(day % 3 == 0 ? fmod(day * 0.37, 17.1) : 0.0);
+    d.results[c++].push_back(9 + 10 * season + fmod(day * 0.13, 3.0));
+    d.results[c++].push_back(max(0.05, 1.7 + 1.5 * season));
+    d.results[c++].push_back(fmod(day * 0.011, 1.3));
+    d.results[c++].push_back(fmod(day * 0.0007, 0.05));
+    J11Array mois, soc;
+    for (int l = 0; l < 20; l++) mois.push_back(0.18 + 0.01 * l + 0.03 * season);
+    for (int l = 0; l < 3; l++) soc.push_back(1.1 - 0.3 * l + day * 1e-7);
+    d.results[c++].push_back(mois);
+    d.results[c++].push_back(soc);
+    if (date.day() == 31 && date.month() == 12) {
+      y.resultsObj.push_back(J11Object{{"Year", int(date.year())}, {"Precip", 550.0 + fmod(day * 0.7, 200.0)},
+                                       {"Tavg", 8.5 + fmod(day * 0.001, 2.0)}});
+    }
+  }
+  out.data.push_back(d);
+  out.data.push_back(y);
+  return out;
+}
+
+//! peak resident set size of the process so far in bytes, 0 if unknown
+size_t peakRss() {
+#ifndef _WIN32
+  rusage ru{};
+  if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+#ifdef __APPLE__
+  return size_t(ru.ru_maxrss);
+#else
+  return size_t(ru.ru_maxrss) * 1024;
+#endif
+#else
+  return 0;
+#endif
+}
+
+struct Result {
+  double seconds{0};
+  size_t bytes{0};
+  size_t peakRssGrowth{0};
+};
+
+template<typename F>
+Result bestOf(size_t repetitions, const string& pathToFile, F write) {
+  Result best{numeric_limits<double>::max(), 0, 0};
+  auto rssBefore = peakRss();
+  for (size_t i = 0; i < repetitions; i++) {
+    auto start = chrono::steady_clock::now();
+    ofstream out(pathToFile, ios::out | ios::binary | ios::trunc);
+    write(out);
+    out.close();
+    chrono::duration<double> d = chrono::steady_clock::now() - start;
+    best.seconds = min(best.seconds, d.count());
+  }
+  best.peakRssGrowth = peakRss() - rssBefore;
+  ifstream in(pathToFile, ios::binary | ios::ate);
+  best.bytes = size_t(in.tellg());
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int years = 100;
+  size_t repetitions = 5;
+  string pathToDir = ".";
+
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    if ((arg == "-y" || arg == "--years") && i + 1 < argc) years = stoi(argv[++i]);
+    else if ((arg == "-r" || arg == "--repetitions") && i + 1 < argc) repetitions = stoul(argv[++i]);
+    else if (arg == "-h" || arg == "--help") {
+      cout << "output-json-bench [-y | --years N (default: 100)] [-r | --repetitions N (default: 5)] [output dir]"
+           << endl;
+      return 0;
+    } else pathToDir = arg;
+  }
+
+  auto output = createOutput(years);
+  auto rows = output.data.front().results.front().size();
+
+  // the peak RSS can only grow, so the writer which is expected to need less memory has to run first
+  auto writer = bestOf(repetitions, pathToDir + "/output-json-bench-writer.json", [&](ostream& out) {
+    output.writeJson(out);
+  });
+  auto tree = bestOf(repetitions, pathToDir + "/output-json-bench-tree.json", [&](ostream& out) {
+    out << output.to_json().dump();
+  });
+
+  const double mb = 1024.0 * 1024.0;
+  cout << years << " years daily output, " << rows << " rows, " << (writer.bytes / mb) << " MB of JSON (best of "
+       << repetitions << ")" << endl
+       << "writeJson:          " << writer.seconds << " s, peak RSS +" << (writer.peakRssGrowth / mb) << " MB" << endl
+       << "to_json().dump():   " << tree.seconds << " s, peak RSS +" << (tree.peakRssGrowth / mb) << " MB ("
+       << (tree.seconds / writer.seconds) << "x the time)" << endl;
+  if (writer.bytes != tree.bytes) {
+    cerr << "Error: the JSON texts differ in size (" << writer.bytes << " vs. " << tree.bytes << " bytes)" << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,179 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+// compares the JSON text written directly from an Output (toString, writeJson into a string and into a stream)
+// byte by byte with the dump of the json11 tree of Output::to_json(), which it replaces
+
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "io/output.h"
+
+using namespace std;
+using namespace monica;
+using namespace Tools;
+using namespace json11;
+
+namespace {
+
+OId makeOId(const string& name, const string& displayName = "", int fromLayer = -1, int toLayer = -1) {
+  OId oid;
+  oid.name = name;
+  oid.displayName = displayName;
+  oid.jsonInput = displayName.empty() ? name : name + "|" + displayName;
+  oid.fromLayer = fromLayer;
+  oid.toLayer = toLayer;
+  return oid;
+}
+
+//! the special and the string values every section is checked with
+J11Array testValues() {
+  const auto inf = numeric_limits<double>::infinity();
+  const auto nan = numeric_limits<double>::quiet_NaN();
+  return {0.0, -0.0, 1.0, -1.5, 1.0 / 3, 1e300, -1e-300, 123456789.123456789, inf, -inf, nan,
+          numeric_limits<double>::denorm_min(), numeric_limits<double>::max(),
+          "", "plain", "with \"quotes\"", "back\\slash", "new\nline\ttab\rreturn", string("nul\0char", 8),
+          "\x01\x1f control", "°C umlauts äöü", "\xe2\x80\xa8 line separator", "/slash",
+          true, false, Json(),
+          J11Array{1.0, nan, inf, "a\"b", Json()}, J11Array{}, J11Object{{"k\"ey", nan}, {"a", J11Array{-inf}}}};
+}
+
+Output::Data rowSection(size_t noOfRows) {
+  Output::Data d;
+  d.origSpec = "\"daily\"";
+  d.outputIds = {makeOId("Date"), makeOId("Value", "with \"quoted\" display name"), makeOId("Mois", "", 0, 2)};
+  d.results.resize(d.outputIds.size());
+  auto vs = testValues();
+  for (size_t r = 0; r < noOfRows; r++) {
+    d.results[0].push_back("2000-01-" + to_string(r % 31 + 1));
+    d.results[1].push_back(vs[r % vs.size()]);
+    d.results[2].push_back(J11Array{vs[r % vs.size()], double(r), vs[(r + 1) % vs.size()]});
+  }
+  return d;
+}
+
+Output::Data objSection(size_t noOfRows) {
+  Output::Data d;
+  d.origSpec = "{\"from\": \"Sowing\", \"to\": \"Harvest\"}";
+  d.outputIds = {makeOId("Crop"), makeOId("Yield"), makeOId("Esc\"aped\\key")};
+  auto vs = testValues();
+  for (size_t r = 0; r < noOfRows; r++) {
+    J11Object row;
+    // leave out some keys, as happens for missing values
+    if (r % 3 != 0) row["Crop"] = vs[(r + 13) % vs.size()];
+    row["Yield"] = vs[r % vs.size()];
+    row["Esc\"aped\\key"] = vs[(r + 7) % vs.size()];
+    d.resultsObj.push_back(row);
+  }
+  return d;
+}
+
+struct TestCase {
+  string name;
+  Output output;
+};
+
+vector<TestCase> testCases() {
+  vector<TestCase> cases;
+
+  cases.push_back({"empty output", Output()});
+
+  Output justErrors(string("an \"error\"\nwith newline"));
+  justErrors.warnings = {"a warning", "", "tab\there"};
+  justErrors.customId = "custom \"id\"";
+  cases.push_back({"errors and warnings", justErrors});
+
+  Output emptySections;
+  emptySections.customId = J11Object{{"id", 1}, {"env", J11Array{"a", 2.5}}};
+  Output::Data noResults;
+  noResults.origSpec = "\"yearly\"";
+  noResults.outputIds = {makeOId("Year")};
+  emptySections.data.push_back(noResults);
+  Output::Data emptyColumns = noResults;
+  emptyColumns.results.resize(1);
+  emptySections.data.push_back(emptyColumns);
+  Output::Data noOutputIds;
+  noOutputIds.origSpec = "\"crop\"";
+  emptySections.data.push_back(noOutputIds);
+  Output::Data emptyRows;
+  emptyRows.origSpec = "\"crop\"";
+  emptyRows.resultsObj = {J11Object(), J11Object()};
+  emptySections.data.push_back(emptyRows);
+  cases.push_back({"empty sections", emptySections});
+
+  Output rows;
+  rows.customId = 42;
+  rows.data.push_back(rowSection(100));
+  cases.push_back({"row section", rows});
+
+  Output objs;
+  objs.data.push_back(objSection(100));
+  cases.push_back({"object section", objs});
+
+  // large enough to flush the stream buffer several times, in the middle of a row and of an object
+  Output mixed;
+  mixed.customId = "mixed";
+  mixed.data.push_back(rowSection(20000));
+  mixed.data.push_back(objSection(5000));
+  mixed.data.push_back(noResults);
+  mixed.data.push_back(rowSection(3));
+  mixed.errors = {"e1"};
+  mixed.warnings = {"w1", "w2"};
+  cases.push_back({"mixed large output", mixed});
+
+  return cases;
+}
+
+} // namespace
+
+int main() {
+  int failures = 0, checks = 0;
+  auto check = [&](const string& what, const string& expected, const string& actual) {
+    checks++;
+    if (expected == actual) return;
+    failures++;
+    size_t i = 0;
+    while (i < expected.size() && i < actual.size() && expected[i] == actual[i]) i++;
+    auto from = i < 40 ? 0 : i - 40;
+    cerr << "FAILED: " << what << ": outputs differ at byte " << i << " (sizes " << expected.size() << " vs. "
+         << actual.size() << ")" << endl
+         << "  expected: ..." << expected.substr(from, 80) << endl
+         << "  actual:   ..." << actual.substr(from, 80) << endl;
+  };
+
+  for (const auto& tc : testCases()) {
+    auto expected = tc.output.to_json().dump();
+
+    check(tc.name + ", toString", expected, tc.output.toString());
+
+    string into = "prefix";
+    tc.output.writeJson(into);
+    check(tc.name + ", writeJson into a string", "prefix" + expected, into);
+
+    ostringstream out;
+    tc.output.writeJson(out);
+    check(tc.name + ", writeJson into a stream", expected, out.str());
+  }
+
+  if (failures > 0) {
+    cerr << failures << " of " << checks << " comparisons failed" << endl;
+    return 1;
+  }
+  cout << "all " << checks << " comparisons passed" << endl;
+  return 0;
+}
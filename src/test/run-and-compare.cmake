@@ -0,0 +1,33 @@
+# runs a reference and a candidate monica-run and compares their CSV outputs with compare-csv-outputs
+#
+# cmake -DREF_RUN=... -DREF_SIM=... -DCAND_RUN=... -DCAND_SIM=... -DCOMPARE=... "-DCOMPARE_ARGS=..." -DOUT_DIR=...
+#       -P run-and-compare.cmake
+
+foreach (var REF_RUN REF_SIM CAND_RUN CAND_SIM COMPARE OUT_DIR)
+    if (NOT DEFINED ${var})
+        message(FATAL_ERROR "${var} is not defined")
+    endif ()
+endforeach ()
+
+if (NOT DEFINED ENV{MONICA_PARAMETERS})
+    message(FATAL_ERROR "MONICA_PARAMETERS has to point to the monica-parameters directory")
+endif ()
+
+file(MAKE_DIRECTORY ${OUT_DIR})
+
+execute_process(COMMAND ${REF_RUN} -o ${OUT_DIR}/reference.csv ${REF_SIM} RESULT_VARIABLE res)
+if (NOT res EQUAL 0)
+    message(FATAL_ERROR "reference run failed: ${res}")
+endif ()
+
+execute_process(COMMAND ${CAND_RUN} -o ${OUT_DIR}/candidate.csv ${CAND_SIM} RESULT_VARIABLE res)
+if (NOT res EQUAL 0)
+    message(FATAL_ERROR "candidate run failed: ${res}")
+endif ()
+
+separate_arguments(COMPARE_ARGS)
+execute_process(COMMAND ${COMPARE} ${COMPARE_ARGS} ${OUT_DIR}/reference.csv ${OUT_DIR}/candidate.csv
+        RESULT_VARIABLE res)
+if (NOT res EQUAL 0)
+    message(FATAL_ERROR "outputs differ")
+endif ()
@@ -0,0 +1,72 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+Authors:
+Michael Berg <michael.berg@zalf.de>
+
+Maintainers:
+Currently maintained by the authors.
+
+This file is part of the MONICA model.
+Copyright (C) Leibniz Centre for Agricultural Landscape Research (ZALF)
+*/
+
+#pragma once
+
+// shared by the tests and benchmarks: creates the Env of a sim.json the way monica-run does
+// (just for local files, no capnp sturdy refs)
+
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "json11/json11.hpp"
+
+#include "tools/helper.h"
+#include "soil/soil.h"
+#include "soil/conversion.h"
+#include "run/run-monica.h"
+#include "run/create-env-from-json-config.h"
+
+namespace monica {
+namespace test {
+
+inline Env createEnvFromSimJson(const std::string& pathToSimJson) {
+  using namespace Tools;
+
+  std::string pathOfSimJson, simFileName;
+  std::tie(pathOfSimJson, simFileName) = splitPathToFile(pathToSimJson);
+
+  auto simm = printPossibleErrors(readAndParseJsonFile(pathToSimJson)).object_items();
+  for (auto name : {"crop.json", "site.json", "climate.csv"}) {
+    auto path = simm[name].string_value();
+    if (!isAbsolutePath(path)) simm[name] = pathOfSimJson + path;
+  }
+
+  std::map<std::string, json11::Json> ps;
+  ps["sim"] = json11::Json(simm);
+  ps["crop"] = printPossibleErrors(readAndParseJsonFile(simm["crop.json"].string_value()));
+  ps["site"] = printPossibleErrors(readAndParseJsonFile(simm["site.json"].string_value()));
+
+  Env env;
+  auto pathToSoilDir = fixSystemSeparator(replaceEnvVars("${MONICA_PARAMETERS}/soil/"));
+  env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Wessolek2009"] =
+      Soil::getInitializedUpdateUnsetPwpFcSatfromKA5textureClassFunction(pathToSoilDir);
+  env.params.siteParameters.calculateAndSetPwpFcSatFunctions["VanGenuchten"] = Soil::updateUnsetPwpFcSatFromVanGenuchten;
+  env.params.siteParameters.calculateAndSetPwpFcSatFunctions["Toth"] = Soil::updateUnsetPwpFcSatFromToth;
+
+  auto mergeResult = env.merge(createEnvJsonFromJsonObjects(ps));
+  printPossibleErrors(mergeResult);
+  if (mergeResult.failure()) return {};
+
+  env.params.userSoilMoistureParameters.getCapillaryRiseRate =
+      [](const std::string& soilTexture, size_t distance) {
+        return Soil::readCapillaryRiseRates().getRate(soilTexture, distance);
+      };
+  return env;
+}
+
+} // namespace test
+} // namespace monica